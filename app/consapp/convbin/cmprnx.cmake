@@ -0,0 +1,29 @@
+# compare output files of convbin in directories DIR1 and DIR2 ignoring the
+# PGM / RUN BY / DATE header line, and delete the directories
+#
+#   cmake -DDIR1=<dir1> -DDIR2=<dir2> -P cmprnx.cmake
+
+get_filename_component(DIR1 ${DIR1} ABSOLUTE)
+get_filename_component(DIR2 ${DIR2} ABSOLUTE)
+file(GLOB files RELATIVE ${DIR1} ${DIR1}/*)
+file(GLOB files2 RELATIVE ${DIR2} ${DIR2}/*)
+list(LENGTH files n)
+list(LENGTH files2 n2)
+
+if(n EQUAL 0 OR NOT n EQUAL n2)
+  message(FATAL_ERROR "number of output files differ: ${DIR1} ${n} ${DIR2} ${n2}")
+endif()
+foreach(f ${files})
+  if(NOT EXISTS ${DIR2}/${f})
+    message(FATAL_ERROR "no output file: ${DIR2}/${f}")
+  endif()
+  file(STRINGS ${DIR1}/${f} lines1)
+  file(STRINGS ${DIR2}/${f} lines2)
+  list(FILTER lines1 EXCLUDE REGEX "PGM / RUN BY / DATE")
+  list(FILTER lines2 EXCLUDE REGEX "PGM / RUN BY / DATE")
+  if(NOT lines1 STREQUAL lines2)
+    message(FATAL_ERROR "output files differ: ${f}")
+  endif()
+  message(STATUS "${f}: identical")
+endforeach()
+file(REMOVE_RECURSE ${DIR1} ${DIR2})
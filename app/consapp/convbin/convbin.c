@@ -43,6 +43,9 @@
 *                           force option -scan
 *                           delete option -noscan
 *                           suppress warnings
+*           2026/10/18 1.21 add option -onepass
+*           2026/10/18 1.22 support multiple input files converted in parallel
+*                           add option -j, -tu
 *-----------------------------------------------------------------------------*/
 #define _POSIX_C_SOURCE 200112L
 #include <stdio.h>
@@ -50,18 +53,41 @@
 #include <string.h>
 #include <stdarg.h>
 #include <sys/stat.h>
+#ifndef WIN32
+#include <unistd.h>
+#endif
 #include "rtklib.h"
 
 #define PRGNAME   "CONVBIN"
 #define TRACEFILE "convbin.trace"
 #define NOUTFILE        9       /* number of output files */
+#define MAXFILE         8192    /* max number of input files */
+#define MAXTHREAD       64      /* max number of conversion threads */
+
+typedef struct {                /* conversion job type */
+    rnxopt_t opt;               /* RINEX options */
+    int format;                 /* input format */
+    const char *ifile;          /* input file */
+    int stat;                   /* status (1:ok,0:error) */
+} convjob_t;
+
+typedef struct {                /* conversion job pool type */
+    convjob_t *job;             /* conversion jobs */
+    int njob,next;              /* number of jobs and next job */
+    char **ofile;               /* output files */
+    char *dir;                  /* output directory */
+    rtklib_lock_t lock;         /* lock for next job */
+} jobpool_t;
+
+static rtklib_lock_t lock_msg;  /* lock for messages */
+static int lock_init=0;         /* lock initialized flag */
 
 /* help text -----------------------------------------------------------------*/
 static const char *help[]={
 "",
 " Synopsis",
 "",
-" convbin [option ...] file", 
+" convbin [option ...] file [file ...]", 
 "",
 " Description",
 "",
@@ -90,13 +116,14 @@ static const char *help[]={
 "",
 " Options [default]",
 "",
-"     file         input receiver binary log file",
+"     file         input receiver binary log file(s)",
 "     -ts y/m/d h:m:s  start time [all]",
 "     -te y/m/d h:m:s  end time [all]",
 "     -tr y/m/d h:m:s  approximated time for RTCM",
 "     -ti tint     observation data interval (s) [all]",
 "     -tt ttol     observation data epoch tolerance (s) [0.005]",
 "     -span span   time span (h) [all]",
+"     -tu unit     time unit for multiple sessions with -ts and -te (h) [off]",
 "     -r format    log format type",
 "                  rtcm2= RTCM 2",
 "                  rtcm3= RTCM 3",
@@ -131,6 +158,7 @@ static const char *help[]={
 "     -ol          include leap seconds in rinex nav header [off]",
 "     -halfc       half-cycle ambiguity correction [off]",
 "     -sortsats    sort observations by the RTKLib satellite index [off]",
+"     -onepass     single-pass conversion without scanning input [off]",
 "     -mask   [sig[,...]] signal mask(s) (sig={G|R|E|J|S|C|I}L{1C|1P|1W|...})",
 "     -nomask [sig[,...]] signal no mask (same as above)",
 "     -x sat       exclude satellite",
@@ -147,6 +175,7 @@ static const char *help[]={
 "     -b cfile     output RINEX CNAV file",
 "     -i ifile     output RINEX INAV file",
 "     -s sfile     output SBAS message file",
+"     -j nthread   number of conversion threads [number of cpus]",
 "     -trace level output trace level [off]",
 "",
 " If any output file specified, default output files (<file>.obs,",
@@ -156,6 +185,13 @@ static const char *help[]={
 " Without -tr option, the program obtains the week number from the time-tag file",
 " (if it exists) or the last modified time of the log file instead.",
 "",
+" Multiple input files are converted in parallel by -j threads, each to the",
+" default output files. Options -c and output file options are not allowed",
+" with multiple input files. For a single input file with -tu option, the",
+" time sessions are converted in parallel instead only if -j is specified,",
+" where each session does not carry station info and approx position found",
+" in the previous sessions.",
+"",
 " If receiver type is not specified, type is recognized by the input",
 " file extension as follows.",
 "     *.rtcm2       RTCM 2",
@@ -185,8 +221,10 @@ static void printhelp(void)
 extern int showmsg(const char *format, ...)
 {
     va_list arg;
+    if (lock_init) rtklib_lock(&lock_msg);
     va_start(arg,format); vfprintf(stderr,format,arg); va_end(arg);
     fprintf(stderr,*format?"\r":"\n");
+    if (lock_init) rtklib_unlock(&lock_msg);
     return 0;
 }
 /* convert main --------------------------------------------------------------*/
@@ -194,7 +232,7 @@ static int convbin(int format, rnxopt_t *opt, const char *ifile, char **file,
                    char *dir)
 {
     int i,def;
-    static char work[1024],ofile_[NOUTFILE][1024]={"","","","","","","","",""};
+    char work[1024],ofile_[NOUTFILE][1024]={"","","","","","","","",""};
     char ifile_[1024],*ofile[NOUTFILE],*p;
     char *extnav=(opt->rnxver<=299||opt->navsys==SYS_GPS)?"N":"P";
     char *extlog="sbs";
@@ -298,6 +336,7 @@ static int convbin(int format, rnxopt_t *opt, const char *ifile, char **file,
         else strcpy(work,ofile[i]);
         sprintf(ofile[i],"%s%c%s",dir,RTKLIB_FILEPATHSEP,work);
     }
+    if (lock_init) rtklib_lock(&lock_msg);
     fprintf(stderr,"input file  : %s (%s)\n",ifile,formatstrs[format]);
     
     if (*ofile[0]) fprintf(stderr,"->rinex obs : %s\n",ofile[0]);
@@ -309,14 +348,89 @@ static int convbin(int format, rnxopt_t *opt, const char *ifile, char **file,
     if (*ofile[6]) fprintf(stderr,"->rinex cnav: %s\n",ofile[6]);
     if (*ofile[7]) fprintf(stderr,"->rinex inav: %s\n",ofile[7]);
     if (*ofile[8]) fprintf(stderr,"->sbas log  : %s\n",ofile[8]);
+    if (lock_init) rtklib_unlock(&lock_msg);
     
     if (!convrnx(format,opt,ifile,ofile)) {
-        fprintf(stderr,"\n");
+        showmsg("");
         return 0;
     }
-    fprintf(stderr,"\n");
+    showmsg("");
     return 1;
 }
+/* conversion thread ---------------------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI convthread(void *arg)
+#else
+static void *convthread(void *arg)
+#endif
+{
+    jobpool_t *pool=(jobpool_t *)arg;
+    convjob_t *job;
+    int i;
+    
+    for (;;) {
+        rtklib_lock(&pool->lock);
+        i=pool->next++;
+        rtklib_unlock(&pool->lock);
+        
+        if (i>=pool->njob) break;
+        job=pool->job+i;
+        job->stat=convbin(job->format,&job->opt,job->ifile,pool->ofile,
+                          pool->dir);
+    }
+    return 0;
+}
+/* convert multiple files by threads -----------------------------------------*/
+static int convbin_p(convjob_t *job, int njob, char **ofile, char *dir,
+                     int nthread)
+{
+    jobpool_t pool={0};
+    rtklib_thread_t thread[MAXTHREAD];
+    int i,n,stat=1;
+    
+    pool.job=job;
+    pool.njob=njob;
+    pool.ofile=ofile;
+    pool.dir=dir;
+    rtklib_initlock(&pool.lock);
+    
+    if (nthread>MAXTHREAD) nthread=MAXTHREAD;
+    if (nthread>njob) nthread=njob;
+    
+    for (n=0;n<nthread;n++) {
+#ifdef WIN32
+        if (!(thread[n]=CreateThread(NULL,0,convthread,&pool,0,NULL))) break;
+#else
+        if (pthread_create(thread+n,NULL,convthread,&pool)) break;
+#endif
+    }
+    if (n<=0) convthread(&pool); /* no thread available */
+    
+    for (i=0;i<n;i++) {
+#ifdef WIN32
+        WaitForSingleObject(thread[i],INFINITE);
+        CloseHandle(thread[i]);
+#else
+        pthread_join(thread[i],NULL);
+#endif
+    }
+    for (i=0;i<njob;i++) {
+        if (!job[i].stat) stat=0;
+    }
+    return stat;
+}
+/* number of cpus ------------------------------------------------------------*/
+static int ncpu(void)
+{
+#ifdef WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long n=sysconf(_SC_NPROCESSORS_ONLN);
+    return n>0?(int)n:1;
+#endif
+}
 /* set signal mask -----------------------------------------------------------*/
 static void setmask(const char *argv, rnxopt_t *opt, int mask)
 {
@@ -418,13 +532,14 @@ static int get_filetime(const char *file, gtime_t *time)
     return 0;
 }
 /* parse command line options ------------------------------------------------*/
-static int cmdopts(int argc, char **argv, rnxopt_t *opt, char **ifile,
-                   char **ofile, char **dir, int *trace)
+static void cmdopts(int argc, char **argv, rnxopt_t *opt, char **ifile,
+                    int *nfile, char **ofile, char **dir, int *trace,
+                    char **fmt, int *nthread)
 {
     double eps[]={1980,1,1,0,0,0},epe[]={2037,12,31,0,0,0};
     double epr[]={2010,1,1,0,0,0},span=0.0;
-    int i,j,k,sat,nf=6,format=-1;
-    char *p,*sys,*fmt="",*paths[1],path[1024],buff[256];
+    int i,j,k,sat,nf=6;
+    char *p,*sys,buff[256];
     
     opt->rnxver=304;
     opt->obstype=OBSTYPE_PR|OBSTYPE_CP;
@@ -461,8 +576,11 @@ static int cmdopts(int argc, char **argv, rnxopt_t *opt, char **ifile,
         else if (!strcmp(argv[i],"-span")&&i+1<argc) {
             span=atof(argv[++i]);
         }
+        else if (!strcmp(argv[i],"-tu")&&i+1<argc) {
+            opt->tunit=atof(argv[++i])*3600.0;
+        }
         else if (!strcmp(argv[i],"-r" )&&i+1<argc) {
-            fmt=argv[++i];
+            *fmt=argv[++i];
         }
         else if (!strcmp(argv[i],"-ro")&&i+1<argc) {
             strcpy(opt->rcvopt,argv[++i]);
@@ -544,6 +662,9 @@ static int cmdopts(int argc, char **argv, rnxopt_t *opt, char **ifile,
         else if (!strcmp(argv[i],"-sortsats")) {
             opt->sortsats=1;
         }
+        else if (!strcmp(argv[i],"-onepass")) {
+            opt->onepass=1;
+        }
         else if (!strcmp(argv[i],"-mask")&&i+1<argc) {
             for (j=0;j<RNX_NUMSYS;j++) {
               for (k=0;k<MAXCODE;k++) opt->mask[j][k]='0';
@@ -585,6 +706,9 @@ static int cmdopts(int argc, char **argv, rnxopt_t *opt, char **ifile,
         else if (!strcmp(argv[i],"-b" )&&i+1<argc) ofile[6]=argv[++i];
         else if (!strcmp(argv[i],"-i" )&&i+1<argc) ofile[7]=argv[++i];
         else if (!strcmp(argv[i],"-s" )&&i+1<argc) ofile[8]=argv[++i];
+        else if (!strcmp(argv[i],"-j" )&&i+1<argc) {
+            *nthread=atoi(argv[++i]);
+        }
         else if (!strcmp(argv[i],"-trace" )&&i+1<argc) {
             *trace=atoi(argv[++i]);
         }
@@ -594,7 +718,7 @@ static int cmdopts(int argc, char **argv, rnxopt_t *opt, char **ifile,
         }
         else if (!strncmp(argv[i],"-",1)) printhelp();
         
-        else *ifile=argv[i];
+        else if (*nfile<MAXFILE) ifile[(*nfile)++]=argv[i];
     }
     if (span>0.0&&opt->ts.time) {
         opt->te=timeadd(opt->ts,span*3600.0-1e-3);
@@ -608,11 +732,18 @@ static int cmdopts(int argc, char **argv, rnxopt_t *opt, char **ifile,
     if (nf>=7) opt->freqtype|=FREQTYPE_ALL;
     
     if (opt->trtcm.time == 0) {
-        // Use the start or end time if supplied. Otherwise use the file time.
+        // Use the start or end time if supplied. Otherwise use the file time
+        // of each input file.
         if (opt->ts.time != 0) opt->trtcm = opt->ts;
         else if (opt->te.time != 0) opt->trtcm = opt->te;
-        else get_filetime(*ifile, &opt->trtcm);
     }
+}
+/* get input format ----------------------------------------------------------*/
+static int getformat(const char *fmt, const char *ifile)
+{
+    int format=-1;
+    char *p,*paths[1],path[1024];
+    
     if (*fmt) {
         if      (!strcmp(fmt,"rtcm2")) format=STRFMT_RTCM2;
         else if (!strcmp(fmt,"rtcm3")) format=STRFMT_RTCM3;
@@ -637,7 +768,7 @@ static int cmdopts(int argc, char **argv, rnxopt_t *opt, char **ifile,
     }
     else {
         paths[0]=path;
-        if (!expath(*ifile,paths,1)||!(p=strrchr(path,'.'))) return -1;
+        if (!expath(ifile,paths,1)||!(p=strrchr(path,'.'))) return -1;
         if      (!strcmp(p,".rtcm2"))  format=STRFMT_RTCM2;
         else if (!strcmp(p,".rtcm3"))  format=STRFMT_RTCM3;
         else if (!strcmp(p,".gps"  ))  format=STRFMT_OEM4;
@@ -670,29 +801,62 @@ static int cmdopts(int argc, char **argv, rnxopt_t *opt, char **ifile,
 /* main ----------------------------------------------------------------------*/
 int main(int argc, char **argv)
 {
+    static char *ifile[MAXFILE];
     rnxopt_t opt={{0}};
-    int format,trace=0,stat;
-    char *ifile="",*ofile[NOUTFILE]={0},*dir="";
+    convjob_t *job;
+    int i,nfile=0,trace=0,nthread=0,stat;
+    char *ofile[NOUTFILE]={0},*dir="",*fmt="";
     
     /* parse command line options */
-    format=cmdopts(argc,argv,&opt,&ifile,ofile,&dir,&trace);
+    cmdopts(argc,argv,&opt,ifile,&nfile,ofile,&dir,&trace,&fmt,&nthread);
     
-    if (!*ifile) {
+    if (nfile<=0) {
         fprintf(stderr,"no input file\n");
         return EXIT_FAILURE;
     }
-    if (format<0) {
-        fprintf(stderr,"input format can not be recognized\n");
+    if (nfile>1) {
+        for (i=0;i<NOUTFILE;i++) if (ofile[i]) break;
+        if (i<NOUTFILE||*opt.staid) {
+            fprintf(stderr,"output file options not allowed for multiple input files\n");
+            return EXIT_FAILURE;
+        }
+    }
+    if (!(job=(convjob_t *)calloc(nfile,sizeof(convjob_t)))) {
+        fprintf(stderr,"memory allocation error\n");
         return EXIT_FAILURE;
     }
     sprintf(opt.prog,"%s %s %s",PRGNAME,VER_RTKLIB,PATCH_LEVEL);
+    /* parallel sessions of single input file only by explicit -j */
+    opt.nthread=nfile>1||nthread<=0?1:nthread;
+    if (nthread<=0) nthread=ncpu();
+    
+    for (i=0;i<nfile;i++) {
+        job[i].opt=opt;
+        job[i].ifile=ifile[i];
+        if (!opt.trtcm.time) get_filetime(ifile[i],&job[i].opt.trtcm);
+        
+        if ((job[i].format=getformat(fmt,ifile[i]))<0) {
+            fprintf(stderr,"input format can not be recognized: %s\n",ifile[i]);
+            free(job);
+            return EXIT_FAILURE;
+        }
+    }
     if (trace>0) {
         traceopen(TRACEFILE);
         tracelevel(trace);
     }
-    stat=convbin(format,&opt,ifile,ofile,dir);
-    
+    if (nfile>1&&nthread>1) {
+        rtklib_initlock(&lock_msg);
+        lock_init=1;
+        stat=convbin_p(job,nfile,ofile,dir,nthread);
+    }
+    else {
+        for (i=0,stat=1;i<nfile;i++) {
+            if (!convbin(job[i].format,&job[i].opt,ifile[i],ofile,dir)) stat=0;
+        }
+    }
     traceclose();
+    free(job);
     
     return stat?0:EXIT_FAILURE;
 }
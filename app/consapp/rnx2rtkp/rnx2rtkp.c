@@ -16,6 +16,7 @@
 *           2015/05/15  1.8 -r or -l options for fixed or ppp-fixed mode
 *           2015/06/12  1.9 output patch level in header
 *           2016/09/07  1.10 add option -sys
+*           2026/10/18  1.11 add option -pc and -nc for product cache
 *-----------------------------------------------------------------------------*/
 #include <stdarg.h>
 #include "rtklib.h"
@@ -73,6 +74,8 @@ static const char *help[]={
 "           rover latitude/longitude/height for fixed or ppp-fixed mode",
 " -y level  output solution status (0:off,1:states,2:residuals) [0]",
 " -x level  debug trace level (0:off) [0]",
+" -pc dir   product cache directory for NAV/CLK/SP3/ANTEX/ERP [off]",
+" -nc       disable product cache set by configuration file [off]",
 " --rover list rover names for processing, separated by a space",
 " --base list  base names for processing, separated by a space",
 " --version display release version",
@@ -103,7 +106,7 @@ int main(int argc, char **argv)
     filopt_t filopt={""};
     gtime_t ts={0},te={0};
     double tint=0.0,es[]={2000,1,1,0,0,0},ee[]={2000,12,31,23,59,59},pos[3];
-    int i,j,n,ret;
+    int i,j,n,ret,nhit,nmiss;
     const char *infile[MAXFILE],*outfile="",*p;
     const char *rover = "", *base = "";
 
@@ -185,6 +188,10 @@ int main(int argc, char **argv)
         else if (!strcmp(argv[i],"--base")&&i+1<argc) base=argv[++i];
         else if (!strcmp(argv[i],"-y")&&i+1<argc) solopt.sstat=atoi(argv[++i]);
         else if (!strcmp(argv[i],"-x")&&i+1<argc) solopt.trace=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-pc")&&i+1<argc) {
+            strncpy(filopt.cache,argv[++i],MAXSTRPATH-1);
+        }
+        else if (!strcmp(argv[i],"-nc")) *filopt.cache='\0';
         else if (!strcmp(argv[i], "--version")) {
             fprintf(stderr, "rnx2rtkp RTKLIB %s %s\n", VER_RTKLIB, PATCH_LEVEL);
             exit(0);
@@ -208,5 +215,9 @@ int main(int argc, char **argv)
     ret=postpos(ts,te,tint,0.0,&prcopt,&solopt,&filopt,infile,n,outfile,rover,base);
 
     if (!ret) fprintf(stderr,"%40s\r","");
+
+    if (getprodcache(&nhit,&nmiss)) {
+        fprintf(stderr,"product cache: hit=%d miss=%d\n",nhit,nmiss);
+    }
     return ret?EXIT_FAILURE:0;
 }
@@ -35,8 +35,16 @@
 *           2016/09/19 1.20 support multiple remote console connections
 *                           add option -w
 *           2017/09/01 1.21 add command ssr
+*           2026/10/18 1.22 add option misc-svrevent
+*                           add option misc-svrdecthread
+*                           add option misc-latency
+*                           add stage latency to command status
+*                           add option -e for metrics http endpoint
+*                           read status snapshot in commands status,satellite
+*                           add option misc-replay
 *-----------------------------------------------------------------------------*/
 #define _POSIX_C_SOURCE 200112L
+#include <stdarg.h>
 #include <stdlib.h>
 #include <signal.h>
 #include <unistd.h>
@@ -66,6 +74,7 @@
 #define TRACEFILE   "rtkrcv_%Y%m%d%h%M.trace" /* debug trace file */
 #define LOGFILE     "rtkrcv_%Y%m%d%h%M.log"   /* Deamon log file */
 #define INTKEEPALIVE 1000               /* keep alive interval (ms) */
+#define MAXMETRICS  32768               /* max size of metrics (bytes) */
 
 #define ESC_CLEAR   "\033[H\033[2J"     /* ansi/vt100 escape: erase screen */
 #define ESC_RESET   "\033[0m"           /* ansi/vt100: reset attribute */
@@ -84,6 +93,7 @@ typedef struct {                       /* console type */
 /* global variables ----------------------------------------------------------*/
 static rtksvr_t svr;                    /* rtk server struct */
 static stream_t moni;                   /* monitor stream */
+static httpsvr_t metsvr;                /* metrics http server */
 
 static int intflg       =0;             /* interrupt flag (2:shutdown) */
 
@@ -100,6 +110,10 @@ static int strfmt[]={                   /* stream formats */
 };
 static char rcvopt[3][256]={""};        /* Receiver options */
 static int svrcycle     =10;            /* server cycle (ms) */
+static int svrevent     =0;             /* server event wait (0:off,1:on) */
+static int svrdecthread =0;             /* server decoder threads (0:off,1:on) */
+static int svrlatency   =0;             /* server stage latency (0:off,1:on) */
+static int svrreplay    =0;             /* server replay by time-tags (0:off,1:on) */
 static int timeout      =10000;         /* timeout time (ms) */
 static int reconnect    =10000;         /* reconnect interval (ms) */
 static int nmeacycle    =5000;          /* nmea request cycle (ms) */
@@ -116,6 +130,7 @@ static char stopcmd [MAXSTR]="";        /* stop command */
 static int modflgr[256] ={0};           /* modified flags of receiver options */
 static int modflgs[256] ={0};           /* modified flags of system options */
 static int moniport     =0;             /* monitor port */
+static int metport      =0;             /* metrics http port */
 static int keepalive    =0;             /* keep alive flag */
 static int start        =0;             /* auto start */
 static int fswapmargin  =30;            /* file swap margin (s) */
@@ -127,12 +142,14 @@ static filopt_t filopt  ={""};          /* file options */
 
 /* help text -----------------------------------------------------------------*/
 static const char *usage[]={
-    "usage: rtkrcv [-s][-p port][-d dev][-o file][-w pwd][-r level][-t level][-sta sta]",
+    "usage: rtkrcv [-s][-p port][-m port][-e port][-d dev][-o file][-w pwd][-r level]",
+    "              [-t level][-sta sta]",
     "options",
     "  -s         start RTK server on program startup",
     "  -nc        start RTK server on program startup with no console",
     "  -p port    port number for telnet console",
     "  -m port    port number for monitor stream",
+    "  -e port    port number for metrics http endpoint (prometheus)",
     "  -d dev     terminal device for console",
     "  -o file    processing options file",
     "  -w pwd     login password for remote console (\"\": no password)",
@@ -226,6 +243,10 @@ static opt_t rcvopts[]={
     {"logstr3-path",    2,  (void *)strpath [7],         ""     },
     
     {"misc-svrcycle",   0,  (void *)&svrcycle,           "ms"   },
+    {"misc-svrevent",   3,  (void *)&svrevent,           "0:off,1:on"},
+    {"misc-svrdecthread",3, (void *)&svrdecthread,       "0:off,1:on"},
+    {"misc-latency",    3,  (void *)&svrlatency,         "0:off,1:on"},
+    {"misc-replay",     3,  (void *)&svrreplay,          "0:off,1:on"},
     {"misc-timeout",    0,  (void *)&timeout,            "ms"   },
     {"misc-reconnect",  0,  (void *)&reconnect,          "ms"   },
     {"misc-nmeacycle",  0,  (void *)&nmeacycle,          "ms"   },
@@ -308,6 +329,183 @@ static void closemoni(void)
     
     strclose(&moni);
 }
+/* open metrics port ---------------------------------------------------------*/
+static int openmetrics(int port)
+{
+    char path[64],msg[MAXSTRMSG]="";
+    
+    trace(3,"openmetrics: port=%d\n",port);
+    
+    sprintf(path,":%d",port);
+    if (!httpsvropen(&metsvr,path,msg)) {
+        trace(2,"openmetrics: %s\n",msg);
+        return 0;
+    }
+    return 1;
+}
+/* print to metrics buffer with remaining length -----------------------------*/
+static char *prmet(char *p, const char *end, const char *format, ...)
+{
+    va_list ap;
+    int n;
+    
+    if (p>=end-1) return p;
+    va_start(ap,format);
+    n=vsnprintf(p,(size_t)(end-p),format,ap);
+    va_end(ap);
+    return n<0?p:(n<end-p?p+n:(char *)end-1); /* truncated at end */
+}
+/* print metric header -------------------------------------------------------*/
+static char *prmethdr(char *p, const char *end, const char *name,
+                      const char *type, const char *help)
+{
+    p=prmet(p,end,"# HELP rtkrcv_%s %s\n",name,help);
+    p=prmet(p,end,"# TYPE rtkrcv_%s %s\n",name,type);
+    return p;
+}
+/* print metrics in prometheus text format -----------------------------------*/
+static int prmetrics(char *buff, int size)
+{
+    const char *ch[]={"rover","base","corr","sol1","sol2","logr","logb","logc"};
+    const char *type[]={
+        "obs","nav","ion","sbs","pos","dgps","gnav","ssr","","err"
+    };
+    const char *sol[]={"none","fix","float","sbas","dgps","single","ppp","dr"};
+    const char *stage[]={
+        "read","decode","satpos","residual","filter","ambiguity","format",
+        "output"
+    };
+    svrstat_t *stat;
+    double p50[NLATSTG],p99[NLATSTG],lmax[NLATSTG],lsum[NLATSTG];
+    uint32_t lcnt[NLATSTG];
+    char *p=buff;
+    const char *end=buff+size;
+    int i,j,state,bsize,nlat[NLATSTG];
+    
+    trace(4,"prmetrics:\n");
+    
+    if (!(stat=(svrstat_t *)calloc(1,sizeof(svrstat_t)))) return 0;
+    
+    /* status snapshot of rtk server (all zero before first epoch) */
+    rtksvrstat(&svr,stat);
+    state=svr.state;
+    bsize=svr.buffsize;
+    
+    p=prmethdr(p,end,"server_state","gauge","RTK server state (0:stop,1:run)");
+    p=prmet(p,end,"rtkrcv_server_state %d\n",state);
+    
+    p=prmethdr(p,end,"stream_state","gauge","stream state (-1:error,0:close,1:open)");
+    for (i=0;i<8;i++) {
+        p=prmet(p,end,"rtkrcv_stream_state{stream=\"%s\"} %d\n",ch[i],
+                stat->state[i]);
+    }
+    p=prmethdr(p,end,"stream_bytes_total","counter","stream bytes");
+    for (i=0;i<8;i++) {
+        p=prmet(p,end,"rtkrcv_stream_bytes_total{stream=\"%s\",dir=\"in\"} %u\n",
+                ch[i],stat->inb[i]);
+        p=prmet(p,end,"rtkrcv_stream_bytes_total{stream=\"%s\",dir=\"out\"} %u\n",
+                ch[i],stat->outb[i]);
+    }
+    p=prmethdr(p,end,"stream_rate_bps","gauge","stream data rate (bps)");
+    for (i=0;i<8;i++) {
+        p=prmet(p,end,"rtkrcv_stream_rate_bps{stream=\"%s\",dir=\"in\"} %u\n",
+                ch[i],stat->inr[i]);
+        p=prmet(p,end,"rtkrcv_stream_rate_bps{stream=\"%s\",dir=\"out\"} %u\n",
+                ch[i],stat->outr[i]);
+    }
+    p=prmethdr(p,end,"messages_total","counter","input messages");
+    for (i=0;i<3;i++) for (j=0;j<10;j++) {
+        if (!*type[j]) continue;
+        p=prmet(p,end,"rtkrcv_messages_total{stream=\"%s\",type=\"%s\"} %u\n",
+                ch[i],type[j],stat->nmsg[i][j]);
+    }
+    p=prmethdr(p,end,"solutions_total","counter","solutions by quality");
+    for (i=0;i<=MAXSOLQ;i++) {
+        p=prmet(p,end,"rtkrcv_solutions_total{quality=\"%s\"} %u\n",sol[i],
+                stat->nsolq[i]);
+    }
+    p=prmethdr(p,end,"solution_quality","gauge","solution quality "
+               "(0:none,1:fix,2:float,3:sbas,4:dgps,5:single,6:ppp,7:dr)");
+    p=prmet(p,end,"rtkrcv_solution_quality %d\n",stat->sol.stat);
+    p=prmethdr(p,end,"solution_satellites","gauge","number of valid satellites");
+    p=prmet(p,end,"rtkrcv_solution_satellites %d\n",stat->sol.ns);
+    p=prmethdr(p,end,"cycle_cpu_time_ms","gauge","CPU time for a processing cycle (ms)");
+    p=prmet(p,end,"rtkrcv_cycle_cpu_time_ms %d\n",stat->cputime);
+    p=prmethdr(p,end,"missing_epochs_total","counter","missing observation data");
+    p=prmet(p,end,"rtkrcv_missing_epochs_total %d\n",stat->prcout);
+    
+    p=prmethdr(p,end,"input_buffer_bytes","gauge","bytes in input buffer");
+    for (i=0;i<3;i++) {
+        p=prmet(p,end,"rtkrcv_input_buffer_bytes{stream=\"%s\"} %d\n",ch[i],
+                stat->nb[i]);
+    }
+    p=prmethdr(p,end,"input_buffer_size_bytes","gauge","input buffer size");
+    p=prmet(p,end,"rtkrcv_input_buffer_size_bytes %d\n",bsize);
+    p=prmethdr(p,end,"decoder_queue_bytes","gauge","bytes in decoder queue");
+    for (i=0;i<3;i++) {
+        p=prmet(p,end,"rtkrcv_decoder_queue_bytes{stream=\"%s\"} %u\n",ch[i],
+                stat->qlen[i]);
+    }
+    p=prmethdr(p,end,"decoder_queue_size_bytes","gauge","decoder queue size");
+    for (i=0;i<3;i++) {
+        p=prmet(p,end,"rtkrcv_decoder_queue_size_bytes{stream=\"%s\"} %u\n",
+                ch[i],stat->qsize[i]);
+    }
+    p=prmethdr(p,end,"decoder_dropped_total","counter","dropped decoded messages");
+    for (i=0;i<3;i++) {
+        p=prmet(p,end,"rtkrcv_decoder_dropped_total{stream=\"%s\"} %u\n",ch[i],
+                stat->qdrop[i]);
+    }
+    if (rtksvrlstat(&svr,nlat,p50,p99,lmax)) {
+        rtksvrlock(&svr);
+        for (i=0;i<NLATSTG;i++) {
+            lcnt[i]=svr.lat.cnt[i];
+            lsum[i]=svr.lat.sum[i];
+        }
+        rtksvrunlock(&svr);
+        p=prmethdr(p,end,"stage_latency_seconds","summary",
+                   "processing stage latency (s)");
+        for (i=0;i<NLATSTG;i++) {
+            p=prmet(p,end,"rtkrcv_stage_latency_seconds{stage=\"%s\",quantile=\"0.5\"} %.6f\n",
+                    stage[i],p50[i]*1E-6);
+            p=prmet(p,end,"rtkrcv_stage_latency_seconds{stage=\"%s\",quantile=\"0.99\"} %.6f\n",
+                    stage[i],p99[i]*1E-6);
+            p=prmet(p,end,"rtkrcv_stage_latency_seconds{stage=\"%s\",quantile=\"1\"} %.6f\n",
+                    stage[i],lmax[i]*1E-6);
+            p=prmet(p,end,"rtkrcv_stage_latency_seconds_sum{stage=\"%s\"} %.6f\n",
+                    stage[i],lsum[i]*1E-6);
+            p=prmet(p,end,"rtkrcv_stage_latency_seconds_count{stage=\"%s\"} %u\n",
+                    stage[i],lcnt[i]);
+        }
+        p=prmethdr(p,end,"stage_latency_samples","gauge",
+                   "processing stage latency samples");
+        for (i=0;i<NLATSTG;i++) {
+            p=prmet(p,end,"rtkrcv_stage_latency_samples{stage=\"%s\"} %d\n",
+                    stage[i],nlat[i]);
+        }
+    }
+    free(stat);
+    return (int)(p-buff);
+}
+/* respond to metrics requests -----------------------------------------------*/
+static void rspmetrics(void)
+{
+    static char buff[MAXMETRICS];
+    const char *msg="not found\n";
+    char url[256],*p;
+    int i;
+    
+    while ((i=httpsvrreq(&metsvr,url))>=0) {
+        if ((p=strchr(url,'?'))) *p='\0';
+        
+        if (strcmp(url,"/metrics")&&strcmp(url,"/")) {
+            httpsvrrsp(&metsvr,i,404,"text/plain",msg,(int)strlen(msg));
+            continue;
+        }
+        httpsvrrsp(&metsvr,i,200,"text/plain; version=0.0.4",buff,
+                   prmetrics(buff,sizeof(buff)));
+    }
+}
 /* confirm overwrite ---------------------------------------------------------*/
 static int confwrite(vt_t *vt, const char *file)
 {
@@ -511,6 +709,10 @@ static int startsvr(vt_t *vt)
     solopt[1].posf=strfmt[4];
     
     /* start rtk server */
+    svr.evtwait=svrevent;
+    svr.decthread=svrdecthread;
+    svr.lat.ena=svrlatency;
+    svr.replay=svrreplay;
     if (!rtksvrstart(&svr,svrcycle,buffsize,strtype,(const char **)paths,strfmt,navmsgsel,
                      (const char **)cmds,(const char **)cmds_periodic,(const char **)ropts,nmeacycle,nmeareq,npos,&prcopt,
                      solopt,&moni,errmsg)) {
@@ -680,42 +882,48 @@ static void prstatus(vt_t *vt)
     };
     gtime_t eventime={0};
     const char *freq[]={"-","L1","L1+L2","L1+L2+E5b","L1+L2+E5b+L5","5","6","7"};
-    rtcm_t rtcm[3];
+    const char *stage[]={
+        "stream read","decode","satellite position","residuals","filter update",
+        "ambiguity resolution","solution format","solution output"
+    };
+    uint32_t nmsg2[3][100],nmsg3[3][400];
+    svrstat_t *stat;
     pthread_t thread;
-    int i,j,n,cycle,state,rtkstat,nsat0,nsat1,prcout,rcvcount,tmcount,timevalid,nave;
-    int cputime,nb[3]={0},nmsg[3][10]={{0}};
-    char tstr[40],tmstr[40],s[1024],*p;
+    int i,j,n,cycle,state,pmode,nf,rcvcount,tmcount,timevalid,nave,nlat[NLATSTG];
+    char tstr[40],tmstr[40],s[1024],anttype[2][MAXANT],*p;
+    double p50[NLATSTG],p99[NLATSTG],lmax[NLATSTG];
     double runtime,rt[3]={0},dop[4]={0},rr[3],bl1=0.0,bl2=0.0;
-    double azel[MAXSAT*2],pos[3],vel[3],*del;
+    double azel[MAXSAT*2],pos[3],vel[3],antdel[2][3],*del;
     
     trace(4,"prstatus:\n");
     
-    rtk_t *rtk = (rtk_t *)malloc(sizeof(rtk_t));
-    if (rtk == NULL) return;
-
+    if (!(stat=(svrstat_t *)calloc(1,sizeof(svrstat_t)))) return;
+    
+    /* solution, satellite and input status by snapshot without lock */
+    rtksvrstat(&svr,stat);
+    
     rtksvrlock(&svr);
-    *rtk=svr.rtk;
     thread=svr.thread;
     cycle=svr.cycle;
     state=svr.state;
-    rtkstat=svr.rtk.sol.stat;
-    nsat0=svr.obs[0][0].n;
-    nsat1=svr.obs[1][0].n;
+    pmode=svr.rtk.opt.mode;
+    nf=svr.rtk.opt.nf;
+    for (i=0;i<2;i++) {
+        strcpy(anttype[i],svr.rtk.opt.pcvr[i].type);
+        for (j=0;j<3;j++) antdel[i][j]=svr.rtk.opt.antdel[i][j];
+    }
     rcvcount = svr.raw[0].obs.rcvcount;
     tmcount = svr.raw[0].obs.tmcount;
-    cputime=svr.cputime;
-    prcout=svr.prcout;
     nave=svr.nave;
-    for (i=0;i<3;i++) nb[i]=svr.nb[i];
-    for (i=0;i<3;i++) for (j=0;j<10;j++) {
-        nmsg[i][j]=svr.nmsg[i][j];
-    }
     if (svr.state) {
         runtime=(double)(tickget()-svr.tick)/1000.0;
         rt[0]=floor(runtime/3600.0); runtime-=rt[0]*3600.0;
         rt[1]=floor(runtime/60.0); rt[2]=runtime-rt[1]*60.0;
     }
-    for (i=0;i<3;i++) rtcm[i]=svr.rtcm[i];
+    for (i=0;i<3;i++) {
+        memcpy(nmsg2[i],svr.rtcm[i].nmsg2,sizeof(nmsg2[i]));
+        memcpy(nmsg3[i],svr.rtcm[i].nmsg3,sizeof(nmsg3[i]));
+    }
     if (svr.raw[0].obs.data != NULL) {
         timevalid = svr.raw[0].obs.data[0].timevalid;
         eventime = svr.raw[0].obs.data[0].eventime;
@@ -724,10 +932,10 @@ static void prstatus(vt_t *vt)
     rtksvrunlock(&svr);
     
     for (i=n=0;i<MAXSAT;i++) {
-        if (rtk->opt.mode==PMODE_SINGLE&&!rtk->ssat[i].vs) continue;
-        if (rtk->opt.mode!=PMODE_SINGLE&&!rtk->ssat[i].vsat[0]) continue;
-        azel[  n*2]=rtk->ssat[i].azel[0];
-        azel[1+n*2]=rtk->ssat[i].azel[1];
+        if (pmode==PMODE_SINGLE&&!stat->ssat[i].vs) continue;
+        if (pmode!=PMODE_SINGLE&&!stat->ssat[i].vsat[0]) continue;
+        azel[  n*2]=stat->ssat[i].azel[0];
+        azel[1+n*2]=stat->ssat[i].azel[1];
         n++;
     }
     dops(n,azel,0.0,dop);
@@ -737,86 +945,94 @@ static void prstatus(vt_t *vt)
     vt_printf(vt,"%-28s: %lx\n","rtk server thread",(unsigned long)thread);
     vt_printf(vt,"%-28s: %s\n","rtk server state",svrstate[state]);
     vt_printf(vt,"%-28s: %d\n","processing cycle (ms)",cycle);
-    vt_printf(vt,"%-28s: %s\n","positioning mode",mode[rtk->opt.mode]);
-    vt_printf(vt,"%-28s: %s\n","frequencies",freq[rtk->opt.nf]);
+    vt_printf(vt,"%-28s: %s\n","positioning mode",mode[pmode]);
+    vt_printf(vt,"%-28s: %s\n","frequencies",freq[nf]);
     vt_printf(vt,"%-28s: %02.0f:%02.0f:%04.1f\n","accumulated time to run",rt[0],rt[1],rt[2]);
-    vt_printf(vt,"%-28s: %d\n","cpu time for a cycle (ms)",cputime);
-    vt_printf(vt,"%-28s: %d\n","missing obs data count",prcout);
-    vt_printf(vt,"%-28s: %d,%d\n","bytes in input buffer",nb[0],nb[1]);
+    vt_printf(vt,"%-28s: %d\n","cpu time for a cycle (ms)",stat->cputime);
+    vt_printf(vt,"%-28s: %d\n","missing obs data count",stat->prcout);
+    if (rtksvrlstat(&svr,nlat,p50,p99,lmax)) {
+        for (i=0;i<NLATSTG;i++) {
+            sprintf(s,"latency %s (us)",stage[i]);
+            vt_printf(vt,"%-28s: p50=%.0f p99=%.0f max=%.0f n=%d\n",s,p50[i],
+                      p99[i],lmax[i],nlat[i]);
+        }
+    }
+    vt_printf(vt,"%-28s: %d,%d\n","bytes in input buffer",stat->nb[0],stat->nb[1]);
     for (i=0;i<3;i++) {
         sprintf(s,"# of input data %s",type[i]);
         vt_printf(vt,"%-28s: obs(%d),nav(%d),gnav(%d),ion(%d),sbs(%d),pos(%d),dgps(%d),ssr(%d),err(%d)\n",
-                s,nmsg[i][0],nmsg[i][1],nmsg[i][6],nmsg[i][2],nmsg[i][3],
-                nmsg[i][4],nmsg[i][5],nmsg[i][7],nmsg[i][9]);
+                s,stat->nmsg[i][0],stat->nmsg[i][1],stat->nmsg[i][6],
+                stat->nmsg[i][2],stat->nmsg[i][3],stat->nmsg[i][4],
+                stat->nmsg[i][5],stat->nmsg[i][7],stat->nmsg[i][9]);
     }
     for (i=0;i<3;i++) {
         p=s; *p='\0';
         for (j=1;j<100;j++) {
-            if (rtcm[i].nmsg2[j]==0) continue;
-            p+=sprintf(p,"%s%d(%d)",p>s?",":"",j,rtcm[i].nmsg2[j]);
+            if (nmsg2[i][j]==0) continue;
+            p+=sprintf(p,"%s%d(%d)",p>s?",":"",j,nmsg2[i][j]);
         }
-        if (rtcm[i].nmsg2[0]>0) {
-            sprintf(p,"%sother2(%d)",p>s?",":"",rtcm[i].nmsg2[0]);
+        if (nmsg2[i][0]>0) {
+            sprintf(p,"%sother2(%d)",p>s?",":"",nmsg2[i][0]);
         }
         for (j=1;j<300;j++) {
-            if (rtcm[i].nmsg3[j]==0) continue;
-            p+=sprintf(p,"%s%d(%d)",p>s?",":"",j+1000,rtcm[i].nmsg3[j]);
+            if (nmsg3[i][j]==0) continue;
+            p+=sprintf(p,"%s%d(%d)",p>s?",":"",j+1000,nmsg3[i][j]);
         }
-        if (rtcm[i].nmsg3[0]>0) {
-            sprintf(p,"%sother3(%d)",p>s?",":"",rtcm[i].nmsg3[0]);
+        if (nmsg3[i][0]>0) {
+            sprintf(p,"%sother3(%d)",p>s?",":"",nmsg3[i][0]);
         }
         vt_printf(vt,"%-15s %-9s: %s\n","# of rtcm messages",type[i],s);
     }
-    vt_printf(vt,"%-28s: %s\n","solution status",sol[rtkstat]);
-    time2str(rtk->sol.time,tstr,9);
-    vt_printf(vt,"%-28s: %s\n","time of receiver clock rover",rtk->sol.time.time?tstr:"-");
-    vt_printf(vt,"%-28s: %.3f,%.3f,%.3f,%.3f\n","time sys offset (ns)",rtk->sol.dtr[1]*1e9,
-              rtk->sol.dtr[2]*1e9,rtk->sol.dtr[3]*1e9,rtk->sol.dtr[4]*1e9);
-    vt_printf(vt,"%-28s: %.3f\n","solution interval (s)",rtk->tt);
-    vt_printf(vt,"%-28s: %.3f\n","age of differential (s)",rtk->sol.age);
-    vt_printf(vt,"%-28s: %.3f\n","ratio for ar validation",rtk->sol.ratio);
-    vt_printf(vt,"%-28s: %d\n","# of satellites rover",nsat0);
-    vt_printf(vt,"%-28s: %d\n","# of satellites base",nsat1);
-    vt_printf(vt,"%-28s: %d\n","# of valid satellites",rtk->sol.ns);
+    vt_printf(vt,"%-28s: %s\n","solution status",sol[stat->sol.stat]);
+    time2str(stat->sol.time,tstr,9);
+    vt_printf(vt,"%-28s: %s\n","time of receiver clock rover",stat->sol.time.time?tstr:"-");
+    vt_printf(vt,"%-28s: %.3f,%.3f,%.3f,%.3f\n","time sys offset (ns)",stat->sol.dtr[1]*1e9,
+              stat->sol.dtr[2]*1e9,stat->sol.dtr[3]*1e9,stat->sol.dtr[4]*1e9);
+    vt_printf(vt,"%-28s: %.3f\n","solution interval (s)",stat->tt);
+    vt_printf(vt,"%-28s: %.3f\n","age of differential (s)",stat->sol.age);
+    vt_printf(vt,"%-28s: %.3f\n","ratio for ar validation",stat->sol.ratio);
+    vt_printf(vt,"%-28s: %d\n","# of satellites rover",stat->nobs[0]);
+    vt_printf(vt,"%-28s: %d\n","# of satellites base",stat->nobs[1]);
+    vt_printf(vt,"%-28s: %d\n","# of valid satellites",stat->sol.ns);
     vt_printf(vt,"%-28s: %.1f,%.1f,%.1f,%.1f\n","GDOP/PDOP/HDOP/VDOP",dop[0],dop[1],dop[2],dop[3]);
-    vt_printf(vt,"%-28s: %d\n","# of real estimated states",rtk->na);
-    vt_printf(vt,"%-28s: %d\n","# of all estimated states",rtk->nx);
+    vt_printf(vt,"%-28s: %d\n","# of real estimated states",stat->na);
+    vt_printf(vt,"%-28s: %d\n","# of all estimated states",stat->nx);
     vt_printf(vt,"%-28s: %.3f,%.3f,%.3f\n","pos xyz single (m) rover",
-            rtk->sol.rr[0],rtk->sol.rr[1],rtk->sol.rr[2]);
-    if (norm(rtk->sol.rr,3)>0.0) ecef2pos(rtk->sol.rr,pos); else pos[0]=pos[1]=pos[2]=0.0;
+            stat->sol.rr[0],stat->sol.rr[1],stat->sol.rr[2]);
+    if (norm(stat->sol.rr,3)>0.0) ecef2pos(stat->sol.rr,pos); else pos[0]=pos[1]=pos[2]=0.0;
     vt_printf(vt,"%-28s: %.8f,%.8f,%.3f\n","pos llh single (deg,m) rover",
             pos[0]*R2D,pos[1]*R2D,pos[2]);
-    ecef2enu(pos,rtk->sol.rr+3,vel);
+    ecef2enu(pos,stat->sol.rr+3,vel);
     vt_printf(vt,"%-28s: %.3f,%.3f,%.3f\n","vel enu (m/s) rover",vel[0],vel[1],vel[2]);
     vt_printf(vt,"%-28s: %.3f,%.3f,%.3f\n","pos xyz float (m) rover",
-            rtk->x?rtk->x[0]:0,rtk->x?rtk->x[1]:0,rtk->x?rtk->x[2]:0);
+            stat->xf[0],stat->xf[1],stat->xf[2]);
     vt_printf(vt,"%-28s: %.3f,%.3f,%.3f\n","pos xyz float std (m) rover",
-            rtk->P?SQRT(rtk->P[0]):0,rtk->P?SQRT(rtk->P[1+1*rtk->nx]):0,rtk->P?SQRT(rtk->P[2+2*rtk->nx]):0);
+            stat->sf[0],stat->sf[1],stat->sf[2]);
     vt_printf(vt,"%-28s: %.3f,%.3f,%.3f\n","pos xyz fixed (m) rover",
-            rtk->xa?rtk->xa[0]:0,rtk->xa?rtk->xa[1]:0,rtk->xa?rtk->xa[2]:0);
+            stat->xa[0],stat->xa[1],stat->xa[2]);
     vt_printf(vt,"%-28s: %.3f,%.3f,%.3f\n","pos xyz fixed std (m) rover",
-            rtk->Pa?SQRT(rtk->Pa[0]):0,rtk->Pa?SQRT(rtk->Pa[1+1*rtk->na]):0,rtk->Pa?SQRT(rtk->Pa[2+2*rtk->na]):0);
+            stat->sa[0],stat->sa[1],stat->sa[2]);
     vt_printf(vt,"%-28s: %.3f,%.3f,%.3f\n","pos xyz (m) base",
-            rtk->rb[0],rtk->rb[1],rtk->rb[2]);
-    if (norm(rtk->rb,3)>0.0) ecef2pos(rtk->rb,pos); else pos[0]=pos[1]=pos[2]=0.0;
+            stat->rb[0],stat->rb[1],stat->rb[2]);
+    if (norm(stat->rb,3)>0.0) ecef2pos(stat->rb,pos); else pos[0]=pos[1]=pos[2]=0.0;
     vt_printf(vt,"%-28s: %.8f,%.8f,%.3f\n","pos llh (deg,m) base",
             pos[0]*R2D,pos[1]*R2D,pos[2]);
     vt_printf(vt,"%-28s: %d\n","# of average single pos base",nave);
-    vt_printf(vt,"%-28s: %s\n","ant type rover",rtk->opt.pcvr[0].type);
-    del=rtk->opt.antdel[0];
+    vt_printf(vt,"%-28s: %s\n","ant type rover",anttype[0]);
+    del=antdel[0];
     vt_printf(vt,"%-28s: %.4f %.4f %.4f\n","ant delta rover",del[0],del[1],del[2]);
-    vt_printf(vt,"%-28s: %s\n","ant type base" ,rtk->opt.pcvr[1].type);
-    del=rtk->opt.antdel[1];
+    vt_printf(vt,"%-28s: %s\n","ant type base" ,anttype[1]);
+    del=antdel[1];
     vt_printf(vt,"%-28s: %.4f %.4f %.4f\n","ant delta base",del[0],del[1],del[2]);
-    ecef2enu(pos,rtk->rb+3,vel);
+    ecef2enu(pos,stat->rb+3,vel);
     vt_printf(vt,"%-28s: %.3f,%.3f,%.3f\n","vel enu (m/s) base",
             vel[0],vel[1],vel[2]);
-    if (rtk->opt.mode>0&&rtk->x&&norm(rtk->x,3)>0.0) {
-        for (i=0;i<3;i++) rr[i]=rtk->x[i]-rtk->rb[i];
+    if (pmode>0&&norm(stat->xf,3)>0.0) {
+        for (i=0;i<3;i++) rr[i]=stat->xf[i]-stat->rb[i];
         bl1=norm(rr,3);
     }
-    if (rtk->opt.mode>0&&rtk->xa&&norm(rtk->xa,3)>0.0) {
-        for (i=0;i<3;i++) rr[i]=rtk->xa[i]-rtk->rb[i];
+    if (pmode>0&&norm(stat->xa,3)>0.0) {
+        for (i=0;i<3;i++) rr[i]=stat->xa[i]-stat->rb[i];
         bl2=norm(rr,3);
     }
     vt_printf(vt,"%-28s: %.3f\n","baseline length float (m)",bl1);
@@ -824,7 +1040,7 @@ static void prstatus(vt_t *vt)
     vt_printf(vt,"%-28s: %s\n","last time mark",tmcount ? tmstr : "-");
     vt_printf(vt,"%-28s: %d\n","receiver time mark count",rcvcount);
     vt_printf(vt,"%-28s: %d\n","rtklib time mark count",tmcount);
-    free(rtk);
+    free(stat);
 }
 /* print satellite -----------------------------------------------------------*/
 static void prsatellite(vt_t *vt, int nf)
@@ -835,12 +1051,10 @@ static void prsatellite(vt_t *vt, int nf)
     
     trace(4,"prsatellite:\n");
     
-    rtk_t *rtk = (rtk_t *)malloc(sizeof(rtk_t));
-    if (rtk == NULL) return;
+    svrstat_t *stat=(svrstat_t *)calloc(1,sizeof(svrstat_t));
+    if (stat == NULL) return;
 
-    rtksvrlock(&svr);
-    *rtk=svr.rtk;
-    rtksvrunlock(&svr);
+    rtksvrstat(&svr,stat);
     if (nf<=0||nf>NFREQ) nf=NFREQ;
     vt_printf(vt,"\n%s%3s %2s %5s %4s",ESC_BOLD,"SAT","C1","Az","El");
     for (j=0;j<nf;j++) vt_printf(vt," L%d"    ,frq[j]);
@@ -853,25 +1067,25 @@ static void prsatellite(vt_t *vt, int nf)
     vt_printf(vt,"%s\n",ESC_RESET);
     
     for (i=0;i<MAXSAT;i++) {
-        if (rtk->ssat[i].azel[1]<=0.0) continue;
+        if (stat->ssat[i].azel[1]<=0.0) continue;
         satno2id(i+1,id);
-        vt_printf(vt,"%3s %2s",id,rtk->ssat[i].vs?"OK":"-");
-        az=rtk->ssat[i].azel[0]*R2D; if (az<0.0) az+=360.0;
-        el=rtk->ssat[i].azel[1]*R2D;
+        vt_printf(vt,"%3s %2s",id,stat->ssat[i].vs?"OK":"-");
+        az=stat->ssat[i].azel[0]*R2D; if (az<0.0) az+=360.0;
+        el=stat->ssat[i].azel[1]*R2D;
         vt_printf(vt," %5.1f %4.1f",az,el);
-        for (j=0;j<nf;j++) vt_printf(vt," %2s",rtk->ssat[i].vsat[j]?"OK":"-");
+        for (j=0;j<nf;j++) vt_printf(vt," %2s",stat->ssat[i].vsat[j]?"OK":"-");
         for (j=0;j<nf;j++) {
-            fix=rtk->ssat[i].fix[j];
+            fix=stat->ssat[i].fix[j];
             vt_printf(vt," %5s",fix==1?"FLOAT":(fix==2?"FIX":(fix==3?"HOLD":"-")));
         }
-        for (j=0;j<nf;j++) vt_printf(vt,"%7.3f",rtk->ssat[i].resp[j]);
-        for (j=0;j<nf;j++) vt_printf(vt,"%8.4f",rtk->ssat[i].resc[j]);
-        for (j=0;j<nf;j++) vt_printf(vt," %4d",rtk->ssat[i].slipc[j]);
-        for (j=0;j<nf;j++) vt_printf(vt," %6d",rtk->ssat[i].lock [j]);
-        for (j=0;j<nf;j++) vt_printf(vt," %3d",rtk->ssat[i].rejc [j]);
+        for (j=0;j<nf;j++) vt_printf(vt,"%7.3f",stat->ssat[i].resp[j]);
+        for (j=0;j<nf;j++) vt_printf(vt,"%8.4f",stat->ssat[i].resc[j]);
+        for (j=0;j<nf;j++) vt_printf(vt," %4d",stat->ssat[i].slipc[j]);
+        for (j=0;j<nf;j++) vt_printf(vt," %6d",stat->ssat[i].lock [j]);
+        for (j=0;j<nf;j++) vt_printf(vt," %3d",stat->ssat[i].rejc [j]);
         vt_printf(vt,"\n");
     }
-    free(rtk);
+    free(stat);
 }
 /* print observation data ----------------------------------------------------*/
 static void probserv(vt_t *vt, int nf)
@@ -1680,7 +1894,8 @@ static void deamonise(void)
 
 /* rtkrcv main -----------------------------------------------------------------
 * synopsis
-*     rtkrcv [-s][-nc][-p port][-d dev][-o file][-r level][-t level][-sta sta]
+*     rtkrcv [-s][-nc][-p port][-m port][-e port][-d dev][-o file][-r level]
+*            [-t level][-sta sta]
 *
 * description
 *     A command line version of the real-time positioning AP by rtklib. To start
@@ -1703,6 +1918,7 @@ static void deamonise(void)
 *     -nc        start RTK server on program startup with no console
 *     -p port    port number for telnet console
 *     -m port    port number for monitor stream
+*     -e port    port number for metrics http endpoint (prometheus)
 *     -d dev     terminal device for console
 *     -o file    processing options file
 *     -w pwd     login password for remote console ("": no password)
@@ -1809,6 +2025,7 @@ int main(int argc, char **argv)
         else if (!strcmp(argv[i],"-nc")) start|=2; /* no console */
         else if (!strcmp(argv[i],"-p")&&i+1<argc) port=atoi(argv[++i]);
         else if (!strcmp(argv[i],"-m")&&i+1<argc) moniport=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-e")&&i+1<argc) metport=atoi(argv[++i]);
         else if (!strcmp(argv[i],"-d")&&i+1<argc) dev=argv[++i];
         else if (!strcmp(argv[i],"-o")&&i+1<argc) strcpy(file,argv[++i]);
         else if (!strcmp(argv[i],"-w")&&i+1<argc) strcpy(passwd,argv[++i]);
@@ -1853,6 +2070,10 @@ int main(int argc, char **argv)
     if (moniport>0&&!openmoni(moniport)) {
         fprintf(stderr,"monitor port open error: %d\n",moniport);
     }
+    /* open metrics port */
+    if (metport>0&&!openmetrics(metport)) {
+        fprintf(stderr,"metrics port open error: %d\n",metport);
+    }
     if (port) {
         /* open socket for remote console */
         if ((sock=open_sock(port))<=0) {
@@ -1884,6 +2105,9 @@ int main(int argc, char **argv)
     while (!intflg) {
         /* accept remote console connection */
         accept_sock(sock,con);
+        
+        /* respond to metrics requests */
+        if (metport>0) rspmetrics();
         sleepms(100);
     }
     /* stop rtk server */
@@ -1894,6 +2118,7 @@ int main(int argc, char **argv)
         con_close(con[i]);
     }
     if (moniport>0) closemoni();
+    if (metport>0) httpsvrclose(&metsvr);
     if (outstat>0) rtkclosestat();
     
     /* save navigation data */
@@ -28,8 +28,11 @@
 *           2016/09/17  1.16 add option -b
 *           2017/05/26  1.17 add input format tersus
 *           2020/11/30  1.18 support api change strsvrstart(),strsvrstat()
+*           2026/10/18  1.19 add option -ev,-maxcli,-q,-qb
+*                            add option -e for metrics http endpoint
 *-----------------------------------------------------------------------------*/
 #define _POSIX_C_SOURCE 200112L
+#include <stdarg.h>
 #include <fcntl.h>
 #include <signal.h>
 #include <unistd.h>
@@ -39,10 +42,13 @@
 #define MAXSTR      5                  /* max number of streams */
 #define TRACEFILE   "str2str_%Y%m%d%h%M.trace" /* Debug trace file */
 #define LOGFILE     "str2str_%Y%m%d%h%M.log"   /* Deamon log file */
+#define MAXMETRICS  16384              /* max size of metrics (bytes) */
+#define METCYCLE    100                /* metrics request polling cycle (ms) */
 
 /* global variables ----------------------------------------------------------*/
 static strsvr_t strsvr;                /* stream server */
 static volatile int intrflg=0;         /* interrupt flag */
+static httpsvr_t metsvr;               /* metrics http server */
 
 /* help text -----------------------------------------------------------------*/
 static const char *help[]={
@@ -114,6 +120,11 @@ static const char *help[]={
 " -l  local_dir     ftp/http local directory []",
 " -x  proxy_addr    http/ntrip proxy address [no]",
 " -b  str_no        relay back messages from output str to input str [no]",
+" -ev               wait for input data events instead of fixed cycle [off]",
+" -maxcli n         max clients of tcp server and ntrip caster [32]",
+" -q  bytes         output queue size of writer thread per output str [no]",
+" -qb               wait for writer instead of dropping data on queue full",
+" -e  port          port number for metrics http endpoint (prometheus) [no]",
 " -t  level         trace level [0]",
 " -fl file          log file [str2str.trace]",
 " --deamon          detach from the console",
@@ -144,6 +155,96 @@ static void sigfunc(int sig)
 {
     intrflg=1;
 }
+/* print to metrics buffer with remaining length -----------------------------*/
+static char *prmet(char *p, const char *end, const char *format, ...)
+{
+    va_list ap;
+    int n;
+    
+    if (p>=end-1) return p;
+    va_start(ap,format);
+    n=vsnprintf(p,(size_t)(end-p),format,ap);
+    va_end(ap);
+    return n<0?p:(n<end-p?p+n:(char *)end-1); /* truncated at end */
+}
+/* print metric header -------------------------------------------------------*/
+static char *prmethdr(char *p, const char *end, const char *name,
+                      const char *type, const char *help)
+{
+    p=prmet(p,end,"# HELP str2str_%s %s\n",name,help);
+    p=prmet(p,end,"# TYPE str2str_%s %s\n",name,type);
+    return p;
+}
+/* print metrics in prometheus text format -----------------------------------*/
+static int prmetrics(char *buff, int size)
+{
+    const char *ch[]={"in","out1","out2","out3","out4"};
+    char strmsg[MAXSTRMSG*MAXSTR]="",*p=buff;
+    const char *end=buff+size;
+    int i,nstr=strsvr.nstr<MAXSTR?strsvr.nstr:MAXSTR;
+    int stat[MAXSTR]={0},log_stat[MAXSTR]={0},byte[MAXSTR]={0},bps[MAXSTR]={0};
+    int qlen[MAXSTR]={0},qdrop[MAXSTR]={0},qlat[MAXSTR]={0};
+    
+    strsvrstat(&strsvr,stat,log_stat,byte,bps,qlen,qdrop,qlat,strmsg);
+    
+    p=prmethdr(p,end,"server_state","gauge","stream server state (0:stop,1:run)");
+    p=prmet(p,end,"str2str_server_state %d\n",strsvr.state);
+    
+    p=prmethdr(p,end,"stream_state","gauge","stream state (-1:error,0:close,1:wait,2:connect)");
+    for (i=0;i<nstr;i++) {
+        p=prmet(p,end,"str2str_stream_state{stream=\"%s\"} %d\n",ch[i],stat[i]);
+    }
+    p=prmethdr(p,end,"stream_bytes_total","counter","stream input/output bytes");
+    for (i=0;i<nstr;i++) {
+        p=prmet(p,end,"str2str_stream_bytes_total{stream=\"%s\"} %u\n",ch[i],
+                (uint32_t)byte[i]);
+    }
+    p=prmethdr(p,end,"stream_rate_bps","gauge","stream input/output data rate (bps)");
+    for (i=0;i<nstr;i++) {
+        p=prmet(p,end,"str2str_stream_rate_bps{stream=\"%s\"} %d\n",ch[i],bps[i]);
+    }
+    p=prmethdr(p,end,"log_state","gauge","log stream state (-1:error,0:close,1:open)");
+    for (i=0;i<nstr;i++) {
+        p=prmet(p,end,"str2str_log_state{stream=\"%s\"} %d\n",ch[i],log_stat[i]);
+    }
+    if (strsvr.qsize<=0) return (int)(p-buff);
+    
+    p=prmethdr(p,end,"queue_bytes","gauge","bytes in output queue");
+    for (i=1;i<nstr;i++) {
+        p=prmet(p,end,"str2str_queue_bytes{stream=\"%s\"} %d\n",ch[i],qlen[i]);
+    }
+    p=prmethdr(p,end,"queue_size_bytes","gauge","output queue size");
+    p=prmet(p,end,"str2str_queue_size_bytes %d\n",strsvr.qsize);
+    p=prmethdr(p,end,"queue_dropped_bytes_total","counter","dropped bytes on output queue full");
+    for (i=1;i<nstr;i++) {
+        p=prmet(p,end,"str2str_queue_dropped_bytes_total{stream=\"%s\"} %u\n",
+                ch[i],(uint32_t)qdrop[i]);
+    }
+    p=prmethdr(p,end,"queue_latency_ms","gauge","average output queue write latency (ms)");
+    for (i=1;i<nstr;i++) {
+        p=prmet(p,end,"str2str_queue_latency_ms{stream=\"%s\"} %d\n",ch[i],qlat[i]);
+    }
+    return (int)(p-buff);
+}
+/* respond to metrics requests -----------------------------------------------*/
+static void rspmetrics(void)
+{
+    static char buff[MAXMETRICS];
+    const char *msg="not found\n";
+    char url[256],*p;
+    int i;
+    
+    while ((i=httpsvrreq(&metsvr,url))>=0) {
+        if ((p=strchr(url,'?'))) *p='\0';
+        
+        if (strcmp(url,"/metrics")&&strcmp(url,"/")) {
+            httpsvrrsp(&metsvr,i,404,"text/plain",msg,(int)strlen(msg));
+            continue;
+        }
+        httpsvrrsp(&metsvr,i,200,"text/plain; version=0.0.4",buff,
+                   prmetrics(buff,sizeof(buff)));
+    }
+}
 /* decode format -------------------------------------------------------------*/
 static void decodefmt(char *path, int *fmt)
 {
@@ -295,7 +396,9 @@ int main(int argc, char **argv)
     int i,j,n=0,dispint=5000,trlevel=0,opts[]={10000,10000,2000,32768,10,0,30,0};
     int types[MAXSTR]={STR_FILE,STR_FILE},stat[MAXSTR]={0},log_stat[MAXSTR]={0};
     int byte[MAXSTR]={0},bps[MAXSTR]={0},fmts[MAXSTR]={0},sta=0;
-    int deamon=0;
+    int deamon=0,evtwait=0,maxcli=0,qsize=0,qblock=0,metport=0;
+    uint32_t tick;
+    int qlen[MAXSTR]={0},qdrop[MAXSTR]={0},qlat[MAXSTR]={0};
     const char *msg = "1004,1019"; // Current messages.
     const char *msgs[MAXSTR];      // Messages per output stream.
     const char *log = "";          // Log for the next input or output stream.
@@ -362,6 +465,11 @@ int main(int argc, char **argv)
         else if (!strcmp(argv[i],"-l"  )&&i+1<argc) local=argv[++i];
         else if (!strcmp(argv[i],"-x"  )&&i+1<argc) proxy=argv[++i];
         else if (!strcmp(argv[i],"-b"  )&&i+1<argc) opts[7]=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-ev" )) evtwait=1;
+        else if (!strcmp(argv[i],"-maxcli")&&i+1<argc) maxcli=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-q"  )&&i+1<argc) qsize=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-qb" )) qblock=1;
+        else if (!strcmp(argv[i],"-e"  )&&i+1<argc) metport=atoi(argv[++i]);
         else if (!strcmp(argv[i],"-fl" )&&i+1<argc) logfile=argv[++i];
         else if (!strcmp(argv[i],"-t"  )&&i+1<argc) trlevel=atoi(argv[++i]);
         else if (!strcmp(argv[i], "--deamon")) deamon=1;
@@ -413,6 +521,9 @@ int main(int argc, char **argv)
     signal(SIGPIPE,SIG_IGN);
     
     strsvrinit(&strsvr,n+1);
+    strsvr.evtwait=evtwait;
+    strsvr.qsize=qsize;
+    strsvr.qblock=qblock;
     
     if (trlevel>0) {
         traceopen(*logfile?logfile:TRACEFILE);
@@ -422,11 +533,20 @@ int main(int argc, char **argv)
     
     strsetdir(local);
     strsetproxy(proxy);
+    strsetmaxcli(maxcli);
     
     for (i=0;i<MAXSTR;i++) {
         if (*cmdfile[i]) readcmd(cmdfile[i],cmds[i], sizeof(cmd_strs[0]),0);
         if (*cmdfile[i]) readcmd(cmdfile[i],cmds_periodic[i], sizeof(cmd_periodic_strs[0]), 2);
     }
+    /* open metrics port */
+    if (metport>0) {
+        sprintf(buff,":%d",metport);
+        if (!httpsvropen(&metsvr,buff,strmsg)) {
+            fprintf(stderr,"metrics port open error: %d\n",metport);
+            metport=0;
+        }
+    }
     /* start stream server */
     if (!strsvrstart(&strsvr,opts,types,(const char **)paths,(const char **)logs,conv,(const char **)cmds,(const char **)cmds_periodic,
                      stapos)) {
@@ -436,17 +556,27 @@ int main(int argc, char **argv)
     for (intrflg=0;!intrflg;) {
         
         /* get stream server status */
-        strsvrstat(&strsvr,stat,log_stat,byte,bps,strmsg);
+        strsvrstat(&strsvr,stat,log_stat,byte,bps,qlen,qdrop,qlat,strmsg);
         
         /* show stream server status */
         for (i=0,p=buff;i<MAXSTR;i++) p+=sprintf(p,"%c",ss[stat[i]+1]);
+        
+        /* show output queue status */
+        for (i=1,p=strmsg+strlen(strmsg);qsize>0&&i<=n&&p<strmsg+MAXSTRMSG-64;i++) {
+            p+=sprintf(p,"(q%d) %d B %d drop %d ms ",i,qlen[i],qdrop[i],qlat[i]);
+        }
 
         char tstr[40];
         time2str(utc2gpst(timeget()),tstr,0);
         fprintf(stderr,"%s [%s] %10d B %7d bps %s\n",
                 tstr,buff,byte[0],bps[0],strmsg);
         
-        sleepms(dispint);
+        /* wait for display interval responding to metrics requests */
+        for (tick=tickget();;) {
+            if (metport>0) rspmetrics();
+            if (intrflg||(int)(tickget()-tick)>=dispint) break;
+            sleepms(metport>0?METCYCLE:dispint);
+        }
     }
     for (i=0;i<MAXSTR;i++) {
         if (*cmdfile[i]) readcmd(cmdfile[i],cmds[i],sizeof(cmd_strs[0]),1);
@@ -454,6 +584,8 @@ int main(int argc, char **argv)
     /* stop stream server */
     strsvrstop(&strsvr,(const char **)cmds);
     
+    if (metport>0) httpsvrclose(&metsvr);
+    
     for (i=0;i<n;i++) {
         strconvfree(conv[i]);
     }
@@ -7,6 +7,8 @@
 #include <QStringList>
 #include <QDebug>
 
+#include <algorithm>
+
 #include "plotmain.h"
 #include "helper.h"
 #include "plotopt.h"
@@ -207,6 +209,66 @@ TIMEPOS *Plot::solutionToPosition(solbuf_t *sol, int index, int qflag, int type)
     delete vel;
     return acc; // acceleration
 }
+// get cached level-of-detail series from solutions -------------------------
+// series: 0=solution 1, 1=solution 2, 2=solution 1-2, 3=nsat 1, 4=nsat 2
+const LODSERIES *Plot::solutionToSeries(int series, int qflag, int type)
+{
+    TIMEPOS *pos, *pos1, *pos2;
+    QByteArray key;
+    double *x, tint = timeEnabled[2] ? timeInterval : 0.0;
+    int i, timeFormat = plotOptDialog->getTimeFormat();
+
+    trace(3, "solutionToSeries: series=%d qflag=%d type=%d\n", series, qflag, type);
+
+    // the key covers everything the series content and x-coordinates depend on
+    key.append((const char *)&qflag, sizeof(qflag));
+    key.append((const char *)&type, sizeof(type));
+    key.append((const char *)&tint, sizeof(tint));
+    key.append((const char *)&timeFormat, sizeof(timeFormat));
+    key.append((const char *)&startWeek, sizeof(startWeek));
+    key.append((const char *)originPosition, sizeof(originPosition));
+    key.append((const char *)originVelocity, sizeof(originVelocity));
+    key.append((const char *)&originEpoch, sizeof(originEpoch));
+    for (i = 0; i < 2; i++) {
+        key.append((const char *)&solutionData[i].data, sizeof(sol_t *));
+        key.append((const char *)&solutionData[i].n, sizeof(int));
+        key.append((const char *)&solutionData[i].start, sizeof(int));
+        key.append((const char *)&solutionData[i].end, sizeof(int));
+    }
+    if (solutionSeries[series] && solutionSeries[series]->key == key)
+        return solutionSeries[series];
+
+    if (series <= 1) {
+        pos = solutionToPosition(solutionData + series, -1, qflag, type);
+    } else if (series == 2) {
+        pos1 = solutionToPosition(solutionData, -1, 0, type);
+        pos2 = solutionToPosition(solutionData + 1, -1, 0, type);
+        pos = pos1->diff(pos2, qflag);
+        delete pos1;
+        delete pos2;
+    } else {
+        pos = solutionToNsat(solutionData + series - 3, -1, qflag);
+    }
+    x = new double[pos->n];
+
+    for (i = 0; i < pos->n; i++)
+        x[i] = timePosition(pos->t[i]);
+
+    delete solutionSeries[series];
+    solutionSeries[series] = new LODSERIES(pos, x, key);
+
+    return solutionSeries[series];
+}
+// clear cached level-of-detail series --------------------------------------
+void Plot::clearSeries()
+{
+    trace(3, "clearSeries\n");
+
+    for (int i = 0; i < 5; i++) {
+        delete solutionSeries[i];
+        solutionSeries[i] = NULL;
+    }
+}
 // get number of satellites, age and ratio from solutions -------------------
 TIMEPOS *Plot::solutionToNsat(solbuf_t *sol, int index, int qflag)
 {
@@ -640,3 +702,98 @@ TIMEPOS *TIMEPOS::diff(const TIMEPOS *pos2, int qflag)
     return pos;
 }
 //---------------------------------------------------------------------------
+// level-of-detail time-series class implementation
+//---------------------------------------------------------------------------
+// constructor (takes ownership of pos and x) -------------------------------
+LODSERIES::LODSERIES(TIMEPOS *pos, double *x, const QByteArray &key)
+    : pos(pos), x(x), key(key)
+{
+    const double *y;
+    int i, j, k, m, mp, a, b, n = pos->n;
+
+    // min/max levels are only built for data sorted in time
+    for (i = 1; i < n; i++)
+        if (x[i] < x[i - 1]) break;
+
+    nlevel_ = 1;
+    if (i >= n)
+        while ((n >> nlevel_) > 0) nlevel_++;
+
+    for (int panel = 0; panel < 3; panel++) {
+        y = panel == 0 ? pos->x : (panel == 1 ? pos->y : pos->z);
+        imin_[panel] = new int *[nlevel_];
+        imax_[panel] = new int *[nlevel_];
+        imin_[panel][0] = imax_[panel][0] = NULL; // level 0: raw samples
+
+        for (k = 1, mp = n; k < nlevel_; k++, mp = m) {
+            m = ((n - 1) >> k) + 1;
+            imin_[panel][k] = new int[m];
+            imax_[panel][k] = new int[m];
+
+            for (i = 0; i < m; i++) {
+                j = 2 * i + 1 < mp ? 2 * i + 1 : 2 * i;
+                if (k == 1) {
+                    a = b = 2 * i;
+                    if (y[j] < y[a]) a = j;
+                    if (y[j] > y[b]) b = j;
+                } else {
+                    a = imin_[panel][k - 1][2 * i];
+                    b = imax_[panel][k - 1][2 * i];
+                    if (y[imin_[panel][k - 1][j]] < y[a]) a = imin_[panel][k - 1][j];
+                    if (y[imax_[panel][k - 1][j]] > y[b]) b = imax_[panel][k - 1][j];
+                }
+                imin_[panel][k][i] = a;
+                imax_[panel][k][i] = b;
+            }
+        }
+    }
+}
+// destructor ---------------------------------------------------------------
+LODSERIES::~LODSERIES()
+{
+    for (int panel = 0; panel < 3; panel++) {
+        for (int k = 1; k < nlevel_; k++) {
+            delete [] imin_[panel][k];
+            delete [] imax_[panel][k];
+        }
+        delete [] imin_[panel];
+        delete [] imax_[panel];
+    }
+    delete [] x;
+    delete pos;
+}
+// select sample indices to draw for x-range and width (pixels) -------------
+// index must have room for pos->n entries. returns the number of indices,
+// in time order. all samples in range are returned if they fit the width.
+int LODSERIES::select(int panel, double x0, double x1, int width, int *index) const
+{
+    int i, i0, i1, k, a, b, n = 0;
+
+    if (pos->n <= 0) return 0;
+
+    if (nlevel_ <= 1) { // unsorted data: no decimation
+        for (i = 0; i < pos->n; i++) index[n++] = i;
+        return n;
+    }
+    // visible range with one sample margin on each side for line continuity
+    i0 = static_cast<int>(std::lower_bound(x, x + pos->n, x0) - x);
+    i1 = static_cast<int>(std::upper_bound(x, x + pos->n, x1) - x);
+    if (i0 > 0) i0--;
+    if (i1 < pos->n) i1++;
+
+    // select coarsest level with at most two buckets per pixel
+    for (k = 0; k + 1 < nlevel_ && ((i1 - i0) >> k) > 2 * qMax(width, 1); k++) ;
+
+    if (k == 0) {
+        for (i = i0; i < i1; i++) index[n++] = i;
+        return n;
+    }
+    for (i = i0 >> k; i <= (i1 - 1) >> k; i++) {
+        a = imin_[panel][k][i];
+        b = imax_[panel][k][i];
+        index[n++] = qMin(a, b);
+        if (a != b) index[n++] = qMax(a, b);
+    }
+    return n;
+}
+//---------------------------------------------------------------------------
@@ -78,6 +78,7 @@ void Plot::readSolution(const QStringList &files, int sel)
         readWaitEnd();
         return;
     }
+    clearSeries();
     freesolbuf(solutionData + sel);
     solutionData[sel] = sol;
 
@@ -397,11 +398,11 @@ void Plot::readElevationMaskData(const QString &file)
 // generate visibility data ----------------------------------------------------
 void Plot::generateVisibilityData()
 {
-    gtime_t time, ts, te;
+    gtime_t time, ts, te, *times;
     obsd_t data = {};
-    double tint, pos[3], rr[3], rs[6], e[3], azel[2], time_span;
-    unsigned char i, j;
-    int nobs = 0, per, per_=-1;
+    double tint, pos[3], rr[3], *rs, e[3], azel[2];
+    int i, j, k, nt, ns = 0;
+    int per, per_=-1, tleIndex[MAXSAT], tleSat[MAXSAT], *tleStat;
     char name[8];
 
     trace(3, "generateVisibilityData\n");
@@ -420,12 +421,32 @@ void Plot::generateVisibilityData()
     showMessage(tr("Generating satellite visibility..."));
     qApp->processEvents();
 
-    time_span = timediff(ts, te);
-    for (time = ts; timediff(time, te) <= 0.0; time = timeadd(time, tint)) {
-        for (i = 0; i < MAXSAT; i++) {
-            satno2id(i + 1, name);
-            if (!tle_pos(time, name, "", "", &tleData, NULL, rs)) continue;
-            if ((geodist(rs, rr, e)) <= 0.0) continue;
+    // resolve TLE data of satellites once
+    for (i = 0; i < MAXSAT; i++) {
+        satno2id(i + 1, name);
+        if ((k = tle_index(name, "", "", &tleData)) < 0) continue;
+        tleSat[ns] = i + 1;
+        tleIndex[ns++] = k;
+    }
+    // time grid
+    for (time = ts, nt = 0; timediff(time, te) <= 0.0 && nt < MAX_SIMOBS; time = timeadd(time, tint)) nt++;
+
+    times = static_cast<gtime_t *>(malloc(sizeof(gtime_t) * (nt > 0 ? nt : 1)));
+    rs = static_cast<double *>(malloc(sizeof(double) * 6 * (nt * ns > 0 ? nt * ns : 1)));
+    tleStat = static_cast<int *>(malloc(sizeof(int) * (nt * ns > 0 ? nt * ns : 1)));
+
+    if (times && rs && tleStat) {
+        for (i = 0, time = ts; i < nt; i++, time = timeadd(time, tint)) times[i] = time;
+
+        // satellite positions at all times by one batch
+        if (tle_pos_batch(times, nt, tleIndex, ns, &tleData, NULL, rs, tleStat) < 0) nt = 0;
+    }
+    else nt = 0;
+
+    for (k = 0; k < nt; k++) {
+        for (i = 0; i < ns; i++) {
+            if (!tleStat[k * ns + i]) continue;
+            if ((geodist(rs + (k * ns + i) * 6, rr, e)) <= 0.0) continue;
             if (satazel(pos, e, azel) <= 0.0) continue;
             if (observation.n >= observation.nmax) {  // allocate more memory
                 observation.nmax = observation.nmax <= 0 ? 4096 : observation.nmax * 2;
@@ -435,8 +456,8 @@ void Plot::generateVisibilityData()
                     break;
                 }
             }
-            data.time = time;
-            data.sat = i + 1;
+            data.time = times[k];
+            data.sat = tleSat[i];
 
             for (j = 0; j < NFREQ; j++) {
                 data.P[j] = data.L[j] = 0.0;
@@ -445,20 +466,23 @@ void Plot::generateVisibilityData()
             data.code[0] = CODE_L1C;
             observation.data[observation.n++] = data;
         }
-        per =  timediff(ts, time) / time_span * 100;
+        per = (k + 1) * 100 / nt;
         if (per != per_) {
             showMessage(tr("Visibility analysis... %1%").arg(per));
             per_ = per;
             qApp->processEvents();
         }
-        if (++nobs >= MAX_SIMOBS) break;
     }
+    free(times);
+    free(rs);
+    free(tleStat);
+
     if (observation.n <= 0) {
         readWaitEnd();
         showMessage(tr("No satellite visibility"));
         return;
     }
-    updateObservation(nobs);
+    updateObservation(nt);
 
     setWindowTitle(tr("Satellite Visibility (Predicted)"));
     ui->btnSolution1->setChecked(true);
@@ -1446,6 +1470,8 @@ void Plot::clearObservation()
 // clear solution --------------------------------------------------------------
 void Plot::clearSolution()
 {
+    clearSeries();
+
     for (int i = 0; i < 2; i++) {
         freesolbuf(solutionData + i);
         free(solutionStat[i].data);
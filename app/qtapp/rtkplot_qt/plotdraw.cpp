@@ -665,6 +665,7 @@ void Plot::drawSolution(QPainter &c, int level, int type)
 {
     QString label[] = { tr("E-W"), tr("N-S"), tr("U-D") }, unit[] = { "m", "m/s", QString("m/s²") };
     QPushButton *btn[] = {ui->btnOn1, ui->btnOn2, ui->btnOn3 };
+    const LODSERIES *series;
     TIMEPOS *pos, *pos1, *pos2;
     gtime_t time1 = {0, 0}, time2 = {0, 0};
     QPoint p1, p2;
@@ -711,33 +712,23 @@ void Plot::drawSolution(QPainter &c, int level, int type)
 
     // draw solution 1
     if (ui->btnSolution1->isChecked()) {
-        pos = solutionToPosition(solutionData, -1, ui->cBQFlag->currentIndex(), type);
-        drawSolutionPoint(c, pos, level, 0);
-        drawSolutionStat(c, pos, unit[type], p++);
-
-        delete pos;
+        series = solutionToSeries(0, ui->cBQFlag->currentIndex(), type);
+        drawSolutionPoint(c, series, level, 0);
+        drawSolutionStat(c, series->pos, unit[type], p++);
     }
 
     // draw solution 2
     if (ui->btnSolution2->isChecked()) {
-        pos = solutionToPosition(solutionData + 1, -1, ui->cBQFlag->currentIndex(), type);
-        drawSolutionPoint(c, pos, level, 1);
-        drawSolutionStat(c, pos, unit[type], p++);
-
-        delete pos;
+        series = solutionToSeries(1, ui->cBQFlag->currentIndex(), type);
+        drawSolutionPoint(c, series, level, 1);
+        drawSolutionStat(c, series->pos, unit[type], p++);
     }
 
     // draw solution difference
     if (ui->btnSolution12->isChecked()) {
-        pos1 = solutionToPosition(solutionData, -1, 0, type);
-        pos2 = solutionToPosition(solutionData + 1, -1, 0, type);
-        pos = pos1->diff(pos2, ui->cBQFlag->currentIndex());
-        drawSolutionPoint(c, pos, level, 0);
-        drawSolutionStat(c, pos, unit[type], p++);
-
-        delete pos;
-        delete pos1;
-        delete pos2;
+        series = solutionToSeries(2, ui->cBQFlag->currentIndex(), type);
+        drawSolutionPoint(c, series, level, 0);
+        drawSolutionStat(c, series->pos, unit[type], p++);
     }
 
     if (ui->btnShowTrack->isChecked() && (ui->btnSolution1->isChecked() || ui->btnSolution2->isChecked() || ui->btnSolution12->isChecked())) {
@@ -811,45 +802,57 @@ void Plot::drawSolution(QPainter &c, int level, int type)
     }
 }
 // draw points and line on solution-plot ------------------------------------
-void Plot::drawSolutionPoint(QPainter &c, const TIMEPOS *pos, int level, int style)
+void Plot::drawSolutionPoint(QPainter &c, const LODSERIES *series, int level, int style)
 {
     QPushButton *btn[] = {ui->btnOn1, ui->btnOn2, ui->btnOn3 };
-    double *x, *y, *s, xs, ys, *yy;
-    int j;
+    const TIMEPOS *pos = series->pos;
+    QPoint p1, p2;
+    double *x, *y, *s, *py, *ps, xs, ys, *yy, xl[2], yl[2];
+    int *index, j, n;
 
     trace(3, "drawSolutionPoint: level=%d style=%d\n", level, style);
 
     x = new double[pos->n];
-
-    for (int i = 0; i < pos->n; i++)
-        x[i] = timePosition(pos->t[i]);
+    y = new double[pos->n];
+    s = new double[pos->n];
+    index = new int[pos->n];
 
     for (int panel = 0; panel < 3; panel++) {
         if (!btn[panel]->isChecked()) continue;
 
-        y = panel == 0 ? pos->x : (panel == 1 ? pos->y : pos->z);
-        s = panel == 0 ? pos->xs : (panel == 1 ? pos->ys : pos->zs);
+        py = panel == 0 ? pos->x : (panel == 1 ? pos->y : pos->z);
+        ps = panel == 0 ? pos->xs : (panel == 1 ? pos->ys : pos->zs);
+
+        // select points of visible time range decimated to plot resolution
+        graphTriple[panel]->getLimits(xl, yl);
+        graphTriple[panel]->getExtent(p1, p2);
+        n = series->select(panel, xl[0], xl[1], p2.x() - p1.x(), index);
 
+        for (j = 0; j < n; j++) {
+            x[j] = series->x[index[j]];
+            y[j] = py[index[j]];
+            s[j] = ps ? ps[index[j]] : 0.0;
+        }
         if (!level || (plotOptDialog->getPlotStyle() % 2) == 0) // a style with lines
-            drawPolyS(graphTriple[panel], c, x, y, pos->n, plotOptDialog->getCColor(3), style);
+            drawPolyS(graphTriple[panel], c, x, y, n, plotOptDialog->getCColor(3), style);
 
         // draw errors
         if (level && plotOptDialog->getShowError() != 0 && plotType <= PLOT_SOLA && plotOptDialog->getPlotStyle() < 2) {
             graphTriple[panel]->getScale(xs, ys);
 
             if (plotOptDialog->getShowError() == 1) {  // bar error style
-                for (j = 0; j < pos->n; j++)
+                for (j = 0; j < n; j++)
                     graphTriple[panel]->drawMark(c, x[j], y[j], Graph::MarkerTypes::VScale, plotOptDialog->getCColor(1), static_cast<int>(SQRT(s[j]) * 2.0 / ys), 0);
             } else {  // getShowError() == 2: dots error style
-                yy = new double [pos->n];
+                yy = new double [n];
 
                 // negative std-dev
-                for (j = 0; j < pos->n; j++) yy[j] = y[j] - SQRT(s[j]);
-                drawPolyS(graphTriple[panel], c, x, yy, pos->n, plotOptDialog->getCColor(1), 1);
+                for (j = 0; j < n; j++) yy[j] = y[j] - SQRT(s[j]);
+                drawPolyS(graphTriple[panel], c, x, yy, n, plotOptDialog->getCColor(1), 1);
 
                 // position std-dev
-                for (j = 0; j < pos->n; j++) yy[j] = y[j] + SQRT(s[j]);
-                drawPolyS(graphTriple[panel], c, x, yy, pos->n, plotOptDialog->getCColor(1), 1);
+                for (j = 0; j < n; j++) yy[j] = y[j] + SQRT(s[j]);
+                drawPolyS(graphTriple[panel], c, x, yy, n, plotOptDialog->getCColor(1), 1);
 
                 delete [] yy;
             }
@@ -857,16 +860,19 @@ void Plot::drawSolutionPoint(QPainter &c, const TIMEPOS *pos, int level, int sty
 
         // draw markers
         if (level && plotOptDialog->getPlotStyle() < 2) {  // a style with markers
-            QColor * color = new QColor[pos->n];
+            QColor * color = new QColor[n];
 
-            for (j = 0; j < pos->n; j++)
-                color[j] = plotOptDialog->getMarkerColor(style, pos->q[j]);
-            graphTriple[panel]->drawMarks(c, x, y, color, pos->n, Graph::MarkerTypes::Dot, plotOptDialog->getMarkSize(), 0);
+            for (j = 0; j < n; j++)
+                color[j] = plotOptDialog->getMarkerColor(style, pos->q[index[j]]);
+            graphTriple[panel]->drawMarks(c, x, y, color, n, Graph::MarkerTypes::Dot, plotOptDialog->getMarkSize(), 0);
 
             delete[] color;
         }
     }
     delete [] x;
+    delete [] y;
+    delete [] s;
+    delete [] index;
 }
 // draw statistics on solution-plot -----------------------------------------
 void Plot::drawSolutionStat(QPainter &c, const TIMEPOS *pos, const QString &unit, int p)
@@ -954,17 +960,11 @@ void Plot::drawNsat(QPainter &c, int level)
     }
 
     // draw solutions
-    if (ui->btnSolution1->isChecked()) {
-        ns = solutionToNsat(solutionData, -1, ui->cBQFlag->currentIndex());
-        drawSolutionPoint(c, ns, level, 0);
-        delete ns;
-    }
+    if (ui->btnSolution1->isChecked())
+        drawSolutionPoint(c, solutionToSeries(3, ui->cBQFlag->currentIndex(), 0), level, 0);
 
-    if (ui->btnSolution2->isChecked()) {
-        ns = solutionToNsat(solutionData + 1, -1, ui->cBQFlag->currentIndex());
-        drawSolutionPoint(c, ns, level, 1);
-        delete ns;
-    }
+    if (ui->btnSolution2->isChecked())
+        drawSolutionPoint(c, solutionToSeries(4, ui->cBQFlag->currentIndex(), 0), level, 1);
 
     // draw current position
     if (ui->btnShowTrack->isChecked() && (ui->btnSolution1->isChecked() || ui->btnSolution2->isChecked())) {
@@ -1010,7 +1010,7 @@ void Plot::drawObservation(QPainter &c, int level)
     gtime_t time;
     obsd_t *obs;
     double xs, ys, xt, xl[2], yl[2], tt[MAXSAT] = { 0 }, xp, xc, yc, yp[MAXSAT] = { 0 };
-    int i, j, nSats = 0, sats[MAXSAT] = { 0 }, ind = observationIndex;
+    int i, j, k, is, ie, nSats = 0, sats[MAXSAT] = { 0 }, ind = observationIndex;
     char id[8];
 
     trace(3, "drawObservation: level=%d\n", level);
@@ -1075,8 +1075,21 @@ void Plot::drawObservation(QPainter &c, int level)
     // draw observations
     if (level && plotOptDialog->getPlotStyle() <= 2) {
         graphSingle->getScale(xs, ys);
+        graphSingle->getLimits(xl, yl);
 
-        for (i = 0; i < observation.n; i++) {
+        // binary search epochs of visible time range (one epoch margin)
+        for (is = 0, ie = nObservation; is < ie; ) {
+            k = (is + ie) / 2;
+            if (timePosition(observation.data[indexObservation[k]].time) < xl[0]) is = k + 1; else ie = k;
+        }
+        for (k = is, ie = nObservation; k < ie; ) {
+            j = (k + ie) / 2;
+            if (timePosition(observation.data[indexObservation[j]].time) <= xl[1]) k = j + 1; else ie = j;
+        }
+        is = nObservation > 0 ? indexObservation[qMax(is - 1, 0)] : 0;
+        ie = nObservation > 0 ? indexObservation[qMin(ie + 1, nObservation)] : 0;
+
+        for (i = is; i < ie; i++) {
             obs = &observation.data[i];
 
             QColor col = observationColor(obs, azimuth[i], elevation[i], obstype);
@@ -131,6 +131,8 @@ Plot::Plot(QWidget *parent) : QMainWindow(parent), ui(new Ui::Plot)
         solutionStat[i] = solstat0;
         solutionIndex[i] = 0;
     }
+    for (int i = 0; i < 5; i++)
+        solutionSeries[i] = NULL;
 
     obs0.data = NULL; obs0.n = obs0.nmax = 0;
 
@@ -377,6 +379,8 @@ Plot::Plot(QWidget *parent) : QMainWindow(parent), ui(new Ui::Plot)
 // destructor ---------------------------------------------------------------
 Plot::~Plot()
 {
+    clearSeries();
+
     delete [] indexObservation;
     delete [] azimuth;
     delete [] elevation;
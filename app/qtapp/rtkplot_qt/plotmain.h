@@ -2,6 +2,7 @@
 #ifndef plotmainH
 #define plotmainH
 //---------------------------------------------------------------------------
+#include <QByteArray>
 #include <QTimer>
 #include <QElapsedTimer>
 #include <QMainWindow>
@@ -113,6 +114,27 @@ public:
     TIMEPOS *diff(const TIMEPOS *pos2, int qflag);
 };
 
+// level-of-detail time-series class ----------------------------------------
+// holds time-position data with plot x-coordinates and a min/max pyramid per
+// panel (x, y, z). level k stores the indices of the min/max sample of each
+// bucket of 2^k samples, so that select() returns at most a few points per
+// pixel column of the visible time range.
+class LODSERIES
+{
+private:
+    int nlevel_;
+    int **imin_[3], **imax_[3];
+    LODSERIES(LODSERIES &){}
+
+public:
+    TIMEPOS *pos;
+    double *x;
+    QByteArray key;
+    LODSERIES(TIMEPOS *pos, double *x, const QByteArray &key);
+    ~LODSERIES();
+    int select(int panel, double x0, double x1, int width, int *index) const;
+};
+
 struct WayPoint {
     QString name;
     double position[3];
@@ -248,6 +270,7 @@ private:
     stream_t streamTimeSync;
     solbuf_t solutionData[2];
     solstatbuf_t solutionStat[2];
+    LODSERIES *solutionSeries[5];
     int solutionIndex[2];
     obs_t observation;
     nav_t navigation;
@@ -335,7 +358,7 @@ private:
     void drawLabel(Graph *,QPainter &g, const QPoint &p, const QString &label, int ha, int va);
     void drawMark(Graph *,QPainter &g, const QPoint &p, int mark, const QColor &color, int size, int rot);
     void drawSolution(QPainter &g,int level, int type);
-    void drawSolutionPoint(QPainter &g,const TIMEPOS *pos, int level, int style);
+    void drawSolutionPoint(QPainter &g,const LODSERIES *series, int level, int style);
     void drawSolutionStat(QPainter &g,const TIMEPOS *pos, const QString &unit, int p);
     void drawNsat(QPainter &g,int level);
     void drawResidual(QPainter &g,int level);
@@ -358,6 +381,8 @@ private:
 
     TIMEPOS *solutionToPosition(solbuf_t *sol, int index, int qflag, int type);
     TIMEPOS *solutionToNsat(solbuf_t *sol, int index, int qflag);
+    const LODSERIES *solutionToSeries(int series, int qflag, int type);
+    void clearSeries();
     
     void positionToXyz(gtime_t time, const double *rr, int type, double *xyz);
     void covarianceToXyz(const double *rr, const float *qr, int type, double *xyzs);
@@ -398,7 +398,7 @@ void MainForm::updateServerStat()
     char msg[MAXSTRMSG * MAXSTR] = "";
     double ctime, t[4], pos;
 
-    strsvrstat(&strsvr, stat, log_stat, byte, bps, msg);
+    strsvrstat(&strsvr, stat, log_stat, byte, bps, NULL, NULL, NULL, msg);
     // update status indicators
     for (int i = 0; i < MAXSTR; i++) {
         lblStatus[i]->setStyleSheet(QStringLiteral("QLabel {background-color: %1;}").arg(color2String(color[stat[i] + 1])));
@@ -1685,10 +1685,11 @@ void __fastcall TMainForm::DrawPlot(TImage *plot, int type, int freq)
     ns[0]=rtksvrostat(&rtksvr,0,&time,sat[0],az[0],el[0],snr0,vsat[0]);
     ns[1]=rtksvrostat(&rtksvr,1,&time,sat[1],az[1],el[1],snr1,vsat[1]);
     
-    rtksvrlock(&rtksvr);
-    matcpy(rr,rtksvr.rtk.sol.rr,3,1);
+    svrstat_t *stat=new svrstat_t;
+    if (rtksvrstat(&rtksvr,stat)) matcpy(rr,stat->sol.rr,3,1);
+    else rr[0]=rr[1]=rr[2]=0.0;
     ecef2pos(rr,pos);
-    rtksvrunlock(&rtksvr);
+    delete stat;
     
     for (i=0;i<2;i++) {
         if (ns[i]>0) {
@@ -371,11 +371,11 @@ void __fastcall TPlot::ReadElMaskData(AnsiString file)
 // generate visibility data ---------------------------------------------------
 void __fastcall TPlot::GenVisData(void)
 {
-    gtime_t time,ts,te;
+    gtime_t time,ts,te,*times;
     obsd_t data={{0}};
     sta_t sta={0};
-    double tint,r,pos[3],rr[3],rs[6],e[3],azel[2];
-    int i,j,nobs=0;
+    double tint,r,pos[3],rr[3],*rs,e[3],azel[2];
+    int i,j,k,nt,ns=0,index[MAXSAT],sat[MAXSAT],*stat;
     char name[8];
     
     trace(3,"GenVisData\n");
@@ -394,11 +394,32 @@ void __fastcall TPlot::GenVisData(void)
     ShowMsg("generating satellite visibility...");
     Application->ProcessMessages();
     
-    for (time=ts;timediff(time,te)<=0.0;time=timeadd(time,tint)) {
-        for (i=0;i<MAXSAT;i++) {
-            satno2id(i+1,name);
-            if (!tle_pos(time,name,"","",&TLEData,NULL,rs)) continue;
-            if ((r=geodist(rs,rr,e))<=0.0) continue;
+    /* resolve tle data of satellites once */
+    for (i=0;i<MAXSAT;i++) {
+        satno2id(i+1,name);
+        if ((k=tle_index(name,"","",&TLEData))<0) continue;
+        sat[ns]=i+1;
+        index[ns++]=k;
+    }
+    /* time grid */
+    for (time=ts,nt=0;timediff(time,te)<=0.0&&nt<MAX_SIMOBS;time=timeadd(time,tint)) nt++;
+    
+    times=(gtime_t *)malloc(sizeof(gtime_t)*(nt>0?nt:1));
+    rs=(double *)malloc(sizeof(double)*6*(nt*ns>0?nt*ns:1));
+    stat=(int *)malloc(sizeof(int)*(nt*ns>0?nt*ns:1));
+    
+    if (times&&rs&&stat) {
+        for (i=0,time=ts;i<nt;i++,time=timeadd(time,tint)) times[i]=time;
+        
+        /* satellite positions at all times by one batch */
+        if (tle_pos_batch(times,nt,index,ns,&TLEData,NULL,rs,stat)<0) nt=0;
+    }
+    else nt=0;
+    
+    for (k=0;k<nt;k++) {
+        for (i=0;i<ns;i++) {
+            if (!stat[k*ns+i]) continue;
+            if ((r=geodist(rs+(k*ns+i)*6,rr,e))<=0.0) continue;
             if (satazel(pos,e,azel)<=0.0) continue;
             if (Obs.n>=Obs.nmax) {
                 Obs.nmax=Obs.nmax<=0?4096:Obs.nmax*2;
@@ -408,8 +429,8 @@ void __fastcall TPlot::GenVisData(void)
                     break;
                 }
             }
-            data.time=time;
-            data.sat=i+1;
+            data.time=times[k];
+            data.sat=sat[i];
             
             for (j=0;j<NFREQ;j++) {
                 data.P[j]=data.L[j]=0.0;
@@ -418,14 +439,17 @@ void __fastcall TPlot::GenVisData(void)
             data.code[0]=CODE_L1C;
             Obs.data[Obs.n++]=data;
         }
-        if (++nobs>=MAX_SIMOBS) break;
     }
+    free(times);
+    free(rs);
+    free(stat);
+    
     if (Obs.n<=0) {
         ReadWaitEnd();
         ShowMsg("no satellite visibility");
         return;
     }
-    UpdateObs(nobs);
+    UpdateObs(nt);
     
     Caption="Satellite Visibility (Predicted)";
     BtnSol1->Down=true;
@@ -366,7 +366,7 @@ void __fastcall TMainForm::Timer1Timer(TObject *Sender)
 	char msg[MAXSTRMSG*MAXSTR]="",s1[256],s2[256];
 	double ctime,t[4],pos,range;
 	
-	strsvrstat(&strsvr,stat,log_stat,byte,bps,msg);
+	strsvrstat(&strsvr,stat,log_stat,byte,bps,NULL,NULL,NULL,msg);
 	for (int i=0;i<MAXSTR;i++) {
 		num2cnum(byte[i],s1);
 		num2cnum(bps[i],s2);
@@ -43,11 +43,17 @@
 *                           fix bug on screening time in screent_ttol()
 *                           fix bug on screening QZS L1S messages as SBAS
 *                           use integer types in stdint.h
+*           2026/10/18 1.16 add single-pass conversion (onepass) in rnxopt_t
+*                           add parallel multiple-session conversion (nthread)
 *-----------------------------------------------------------------------------*/
+#include <stdarg.h>
 #include "rtklib.h"
 
 #define NOUTFILE        9       /* number of output files */
 #define TSTARTMARGIN    60.0    /* time margin for file name replacement */
+#define MAXCONVTHREAD   64      /* max number of conversion threads */
+
+#define MIN(x,y)        ((x)<(y)?(x):(y))
 
 #define EVENT_STARTMOVE 2       /* rinex event start moving antenna */
 #define EVENT_NEWSITE   3       /* rinex event new site occupation */
@@ -87,6 +93,44 @@ typedef struct {                /* stream file type */
     FILE   *fp;                 /* output file pointer */
 } strfile_t;
 
+typedef struct {                /* scanned obs-types type */
+    uint8_t codes[RNX_NUMSYS][33]; /* obs codes */
+    uint8_t types[RNX_NUMSYS][33]; /* obs types (1:P,2:L,4:D,8:S) */
+    int n[RNX_NUMSYS];          /* number of obs codes */
+} obstype_t;
+
+typedef struct {                /* single-pass conversion type */
+    FILE   *fp[NOUTFILE];       /* spill files (obs epochs and nav bodies) */
+    double ion0[8];             /* initial GPS ionosphere parameters */
+    int    ionset;              /* GPS ionosphere parameters updated */
+    int    fcn[MAXPRNGLO];      /* GLONASS FCN+8 used for obs data */
+    uint8_t fcnuse[MAXPRNGLO];  /* GLONASS FCN used for obs data */
+    int    fcnerr;              /* GLONASS FCN changed while used */
+    int    posstat;             /* approx position (0:none,1:pending,2:fixed) */
+    int    posfail;             /* point positioning failed before ion set */
+    double pos[3];              /* approx position */
+    obsd_t *obs;                /* obs data for pending approx position */
+    int    nobs;                /* number of obs data for pending position */
+    nav_t  nav;                 /* nav data for pending approx position */
+} onepass_t;
+
+typedef struct {                /* conversion session type */
+    rnxopt_t opt;               /* RINEX options */
+    int stat;                   /* status (1:ok,0:error,-1:abort,-2:not run) */
+} convsess_t;
+
+typedef struct {                /* conversion thread pool type */
+    int format;                 /* input format */
+    const char *file;           /* input file */
+    char **ofile;               /* output files */
+    convsess_t *sess;           /* sessions */
+    int nsess;                  /* number of sessions */
+    int next;                   /* next session index */
+    int abort;                  /* abort flag */
+    rtklib_lock_t lock;         /* lock flag */
+    rtklib_lock_t lock_msg;     /* lock flag for message callback */
+} convpool_t;
+
 /* global variables ----------------------------------------------------------*/
 static const int navsys[RNX_NUMSYS]={     /* system codes */
     SYS_GPS,SYS_GLO,SYS_GAL,SYS_QZS,SYS_SBS,SYS_CMP,SYS_IRN
@@ -122,6 +166,22 @@ static const char ver4code[][MAXCODE] = {
   // clang-format on
 };
 
+static THREADLOCAL rtklib_lock_t *lock_msg=NULL; /* lock for showmsg() */
+
+/* show message by callback --------------------------------------------------*/
+static int convmsg(const char *format, ...)
+{
+    va_list ap;
+    char buff[1024];
+    int stat;
+    
+    va_start(ap,format); vsnprintf(buff,sizeof(buff),format,ap); va_end(ap);
+    
+    if (lock_msg) rtklib_lock(lock_msg);
+    stat=*buff?showmsg("%s",buff):showmsg("");
+    if (lock_msg) rtklib_unlock(lock_msg);
+    return stat;
+}
 /* convert RINEX obs-type ver.3 -> ver.2 -------------------------------------*/
 static void convcode(int rnxver, int sys, char *type)
 {
@@ -180,7 +240,7 @@ static strfile_t *gen_strfile(int format, const char *opt)
     if (format==STRFMT_RTCM2||format==STRFMT_RTCM3) {
         if (!init_rtcm(&str->rtcm)) {
             free(str);
-            showmsg("init rtcm error");
+            convmsg("init rtcm error");
             return NULL;
         }
         str->rtcm.time=time0;
@@ -192,7 +252,7 @@ static strfile_t *gen_strfile(int format, const char *opt)
     else if (format<=MAXRCVFMT) {
         if (!init_raw(&str->raw,format)) {
             free(str);
-            showmsg("init raw error");
+            convmsg("init raw error");
             return NULL;
         }
         str->raw.time=time0;
@@ -204,7 +264,7 @@ static strfile_t *gen_strfile(int format, const char *opt)
     else if (format==STRFMT_RINEX) {
         if (!init_rnxctr(&str->rnx)) {
             free(str);
-            showmsg("init rnx error");
+            convmsg("init rnx error");
             return NULL;
         }
         str->rnx.time=time0;
@@ -256,6 +316,35 @@ static void free_strfile(strfile_t *str)
     }
     free(str);
 }
+/* reinitialize stream file -------------------------------------------------*/
+static int reinit_strfile(strfile_t *str, const char *opt)
+{
+    trace(3,"reinit_strfile:\n");
+    
+    if (str->format == STRFMT_RTCM2 || str->format == STRFMT_RTCM3) {
+        free_rtcm(&str->rtcm);
+        if (!init_rtcm(&str->rtcm)) {
+            convmsg("init rtcm error");
+            return 0;
+        }
+        strcpy(str->rtcm.opt, opt);
+    } else if (str->format <= MAXRCVFMT) {
+        free_raw(&str->raw);
+        if (!init_raw(&str->raw, str->format)) {
+            convmsg("reinit raw error");
+            return 0;
+        }
+        strcpy(str->raw.opt, opt);
+    } else if (str->format == STRFMT_RINEX) {
+        free_rnxctr(&str->rnx);
+        if (!init_rnxctr(&str->rnx)) {
+            convmsg("reinit rnx error");
+            return 0;
+        }
+        strcpy(str->rnx.opt, opt);
+    }
+    return 1;
+}
 /* input stream file ---------------------------------------------------------*/
 static int input_strfile(strfile_t *str)
 {
@@ -309,26 +398,26 @@ static int open_strfile(strfile_t *str, const char *file)
     
     if (str->format==STRFMT_RTCM2||str->format==STRFMT_RTCM3) {
         if (!(str->fp=fopen(file,"rb"))) {
-            showmsg("rtcm open error: %s",file);
+            convmsg("rtcm open error: %s",file);
             return 0;
         }
         str->rtcm.time=str->time;
     }
     else if (str->format<=MAXRCVFMT) {
         if (!(str->fp=fopen(file,"rb"))) {
-            showmsg("log open error: %s",file);
+            convmsg("log open error: %s",file);
             return 0;
         }
         str->raw.time=str->time;
     }
     else if (str->format==STRFMT_RINEX) {
         if (!(str->fp=fopen(file,"r"))) {
-            showmsg("rinex open error: %s",file);
+            convmsg("rinex open error: %s",file);
             return 0;
         }
         /* open rinex control */
         if (!open_rnxctr(&str->rnx,str->fp)) {
-            showmsg("no rinex file: %s",file);
+            convmsg("no rinex file: %s",file);
             fclose(str->fp);
             return 0;
         }
@@ -751,96 +840,75 @@ static void resolve_halfc(const strfile_t *str, obsd_t *data, int n)
         }
     }
 }
-/* scan input files ----------------------------------------------------------*/
-static int scan_file(char **files, int nf, rnxopt_t *opt, strfile_t *str,
-                     int *mask)
+/* scan observation data ---------------------------------------------------*/
+static void scan_obs(const rnxopt_t *opt, strfile_t *str, obstype_t *ot)
 {
-    eph_t  eph0 ={0,-1,-1};
-    geph_t geph0={0,-1};
-    seph_t seph0={0};
-    uint8_t codes[RNX_NUMSYS][33]={{0}};
-    uint8_t types[RNX_NUMSYS][33]={{0}};
-    char msg[128];
-    int i,j,k,l,m,c=0,type,sys,prn,abort=0,n[RNX_NUMSYS]={0};
-    
-    trace(3,"scan_file: nf=%d\n",nf);
-    
-    for (m=0;m<nf&&!abort;m++) {
+    int i,j,k,l,c,sys;
+    
+    for (i=0;i<str->obs->n;i++) {
+        sys=satsys(str->obs->data[i].sat,NULL);
+        if (!(sys&opt->navsys)) continue;
+        /* Mapping from SYS_ to RNX_SYS_ */
+        for (l=0;l<RNX_NUMSYS;l++) if (navsys[l]==sys) break;
+        if (l>=RNX_NUMSYS) continue;
         
-        if (!open_strfile(str,files[m])) {
-            continue;
-        }
-        while ((type=input_strfile(str))>=-1) {
-            if (opt->ts.time&&timediff(str->time,opt->ts)<-opt->ttol) continue;
-            if (opt->te.time&&timediff(str->time,opt->te)>-opt->ttol) break;
-            mask[m]=1; /* update file mask */
+        /* update obs-types */
+        for (j=0;j<NFREQ+NEXOBS;j++) {
+            c=str->obs->data[i].code[j];
+            if (c==CODE_NONE) continue;
             
-            if (type==1) { /* observation data */
-                for (i=0;i<str->obs->n;i++) {
-                    sys=satsys(str->obs->data[i].sat,NULL);
-                    if (!(sys&opt->navsys)) continue;
-                    /* Mapping from SYS_ to RNX_SYS_ */
-                    for (l=0;l<RNX_NUMSYS;l++) if (navsys[l]==sys) break;
-                    if (l>=RNX_NUMSYS) continue;
-                    
-                    /* update obs-types */
-                    for (j=0;j<NFREQ+NEXOBS;j++) {
-                        int c=str->obs->data[i].code[j];
-                        if (c==CODE_NONE) continue;
-                        
-                        for (k=0;k<n[l];k++) {
-                            if (codes[l][k]==c) break;
-                        }
-                        if (k>=n[l]&&n[l]<32) {
-                            codes[l][n[l]++]=c;
-                        }
-                        if (k<n[l]) {
-                            if (str->obs->data[i].P[j]!=0.0) types[l][k]|=1;
-                            if (str->obs->data[i].L[j]!=0.0) types[l][k]|=2;
-                            if (str->obs->data[i].D[j]!=0.0) types[l][k]|=4;
-                            if (str->obs->data[i].SNR[j]!=0) types[l][k]|=8;
-                        }
-                    }
-                    /* update half-cycle ambiguity list */
-                    if (opt->halfcyc) {
-                        update_halfc(str,str->obs->data+i);
-                    }
-                }
-                /* update station list */
-                update_stas(str);
+            for (k=0;k<ot->n[l];k++) {
+                if (ot->codes[l][k]==c) break;
             }
-            else if (type==5) { /* station info */
-                /* update station info */
-                update_stainf(str);
+            if (k>=ot->n[l]&&ot->n[l]<32) {
+                ot->codes[l][ot->n[l]++]=c;
+            }
+            if (k<ot->n[l]) {
+                if (str->obs->data[i].P[j]!=0.0) ot->types[l][k]|=1;
+                if (str->obs->data[i].L[j]!=0.0) ot->types[l][k]|=2;
+                if (str->obs->data[i].D[j]!=0.0) ot->types[l][k]|=4;
+                if (str->obs->data[i].SNR[j]!=0) ot->types[l][k]|=8;
             }
-            if (++c%11) continue;
-            
-            char tstr[40];
-            snprintf(msg,sizeof(msg),"scanning: %s %s%s%s%s%s%s%s",
-                     time2str(str->time,tstr,0),
-                     n[0]?"G":"",n[1]?"R":"",n[2]?"E":"",n[3]?"J":"",
-                     n[4]?"S":"",n[5]?"C":"",n[6]?"I":"");
-            if ((abort=showmsg(msg))) break;
         }
-        close_strfile(str);
+        /* update half-cycle ambiguity list */
+        if (opt->halfcyc) {
+            update_halfc(str,str->obs->data+i);
+        }
     }
-    showmsg("");
-    
-    if (abort) {
-        trace(2,"aborted in scan\n");
-        return 0;
+    /* update station list */
+    update_stas(str);
+}
+/* scan input message --------------------------------------------------------*/
+static void scan_msg(const rnxopt_t *opt, strfile_t *str, obstype_t *ot,
+                     int type)
+{
+    if (type==1) { /* observation data */
+        scan_obs(opt,str,ot);
     }
-    for (i=0;i<RNX_NUMSYS;i++) for (j=0;j<n[i];j++) {
-        trace(2,"scan_file: sys=%d code=%s type=%d\n",i,code2obs(codes[i][j]),
-              types[i][j]);
+    else if (type==5) { /* station info */
+        /* update station info */
+        update_stainf(str);
+    }
+}
+/* end scanning input files --------------------------------------------------*/
+static void scan_end(rnxopt_t *opt, strfile_t *str, obstype_t *ot)
+{
+    eph_t  eph0 ={0,-1,-1};
+    geph_t geph0={0,-1};
+    seph_t seph0={0};
+    int i,j,prn;
+    
+    for (i=0;i<RNX_NUMSYS;i++) for (j=0;j<ot->n[i];j++) {
+        trace(2,"scan_file: sys=%d code=%s type=%d\n",i,
+              code2obs(ot->codes[i][j]),ot->types[i][j]);
     }
     /* sort and set obs-types in RINEX options */
     for (i=0;i<RNX_NUMSYS;i++) {
-        sort_obstype(codes[i],types[i],n[i],i);
-        setopt_obstype(codes[i],types[i],i,opt);
+        sort_obstype(ot->codes[i],ot->types[i],ot->n[i],i);
+        setopt_obstype(ot->codes[i],ot->types[i],i,opt);
         
-        for (j=0;j<n[i];j++) {
-            trace(3,"scan_file: sys=%d code=%s\n",i,code2obs(codes[i][j]));
+        for (j=0;j<ot->n[i];j++) {
+            trace(3,"scan_file: sys=%d code=%s\n",i,code2obs(ot->codes[i][j]));
         }
     }
     /* set station info in RINEX options */
@@ -864,6 +932,48 @@ static int scan_file(char **files, int nf, rnxopt_t *opt, strfile_t *str,
     }
     dump_stas(str);
     dump_halfc(str);
+}
+/* scan input files ----------------------------------------------------------*/
+static int scan_file(char **files, int nf, rnxopt_t *opt, strfile_t *str,
+                     int *mask)
+{
+    obstype_t ot={{{0}}};
+    char msg[128];
+    int m,c=0,type,abort=0;
+    
+    trace(3,"scan_file: nf=%d\n",nf);
+    
+    for (m=0;m<nf&&!abort;m++) {
+        
+        if (!open_strfile(str,files[m])) {
+            continue;
+        }
+        while ((type=input_strfile(str))>=-1) {
+            if (opt->ts.time&&timediff(str->time,opt->ts)<-opt->ttol) continue;
+            if (opt->te.time&&timediff(str->time,opt->te)>-opt->ttol) break;
+            mask[m]=1; /* update file mask */
+            
+            scan_msg(opt,str,&ot,type);
+            
+            if (++c%11) continue;
+            
+            char tstr[40];
+            snprintf(msg,sizeof(msg),"scanning: %s %s%s%s%s%s%s%s",
+                     time2str(str->time,tstr,0),
+                     ot.n[0]?"G":"",ot.n[1]?"R":"",ot.n[2]?"E":"",
+                     ot.n[3]?"J":"",ot.n[4]?"S":"",ot.n[5]?"C":"",
+                     ot.n[6]?"I":"");
+            if ((abort=convmsg(msg))) break;
+        }
+        close_strfile(str);
+    }
+    convmsg("");
+    
+    if (abort) {
+        trace(2,"aborted in scan\n");
+        return 0;
+    }
+    scan_end(opt,str,&ot);
     return 1;
 }
 /* write RINEX header --------------------------------------------------------*/
@@ -903,7 +1013,7 @@ static int openfile(FILE **ofp, char *files[], const char *file,
         createdir(path);
         
         if (!(ofp[i]=fopen(path,"w"))) {
-            showmsg("file open error: %s",path);
+            convmsg("file open error: %s",path);
             for (i--;i>=0;i--) if (ofp[i]) fclose(ofp[i]);
             return 0;
         }
@@ -1033,40 +1143,40 @@ static int cmpobs(const void *p1, const void *p2)
     obsd_t *obs1 = (obsd_t *)p1, *obs2 = (obsd_t *)p2;
     return obs1->sat - obs2->sat;
 }
-/* convert observation data --------------------------------------------------*/
-static void convobs(FILE **ofp, rnxopt_t *opt, strfile_t *str, int *n,
-                    gtime_t *tend, int *staid)
+/* screen observation data -------------------------------------------------*/
+static int scrobs(rnxopt_t *opt, strfile_t *str, gtime_t *tend)
 {
-    gtime_t time;
-    int i,j;
-    
-    trace(3,"convobs :\n");
-    
-    if (!ofp[0]||str->obs->n<=0) return;
-    
-    time=str->obs->data[0].time;
+    gtime_t time=str->obs->data[0].time;
     
     /* Avoid duplicated data by multiple files handover */
-    if (tend->time&&timediff(time,*tend)<-opt->ttol) return;
+    if (tend->time&&timediff(time,*tend)<-opt->ttol) return 0;
     *tend=time;
 
     /* save cycle slips */
     save_slips(str,str->obs->data,str->obs->n);
     
-    if (!screent_ttol(time,opt->ts,opt->te,opt->tint,opt->ttol)) return;
+    if (!screent_ttol(time,opt->ts,opt->te,opt->tint,opt->ttol)) return 0;
     
     /* restore cycle slips */
     rest_slips(str,str->obs->data,str->obs->n);
+    return 1;
+}
+/* output observation data ---------------------------------------------------*/
+static void outobs(FILE **ofp, rnxopt_t *opt, strfile_t *str, obsd_t *data,
+                   int nobs, int flag, int *n, int *staid)
+{
+    gtime_t time=data[0].time;
+    int i,j;
     
     if (str->staid!=*staid) { /* station ID changed */
         
         if (*staid>=0) { /* output RINEX event */
             outrnxevent(ofp[0],opt,str->time,EVENT_NEWSITE,str->stas,str->staid);
             /* Set cycle slips */
-            for (i=0;i<str->obs->n;i++) {
+            for (i=0;i<nobs;i++) {
                 for (j=0;j<NFREQ+NEXOBS;j++) {
-                    if (str->obs->data[i].L[j]!=0.0) {
-                        str->obs->data[i].LLI[j]|=LLI_SLIP;
+                    if (data[i].L[j]!=0.0) {
+                        data[i].LLI[j]|=LLI_SLIP;
                     }
                 }
             }
@@ -1076,25 +1186,38 @@ static void convobs(FILE **ofp, rnxopt_t *opt, strfile_t *str, int *n,
     }
     /* resolve half-cycle ambiguity */
     if (opt->halfcyc) {
-        resolve_halfc(str,str->obs->data,str->obs->n);
+        resolve_halfc(str,data,nobs);
     }
     /* Sort observation data by the RTKLib satellite index */
     if (opt->sortsats) {
-        qsort(str->obs->data, str->obs->n, sizeof(obsd_t), cmpobs);
+        qsort(data, nobs, sizeof(obsd_t), cmpobs);
     }
     /* output RINEX observation data */
-    outrnxobsb(ofp[0],opt,str->obs->data,str->obs->n,str->obs->flag);
+    outrnxobsb(ofp[0],opt,data,nobs,flag);
     /* n[NOUTFILE+1] - count of events converted to rinex */
-    if (str->obs->flag == 5)
+    if (flag == 5)
        n[NOUTFILE+1]++;
-    /* set to zero flag for the next iteration (initialization) */
-    str->obs->flag = 0;
     
     if (opt->tstart.time==0) opt->tstart=time;
     opt->tend=time;
     
     n[0]++;
 }
+/* convert observation data --------------------------------------------------*/
+static void convobs(FILE **ofp, rnxopt_t *opt, strfile_t *str, int *n,
+                    gtime_t *tend, int *staid)
+{
+    trace(3,"convobs :\n");
+    
+    if (!ofp[0]||str->obs->n<=0) return;
+    
+    if (!scrobs(opt,str,tend)) return;
+    
+    outobs(ofp,opt,str,str->obs->data,str->obs->n,str->obs->flag,n,staid);
+    
+    /* set to zero flag for the next iteration (initialization) */
+    str->obs->flag = 0;
+}
 /* convert navigation data --------------------------------------------------*/
 static void convnav(FILE **ofp, rnxopt_t *opt, strfile_t *str, int *n)
 {
@@ -1238,22 +1361,29 @@ static void convsbs(FILE **ofp, rnxopt_t *opt, strfile_t *str, int *n,
         }
     }
 }
-/* set approx position in RINEX options --------------------------------------*/
-static void setopt_apppos(strfile_t *str, rnxopt_t *opt)
+/* approx position by point positioning -------------------------------------*/
+static int apppos(const obsd_t *obs, int n, const nav_t *nav,
+                  const rnxopt_t *opt, double *pos, char *msg)
 {
     prcopt_t prcopt=prcopt_default;
     sol_t sol={{0}};
-    char msg[128];
     
     prcopt.navsys=opt->navsys;
     
-    /* point positioning with last obs data */
-    if (!pntpos(str->obs->data,str->obs->n,str->nav,&prcopt,&sol,NULL,NULL,
-                msg)) {
+    if (!pntpos(obs,n,nav,&prcopt,&sol,NULL,NULL,msg)) {
         trace(2,"point position error (%s)\n",msg);
-        return;
+        return 0;
     }
-    matcpy(opt->apppos,sol.rr,3,1);
+    matcpy(pos,sol.rr,3,1);
+    return 1;
+}
+/* set approx position in RINEX options --------------------------------------*/
+static void setopt_apppos(strfile_t *str, rnxopt_t *opt)
+{
+    char msg[128];
+    
+    /* point positioning with last obs data */
+    apppos(str->obs->data,str->obs->n,str->nav,opt,opt->apppos,msg);
 }
 /* show conversion status ----------------------------------------------------*/
 static int showstat(int sess, gtime_t ts, gtime_t te, int *n)
@@ -1280,7 +1410,310 @@ static int showstat(int sess, gtime_t ts, gtime_t te, int *n)
         if (n[i]==0) continue;
         p+=sprintf(p,"%c=%d%s",type[i],n[i],i<NOUTFILE+1?" ":"");
     }
-    return showmsg(msg);
+    return convmsg(msg);
+}
+/* free single-pass conversion -----------------------------------------------*/
+static void free_onepass(onepass_t *op)
+{
+    int i;
+    
+    for (i=0;i<NOUTFILE;i++) {
+        if (op->fp[i]) fclose(op->fp[i]);
+    }
+    free(op->obs);
+    free(op->nav.eph);
+    free(op->nav.geph);
+    free(op->nav.seph);
+    free(op);
+}
+/* spill observation data ----------------------------------------------------*/
+static void spill_obs(onepass_t *op, rnxopt_t *opt, strfile_t *str,
+                      gtime_t *tend)
+{
+    FILE *fp=op->fp[0];
+    
+    trace(3,"spill_obs:\n");
+    
+    if (!fp||str->obs->n<=0) return;
+    
+    if (!scrobs(opt,str,tend)) return;
+    
+    /* Sort observation data by the RTKLib satellite index */
+    if (opt->sortsats) {
+        qsort(str->obs->data, str->obs->n, sizeof(obsd_t), cmpobs);
+    }
+    fwrite(&str->time,sizeof(gtime_t),1,fp);
+    fwrite(&str->staid,sizeof(int),1,fp);
+    fwrite(&str->obs->n,sizeof(int),1,fp);
+    fwrite(&str->obs->flag,sizeof(int),1,fp);
+    fwrite(str->obs->data,sizeof(obsd_t),str->obs->n,fp);
+    
+    /* set to zero flag for the next iteration (initialization) */
+    str->obs->flag = 0;
+}
+/* check GLONASS FCN used for observation data -------------------------------*/
+static void check_fcn(onepass_t *op, const strfile_t *str)
+{
+    const nav_t *nav=str->nav;
+    int i,j,sat,prn;
+    
+    /* formats decoding GLONASS obs data with FCN in nav data */
+    if (str->format!=STRFMT_RTCM3&&str->format!=STRFMT_OEM4&&
+        str->format!=STRFMT_UBX&&str->format!=STRFMT_CRES&&
+        str->format!=STRFMT_BINEX&&str->format!=STRFMT_SEPT&&
+        str->format!=STRFMT_UNICORE&&str->format!=STRFMT_RINEX) return;
+    
+    for (i=0;i<str->obs->n;i++) {
+        sat=str->obs->data[i].sat;
+        if (satsys(sat,&prn)!=SYS_GLO) continue;
+        
+        /* FCN by ephemeris is independent of the scan pass */
+        for (j=0;j<nav->ng;j++) {
+            if (nav->geph[j].sat==sat) break;
+        }
+        if (j<nav->ng) continue;
+        
+        if (!op->fcnuse[prn-1]) {
+            op->fcn[prn-1]=nav->glo_fcn[prn-1];
+            op->fcnuse[prn-1]=1;
+        }
+        else if (op->fcn[prn-1]!=nav->glo_fcn[prn-1]) {
+            op->fcnerr=1;
+        }
+    }
+}
+/* update approx position for single-pass conversion -------------------------*/
+static void update_pos(onepass_t *op, const rnxopt_t *opt,
+                       const strfile_t *str)
+{
+    const nav_t *nav=str->nav;
+    char msg[128]="";
+    
+    if (op->posstat) return;
+    
+    if (memcmp(nav->ion_gps,op->ion0,sizeof(op->ion0))) op->ionset=1;
+    
+    if (!apppos(str->obs->data,str->obs->n,nav,opt,op->pos,msg)) {
+        
+        /* lack of satellites does not depend on ionosphere parameters */
+        if (!op->ionset&&strncmp(msg,"lack of valid sats",18)) op->posfail=1;
+        return;
+    }
+    op->posstat=op->ionset?2:1;
+    if (op->posstat==2) return;
+    
+    /* save obs and nav data to estimate with final ionosphere parameters */
+    op->nav=*nav;
+    op->nav.eph=NULL; op->nav.geph=NULL; op->nav.seph=NULL;
+    if (!(op->obs =(obsd_t *)malloc(sizeof(obsd_t)*str->obs->n))||
+        !(op->nav.eph =(eph_t  *)malloc(sizeof(eph_t )*(nav->n >0?nav->n :1)))||
+        !(op->nav.geph=(geph_t *)malloc(sizeof(geph_t)*(nav->ng>0?nav->ng:1)))||
+        !(op->nav.seph=(seph_t *)malloc(sizeof(seph_t)*(nav->ns>0?nav->ns:1)))) {
+        free(op->obs); op->obs=NULL;
+        return;
+    }
+    memcpy(op->obs,str->obs->data,sizeof(obsd_t)*str->obs->n);
+    memcpy(op->nav.eph ,nav->eph ,sizeof(eph_t )*nav->n );
+    memcpy(op->nav.geph,nav->geph,sizeof(geph_t)*nav->ng);
+    memcpy(op->nav.seph,nav->seph,sizeof(seph_t)*nav->ns);
+    op->nobs=str->obs->n;
+}
+/* resolve approx position for single-pass conversion ------------------------*/
+static int resolve_pos(onepass_t *op, const rnxopt_t *opt, const nav_t *nav)
+{
+    char msg[128];
+    
+    if (memcmp(nav->ion_gps,op->ion0,sizeof(op->ion0))) op->ionset=1;
+    
+    /* estimated with same ionosphere parameters as conversion pass */
+    if (!op->ionset) {
+        if (op->posstat) op->posstat=2;
+        return 1;
+    }
+    if (op->posfail) return 0;
+    
+    if (op->posstat==1) {
+        if (!op->obs) return 0;
+        matcpy(op->nav.ion_gps,nav->ion_gps,8,1);
+        if (!apppos(op->obs,op->nobs,&op->nav,opt,op->pos,msg)) return 0;
+        op->posstat=2;
+    }
+    return 1;
+}
+/* RINEX converter for single-session by single-pass ---------------------------
+* decode input files once. obs-types, station list and half-cycle ambiguities
+* are scanned while decoding, obs epochs and nav bodies are spilled to
+* temporary files and output after the RINEX headers are fixed. if GLONASS FCN
+* or approx position could differ from two-pass conversion, return 2 to rerun
+* the conversion pass with the scanned info.
+*-----------------------------------------------------------------------------*/
+static int convrnx_1(int sess, int format, rnxopt_t *opt, const char *file,
+                     char **files, int nf, int *mask, char **ofile,
+                     strfile_t *str)
+{
+    FILE *ofp[NOUTFILE]={NULL};
+    onepass_t *op;
+    obstype_t ot={{{0}}};
+    obsd_t *data=NULL,*data_p;
+    gtime_t tend[3]={{0}},time;
+    size_t nr;
+    int i,j,m,type,nobs,nmax=0,flag,sid,n[NOUTFILE+2]={0},staid=-1,abort=0;
+    char buff[4096],*paths[NOUTFILE],s[NOUTFILE][1024];
+    char *staname=*opt->staid?opt->staid:"0000";
+    
+    trace(3,"convrnx_1: sess=%d format=%d nf=%d\n",sess,format,nf);
+    
+    if (!(op=(onepass_t *)calloc(1,sizeof(onepass_t)))) {
+        return scan_file(files,nf,opt,str,mask)?2:0;
+    }
+    for (i=0;i<NOUTFILE;i++) {
+        if (!*ofile[i]) continue;
+        if (!(op->fp[i]=tmpfile())) {
+            free_onepass(op);
+            return scan_file(files,nf,opt,str,mask)?2:0;
+        }
+    }
+    /* start decoding at first time as conversion pass */
+    for (m=0;m<nf&&!str->tstart.time;m++) {
+        if (!open_strfile(str,files[m])) continue;
+        while (!str->tstart.time&&input_strfile(str)>=-1) ;
+        close_strfile(str);
+    }
+    if (!reinit_strfile(str,opt->rcvopt)) {
+        free_onepass(op);
+        return 0;
+    }
+    str->time=str->tstart;
+    matcpy(op->ion0,str->nav->ion_gps,8,1);
+    
+    for (m=0;m<nf&&!abort;m++) {
+        
+        /* open stream file */
+        if (!open_strfile(str,files[m])) continue;
+        
+        /* input message */
+        for (j=0;(type=input_strfile(str))>=-1;j++) {
+            
+            if (!(j%11)&&(abort=showstat(sess,str->time,str->time,n))) break;
+            if (opt->te.time&&timediff(str->time,opt->te)>-opt->ttol) break;
+            
+            /* scan message */
+            if (!opt->ts.time||timediff(str->time,opt->ts)>=-opt->ttol) {
+                mask[m]=1; /* update file mask */
+                scan_msg(opt,str,&ot,type);
+            }
+            /* convert message to spill files */
+            switch (type) {
+                case  1: check_fcn(op,str);
+                         spill_obs(op,opt,str,tend); break;
+                case  2: convnav(op->fp,opt,str,n); break;
+                case  3: convsbs(op->fp,opt,str,n,tend+1); break;
+                case  9: op->ionset=1; break;
+                case -1: n[NOUTFILE]++; break; /* error */
+            }
+            /* update approx position */
+            if (type==1&&!opt->autopos&&norm(opt->apppos,3)<=0.0) {
+                update_pos(op,opt,str);
+            }
+        }
+        /* close stream file */
+        close_strfile(str);
+    }
+    if (abort) {
+        trace(2,"aborted in single-pass conversion\n");
+        free_onepass(op);
+        return 0;
+    }
+    scan_end(opt,str,&ot);
+    
+    /* check GLONASS FCN and approx position to be same as two-pass */
+    for (i=0;i<MAXPRNGLO;i++) {
+        if (op->fcnuse[i]&&op->fcn[i]!=str->nav->glo_fcn[i]) op->fcnerr=1;
+    }
+    if (op->fcnerr||(!opt->autopos&&norm(opt->apppos,3)<=0.0&&
+                     !resolve_pos(op,opt,str->nav))) {
+        trace(2,"single-pass conversion unavailable: fcnerr=%d\n",op->fcnerr);
+        free_onepass(op);
+        return 2;
+    }
+    /* set format and file in RINEX options comments */
+    setopt_file(format,files,nf,mask,opt);
+    
+    /* replace keywords in output file */
+    for (i=0;i<NOUTFILE;i++) {
+        paths[i]=s[i];
+        if (reppath(ofile[i],paths[i],opt->ts.time?opt->ts:str->tstart,
+                    staname,"")<0) {
+            convmsg("no time for output path: %s",ofile[i]);
+            free_onepass(op);
+            return 0;
+        }
+    }
+    /* open output files */
+    if (!openfile(ofp,paths,file,opt,str->nav)) {
+        free_onepass(op);
+        return 0;
+    }
+    for (m=0;m<nf;m++) {
+        if (mask[m]) break;
+    }
+    if (m>=nf) { /* no input data in time span */
+        for (i=0;i<NOUTFILE+2;i++) n[i]=0;
+    }
+    else {
+        /* set approx position in rinex option */
+        if (op->posstat==2&&!opt->autopos&&norm(opt->apppos,3)<=0.0) {
+            matcpy(opt->apppos,op->pos,3,1);
+        }
+        /* copy spilled nav bodies */
+        for (i=1;i<NOUTFILE;i++) {
+            if (!ofp[i]||!op->fp[i]) continue;
+            rewind(op->fp[i]);
+            while ((nr=fread(buff,1,sizeof(buff),op->fp[i]))>0) {
+                fwrite(buff,1,nr,ofp[i]);
+            }
+        }
+        /* output spilled obs epochs */
+        if (ofp[0]&&op->fp[0]) rewind(op->fp[0]);
+        
+        while (ofp[0]&&op->fp[0]&&!abort&&
+               fread(&time,sizeof(gtime_t),1,op->fp[0])==1&&
+               fread(&sid ,sizeof(int),1,op->fp[0])==1&&
+               fread(&nobs,sizeof(int),1,op->fp[0])==1&&
+               fread(&flag,sizeof(int),1,op->fp[0])==1) {
+            
+            if (nobs>nmax) {
+                if (!(data_p=(obsd_t *)realloc(data,sizeof(obsd_t)*nobs))) {
+                    break;
+                }
+                data=data_p;
+                nmax=nobs;
+            }
+            if (fread(data,sizeof(obsd_t),nobs,op->fp[0])<(size_t)nobs) break;
+            
+            str->time=time;
+            str->staid=sid;
+            outobs(ofp,opt,str,data,nobs,flag,n,&staid);
+            
+            if (!(n[0]%11)) abort=showstat(sess,time,time,n);
+        }
+    }
+    /* close output files */
+    closefile(ofp,opt,str->nav);
+    
+    /* remove empty output files */
+    for (i=0;i<NOUTFILE;i++) {
+        if (ofp[i]&&n[i]<=0) remove(ofile[i]);
+    }
+    showstat(sess,opt->tstart,opt->tend,n);
+    
+    /* unset RINEX options comments */
+    unsetopt_file(opt);
+    
+    free(data);
+    free_onepass(op);
+    
+    return abort?-1:1;
 }
 /* RINEX converter for single-session ----------------------------------------*/
 static int convrnx_s(int sess, int format, rnxopt_t *opt, const char *file,
@@ -1290,6 +1723,7 @@ static int convrnx_s(int sess, int format, rnxopt_t *opt, const char *file,
     strfile_t *str;
     gtime_t tend[3]={{0}};
     int i,j,nf,type,n[NOUTFILE+2]={0},mask[MAXEXFILE]={0},staid=-1,abort=0;
+    int stat;
     char path[1024],*paths[NOUTFILE],s[NOUTFILE][1024];
     char *epath[MAXEXFILE]={0},*staname=*opt->staid?opt->staid:"0000";
     
@@ -1299,7 +1733,7 @@ static int convrnx_s(int sess, int format, rnxopt_t *opt, const char *file,
     
     /* replace keywords in input file */
     if (reppath(file,path,opt->ts,staname,"")<0) {
-        showmsg("no time for input file: %s",file);
+        convmsg("no time for input file: %s",file);
         return 0;
     }
     /* expand wild-cards in input file */
@@ -1310,7 +1744,7 @@ static int convrnx_s(int sess, int format, rnxopt_t *opt, const char *file,
         }
     }
     if ((nf=expath(path,epath,MAXEXFILE))<=0) {
-        showmsg("no input file: %s",path);
+        convmsg("no input file: %s",path);
         return 0;
     }
     if (!(str=gen_strfile(format,opt->rcvopt))) {
@@ -1327,8 +1761,16 @@ static int convrnx_s(int sess, int format, rnxopt_t *opt, const char *file,
     for (i=0;i<MAXPRNGLO;i++) {
         str->nav->glo_fcn[i]=opt->glofcn[i]; /* FCN+8 */
     }
+    /* single-pass conversion without scanning input files */
+    if (opt->onepass&&(nf==1||!opt->ts.time)) {
+        if ((stat=convrnx_1(sess,format,opt,path,epath,nf,mask,ofile,str))!=2) {
+            for (i=0;i<MAXEXFILE;i++) free(epath[i]);
+            free_strfile(str);
+            return stat;
+        }
+    }
     /* scan input files */
-    if (!scan_file(epath,nf,opt,str,mask)) {
+    else if (!scan_file(epath,nf,opt,str,mask)) {
         for (i=0;i<MAXEXFILE;i++) free(epath[i]);
         free_strfile(str);
         return 0;
@@ -1341,7 +1783,7 @@ static int convrnx_s(int sess, int format, rnxopt_t *opt, const char *file,
         paths[i]=s[i];
         if (reppath(ofile[i],paths[i],opt->ts.time?opt->ts:str->tstart,
                     staname,"")<0) {
-            showmsg("no time for output path: %s",ofile[i]);
+            convmsg("no time for output path: %s",ofile[i]);
             for (i=0;i<MAXEXFILE;i++) free(epath[i]);
             free_strfile(str);
             return 0;
@@ -1357,33 +1799,10 @@ static int convrnx_s(int sess, int format, rnxopt_t *opt, const char *file,
     
     // Reinitialize the input state. Don't want decoding state from the
     // end of the scanning pass to affect the start of the next pass.
-    if (str->format == STRFMT_RTCM2 || str->format == STRFMT_RTCM3) {
-        free_rtcm(&str->rtcm);
-        if (!init_rtcm(&str->rtcm)) {
-            showmsg("init rtcm error");
-            for (int i = 0; i < MAXEXFILE; i++) free(epath[i]);
-            free_strfile(str);
-            return 0;
-        }
-        strcpy(str->rtcm.opt, opt->rcvopt);
-    } else if (str->format <= MAXRCVFMT) {
-        free_raw(&str->raw);
-        if (!init_raw(&str->raw, str->format)) {
-            showmsg("reinit raw error");
-            for (int i = 0; i < MAXEXFILE; i++) free(epath[i]);
-            free_strfile(str);
-            return 0;
-        }
-        strcpy(str->raw.opt, opt->rcvopt);
-    } else if (format == STRFMT_RINEX) {
-        free_rnxctr(&str->rnx);
-        if (!init_rnxctr(&str->rnx)) {
-            showmsg("reinit rnx error");
-            for (int i = 0; i < MAXEXFILE; i++) free(epath[i]);
-            free_strfile(str);
-            return 0;
-        }
-        strcpy(str->rnx.opt, opt->rcvopt);
+    if (!reinit_strfile(str, opt->rcvopt)) {
+        for (int i = 0; i < MAXEXFILE; i++) free(epath[i]);
+        free_strfile(str);
+        return 0;
     }
 
     // Don't want saved slips from the scanning pass to be flagged at
@@ -1438,6 +1857,147 @@ static int convrnx_s(int sess, int format, rnxopt_t *opt, const char *file,
     
     return abort?-1:1;
 }
+/* set session time in RINEX options -----------------------------------------*/
+static int setopt_sess(const rnxopt_t *opt, rnxopt_t *opt_, int week,
+                       double ts, double tu, int i)
+{
+    gtime_t t0={0};
+    
+    opt_->ts=gpst2time(week,ts+i*tu);
+    opt_->te=timeadd(opt_->ts,tu);
+    if (opt->trtcm.time) {
+        opt_->trtcm=timeadd(opt->trtcm,timediff(opt_->ts,opt->ts));
+    }
+    if (timediff(opt_->ts,opt->te)>-opt->ttol) return 0;
+    
+    if (timediff(opt_->ts,opt->ts)<0.0) opt_->ts=opt->ts;
+    if (timediff(opt_->te,opt->te)>0.0) opt_->te=opt->te;
+    opt_->tstart=opt_->tend=t0;
+    return 1;
+}
+/* compare strings -----------------------------------------------------------*/
+static int cmpstr(const void *p1, const void *p2)
+{
+    return strcmp(*(const char **)p1,*(const char **)p2);
+}
+/* check output paths shared by sessions -------------------------------------*/
+static int dup_outpath(const convsess_t *sess, int nsess, char **ofile)
+{
+    char *staname,**paths,*buff;
+    int i,j,dup=0;
+    
+    if (!(paths=(char **)malloc(sizeof(char *)*nsess))||
+        !(buff=(char *)malloc(1024*nsess))) {
+        free(paths);
+        return 1;
+    }
+    for (i=0;i<NOUTFILE&&!dup;i++) {
+        if (!*ofile[i]) continue;
+        for (j=0;j<nsess;j++) {
+            paths[j]=buff+j*1024;
+            staname=*sess[j].opt.staid?(char *)sess[j].opt.staid:"0000";
+            reppath(ofile[i],paths[j],sess[j].opt.ts,staname,"");
+        }
+        qsort(paths,nsess,sizeof(char *),cmpstr);
+        for (j=0;j<nsess-1&&!dup;j++) {
+            dup=!strcmp(paths[j],paths[j+1]);
+        }
+    }
+    free(paths);
+    free(buff);
+    return dup;
+}
+/* conversion thread ---------------------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI convthread(void *arg)
+#else
+static void *convthread(void *arg)
+#endif
+{
+    convpool_t *pool=(convpool_t *)arg;
+    int i;
+    
+    lock_msg=&pool->lock_msg;
+    
+    for (;;) {
+        rtklib_lock(&pool->lock);
+        i=pool->abort?pool->nsess:pool->next++;
+        rtklib_unlock(&pool->lock);
+        
+        if (i>=pool->nsess) break;
+        
+        pool->sess[i].stat=convrnx_s(i+1,pool->format,&pool->sess[i].opt,
+                                     pool->file,pool->ofile);
+        if (pool->sess[i].stat<0) {
+            rtklib_lock(&pool->lock);
+            pool->abort=1;
+            rtklib_unlock(&pool->lock);
+        }
+    }
+    lock_msg=NULL;
+    return 0;
+}
+/* RINEX converter for multiple sessions by threads --------------------------*/
+static int convrnx_p(int format, const rnxopt_t *opt, rnxopt_t *opt_,
+                     const char *file, char **ofile, int week, double ts,
+                     double tu, int nsess)
+{
+    convpool_t pool={0};
+    rtklib_thread_t thread[MAXCONVTHREAD];
+    int i,n,nthread,stat=1;
+    
+    trace(3,"convrnx_p: nsess=%d nthread=%d\n",nsess,opt->nthread);
+    
+    if (!(pool.sess=(convsess_t *)malloc(sizeof(convsess_t)*nsess))) {
+        return -2;
+    }
+    for (i=0;i<nsess;i++) {
+        pool.sess[i].opt=*opt_;
+        setopt_sess(opt,&pool.sess[i].opt,week,ts,tu,i);
+        pool.sess[i].stat=-2;
+    }
+    /* sessions writing the same output file are converted sequentially */
+    if (dup_outpath(pool.sess,nsess,ofile)) {
+        free(pool.sess);
+        return -2;
+    }
+    pool.format=format;
+    pool.file=file;
+    pool.ofile=ofile;
+    pool.nsess=nsess;
+    rtklib_initlock(&pool.lock);
+    rtklib_initlock(&pool.lock_msg);
+    
+    nthread=MIN(MIN(opt->nthread,MAXCONVTHREAD),nsess);
+    
+    for (n=0;n<nthread;n++) {
+#ifdef WIN32
+        if (!(thread[n]=CreateThread(NULL,0,convthread,&pool,0,NULL))) break;
+#else
+        if (pthread_create(thread+n,NULL,convthread,&pool)) break;
+#endif
+    }
+    if (n<=0) convthread(&pool); /* no thread available */
+    
+    for (i=0;i<n;i++) {
+#ifdef WIN32
+        WaitForSingleObject(thread[i],INFINITE);
+        CloseHandle(thread[i]);
+#else
+        pthread_join(thread[i],NULL);
+#endif
+    }
+    /* status and time of last converted session as sequential conversion */
+    for (i=0;i<nsess;i++) {
+        if (pool.sess[i].stat==-2) continue;
+        stat=pool.sess[i].stat;
+        opt_->tstart=pool.sess[i].opt.tstart;
+        opt_->tend  =pool.sess[i].opt.tend;
+        if (stat<0) break;
+    }
+    free(pool.sess);
+    return stat;
+}
 /* RINEX converter -------------------------------------------------------------
 * convert receiver log file to RINEX obs/nav, SBAS log files
 * args   : int    format I      receiver raw format (STRFMT_???)
@@ -1460,19 +2020,23 @@ static int convrnx_s(int sess, int format, rnxopt_t *opt, const char *file,
 *          keywords in ofile[] are replaced by first observation date/time and
 *          station ID (%r)
 *          the order of wild-card expanded files must be in-order by time
+*          with opt->nthread>1, multiple sessions are converted in parallel by
+*          threads. each session then starts with the RINEX options given,
+*          not with the station info and approx position found in the
+*          previous session. the callback showmsg() is serialized.
 *-----------------------------------------------------------------------------*/
 extern int convrnx(int format, rnxopt_t *opt, const char *file, char **ofile)
 {
     gtime_t t0={0};
-    rnxopt_t opt_=*opt;
+    rnxopt_t opt_=*opt,sess;
     double tu,ts;
-    int i,week,stat=1,sys_GRS=SYS_GPS|SYS_GLO|SYS_SBS;
+    int i,week,nsess,stat=1,sys_GRS=SYS_GPS|SYS_GLO|SYS_SBS;
     
     trace(3,"convrnx: format=%d file=%s ofile=%s %s %s %s %s %s %s %s %s\n",
           format,file,ofile[0],ofile[1],ofile[2],ofile[3],ofile[4],ofile[5],
           ofile[6],ofile[7],ofile[8]);
     
-    showmsg("");
+    convmsg("");
     
     /* disable systems according to RINEX version */
     if      (opt->rnxver<=210) opt_.navsys&=sys_GRS;
@@ -1497,22 +2061,22 @@ extern int convrnx(int format, rnxopt_t *opt, const char *file, char **ofile)
         tu=opt->tunit<86400.0?opt->tunit:86400.0;
         ts=tu*(int)floor(time2gpst(opt->ts,&week)/tu);
         
-        for (i=0;;i++) { /* for each session */
-            opt_.ts=gpst2time(week,ts+i*tu);
-            opt_.te=timeadd(opt_.ts,tu);
-            if (opt->trtcm.time) {
-                opt_.trtcm=timeadd(opt->trtcm,timediff(opt_.ts,opt->ts));
+        for (nsess=0;;nsess++) {
+            sess=opt_;
+            if (!setopt_sess(opt,&sess,week,ts,tu,nsess)) break;
+        }
+        if (opt->nthread>1&&nsess>1) {
+            stat=convrnx_p(format,opt,&opt_,file,ofile,week,ts,tu,nsess);
+        }
+        if (opt->nthread<=1||nsess<=1||stat==-2) {
+            for (i=0;i<nsess;i++) { /* for each session */
+                setopt_sess(opt,&opt_,week,ts,tu,i);
+                if ((stat=convrnx_s(i+1,format,&opt_,file,ofile))<0) break;
             }
-            if (timediff(opt_.ts,opt->te)>-opt->ttol) break;
-            
-            if (timediff(opt_.ts,opt->ts)<0.0) opt_.ts=opt->ts;
-            if (timediff(opt_.te,opt->te)>0.0) opt_.te=opt->te;
-            opt_.tstart=opt_.tend=t0;
-            if ((stat=convrnx_s(i+1,format,&opt_,file,ofile))<0) break;
         }
     }
     else {
-        showmsg("no period");
+        convmsg("no period");
         return 0;
     }
     /* output start and end time */
@@ -13,6 +13,11 @@
 *                            fix bug on double-free of download paths
 *                            limit max number of download paths
 *                            use integer types in stdint.h
+*           2026/10/18  1.3  download files concurrently by threads
+*                            limit concurrent transfers by host
+*                            retry failed transfers with backoff
+*                            resume partial files (*.part)
+*                            add api dl_setconc()
 *-----------------------------------------------------------------------------*/
 #define _POSIX_C_SOURCE 200112L
 #include <errno.h>
@@ -28,12 +33,28 @@
 #define HTTP_NOFILE 1               /* HTTP error no file */
 #define FTP_RETRY   3               /* FTP number of retry */
 #define MAX_PATHS   131072          /* max number of download paths */
+#define MAX_THREAD  32              /* max number of download threads */
+#define MAX_HOST    64              /* max number of hosts */
+#define DL_NTHREAD  1               /* default number of download threads */
+#define DL_NHOST    2               /* default max transfers by host */
+#define DL_NRETRY   2               /* default number of retry of transfers */
+#define DL_TRETRY   5.0             /* default retry backoff (s) */
+#define DL_PART     ".part"         /* extension of partial file */
+#define MIN(x,y)    ((x)<(y)?(x):(y))
+
+#define DL_DONE     0               /* download status: done */
+#define DL_RETRY    1               /* download status: retry later */
+#define DL_ABORT    2               /* download status: abort */
 
 /* type definitions ----------------------------------------------------------*/
 
 typedef struct {                    /* download path type */
     char *remot;                    /* remote path */
     char *local;                    /* local path */
+    int host;                       /* host index */
+    int stat;                       /* status (0:wait,1:transfer,2:done) */
+    int ntry;                       /* number of retries */
+    uint32_t tnext;                 /* tick of next try (ms) */
 } path_t;
 
 typedef struct {                    /* download paths type */
@@ -41,6 +62,49 @@ typedef struct {                    /* download paths type */
     int n,nmax;                     /* number and max number of paths */
 } paths_t;
 
+typedef struct {                    /* download thread pool type */
+    paths_t *paths;                 /* download paths */
+    const char *usr,*pwd,*proxy;    /* login user, password and proxy */
+    int opts;                       /* download options */
+    FILE *fp;                       /* log file pointer */
+    char remot_p[1024];             /* remote path of FTP listing */
+    char host[MAX_HOST][256];       /* host names */
+    int nhost;                      /* number of hosts */
+    int active[MAX_HOST];           /* number of transfers by host */
+    int next;                       /* first waiting path index */
+    int ndone;                      /* number of done paths */
+    int n[4];                       /* number of OK,No_File,Skip,Error */
+    double bytes;                   /* transferred bytes */
+    uint32_t tick;                  /* start tick (ms) */
+    int abort;                      /* abort flag */
+    rtklib_lock_t lock;             /* lock flag */
+    rtklib_lock_t lock_list;        /* lock flag for FTP listing file */
+    rtklib_lock_t lock_msg;         /* lock flag for message and log */
+} dlpool_t;
+
+/* global variables ----------------------------------------------------------*/
+static int dl_nthread=DL_NTHREAD;   /* number of download threads */
+static int dl_nhost  =DL_NHOST;     /* max transfers by host */
+static int dl_nretry =DL_NRETRY;    /* number of retries of transfers */
+static double dl_tretry=DL_TRETRY;  /* retry backoff (s) */
+
+static THREADLOCAL rtklib_lock_t *lock_msg=NULL; /* lock for showmsg() */
+
+/* show message by callback --------------------------------------------------*/
+static int dlmsg(const char *format, ...)
+{
+    va_list ap;
+    char buff[2048];
+    int stat;
+    
+    va_start(ap,format); vsnprintf(buff,sizeof(buff),format,ap); va_end(ap);
+    
+    if (lock_msg) rtklib_lock(lock_msg);
+    stat=showmsg("%s",buff);
+    if (lock_msg) rtklib_unlock(lock_msg);
+    return stat;
+}
+
 /* execute command with test timeout -----------------------------------------*/
 extern int execcmd_to(const char *cmd)
 {
@@ -56,7 +120,7 @@ extern int execcmd_to(const char *cmd)
                        NULL,&si,&info)) return -1;
     
     while (WaitForSingleObject(info.hProcess,10)==WAIT_TIMEOUT) {
-        showmsg("");
+        dlmsg("");
     }
     if (!GetExitCodeProcess(info.hProcess,&stat)) stat=-1;
     CloseHandle(info.hProcess);
@@ -210,6 +274,9 @@ static int add_path(paths_t *paths, const char *remot, const char *dir)
     }
     strcpy(paths->path[paths->n].remot,remot);
     strcpy(paths->path[paths->n].local,local);
+    paths->path[paths->n].host=paths->path[paths->n].stat=0;
+    paths->path[paths->n].ntry=0;
+    paths->path[paths->n].tnext=0;
     paths->n++;
     return 1;
 }
@@ -427,14 +494,56 @@ static int test_list(path_t *path)
     fclose(fp);
     return 0;
 }
+/* file size (bytes) ---------------------------------------------------------*/
+static double file_size(const char *file)
+{
+    FILE *fp;
+    double size;
+    
+    if (!(fp=fopen(file,"rb"))) return 0.0;
+    fseek(fp,0,SEEK_END);
+    size=(double)ftell(fp);
+    fclose(fp);
+    return size;
+}
+/* output download status and log and count result --------------------------*/
+static void log_down(dlpool_t *pool, const char *stat, int type,
+                     const char *format, ...)
+{
+    va_list ap;
+    
+    if (lock_msg) rtklib_lock(lock_msg);
+    showmsg("STAT=%s",stat);
+    if (pool->fp) {
+        va_start(ap,format); vfprintf(pool->fp,format,ap); va_end(ap);
+    }
+    pool->n[type]++;
+    if (lock_msg) rtklib_unlock(lock_msg);
+}
+/* test no file error in download log ----------------------------------------*/
+static int test_nofile(const char *errfile)
+{
+    FILE *fp;
+    char buff[1024];
+    int stat=0;
+    
+    if (!(fp=fopen(errfile,"r"))) return 0;
+    
+    while (!stat&&fgets(buff,sizeof(buff),fp)) {
+        stat=strstr(buff,"ERROR 404")||strstr(buff,"No such file");
+    }
+    fclose(fp);
+    return stat;
+}
 /* execute download ----------------------------------------------------------*/
-static int exec_down(path_t *path, char *remot_p, const char *usr,
-                     const char *pwd, const char *proxy, int opts, int *n,
-                     FILE *fp)
+static int exec_down(dlpool_t *pool, path_t *path)
 {
-    char dir[1024],errfile[1024],tmpfile[1024],cmd[4096],env[1024]="";
-    char opt[1024]="",*opt2="",*p;
-    int ret,proto;
+    const char *usr=pool->usr,*pwd=pool->pwd,*proxy=pool->proxy;
+    char dir[1024],errfile[1024],tmpfile[1024],partfile[1024],cmd[4096];
+    char env[1024]="",opt[1024]="",*opt2="",*p;
+    double size;
+    size_t m;
+    int n,ret,proto,wild;
     
 #ifndef WIN32
     opt2=" 2> /dev/null";
@@ -448,48 +557,47 @@ static int exec_down(path_t *path, char *remot_p, const char *usr,
     else if (!strncmp(path->remot,"https://",8)) proto=1;
     else {
         trace(2,"exec_down: invalid path %s\n",path->remot);
-        showmsg("STAT=X");
-        if (fp) fprintf(fp,"%s ERROR (INVALID PATH)\n",path->remot);
-        n[1]++;
-        return 0;
+        log_down(pool,"X",1,"%s ERROR (INVALID PATH)\n",path->remot);
+        return DL_DONE;
     }
     /* test local file existence */
-    if (!(opts&DLOPT_FORCE)&&test_file(path->local)) {
-        showmsg("STAT=.");
-        if (fp) fprintf(fp,"%s in %s\n",path->remot,dir);
-        n[2]++;
-        return 0;
+    if (!(pool->opts&DLOPT_FORCE)&&path->ntry==0&&test_file(path->local)) {
+        log_down(pool,".",2,"%s in %s\n",path->remot,dir);
+        return DL_DONE;
     }
-    showmsg("STAT=_");
+    dlmsg("STAT=_");
+    wild=strchr(path->remot,'*')!=NULL;
     
-    /* get remote file list for FTP or FTPS */
-    if ((proto==0||proto==2)&&(p=strrchr(path->remot,'/'))&&
-        strncmp(path->remot,remot_p,p-path->remot)) {
+    if (proto==0||proto==2) {
+        rtklib_lock(&pool->lock_list);
         
-        if (get_list(path,usr,pwd,proxy)) {
-            strcpy(remot_p,path->remot);
+        /* get remote file list for FTP or FTPS */
+        if ((p=strrchr(path->remot,'/'))&&
+            strncmp(path->remot,pool->remot_p,p-path->remot+1)) {
+            
+            if (get_list(path,usr,pwd,proxy)) {
+                strcpy(pool->remot_p,path->remot);
+            }
+            else pool->remot_p[0]='\0';
+        }
+        /* test file in listing or extend wild-card in file path */
+        ret=test_list(path);
+        rtklib_unlock(&pool->lock_list);
+        
+        if (!ret) {
+            log_down(pool,"x",1,"%s NO_FILE\n",path->remot);
+            return DL_DONE;
         }
-    }
-    /* test file in listing for FTP or FTPS or extend wild-card in file path */
-    if ((proto==0||proto==2)&&!test_list(path)) {
-        showmsg("STAT=x");
-        if (fp) fprintf(fp,"%s NO_FILE\n",path->remot);
-        n[1]++;
-        return 0;
     }
     /* generate local directory recursively */
     if (!mkdir_r(dir)) {
-        showmsg("STAT=X");
-        if (fp) fprintf(fp,"%s -> %s ERROR (LOCAL DIR)\n",path->remot,dir);
-        n[3]++;
-        return 0;
+        log_down(pool,"X",3,"%s -> %s ERROR (LOCAL DIR)\n",path->remot,dir);
+        return DL_DONE;
     }
     /* re-test local file existence for file with wild-card */
-    if (!(opts&DLOPT_FORCE)&&test_file(path->local)) {
-        showmsg("STAT=.");
-        if (fp) fprintf(fp,"%s in %s\n",path->remot,dir);
-        n[2]++;
-        return 0;
+    if (!(pool->opts&DLOPT_FORCE)&&wild&&test_file(path->local)) {
+        log_down(pool,".",2,"%s in %s\n",path->remot,dir);
+        return DL_DONE;
     }
     /* proxy option */
     if (*proxy) {
@@ -497,48 +605,76 @@ static int exec_down(path_t *path, char *remot_p, const char *usr,
                 proxy);
         sprintf(opt," --proxy=on ");
     }
-    /* download command */
-    sprintf(errfile,"%s.err",path->local);
+    /* download command to partial file continued if exists */
+    if (snprintf(errfile,sizeof(errfile),"%s.err",path->local)>=
+            (int)sizeof(errfile)||
+        snprintf(partfile,sizeof(partfile),"%s%s",path->local,DL_PART)>=
+            (int)sizeof(partfile)) {
+        trace(2,"exec_down: local path too long %s\n",path->local);
+        log_down(pool,"X",3,"%s -> %s ERROR (LOCAL PATH)\n",path->remot,dir);
+        return DL_DONE;
+    }
+    size=file_size(partfile);
+    
     if (proto==0||proto==2) {
-        sprintf(cmd,"%s%s %s --ftp-user=%s --ftp-password=%s --glob=off "
-                "--passive-ftp %s-t %d -T %d -O \"%s\" -o \"%s\"%s\n",
-                env,FTP_CMD,path->remot,usr,pwd,opt,FTP_RETRY,FTP_TIMEOUT,
-                path->local,errfile,opt2);
+        n=snprintf(cmd,sizeof(cmd),"%s%s %s --ftp-user=%s --ftp-password=%s "
+                   "--glob=off --passive-ftp %s-c -t %d -T %d -O \"%s\" -o "
+                   "\"%s\"%s\n",env,FTP_CMD,path->remot,usr,pwd,opt,FTP_RETRY,
+                   FTP_TIMEOUT,partfile,errfile,opt2);
     }
     else {
         if (*pwd) {
-            sprintf(opt+strlen(opt)," --http-user=%s --http-password=%s ",usr,
-                    pwd);
+            m=strlen(opt);
+            snprintf(opt+m,sizeof(opt)-m," --http-user=%s --http-password=%s ",
+                     usr,pwd);
         }
-        sprintf(cmd,"%s%s %s %s-t %d -T %d -O \"%s\" -o \"%s\"%s\n",env,FTP_CMD,
-                path->remot,opt,FTP_RETRY,FTP_TIMEOUT,path->local,errfile,opt2);
+        n=snprintf(cmd,sizeof(cmd),"%s%s %s %s-c -t %d -T %d -O \"%s\" -o "
+                   "\"%s\"%s\n",env,FTP_CMD,path->remot,opt,FTP_RETRY,
+                   FTP_TIMEOUT,partfile,errfile,opt2);
+    }
+    if (n>=(int)sizeof(cmd)) {
+        trace(2,"exec_down: command too long %s\n",path->remot);
+        log_down(pool,"X",3,"%s -> %s ERROR (COMMAND)\n",path->remot,dir);
+        return DL_DONE;
     }
-    if (fp) fprintf(fp,"%s -> %s",path->remot,dir);
-    
     /* execute download command */
     if ((ret=execcmd_to(cmd))) {
         if ((proto==0&&ret==FTP_NOFILE)||
-            (proto==1&&ret==HTTP_NOFILE)) {
-            showmsg("STAT=x");
-            if (fp) fprintf(fp," NO_FILE\n");
-            n[1]++;
+            (proto==1&&ret==HTTP_NOFILE)||test_nofile(errfile)) {
+            log_down(pool,"x",1,"%s -> %s NO_FILE\n",path->remot,dir);
+            remove(partfile);
         }
-        else {
+        else if (ret!=2&&path->ntry<dl_nretry) { /* retry later */
+            trace(2,"exec_down: retry proto=%d %d ntry=%d\n",proto,ret,
+                  path->ntry+1);
+            rtklib_lock(&pool->lock);
+            pool->bytes+=file_size(partfile)-size;
+            rtklib_unlock(&pool->lock);
+            return DL_RETRY;
+        }
+        else { /* partial file kept to be resumed */
             trace(2,"exec_down: error proto=%d %d\n",proto,ret);
-            showmsg("STAT=X");
-            if (fp) fprintf(fp," ERROR (%d)\n",ret);
-            n[3]++;
+            log_down(pool,"X",3,"%s -> %s ERROR (%d)\n",path->remot,dir,ret);
         }
-        remove(path->local);
-        if (!(opts&DLOPT_HOLDERR)) {
+        if (!(pool->opts&DLOPT_HOLDERR)) {
             remove(errfile);
         }
-        return ret==2;
+        return ret==2?DL_ABORT:DL_DONE;
     }
     remove(errfile);
     
+    rtklib_lock(&pool->lock);
+    pool->bytes+=file_size(partfile)-size;
+    rtklib_unlock(&pool->lock);
+    
+    /* complete partial file */
+    remove(path->local);
+    if (rename(partfile,path->local)) {
+        log_down(pool,"X",3,"%s -> %s ERROR (LOCAL FILE)\n",path->remot,dir);
+        return DL_DONE;
+    }
     /* uncompress download file */
-    if (!(opts&DLOPT_KEEPCMP)&&(p=strrchr(path->local,'.'))&&
+    if (!(pool->opts&DLOPT_KEEPCMP)&&(p=strrchr(path->local,'.'))&&
         (!strcmp(p,".z")||!strcmp(p,".gz")||!strcmp(p,".zip")||
          !strcmp(p,".Z")||!strcmp(p,".GZ")||!strcmp(p,".ZIP"))) {
         
@@ -547,17 +683,145 @@ static int exec_down(path_t *path, char *remot_p, const char *usr,
         }
         else {
             trace(2,"exec_down: uncompress error\n");
-            showmsg("STAT=C");
-            if (fp) fprintf(fp," ERROR (UNCOMP)\n");
-            n[3]++;
-            return 0;
+            log_down(pool,"C",3,"%s -> %s ERROR (UNCOMP)\n",path->remot,dir);
+            return DL_DONE;
+        }
+    }
+    log_down(pool,"o",0,"%s -> %s OK\n",path->remot,dir);
+    return DL_DONE;
+}
+/* select next download path -------------------------------------------------*/
+static int next_path(dlpool_t *pool)
+{
+    path_t *path=pool->paths->path;
+    uint32_t tick=tickget();
+    int i;
+    
+    while (pool->next<pool->paths->n&&path[pool->next].stat==2) pool->next++;
+    
+    for (i=pool->next;i<pool->paths->n;i++) {
+        if (path[i].stat||pool->active[path[i].host]>=dl_nhost) continue;
+        if (path[i].ntry>0&&(int)(tick-path[i].tnext)<0) continue;
+        return i;
+    }
+    return -1;
+}
+/* download thread -----------------------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI dlthread(void *arg)
+#else
+static void *dlthread(void *arg)
+#endif
+{
+    dlpool_t *pool=(dlpool_t *)arg;
+    path_t *path;
+    double t,rate;
+    int i,ret;
+    
+    lock_msg=&pool->lock_msg;
+    
+    for (;;) {
+        rtklib_lock(&pool->lock);
+        if (pool->abort||pool->ndone>=pool->paths->n) {
+            rtklib_unlock(&pool->lock);
+            break;
         }
+        if ((i=next_path(pool))>=0) {
+            path=pool->paths->path+i;
+            path->stat=1;
+            pool->active[path->host]++;
+        }
+        t=(tickget()-pool->tick)*1E-3;
+        rate=t>0.0?pool->bytes/t*1E-6:0.0;
+        rtklib_unlock(&pool->lock);
+        
+        if (i<0) { /* wait for transfers by host or retry */
+            sleepms(10);
+            continue;
+        }
+        /* progress and throughput */
+        if (dlmsg("%s->%s (%d/%d %.2f MB/s)",path->remot,path->local,i+1,
+                  pool->paths->n,rate)) {
+            ret=DL_ABORT;
+        }
+        /* execute download */
+        else ret=exec_down(pool,path);
+        
+        rtklib_lock(&pool->lock);
+        pool->active[path->host]--;
+        if (ret==DL_RETRY) { /* retry with exponential backoff */
+            path->stat=0;
+            path->tnext=tickget()+(uint32_t)(dl_tretry*1E3*(1<<path->ntry));
+            path->ntry++;
+        }
+        else {
+            path->stat=2;
+            pool->ndone++;
+            if (ret==DL_ABORT) pool->abort=1;
+        }
+        rtklib_unlock(&pool->lock);
     }
-    showmsg("STAT=o");
-    if (fp) fprintf(fp," OK\n");
-    n[0]++;
+    lock_msg=NULL;
     return 0;
 }
+/* host index of remote path -------------------------------------------------*/
+static int host_index(dlpool_t *pool, const char *remot)
+{
+    const char *p,*q;
+    char host[256]="";
+    int i;
+    
+    if ((p=strstr(remot,"://"))) {
+        p+=3;
+        if (!(q=strchr(p,'/'))) q=p+strlen(p);
+        if (q-p<(int)sizeof(host)) {
+            strncpy(host,p,q-p);
+            host[q-p]='\0';
+        }
+    }
+    for (i=0;i<pool->nhost;i++) {
+        if (!strcmp(pool->host[i],host)) return i;
+    }
+    if (pool->nhost>=MAX_HOST) return MAX_HOST-1; /* share last host */
+    strcpy(pool->host[pool->nhost],host);
+    return pool->nhost++;
+}
+/* execute download by threads -----------------------------------------------*/
+static void exec_downs(dlpool_t *pool)
+{
+    rtklib_thread_t thread[MAX_THREAD];
+    int i,n,nthread;
+    
+    rtklib_initlock(&pool->lock);
+    rtklib_initlock(&pool->lock_list);
+    rtklib_initlock(&pool->lock_msg);
+    
+    for (i=0;i<pool->paths->n;i++) {
+        pool->paths->path[i].host=host_index(pool,pool->paths->path[i].remot);
+    }
+    nthread=MIN(MIN(dl_nthread,MAX_THREAD),pool->paths->n);
+    
+    trace(3,"exec_downs: n=%d nhost=%d nthread=%d\n",pool->paths->n,
+          pool->nhost,nthread);
+    
+    for (n=0;n<nthread&&nthread>1;n++) {
+#ifdef WIN32
+        if (!(thread[n]=CreateThread(NULL,0,dlthread,pool,0,NULL))) break;
+#else
+        if (pthread_create(thread+n,NULL,dlthread,pool)) break;
+#endif
+    }
+    if (n<=0) dlthread(pool); /* single thread or no thread available */
+    
+    for (i=0;i<n;i++) {
+#ifdef WIN32
+        WaitForSingleObject(thread[i],INFINITE);
+        CloseHandle(thread[i]);
+#else
+        pthread_join(thread[i],NULL);
+#endif
+    }
+}
 /* test local file -----------------------------------------------------------*/
 static int test_local(gtime_t ts, gtime_t te, double ti, const char *path,
                       const char *sta, const char *dir, int *nc, int *nt,
@@ -771,6 +1035,13 @@ extern int dl_readstas(const char *file, char **stas, int nmax)
 *          the remote directory and downloads the firstly matched file in the
 *          remote file-list. The secondary matched or the following files are
 *          not downloaded.
+*          Files are downloaded sequentially in the calling thread by default.
+*          If concurrent download is enabled by dl_setconc(), files are
+*          downloaded by threads with the limit of transfers by host, and
+*          showmsg() is called from the threads (serialized by a lock) which
+*          should be safe for the application. A failed transfer is retried
+*          with backoff and continued from the partial file (*.part), which
+*          is renamed to the local file after completion.
 *-----------------------------------------------------------------------------*/
 extern int dl_exec(gtime_t ts, gtime_t te, double ti, int seqnos, int seqnoe,
                    const url_t *urls, int nurl, const char **stas, int nsta,
@@ -778,10 +1049,10 @@ extern int dl_exec(gtime_t ts, gtime_t te, double ti, int seqnos, int seqnoe,
                    const char *proxy, int opts, char *msg, FILE *fp)
 {
     paths_t paths={0};
+    dlpool_t *pool;
     gtime_t ts_p={0};
-    char str[2048],remot_p[1024]="";
-    int i,n[4]={0};
-    uint32_t tick=tickget();
+    double t;
+    int i;
     
     showmsg("STAT=_");
     
@@ -804,27 +1075,52 @@ extern int dl_exec(gtime_t ts, gtime_t te, double ti, int seqnos, int seqnoe,
         sprintf(msg,"no download data");
         return 0;
     }
-    for (i=0;i<paths.n;i++) {
-        
-        sprintf(str,"%s->%s (%d/%d)",paths.path[i].remot,paths.path[i].local,i+1,
-                paths.n);
-        if (showmsg(str)) break;
-        
-        /* execute download */
-        if (exec_down(paths.path+i,remot_p,usr,pwd,proxy,opts,n,fp)) {
-            break;
-        }
+    if (!(pool=(dlpool_t *)calloc(1,sizeof(dlpool_t)))) {
+        free_path(&paths);
+        sprintf(msg,"memory allocation error");
+        return 0;
     }
+    pool->paths=&paths;
+    pool->usr=usr;
+    pool->pwd=pwd;
+    pool->proxy=proxy;
+    pool->opts=opts;
+    pool->fp=fp;
+    pool->tick=tickget();
+    
+    /* execute download by threads */
+    exec_downs(pool);
+    
     if (!(opts&DLOPT_HOLDLST)) {
         remove(FTP_LISTING);
     }
-    sprintf(msg,"OK=%d No_File=%d Skip=%d Error=%d (Time=%.1f s)",n[0],n[1],n[2],
-            n[3],(tickget()-tick)*0.001);
+    t=(tickget()-pool->tick)*0.001;
+    sprintf(msg,"OK=%d No_File=%d Skip=%d Error=%d (Time=%.1f s %.2f MB/s)",
+            pool->n[0],pool->n[1],pool->n[2],pool->n[3],t,
+            t>0.0?pool->bytes/t*1E-6:0.0);
     
+    free(pool);
     free_path(&paths);
     
     return 1;
 }
+/* set download concurrency ----------------------------------------------------
+* set concurrency of download by dl_exec()
+* args   : int    nthread   I   number of download threads (1:sequential)
+*          int    nhost     I   max number of concurrent transfers by host
+*          int    nretry    I   number of retries of failed transfers
+*          double tretry    I   retry backoff (s) doubled by every retry
+* return : none
+* notes  : defaults are nthread=1, nhost=2, nretry=2 and tretry=5.0
+*          with nthread>1, showmsg() is called from download threads
+*-----------------------------------------------------------------------------*/
+extern void dl_setconc(int nthread, int nhost, int nretry, double tretry)
+{
+    dl_nthread=nthread<1?1:nthread;
+    dl_nhost=nhost<1?1:nhost;
+    dl_nretry=nretry<0?0:nretry;
+    dl_tretry=tretry<0.0?0.0:tretry;
+}
 /* execute local file test -----------------------------------------------------
 * execute local file test
 * args   : gtime_t ts,te    I   time start and end
@@ -15,6 +15,9 @@
 *           2013/03/05 1.1 change api readtec()
 *                          fix problem in case of lat>85deg or lat<-85deg
 *           2014/02/22 1.2 fix problem on compiled as C++
+*           2026/10/18 1.3 search tec grid maps by binary search
+*                          share pierce point and interpolation weights
+*                          between tec grid maps in iontec()
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -22,6 +25,18 @@
 #define VAR_NOTEC   SQR(30.0)   /* variance of no tec */
 #define MIN_EL      0.0         /* min elevation angle (rad) */
 #define MIN_HGT     -1000.0     /* min user height (m) */
+#define MAXLAYER    8           /* max number of layers of pierce point cache */
+
+typedef struct {                /* pierce point of layer */
+    double rb,hion;             /* earth radius and layer height (km) */
+    double fs;                  /* slant factor */
+    double posp[2];             /* pierce point {lat,lon} (rad) */
+    double lats[3],lons[3];     /* grid of interpolation weights (deg) */
+    double lon;                 /* longitude of interpolation weights (rad) */
+    int i,j;                    /* grid index {lat,lon} */
+    double a,b;                 /* interpolation weights {lat,lon} */
+    int stat;                   /* interpolation weights status (1:valid) */
+} ipp_t;
 
 /* get index -----------------------------------------------------------------*/
 static int getindex(double value, const double *range)
@@ -329,15 +344,11 @@ extern void readtec(const char *file, nav_t *nav, int opt)
     /*    nav->cbias[i][0]=CLIGHT*dcb[i]*1E-9; */ /* ns->m */
     /* } */
 }
-/* interpolate tec grid data -------------------------------------------------*/
-static int interptec(const tec_t *tec, int k, const double *posp, double *value,
-                     double *rms)
+/* interpolation weights of tec grid ----------------------------------------*/
+static int tecweight(const tec_t *tec, const double *posp, int *i, int *j,
+                     double *a, double *b)
 {
-    double dlat,dlon,a,b,d[4]={0},r[4]={0};
-    int i,j,n,index;
-    
-    trace(3,"interptec: k=%d posp=%.2f %.2f\n",k,posp[0]*R2D,posp[1]*R2D);
-    *value=*rms=0.0;
+    double dlat,dlon;
     
     if (tec->lats[2]==0.0||tec->lons[2]==0.0) return 0;
     
@@ -346,14 +357,29 @@ static int interptec(const tec_t *tec, int k, const double *posp, double *value,
     if (tec->lons[2]>0.0) dlon-=floor( dlon/360)*360.0; /*  0<=dlon<360 */
     else                  dlon+=floor(-dlon/360)*360.0; /* -360<dlon<=0 */
     
-    a=dlat/tec->lats[2];
-    b=dlon/tec->lons[2];
-    i=(int)floor(a); a-=i;
-    j=(int)floor(b); b-=j;
+    *a=dlat/tec->lats[2];
+    *b=dlon/tec->lons[2];
+    *i=(int)floor(*a); *a-=*i;
+    *j=(int)floor(*b); *b-=*j;
+    return 1;
+}
+/* interpolate tec grid data -------------------------------------------------*/
+static int interptec(const tec_t *tec, int k, const ipp_t *ipp, double *value,
+                     double *rms)
+{
+    double a=ipp->a,b=ipp->b,d[4]={0},r[4]={0};
+    int i,n,index;
+    
+    trace(3,"interptec: k=%d posp=%.2f %.2f\n",k,ipp->posp[0]*R2D,ipp->lon*R2D);
+    *value=*rms=0.0;
+    
+    if (!ipp->stat) return 0;
     
     /* get gridded tec data */
     for (n=0;n<4;n++) {
-        if ((index=dataindex(i+(n%2),j+(n<2?0:1),k,tec->ndata))<0) continue;
+        if ((index=dataindex(ipp->i+(n%2),ipp->j+(n<2?0:1),k,tec->ndata))<0) {
+            continue;
+        }
         d[n]=tec->data[index];
         r[n]=tec->rms [index];
     }
@@ -376,12 +402,54 @@ static int interptec(const tec_t *tec, int k, const double *posp, double *value,
     }
     return 1;
 }
+/* pierce point and interpolation weights of layer ---------------------------*/
+static const ipp_t *layerppp(gtime_t time, const tec_t *tec, const double *pos,
+                             const double *azel, int opt, double hion,
+                             ipp_t *ipp)
+{
+    double posp[3]={0},rp;
+    
+    /* ionospheric pierce point position (shared by tec grid maps) */
+    if (ipp->rb!=tec->rb||ipp->hion!=hion) {
+        ipp->fs=ionppp(pos,azel,tec->rb,hion,posp);
+        
+        if (opt&2) {
+            /* modified single layer mapping function (M-SLM) ref [2] */
+            rp=tec->rb/(tec->rb+hion)*sin(0.9782*(PI/2.0-azel[1]));
+            ipp->fs=1.0/sqrt(1.0-rp*rp);
+        }
+        ipp->rb=tec->rb;
+        ipp->hion=hion;
+        ipp->posp[0]=posp[0];
+        ipp->posp[1]=posp[1];
+        ipp->lats[2]=0.0; /* invalidate interpolation weights */
+    }
+    posp[0]=ipp->posp[0];
+    posp[1]=ipp->posp[1];
+    if (opt&1) {
+        /* earth rotation correction (sun-fixed coordinate) */
+        posp[1]+=2.0*PI*timediff(time,tec->time)/86400.0;
+    }
+    /* interpolation weights (shared by tec grid maps with same grid) */
+    if (ipp->lats[2]==0.0||ipp->lon!=posp[1]||
+        ipp->lats[0]!=tec->lats[0]||ipp->lats[2]!=tec->lats[2]||
+        ipp->lons[0]!=tec->lons[0]||ipp->lons[2]!=tec->lons[2]) {
+        ipp->stat=tecweight(tec,posp,&ipp->i,&ipp->j,&ipp->a,&ipp->b);
+        ipp->lats[0]=tec->lats[0]; ipp->lats[2]=tec->lats[2];
+        ipp->lons[0]=tec->lons[0]; ipp->lons[2]=tec->lons[2];
+        ipp->lon=posp[1];
+    }
+    return ipp;
+}
 /* ionosphere delay by tec grid data -----------------------------------------*/
 static int iondelay(gtime_t time, const tec_t *tec, const double *pos,
-                    const double *azel, int opt, double *delay, double *var)
+                    const double *azel, int opt, ipp_t *ipps, double *delay,
+                    double *var)
 {
     const double fact=40.30E16/FREQL1/FREQL1; /* tecu->L1 iono (m) */
-    double fs,posp[3]={0},vtec,rms,hion,rp;
+    const ipp_t *ipp;
+    ipp_t tmp={0};
+    double vtec,rms,hion;
     int i;
     
     char tstr[40];
@@ -394,28 +462,36 @@ static int iondelay(gtime_t time, const tec_t *tec, const double *pos,
         
         hion=tec->hgts[0]+tec->hgts[2]*i;
         
-        /* ionospheric pierce point position */
-        fs=ionppp(pos,azel,tec->rb,hion,posp);
-        
-        if (opt&2) {
-            /* modified single layer mapping function (M-SLM) ref [2] */
-            rp=tec->rb/(tec->rb+hion)*sin(0.9782*(PI/2.0-azel[1]));
-            fs=1.0/sqrt(1.0-rp*rp);
+        /* pierce point and interpolation weights */
+        if (i<MAXLAYER) {
+            ipp=layerppp(time,tec,pos,azel,opt,hion,ipps+i);
         }
-        if (opt&1) {
-            /* earth rotation correction (sun-fixed coordinate) */
-            posp[1]+=2.0*PI*timediff(time,tec->time)/86400.0;
+        else {
+            tmp.rb=-1.0;
+            ipp=layerppp(time,tec,pos,azel,opt,hion,&tmp);
         }
         /* interpolate tec grid data */
-        if (!interptec(tec,i,posp,&vtec,&rms)) return 0;
+        if (!interptec(tec,i,ipp,&vtec,&rms)) return 0;
         
-        *delay+=fact*fs*vtec;
-        *var+=fact*fact*fs*fs*rms*rms;
+        *delay+=fact*ipp->fs*vtec;
+        *var+=fact*fact*ipp->fs*ipp->fs*rms*rms;
     }
     trace(4,"iondelay: delay=%7.2f std=%6.2f\n",*delay,sqrt(*var));
     
     return 1;
 }
+/* search tec grid map after time --------------------------------------------*/
+static int tecindex(gtime_t time, const nav_t *nav)
+{
+    int i=0,j=nav->nt,k;
+    
+    /* binary search of first map after time (nav->tec sorted by combtec()) */
+    while (i<j) {
+        k=(i+j)/2;
+        if (timediff(nav->tec[k].time,time)>0.0) j=k; else i=k+1;
+    }
+    return i;
+}
 /* ionosphere model by tec grid data -------------------------------------------
 * compute ionospheric delay by tec grid data
 * args   : gtime_t time     I   time (gpst)
@@ -434,8 +510,9 @@ static int iondelay(gtime_t time, const tec_t *tec, const double *pos,
 extern int iontec(gtime_t time, const nav_t *nav, const double *pos,
                   const double *azel, int opt, double *delay, double *var)
 {
+    ipp_t ipps[MAXLAYER];
     double dels[2],vars[2],a,tt;
-    int i,stat[2];
+    int i,j,stat[2];
     
     char tstr[40];
     trace(3,"iontec  : time=%s pos=%.1f %.1f azel=%.1f %.1f\n",time2str(time,tstr,0),
@@ -446,9 +523,8 @@ extern int iontec(gtime_t time, const nav_t *nav, const double *pos,
         *var=VAR_NOTEC;
         return 1;
     }
-    for (i=0;i<nav->nt;i++) {
-        if (timediff(nav->tec[i].time,time)>0.0) break;
-    }
+    i=tecindex(time,nav);
+    
     if (i==0||i>=nav->nt) {
         trace(2,"%s: tec grid out of period\n",time2str(time,tstr,0));
         return 0;
@@ -457,9 +533,10 @@ extern int iontec(gtime_t time, const nav_t *nav, const double *pos,
         trace(2,"tec grid time interval error\n");
         return 0;
     }
-    /* ionospheric delay by tec grid data */
-    stat[0]=iondelay(time,nav->tec+i-1,pos,azel,opt,dels  ,vars  );
-    stat[1]=iondelay(time,nav->tec+i  ,pos,azel,opt,dels+1,vars+1);
+    /* ionospheric delay by tec grid data (pierce points shared by maps) */
+    for (j=0;j<MAXLAYER;j++) ipps[j].rb=-1.0;
+    stat[0]=iondelay(time,nav->tec+i-1,pos,azel,opt,ipps,dels  ,vars  );
+    stat[1]=iondelay(time,nav->tec+i  ,pos,azel,opt,ipps,dels+1,vars+1);
     
     if (!stat[0]&&!stat[1]) {
         trace(2,"%s: tec grid out of area pos=%6.2f %7.2f azel=%6.1f %5.1f\n",
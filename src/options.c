@@ -27,6 +27,7 @@
 *           2020/11/30  1.12 change options pos1-frequency, pos1-ionoopt,
 *                             pos1-tropopt, pos1-sateph, pos1-navsys,
 *                             pos2-gloarmode,
+*           2026/10/18  1.13 add option file-cachedir
 *-----------------------------------------------------------------------------*/
 #define _POSIX_C_SOURCE 200112L
 #include "rtklib.h"
@@ -199,6 +200,7 @@ EXPORT opt_t sysopts[]={
     {"file-geexefile",  2,  (void *)&filopt_.geexe,      ""     },
     {"file-solstatfile",2,  (void *)&filopt_.solstat,    ""     },
     {"file-tracefile",  2,  (void *)&filopt_.trace,      ""     },
+    {"file-cachedir",   2,  (void *)&filopt_.cache,      ""     },
     
     {"",0,NULL,""} /* terminator */
 };
@@ -532,6 +534,7 @@ extern void resetsysopts(void)
     filopt_.blq    [0]='\0';
     filopt_.solstat[0]='\0';
     filopt_.trace  [0]='\0';
+    filopt_.cache  [0]='\0';
     elmask_=15.0;
     elmaskar_=0.0;
     elmaskhold_=0.0;
@@ -40,9 +40,11 @@
 *           2016/10/10  1.22 fix bug on identification of file fopt->blq
 *           2017/06/13  1.23 add smoother of velocity solution
 *           2020/11/30  1.24 use API sat2freq() to get carrier frequency
+*           2026/10/18  1.25 add option fopt->cache for product cache
 *                            fix bug on select best solution in static mode
 *                            delete function to use L2 instead of L5 PCV
 *                            writing solution file in binary mode
+*                            read input files by threads and merge obs data
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -52,6 +54,31 @@
 #define MAXPRCDAYS  100          /* max days of continuous processing */
 #define MAXINFILE   1000         /* max number of input files */
 #define MAXINVALIDTM 100         /* max number of invalid time marks */
+#define MAXRDTHREAD 8            /* max number of threads to read input files */
+#define MAXRDBUF    32           /* max number of input files read ahead */
+
+/* type definitions ----------------------------------------------------------*/
+
+typedef struct {                /* input file read buffer type */
+    int rcv;                    /* receiver number read as */
+    int stat;                   /* read status (1:ok,0:no data,-1:error) */
+    int done;                   /* read done flag */
+    obs_t obs;                  /* observation data */
+    nav_t *nav;                 /* navigation data (NULL: no data) */
+    sta_t sta;                  /* station parameters */
+} rdbuf_t;
+
+typedef struct {                /* input file reader pool type */
+    gtime_t ts,te;              /* time start/end of rover obs data */
+    double ti;                  /* time interval (s) */
+    const char **infile;        /* input files */
+    const prcopt_t *prcopt;     /* processing options */
+    rdbuf_t *buf;               /* read buffers */
+    int n,next;                 /* number of files, next file index */
+    int nmrg;                   /* number of files merged */
+    rtklib_lock_t lock;         /* lock flag */
+    rtklib_cond_t cond;         /* condition of file read or merged */
+} rdpool_t;
 
 /* constants/global variables ------------------------------------------------*/
 
@@ -729,12 +756,179 @@ static void freepreceph(nav_t *nav, sbs_t *sbs)
     if (fp_rtcm) fclose(fp_rtcm);
     free_rtcm(&rtcm);
 }
-/* read obs and nav data -----------------------------------------------------*/
+/* compare obs data by time, receiver and satellite -------------------------*/
+static int cmpobsd(const obsd_t *q1, const obsd_t *q2)
+{
+    double tt=timediff(q1->time,q2->time);
+    if (fabs(tt)>DTTOL) return tt<0?-1:1;
+    if (q1->rcv!=q2->rcv) return (int)q1->rcv-(int)q2->rcv;
+    return (int)q1->sat-(int)q2->sat;
+}
+/* sort obs data of a file ---------------------------------------------------*/
+static void sortobsf(obs_t *obs)
+{
+    obsd_t data;
+    int i,j,k;
+    
+    for (i=1;i<obs->n;i++) {
+        if (timediff(obs->data[i].time,obs->data[i-1].time)<-DTTOL) break;
+    }
+    if (i<obs->n) { /* epochs not in time order */
+        sortobs(obs);
+        return;
+    }
+    /* sort by satellite in each epoch */
+    for (i=0;i<obs->n;i=j) {
+        for (j=i+1;j<obs->n;j++) {
+            if (timediff(obs->data[j].time,obs->data[i].time)>DTTOL) break;
+            if (obs->data[j].sat>=obs->data[j-1].sat) continue;
+            data=obs->data[j];
+            for (k=j;k>i&&obs->data[k-1].sat>data.sat;k--) {
+                obs->data[k]=obs->data[k-1];
+            }
+            obs->data[k]=data;
+        }
+    }
+}
+/* read an input file to buffer ----------------------------------------------*/
+static void readfile(const rdpool_t *pool, rdbuf_t *buf, const char *file)
+{
+    gtime_t ts=pool->ts,te=pool->te;
+    
+    if (buf->rcv>1) {
+        // Expand the time span a little for base observations to support
+        // interpolation at the extents of the rover observations.
+        if (ts.time>=60) ts=timeadd(ts,-60);
+        if (te.time>0) te=timeadd(te,60);
+    }
+    if (!(buf->nav=(nav_t *)calloc(1,sizeof(nav_t)))) {
+        buf->stat=-1;
+        return;
+    }
+    initnavh(buf->nav);
+    
+    /* read rinex obs and nav file */
+    buf->stat=readrnxt(file,buf->rcv,ts,te,pool->ti,
+                       pool->prcopt->rnxopt[buf->rcv<=1?0:1],&buf->obs,
+                       buf->nav,&buf->sta);
+    if (buf->stat>=0) sortobsf(&buf->obs);
+}
+/* input file reader thread --------------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI rdthread(void *arg)
+#else
+static void *rdthread(void *arg)
+#endif
+{
+    rdpool_t *pool=(rdpool_t *)arg;
+    int i;
+    
+    rtklib_lock(&pool->lock);
+    while (pool->next<pool->n) {
+        if (pool->next>=pool->nmrg+MAXRDBUF) { /* wait for merge of files */
+            rtklib_condwait(&pool->cond,&pool->lock);
+            continue;
+        }
+        i=pool->next++;
+        rtklib_unlock(&pool->lock);
+        
+        readfile(pool,pool->buf+i,pool->infile[i]);
+        
+        rtklib_lock(&pool->lock);
+        pool->buf[i].done=1;
+        rtklib_condsignal(&pool->cond);
+    }
+    rtklib_unlock(&pool->lock);
+    return 0;
+}
+/* wait for input file read by threads ---------------------------------------*/
+static void waitfile(rdpool_t *pool, int i)
+{
+    rtklib_lock(&pool->lock);
+    pool->nmrg=i;
+    rtklib_condsignal(&pool->cond); /* wake up threads waiting for merge */
+    while (!pool->buf[i].done) rtklib_condwait(&pool->cond,&pool->lock);
+    rtklib_unlock(&pool->lock);
+}
+/* compare obs data of buffers (equal data in order of buffers) --------------*/
+static int cmpbuf(const rdbuf_t *buf, const int *ip, int a, int b)
+{
+    int c=cmpobsd(buf[a].obs.data+ip[a],buf[b].obs.data+ip[b]);
+    
+    return c?c:a-b;
+}
+/* sift down heap of obs data buffers ----------------------------------------*/
+static void siftdown(const rdbuf_t *buf, const int *ip, int *heap, int nh,
+                     int i)
+{
+    int j,k=heap[i];
+    
+    for (;(j=2*i+1)<nh;i=j) {
+        if (j+1<nh&&cmpbuf(buf,ip,heap[j+1],heap[j])<0) j++;
+        if (cmpbuf(buf,ip,heap[j],k)>=0) break;
+        heap[i]=heap[j];
+    }
+    heap[i]=k;
+}
+/* merge obs data of buffers ---------------------------------------------------
+* merge sorted obs data of buffers by k-way merge deleting duplicated data
+* return : number of epochs (-1: memory allocation error)
+*-----------------------------------------------------------------------------*/
+static int mergeobs(rdbuf_t *buf, int n, obs_t *obs)
+{
+    obsd_t *data,*p,*q=NULL;
+    int i,k,nh=0,nobs=0,nep=0,*ip=NULL,*heap=NULL;
+    
+    for (i=0;i<n;i++) nobs+=buf[i].obs.n;
+    if (nobs<=0) return 0;
+    
+    if (!(data=(obsd_t *)malloc(sizeof(obsd_t)*nobs))||
+        !(ip=(int *)calloc(n,sizeof(int)))||!(heap=(int *)malloc(sizeof(int)*n))) {
+        free(data); free(ip); free(heap);
+        return -1;
+    }
+    for (i=0;i<n;i++) if (buf[i].obs.n>0) heap[nh++]=i;
+    for (i=nh/2-1;i>=0;i--) siftdown(buf,ip,heap,nh,i);
+    
+    for (obs->n=0;nh>0;) {
+        k=heap[0];
+        p=buf[k].obs.data+ip[k];
+        
+        /* delete duplicated data */
+        if (!q||p->sat!=q->sat||p->rcv!=q->rcv||timediff(p->time,q->time)!=0.0) {
+            q=data+obs->n;
+            *q=*p;
+            obs->n++;
+        }
+        if (++ip[k]>=buf[k].obs.n) heap[0]=heap[--nh];
+        if (nh>0) siftdown(buf,ip,heap,nh,0);
+    }
+    free(ip); free(heap);
+    free(obs->data);
+    obs->data=data;
+    obs->nmax=nobs;
+    
+    /* number of epochs */
+    for (i=0;i<obs->n;i=k,nep++) {
+        for (k=i+1;k<obs->n;k++) {
+            if (timediff(obs->data[k].time,obs->data[i].time)>DTTOL) break;
+        }
+    }
+    return nep;
+}
+/* read obs and nav data -------------------------------------------------------
+* read input files by threads to buffers and merge them as read sequentially
+* notes  : receiver number of obs data is incremented by the index of input
+*          files with obs data read. the buffers are read assuming rover obs
+*          data in the first index and read again if it was not the case
+*-----------------------------------------------------------------------------*/
 static int readobsnav(gtime_t ts, gtime_t te, double ti, const char **infile,
                       const int *index, int n, const prcopt_t *prcopt,
                       obs_t *obs, nav_t *nav, sta_t *sta)
 {
-    int i,j,ind=0,nobs=0,rcv=1;
+    rdpool_t pool={{0}};
+    rtklib_thread_t thread[MAXRDTHREAD];
+    int i,j,ind=0,nobs=0,rcv=1,stat=1,nthread=0;
 
     char tstr[40];
     trace(3,"readobsnav: ts=%s n=%d\n",time2str(ts,tstr,0),n);
@@ -746,28 +940,94 @@ static int readobsnav(gtime_t ts, gtime_t te, double ti, const char **infile,
     nav->seph=NULL; nav->ns=nav->nsmax=0;
     nepoch=0;
 
+    if (n>0&&!(pool.buf=(rdbuf_t *)calloc(n,sizeof(rdbuf_t)))) {
+        checkbrk("error : insufficient memory");
+        trace(1,"insufficient memory\n");
+        return 0;
+    }
+    pool.ts=ts; pool.te=te; pool.ti=ti;
+    pool.infile=infile;
+    pool.prcopt=prcopt;
+    pool.n=n;
+    rtklib_initlock(&pool.lock);
+    rtklib_initcond(&pool.cond);
+    
+    /* read files by threads assuming rover obs data in the first index */
+    for (i=0;i<n;i++) pool.buf[i].rcv=index[i]==index[0]?1:2;
+    
+    for (;n>1&&nthread<MIN(n,MAXRDTHREAD);nthread++) {
+#ifdef WIN32
+        if (!(thread[nthread]=CreateThread(NULL,0,rdthread,&pool,0,NULL))) break;
+#else
+        if (pthread_create(thread+nthread,NULL,rdthread,&pool)) break;
+#endif
+    }
     for (i=0;i<n;i++) {
-        if (checkbrk("")) return 0;
-
+        if (checkbrk("")) {
+            stat=0;
+            break;
+        }
         if (index[i]!=ind) {
-            if (obs->n>nobs) rcv++;
-            ind=index[i]; nobs=obs->n;
-        }
-        gtime_t tsw = ts, tew = te;
-        if (rcv > 1) {
-          // Expand the time span a little for base observations to support
-          // interpolation at the extents of the rover observations.
-          if (tsw.time >= 60) tsw = timeadd(tsw, -60);
-          if (tew.time > 0) tew = timeadd(tew, 60);
-        }
-        /* read rinex obs and nav file */
-        if (readrnxt(infile[i],rcv,tsw,tew,ti,prcopt->rnxopt[rcv<=1?0:1],obs,nav,
-                     rcv<=2?sta+rcv-1:NULL)<0) {
+            if (nobs>0) rcv++;
+            ind=index[i]; nobs=0;
+        }
+        if (nthread>0) waitfile(&pool,i);
+        
+        /* read file if not read by threads or not read as rover or base */
+        if (nthread<=0||(rcv<=1)!=(pool.buf[i].rcv<=1)) {
+            freeobs(&pool.buf[i].obs);
+            if (pool.buf[i].nav) freenav(pool.buf[i].nav,0xFF);
+            free(pool.buf[i].nav);
+            pool.buf[i].rcv=rcv;
+            readfile(&pool,pool.buf+i,infile[i]);
+        }
+        if (pool.buf[i].stat<0||!mergenav(nav,pool.buf[i].nav)) {
             checkbrk("error : insufficient memory");
             trace(1,"insufficient memory\n");
-            return 0;
+            stat=0;
+            break;
         }
+        freenav(pool.buf[i].nav,0xFF);
+        free(pool.buf[i].nav);
+        pool.buf[i].nav=NULL;
+        
+        for (j=0;j<pool.buf[i].obs.n;j++) pool.buf[i].obs.data[j].rcv=rcv;
+        nobs+=pool.buf[i].obs.n;
+        
+        if (rcv<=2&&pool.buf[i].stat>0) sta[rcv-1]=pool.buf[i].sta;
+    }
+    /* stop threads */
+    rtklib_lock(&pool.lock);
+    pool.n=pool.next;
+    rtklib_condsignal(&pool.cond);
+    rtklib_unlock(&pool.lock);
+    
+    for (j=0;j<nthread;j++) {
+#ifdef WIN32
+        WaitForSingleObject(thread[j],INFINITE);
+        CloseHandle(thread[j]);
+#else
+        pthread_join(thread[j],NULL);
+#endif
+    }
+    rtklib_freecond(&pool.cond);
+    rtklib_freelock(&pool.lock);
+    
+    /* merge obs data */
+    if (stat&&(nepoch=mergeobs(pool.buf,i,obs))<0) {
+        checkbrk("error : insufficient memory");
+        trace(1,"insufficient memory\n");
+        nepoch=stat=0;
+    }
+    for (i=0;i<n;i++) {
+        freeobs(&pool.buf[i].obs);
+        if (pool.buf[i].nav) freenav(pool.buf[i].nav,0xFF);
+        free(pool.buf[i].nav);
     }
+    free(pool.buf);
+    
+    if (!stat) return 0;
+    
     if (obs->n<=0) {
         checkbrk("error : no obs data");
         trace(1,"\n");
@@ -778,9 +1038,6 @@ static int readobsnav(gtime_t ts, gtime_t te, double ti, const char **infile,
         trace(1,"\n");
         return 0;
     }
-    /* sort observation data */
-    nepoch=sortobs(obs);
-
     /* delete duplicated ephemeris */
     uniqnav(nav);
 
@@ -899,6 +1156,9 @@ static int openses(const prcopt_t *popt, const solopt_t *sopt,
     (void)popt; (void)nav;
     trace(3,"openses :\n");
 
+    /* set product cache directory */
+    setprodcache(fopt->cache);
+
     /* read satellite antenna parameters */
     if (*fopt->satantp&&!(readpcv(fopt->satantp,pcvs))) {
         showmsg("error : no sat ant pcv in %s",fopt->satantp);
@@ -923,8 +1183,15 @@ static int openses(const prcopt_t *popt, const solopt_t *sopt,
 /* close processing session ---------------------------------------------------*/
 static void closeses(nav_t *nav, pcvs_t *pcvs, pcvs_t *pcvr)
 {
+    int nhit,nmiss;
+
     trace(3,"closeses:\n");
 
+    /* product cache statistics */
+    if (getprodcache(&nhit,&nmiss)) {
+        trace(3,"product cache: hit=%d miss=%d\n",nhit,nmiss);
+    }
+
     /* free antenna parameters */
     free_pcvs(pcvs);
     free_pcvs(pcvr);
@@ -59,6 +59,7 @@
 *           2018/10/10 1.13 support api change of satexclude()
 *           2020/11/30 1.14 use sat2freq() to get carrier frequency
 *                           use E1-E5b for Galileo iono-free LC
+*           2026/10/18 1.15 add stage latency statistics in pppos()
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -1179,7 +1180,8 @@ extern void pppos(rtk_t *rtk, const obsd_t *obs, int n, const nav_t *nav)
     const prcopt_t *opt=&rtk->opt;
     double *rs,*dts,*var,*v,*H,*R,*azel,*xp,*Pp,dr[3]={0},std[3];
     char str[40];
-    int i,j,nv,info,svh[MAXOBS],exc[MAXOBS]={0},stat=SOLQ_SINGLE;
+    int i,j,nv,info,ar,svh[MAXOBS],exc[MAXOBS]={0},stat=SOLQ_SINGLE;
+    uint32_t t0;
 
     time2str(obs[0].time,str,2);
     trace(3,"pppos   : time=%s nx=%d n=%d\n",str,rtk->nx,n);
@@ -1196,7 +1198,9 @@ extern void pppos(rtk_t *rtk, const obsd_t *obs, int n, const nav_t *nav)
     udstate_ppp(rtk,obs,n,nav);
 
     /* satellite positions and clocks */
+    t0=latstart(rtk->lat);
     satposs(obs[0].time,obs,n,nav,rtk->opt.sateph,rs,dts,var,svh);
+    latadd(rtk->lat,LATSTG_SATPOS,t0);
 
     /* exclude measurements of eclipsing satellite (block IIA) */
     if (rtk->opt.posopt[3]) {
@@ -1220,15 +1224,20 @@ extern void pppos(rtk_t *rtk, const obsd_t *obs, int n, const nav_t *nav)
          * NOTE: use different limit for pre-fit residuals in first iteration
          *       by using argument post = -1
          */
+        t0=latstart(rtk->lat);
         if (!(nv=ppp_res(i==0?-1:0,obs,n,rs,dts,var,svh,dr,exc,nav,xp,rtk,v,H,R,azel))) {
             trace(2,"%s ppp (%d) no valid obs data\n",str,i+1);
             break;
         }
+        latadd(rtk->lat,LATSTG_RES,t0);
+        
         /* measurement update of ekf states */
+        t0=latstart(rtk->lat);
         if ((info=filter(xp,Pp,H,v,R,rtk->nx,nv))) {
             trace(2,"%s ppp (%d) filter error info=%d\n",str,i+1,info);
             break;
         }
+        latadd(rtk->lat,LATSTG_FILT,t0);
         /* postfit residuals */
         if (ppp_res(i+1,obs,n,rs,dts,var,svh,dr,exc,nav,xp,rtk,NULL,NULL,NULL,azel)) {
             matcpy(rtk->x,xp,rtk->nx,1);
@@ -1242,7 +1251,11 @@ extern void pppos(rtk_t *rtk, const obsd_t *obs, int n, const nav_t *nav)
     }
     if (stat==SOLQ_PPP) {
 
-        if (ppp_ar(rtk,obs,n,exc,nav,azel,xp,Pp)&&
+        t0=latstart(rtk->lat);
+        ar=ppp_ar(rtk,obs,n,exc,nav,azel,xp,Pp);
+        latadd(rtk->lat,LATSTG_AMB,t0);
+        
+        if (ar&&
             ppp_res(9,obs,n,rs,dts,var,svh,dr,exc,nav,xp,rtk,NULL,NULL,NULL,azel)) {
 
             matcpy(rtk->xa,xp,rtk->nx,1);
@@ -48,6 +48,8 @@
 *                           LC defined GPS/QZS L1-L2, GLO G1-G2, GAL E1-E5b,
 *                            BDS B1I-B2I and IRN L5-S for API satantoff()
 *                           fix bug on reading SP3 file extension
+*           2026/10/18 1.18 use API str2dec() for SP3 data fields
+*           2026/10/18 1.19 read SP3 files via product cache
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -178,7 +180,7 @@ static void readsp3b(FILE *fp, char type, int *sats, int ns, double *bfact,
     peph_t peph;
     gtime_t time;
     double val,std,base;
-    int i,j,sat,sys,prn,n=ns*(type=='P'?1:2),pred_o,pred_c,v;
+    int i,j,sat,sys,prn,n=ns*(type=='P'?1:2),pred_o,pred_c,v,len;
     char buff[1024];
 
     trace(3,"readsp3b: type=%c ns=%d index=%d opt=%d\n",type,ns,index,opt);
@@ -211,7 +213,7 @@ static void readsp3b(FILE *fp, char type, int *sats, int ns, double *bfact,
         }
         for (i=pred_o=pred_c=v=0;i<n&&fgets(buff,sizeof(buff),fp);i++) {
 
-            if (strlen(buff)<4||(buff[0]!='P'&&buff[0]!='V')) continue;
+            if ((len=(int)strlen(buff))<4||(buff[0]!='P'&&buff[0]!='V')) continue;
 
             sys=buff[1]==' '?SYS_GPS:code2sys(buff[1]);
             prn=(int)str2num(buff,2,2);
@@ -221,8 +223,8 @@ static void readsp3b(FILE *fp, char type, int *sats, int ns, double *bfact,
             if (!(sat=satno(sys,prn))) continue;
 
             if (buff[0]=='P') {
-                pred_c=strlen(buff)>=76&&buff[75]=='P';
-                pred_o=strlen(buff)>=80&&buff[79]=='P';
+                pred_c=len>=76&&buff[75]=='P';
+                pred_o=len>=80&&buff[79]=='P';
             }
             for (j=0;j<4;j++) {
 
@@ -232,8 +234,8 @@ static void readsp3b(FILE *fp, char type, int *sats, int ns, double *bfact,
                 if (j==3&&(opt&1)&& pred_c) continue;
                 if (j==3&&(opt&2)&&!pred_c) continue;
 
-                val=str2num(buff, 4+j*14,14);
-                std=str2num(buff,61+j* 3,j<3?2:3);
+                val= 4+j*14<=len?str2dec(buff+ 4+j*14,14):0.0;
+                std=61+j* 3<=len?str2dec(buff+61+j* 3,j<3?2:3):0.0;
 
                 if (buff[0]=='P') { /* position */
                     if (val!=0.0&&fabs(val-999999.999999)>=1E-6) {
@@ -314,8 +316,8 @@ extern void readsp3(const char *file, nav_t *nav, int opt)
     FILE *fp;
     gtime_t time={0};
     double bfact[2]={0};
-    int i,j,n,ns,sats[MAXSAT]={0};
-    char *efiles[MAXEXFILE],*ext,type=' ',tsys[4]="";
+    int i,j,n,ns,sats[MAXSAT]={0},n0[7]={0};
+    char *efiles[MAXEXFILE],*ext,type=' ',tsys[4]="",sopt[16];
 
     trace(3,"readpephs: file=%s\n",file);
 
@@ -327,6 +329,7 @@ extern void readsp3(const char *file, nav_t *nav, int opt)
     }
     /* expand wild card in file path */
     n=expath(file,efiles,MAXEXFILE);
+    sprintf(sopt,"%d",opt);
 
     for (i=j=0;i<n;i++) {
         if (!(ext=strrchr(efiles[i],'.'))) continue;
@@ -334,6 +337,11 @@ extern void readsp3(const char *file, nav_t *nav, int opt)
         if (!strstr(ext,".sp3")&&!strstr(ext,".SP3")&&
             !strstr(ext,".eph")&&!strstr(ext,".EPH")) continue;
 
+        /* read from product cache */
+        if (loadprodcache(efiles[i],PCACHE_SP3,sopt,j,&type,nav,NULL,NULL)) {
+            j++;
+            continue;
+        }
         if (!(fp=fopen(efiles[i],"r"))) {
             trace(2,"sp3 file open error %s\n",efiles[i]);
             continue;
@@ -342,9 +350,14 @@ extern void readsp3(const char *file, nav_t *nav, int opt)
         ns=readsp3h(fp,&time,&type,sats,bfact,tsys);
 
         /* read sp3 body */
+        n0[3]=nav->ne;
         readsp3b(fp,type,sats,ns,bfact,tsys,j++,opt,nav);
 
         fclose(fp);
+
+        /* save to product cache */
+        n0[0]=nav->n; n0[1]=nav->ng; n0[2]=nav->ns; n0[4]=nav->nc;
+        saveprodcache(efiles[i],PCACHE_SP3,sopt,type,nav,n0,NULL,NULL);
     }
     for (i=0;i<MAXEXFILE;i++) free(efiles[i]);
 
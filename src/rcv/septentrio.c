@@ -40,6 +40,7 @@
 *           2024/01/12  1.11 update with new code from Tomoji TAKASU
 *           2024/06/16  1.12 restructed code, tested with Mosaic and PolarRx receivers
 *           2024/06/26  1.13 implemented reading new Meas3 records
+*           2026/10/18  1.14 add API input_sbfb()
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -114,6 +115,7 @@ extern int init_sbf(raw_t *raw) {
 #define SBF_SYNC1          0x24 /* SBF message header sync field 1 (correspond to $) */
 #define SBF_SYNC2          0x40 /* SBF message header sync field 2 (correspont to @)*/
 #define SBF_MAXSIG         39   /* SBF max signal number */
+#define SBF_HLEN           8    /* SBF block header length */
 
 /* Measurement Blocks */
 
@@ -4159,6 +4161,99 @@ extern int input_sbf(raw_t *raw, unsigned char data)
 
     return decode_sbf(raw);
 }
+/* input sbf raw data from buffer ----------------------------------------------
+* get sbf raw blocks from a buffer and input the first decoded block
+* args   : raw_t  *raw   IO     receiver raw data control struct
+*          uint8_t *buff I      stream data
+*          int    n      I      number of bytes in stream data
+*          int    *ret   O      status of input block (same as input_sbf())
+* return : number of bytes consumed (0-n)
+* notes  : sync fields are searched by memchr() and complete blocks are copied
+*          to raw->buff at once. a block split over buffers is kept in
+*          raw->buff/nbyte as the same state as input_sbf().
+*          the function returns when a block is input (*ret != 0) or all of
+*          the buffer is consumed. call it again with the rest of buffer.
+*-----------------------------------------------------------------------------*/
+extern int input_sbfb(raw_t *raw, const uint8_t *buff, int n, int *ret)
+{
+    const uint8_t *p;
+    int i = 0, j, k = 0, m, len = 0;
+
+    trace(5, "input_sbfb: n=%d\n", n);
+
+    *ret = 0;
+
+    /* sync field split over buffers */
+    if (n > 0 && raw->nbyte == 0 && raw->buff[1] == SBF_SYNC1 && buff[0] == SBF_SYNC2) {
+        raw->buff[0] = SBF_SYNC1;
+        raw->buff[1] = SBF_SYNC2;
+        raw->nbyte = 2;
+        i = 1;
+    }
+    while (i < n) {
+
+        /* complete block split over buffers */
+        if (raw->nbyte > 0) {
+            if (raw->nbyte < SBF_HLEN) {
+                m = n - i < SBF_HLEN - raw->nbyte ? n - i : SBF_HLEN - raw->nbyte;
+                memcpy(raw->buff + raw->nbyte, buff + i, m);
+                raw->nbyte += m;
+                i += m;
+                if (raw->nbyte < SBF_HLEN) break;
+                if ((raw->len = U2(raw->buff+6)) > MAXRAWLEN) {
+                    trace(2, "sbf length error: len=%d\n", raw->len);
+                    raw->nbyte = 0;
+                    *ret = -1;
+                    return i;
+                }
+            }
+            m = n - i < raw->len - raw->nbyte ? n - i : raw->len - raw->nbyte;
+            if (m > 0) {
+                memcpy(raw->buff + raw->nbyte, buff + i, m);
+                raw->nbyte += m;
+                i += m;
+            }
+            if (raw->nbyte < raw->len) break;
+            raw->nbyte = 0;
+            k = i;
+            if ((*ret = decode_sbf(raw))) return i;
+            continue;
+        }
+        /* search sync field */
+        if (!(p = (const uint8_t *)memchr(buff + i, SBF_SYNC1, n - i))) break;
+        j = (int)(p - buff);
+        if (j + 1 >= n) break;
+        if (p[1] != SBF_SYNC2) {
+            i = j + 1;
+            continue;
+        }
+        if (n - j >= SBF_HLEN && (len = U2(p+6)) > MAXRAWLEN) {
+            trace(2, "sbf length error: len=%d\n", len);
+            raw->buff[0] = SBF_SYNC1;
+            raw->buff[1] = SBF_SYNC2;
+            *ret = -1;
+            return j + SBF_HLEN;
+        }
+        /* block split over buffers */
+        if (n - j < SBF_HLEN || n - j < len) {
+            memcpy(raw->buff, p, n - j);
+            raw->nbyte = n - j;
+            if (raw->nbyte >= SBF_HLEN) raw->len = len;
+            return n;
+        }
+        if (len < SBF_HLEN) len = SBF_HLEN; /* same as input_sbf() */
+        memcpy(raw->buff, p, len);
+        raw->len = U2(p+6);
+        i = k = j + len;
+
+        if ((*ret = decode_sbf(raw))) return i;
+    }
+    /* keep last bytes for sync field split over buffers */
+    if (raw->nbyte == 0) {
+        for (j = n - 2 > k ? n - 2 : k; j < n; j++) sync_sbf(raw->buff, buff[j]);
+    }
+    return n;
+}
 /* sbf raw block finder --------------------------------------------------------
 * get to the next sbf raw block from file
 * args   : raw_t  *raw   IO     receiver raw data control struct
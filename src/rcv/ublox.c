@@ -75,6 +75,8 @@
 *                           support QZSS L1S (CODE_L1Z)
 *                           CODE_L1I -> CODE_L2I for BDS B1I (RINEX 3.04)
 *                           use integer types in stdint.h
+*           2026/10/18 1.29 add API input_ubxb()
+*                           thread-local carrier-phase states for parallel use
 *-----------------------------------------------------------------------------*/
 #define _POSIX_C_SOURCE 200112L
 #include "rtklib.h"
@@ -117,6 +119,8 @@ typedef enum { false, true } bool;
 #define CPSTD_SLIP 15                /* std-dev threshold for slip */
 
 #define ROUND(x)    (int)floor((x)+0.5)
+#define MIN(x,y)    ((x)<(y)?(x):(y))
+#define MAX(x,y)    ((x)>(y)?(x):(y))
 
 /* get fields (little-endian) ------------------------------------------------*/
 #define U1(p) (*((uint8_t *)(p)))
@@ -586,7 +590,7 @@ static int decode_navtime(raw_t *raw)
 /* decode UBX-TRK-MEAS: trace measurement data (unofficial) ------------------*/
 static int decode_trkmeas(raw_t *raw)
 {
-    static double adrs[MAXSAT]={0};
+    static THREADLOCAL double adrs[MAXSAT]={0};
     uint8_t *p=raw->buff+6;
     gtime_t time;
     double ts,tr=-1.0,t,tau,utc_gpst,snr,adr,dop;
@@ -726,7 +730,7 @@ static int decode_trkmeas(raw_t *raw)
 /* decode UBX-TRKD5: trace measurement data (unofficial) ---------------------*/
 static int decode_trkd5(raw_t *raw)
 {
-    static double adrs[MAXSAT]={0};
+    static THREADLOCAL double adrs[MAXSAT]={0};
     gtime_t time;
     double ts,tr=-1.0,t,tau,adr,dop,snr,utc_gpst;
     int i,j,n=0,type,off,len,sys,prn,sat,qi,frq,flag,week;
@@ -1458,6 +1462,93 @@ extern int input_ubx(raw_t *raw, uint8_t data)
     /* decode ublox raw message */
     return decode_ubx(raw);
 }
+/* input ublox raw messages from buffer ----------------------------------------
+* fetch ublox raw messages from a buffer and input the first decoded message
+* args   : raw_t  *raw   IO     receiver raw data control struct
+*          uint8_t *buff I      stream data
+*          int    n      I      number of bytes in stream data
+*          int    *ret   O      status of input message (same as input_ubx())
+* return : number of bytes consumed (0-n)
+* notes  : sync codes are searched by memchr() and complete frames are copied
+*          to raw->buff at once. a frame split over buffers is kept in
+*          raw->buff/nbyte as the same state as input_ubx().
+*          the function returns when a message is input (*ret!=0) or all of
+*          the buffer is consumed. call it again with the rest of buffer.
+*-----------------------------------------------------------------------------*/
+extern int input_ubxb(raw_t *raw, const uint8_t *buff, int n, int *ret)
+{
+    const uint8_t *p;
+    int i=0,j,k=0,m,len=0;
+    
+    trace(5,"input_ubxb: n=%d\n",n);
+    
+    *ret=0;
+    
+    /* sync code split over buffers */
+    if (n>0&&raw->nbyte==0&&raw->buff[1]==UBXSYNC1&&buff[0]==UBXSYNC2) {
+        raw->buff[0]=UBXSYNC1; raw->buff[1]=UBXSYNC2;
+        raw->nbyte=2;
+        i=1;
+    }
+    while (i<n) {
+        
+        /* complete frame split over buffers */
+        if (raw->nbyte>0) {
+            if (raw->nbyte<6) {
+                m=MIN(6-raw->nbyte,n-i);
+                memcpy(raw->buff+raw->nbyte,buff+i,m);
+                raw->nbyte+=m; i+=m;
+                if (raw->nbyte<6) break;
+                if ((raw->len=U2(raw->buff+4)+8)>MAXRAWLEN) {
+                    trace(2,"ubx length error: len=%d\n",raw->len);
+                    raw->nbyte=0;
+                    *ret=-1;
+                    return i;
+                }
+            }
+            m=MIN(raw->len-raw->nbyte,n-i);
+            memcpy(raw->buff+raw->nbyte,buff+i,m);
+            raw->nbyte+=m; i+=m;
+            if (raw->nbyte<raw->len) break;
+            raw->nbyte=0;
+            k=i;
+            if ((*ret=decode_ubx(raw))) return i;
+            continue;
+        }
+        /* search sync code */
+        if (!(p=(const uint8_t *)memchr(buff+i,UBXSYNC1,n-i))) break;
+        j=(int)(p-buff);
+        if (j+1>=n) break;
+        if (p[1]!=UBXSYNC2) {
+            i=j+1;
+            continue;
+        }
+        if (n-j>=6&&(len=U2((uint8_t *)p+4)+8)>MAXRAWLEN) {
+            trace(2,"ubx length error: len=%d\n",len);
+            raw->buff[0]=UBXSYNC1; raw->buff[1]=UBXSYNC2;
+            *ret=-1;
+            return j+6;
+        }
+        /* frame split over buffers */
+        if (n-j<6||n-j<len) {
+            memcpy(raw->buff,p,n-j);
+            raw->nbyte=n-j;
+            if (raw->nbyte>=6) raw->len=len;
+            return n;
+        }
+        memcpy(raw->buff,p,len);
+        raw->len=len;
+        i=k=j+len;
+        
+        /* decode ublox raw message */
+        if ((*ret=decode_ubx(raw))) return i;
+    }
+    /* keep last bytes for sync code split over buffers */
+    if (raw->nbyte==0) {
+        for (j=MAX(k,n-2);j<n;j++) sync_ubx(raw->buff,buff[j]);
+    }
+    return n;
+}
 /* input ublox raw message from file -------------------------------------------
 * fetch next ublox raw data and input a message from file
 * args   : raw_t  *raw   IO     receiver raw data control struct
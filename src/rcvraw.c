@@ -48,6 +48,7 @@
 *                           update references [1], [3] and [4]
 *                           add reference [6]
 *                           use integer types in stdint.h
+*           2026/10/18 1.18 add API input_rawb()
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -1445,6 +1446,36 @@ extern int input_raw(raw_t *raw, int format, uint8_t data)
     }
     return 0;
 }
+/* input receiver raw data from buffer -----------------------------------------
+* fetch receiver raw data from a buffer and input the first decoded message
+* args   : raw_t  *raw   IO     receiver raw data control struct
+*          int    format I      receiver raw data format (STRFMT_???)
+*          uint8_t *buff I      stream data
+*          int    n      I      number of bytes in stream data
+*          int    *ret   O      status of input message (same as input_raw())
+* return : number of bytes consumed (0-n)
+* notes  : the function returns when a message is input (*ret!=0) or all of
+*          the buffer is consumed. call it again with the rest of buffer.
+*          formats without framing by buffer are input by input_raw() byte by
+*          byte.
+*-----------------------------------------------------------------------------*/
+extern int input_rawb(raw_t *raw, int format, const uint8_t *buff, int n,
+                      int *ret)
+{
+    int i;
+    
+    trace(5,"input_rawb: format=%d n=%d\n",format,n);
+    
+    switch (format) {
+        case STRFMT_UBX : return input_ubxb(raw,buff,n,ret);
+        case STRFMT_SEPT: return input_sbfb(raw,buff,n,ret);
+    }
+    for (i=0;i<n;i++) {
+        if ((*ret=input_raw(raw,format,buff[i]))) return i+1;
+    }
+    *ret=0;
+    return n;
+}
 /* input receiver raw data from file -------------------------------------------
 * fetch next receiver raw data and input a message from file
 * args   : raw_t  *raw   IO     receiver raw data control struct
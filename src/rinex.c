@@ -116,12 +116,18 @@
 *                           use API code2idx() to get frequency index
 *                           use integer types in stdint.h
 *                           suppress warnings
+*           2026/10/18 1.31 format RINEX OBS/NAV body fields without printf
+*                           output RINEX OBS epoch/NAV record by one fwrite
+*                           use API str2dec() for OBS/NAV/CLK data fields
+*           2026/10/18 1.32 read RINEX NAV/CLK files via product cache
+*           2026/10/18 1.33 add api initnavh(),mergenav()
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
 /* constants/macros ----------------------------------------------------------*/
 
 #define SQR(x)      ((x)*(x))
+#define NOHDR       -9.87654321E99      /* navigation header not set */
 
 #define NAVEXP      "D"                 /* exponent letter in RINEX NAV */
 #define MAXRNXLEN   (16*MAXOBSTYPE+4)   /* max RINEX record length */
@@ -129,6 +135,7 @@
 #define MINFREQ_GLO -7                  /* min frequency number GLONASS */
 #define MAXFREQ_GLO 13                  /* max frequency number GLONASS */
 #define NINCOBS     262144              /* incremental number of obs data */
+#define MAXRNXBUFF  32768               /* max RINEX output buffer size */
 
 static const int navsys[RNX_NUMSYS]={ /* satellite systems */
     SYS_GPS,SYS_GLO,SYS_GAL,SYS_QZS,SYS_SBS,SYS_CMP,SYS_IRN
@@ -798,7 +805,7 @@ static int decode_obsdata(FILE *fp, char *buff, double ver, int mask,
     uint8_t lli[MAXOBSTYPE]={0};
     double std[MAXOBSTYPE]={0};
     char satid[8]="";
-    int i,j,n,m,q,stat=1,p[MAXOBSTYPE],k[16],l[16],r[16];
+    int i,j,n,m,q,len,stat=1,p[MAXOBSTYPE],k[16],l[16],r[16];
 
     trace(4,"decode_obsdata: ver=%.2f\n",ver);
 
@@ -823,17 +830,20 @@ static int decode_obsdata(FILE *fp, char *buff, double ver, int mask,
         case SYS_IRN: ind=index+6; break;
         default:      ind=index  ; break;
     }
+    len=(int)strlen(buff);
+
     for (i=0,j=ver<=2.99?0:3;i<ind->n;i++,j+=16) {
 
         if (ver<=2.99&&j>=80) { /* ver.2 */
             if (!fgets(buff,MAXRNXLEN,fp)) break;
+            len=(int)strlen(buff);
             j=0;
         }
         if (stat) {
-            val[i]=str2num(buff,j,14)+ind->shift[i];
-            lli[i]=(uint8_t)str2num(buff,j+14,1)&3;
+            val[i]=(j   <=len?str2dec(buff+j   ,14):0.0)+ind->shift[i];
+            lli[i]=(uint8_t)(j+14<=len?str2dec(buff+j+14,1):0.0)&3;
             /* measurement std from receiver, encoded */
-            std[i]=str2num(buff,j+15,1);
+            std[i]=j+15<=len?str2dec(buff+j+15,1):0.0;
         }
     }
     if (!stat) return 0;
@@ -1450,13 +1460,13 @@ static int readrnxnavb(FILE *fp, const char *opt, double ver, int sys,
             }
             /* decode data fields */
             for (j=0,p=buff+sp+19;j<3;j++,p+=19) {
-                data[i++]=str2num(p,0,19);
+                data[i++]=str2dec(p,19);
             }
         }
         else {
             /* decode data fields */
             for (j=0,p=buff+sp;j<4;j++,p+=19) {
-                data[i++]=str2num(p,0,19);
+                data[i++]=str2dec(p,19);
             }
             /* decode ephemeris */
             if (sys==SYS_GLO&&i>=nglo) {
@@ -1561,7 +1571,7 @@ static int readrnxclk(FILE *fp, const char *opt, double ver, int index, nav_t *n
     pclk_t *nav_pclk;
     gtime_t time;
     double data[2];
-    int i,j,sat,mask,off;
+    int i,j,sat,mask,off,len;
     char buff[MAXRNXLEN],satid[8]="";
 
     trace(3,"readrnxclk: index=%d\n", index);
@@ -1585,7 +1595,10 @@ static int readrnxclk(FILE *fp, const char *opt, double ver, int index, nav_t *n
 
         if (!(satsys(sat,NULL)&mask)) continue;
 
-        for (i=0,j=40+off;i<2;i++,j+=20) data[i]=str2num(buff,j,19);
+        len=(int)strlen(buff);
+        for (i=0,j=40+off;i<2;i++,j+=20) {
+            data[i]=j<=len?str2dec(buff+j,19):0.0;
+        }
 
         if (nav->nc>=nav->ncmax) {
             nav->ncmax+=1024;
@@ -1642,7 +1655,7 @@ static int readrnxfp(FILE *fp, gtime_t ts, gtime_t te, double tint,
     return 0;
 }
 /* uncompress and read RINEX file --------------------------------------------*/
-static int readrnxfile(const char *file, gtime_t ts, gtime_t te, double tint,
+static int readrnxpath(const char *file, gtime_t ts, gtime_t te, double tint,
                        const char *opt, int flag, int index, char *type,
                        obs_t *obs, nav_t *nav, sta_t *sta)
 {
@@ -1650,10 +1663,6 @@ static int readrnxfile(const char *file, gtime_t ts, gtime_t te, double tint,
     int cstat,stat;
     char tmpfile[1024];
 
-    trace(3,"readrnxfile: file=%s flag=%d index=%d\n",file,flag,index);
-
-    if (sta) init_sta(sta);
-
     /* uncompress file */
     if ((cstat=rtk_uncompress(file,tmpfile))<0) {
         trace(2,"rinex file uncompact error: %s\n",file);
@@ -1673,6 +1682,167 @@ static int readrnxfile(const char *file, gtime_t ts, gtime_t te, double tint,
 
     return stat;
 }
+/* initialize navigation header parameters as not set -------------------------
+* initialize navigation header parameters of a buffer as not set
+* args   : nav_t  *nav      IO  navigation data buffer
+* return : none
+* notes  : initialize a buffer of RINEX OBS/NAV files read by readrnxt() to
+*          merge the header parameters set in the files by mergenav()
+*-----------------------------------------------------------------------------*/
+extern void initnavh(nav_t *nav)
+{
+    int i;
+
+    for (i=0;i<8;i++) {
+        nav->utc_gps[i]=nav->utc_glo[i]=nav->utc_gal[i]=nav->utc_qzs[i]=NOHDR;
+        nav->utc_cmp[i]=nav->ion_gps[i]=nav->ion_qzs[i]=nav->ion_cmp[i]=NOHDR;
+        nav->ion_irn[i]=NOHDR;
+    }
+    for (i=0;i<9;i++) nav->utc_irn[i]=NOHDR;
+    for (i=0;i<4;i++) nav->utc_sbs[i]=nav->ion_gal[i]=NOHDR;
+    for (i=0;i<32;i++) nav->glo_fcn[i]=-1;
+}
+/* merge navigation header parameters set ------------------------------------*/
+static void merge_navh(double *dst, const double *src, int n)
+{
+    int i;
+
+    for (i=0;i<n;i++) if (src[i]!=NOHDR) dst[i]=src[i];
+}
+/* merge navigation data -------------------------------------------------------
+* merge navigation data read to a buffer as read to nav sequentially
+* args   : nav_t  *nav      IO  navigation data
+*          nav_t  *src      I   navigation data buffer initialized by initnavh()
+* return : status (1:ok,0:memory allocation error)
+*-----------------------------------------------------------------------------*/
+extern int mergenav(nav_t *nav, const nav_t *src)
+{
+    pclk_t *nav_pclk;
+    int i,j;
+
+    for (i=0;i<src->n ;i++) if (!add_eph (nav,src->eph +i)) return 0;
+    for (i=0;i<src->ng;i++) if (!add_geph(nav,src->geph+i)) return 0;
+    for (i=0;i<src->ns;i++) if (!add_seph(nav,src->seph+i)) return 0;
+
+    for (i=0;i<src->nc;i++) {
+
+        /* clock data at the same epoch as the last one of previous file */
+        if (i==0&&nav->nc>0&&
+            fabs(timediff(src->pclk[0].time,nav->pclk[nav->nc-1].time))<=1E-9) {
+            for (j=0;j<MAXSAT;j++) {
+                if (src->pclk[0].clk[j][0]==0.0&&src->pclk[0].std[j][0]==0.0f) {
+                    continue;
+                }
+                nav->pclk[nav->nc-1].clk[j][0]=src->pclk[0].clk[j][0];
+                nav->pclk[nav->nc-1].std[j][0]=src->pclk[0].std[j][0];
+            }
+            continue;
+        }
+        if (nav->nc>=nav->ncmax) {
+            nav->ncmax+=1024;
+            if (!(nav_pclk=(pclk_t *)realloc(nav->pclk,sizeof(pclk_t)*(nav->ncmax)))) {
+                trace(1,"mergenav malloc error: nmax=%d\n",nav->ncmax);
+                free(nav->pclk); nav->pclk=NULL; nav->nc=nav->ncmax=0;
+                return 0;
+            }
+            nav->pclk=nav_pclk;
+        }
+        nav->pclk[nav->nc++]=src->pclk[i];
+    }
+    merge_navh(nav->utc_gps,src->utc_gps,8);
+    merge_navh(nav->utc_glo,src->utc_glo,8);
+    merge_navh(nav->utc_gal,src->utc_gal,8);
+    merge_navh(nav->utc_qzs,src->utc_qzs,8);
+    merge_navh(nav->utc_cmp,src->utc_cmp,8);
+    merge_navh(nav->utc_irn,src->utc_irn,9);
+    merge_navh(nav->utc_sbs,src->utc_sbs,4);
+    merge_navh(nav->ion_gps,src->ion_gps,8);
+    merge_navh(nav->ion_gal,src->ion_gal,4);
+    merge_navh(nav->ion_qzs,src->ion_qzs,8);
+    merge_navh(nav->ion_cmp,src->ion_cmp,8);
+    merge_navh(nav->ion_irn,src->ion_irn,8);
+    for (i=0;i<32;i++) {
+        if (src->glo_fcn[i]>=0) nav->glo_fcn[i]=src->glo_fcn[i];
+    }
+    return 1;
+}
+/* read RINEX file via product cache -------------------------------------------
+* navigation data and clock data are read to a temporary buffer per file and
+* merged to nav as RINEX NAV/CLK files are read to nav sequentially
+*-----------------------------------------------------------------------------*/
+static int readrnxcache(const char *file, gtime_t ts, gtime_t te, double tint,
+                        const char *opt, int flag, int index, char *type,
+                        obs_t *obs, nav_t *nav, sta_t *sta)
+{
+    static const int n0[7]={0};
+    nav_t *tmp;
+    int stat=1,hit,prod,kind=flag?PCACHE_CLK:PCACHE_NAV;
+
+    if (!(tmp=(nav_t *)calloc(1,sizeof(nav_t)))) return 0;
+    initnavh(tmp);
+
+    if (!(hit=loadprodcache(file,kind,opt,index,type,tmp,NULL,NULL))) {
+        stat=readrnxpath(file,ts,te,tint,opt,flag,index,type,obs,tmp,sta);
+    }
+    prod=flag?*type=='C':*type&&strchr("NGHJL",*type);
+
+    if (!hit&&stat>0&&prod) {
+        saveprodcache(file,kind,opt,*type,tmp,n0,NULL,NULL);
+    }
+    if (stat>=0&&!mergenav(nav,tmp)) stat=-1;
+
+    /* status for data read to nav */
+    if (stat>=0&&prod) {
+        stat=flag?nav->nc>0:nav->n>0||nav->ng>0||nav->ns>0;
+    }
+    freenav(tmp,0xFF);
+    free(tmp);
+    return stat;
+}
+/* test RINEX OBS file by header or file name --------------------------------*/
+static int rnxobsfile(const char *file)
+{
+    FILE *fp;
+    char buff[MAXRNXLEN]="",name[1024],*p;
+    int n;
+
+    /* first header line of uncompressed file */
+    if ((fp=fopen(file,"r"))) {
+        if (!fgets(buff,sizeof(buff),fp)) buff[0]='\0';
+        fclose(fp);
+    }
+    if (strstr(buff,"CRINEX VERS")) return 1;
+    if (strstr(buff,"RINEX VERSION / TYPE")) return buff[20]=='O';
+
+    /* file name of compressed file (ssssdddf.yyo/d, *_MO.rnx/crx) */
+    if ((p=strrchr(file,RTKLIB_FILEPATHSEP))) file=p+1;
+    for (n=0;file[n]&&n<(int)sizeof(name)-1;n++) {
+        name[n]=(char)tolower((uint8_t)file[n]);
+    }
+    name[n]='\0';
+    if ((p=strrchr(name,'.'))&&(!strcmp(p,".z")||!strcmp(p,".gz"))) *p='\0';
+    if ((n=(int)strlen(name))>=4&&name[n-4]=='.'&&isdigit((uint8_t)name[n-3])&&
+        isdigit((uint8_t)name[n-2])&&(name[n-1]=='o'||name[n-1]=='d')) {
+        return 1;
+    }
+    return (p=strrchr(name,'.'))&&(!strcmp(p,".crx")||
+           (p-name>=3&&!strncmp(p-3,"_mo",3)));
+}
+/* read RINEX file -----------------------------------------------------------*/
+static int readrnxfile(const char *file, gtime_t ts, gtime_t te, double tint,
+                       const char *opt, int flag, int index, char *type,
+                       obs_t *obs, nav_t *nav, sta_t *sta)
+{
+    trace(3,"readrnxfile: file=%s flag=%d index=%d\n",file,flag,index);
+
+    if (sta) init_sta(sta);
+
+    /* product cache only for RINEX NAV/CLK files */
+    if (nav&&getprodcache(NULL,NULL)&&(flag||!rnxobsfile(file))) {
+        return readrnxcache(file,ts,te,tint,opt,flag,index,type,obs,nav,sta);
+    }
+    return readrnxpath(file,ts,te,tint,opt,flag,index,type,obs,nav,sta);
+}
 /* Add a RINEX comment, taking care of overflow ------------------------------
 * Returns 1 on success, and 0 if omitted or truncated.
 * The comment is append from the first empty comment, and it is assumed that
@@ -2320,22 +2490,58 @@ extern int outrnxobsh(FILE *fp, const rnxopt_t *opt, const nav_t *nav)
     }
     return fprintf(fp,"%-60.60s%-20s\n","","END OF HEADER")!=EOF;
 }
+/* format fixed-point value (%*.*f) -------------------------------------------
+* format fixed-point value without printf. the value near to the rounding
+* boundary is formatted by sprintf() to keep the same output as printf.
+*-----------------------------------------------------------------------------*/
+static char *fmtfix(char *p, double value, int width, int prec)
+{
+    static const double scale[]={1.0,1E1,1E2,1E3,1E4,1E5,1E6};
+    double a=fabs(value),y=a*scale[prec],f=y-floor(y);
+    uint64_t u;
+    char digit[32];
+    int i,n=0;
+    
+    if (!(y<1E12)||fabs(f-0.5)<1E-3) {
+        return p+sprintf(p,"%*.*f",width,prec,value);
+    }
+    u=(uint64_t)floor(y+0.5);
+    for (i=0;i<prec;i++,u/=10) digit[n++]='0'+(char)(u%10);
+    if (prec>0) digit[n++]='.';
+    do {
+        digit[n++]='0'+(char)(u%10);
+    } while (u/=10);
+    if (signbit(value)) digit[n++]='-';
+    for (i=n;i<width;i++) *p++=' ';
+    while (n>0) *p++=digit[--n];
+    return p;
+}
 /* output observation data field ---------------------------------------------*/
-static void outrnxobsf(FILE *fp, double obs, int lli, int std)
+static char *outrnxobsf(char *p, double obs, int lli, int std)
 {
     if (obs==0.0) {
-        fprintf(fp,"              ");
+        memset(p,' ',14);
+        p+=14;
     }
     else {
-        fprintf(fp,"%14.3f",fmod(obs,1e9));
+        p=fmtfix(p,fmod(obs,1e9),14,3);
     }
     if (lli<0||!(lli&(LLI_SLIP|LLI_HALFC|LLI_BOCTRK))) {
-        fprintf(fp," ");
+        *p++=' ';
     }
     else {
-        fprintf(fp,"%1.1d",lli&(LLI_SLIP|LLI_HALFC|LLI_BOCTRK));
+        *p++='0'+(lli&(LLI_SLIP|LLI_HALFC|LLI_BOCTRK));
     }
-    if (std<=0) fprintf(fp," "); else fprintf(fp,"%1.1x", std > 9 ? 9 : std);
+    *p++=std<=0?' ':'0'+(std>9?9:std);
+    return p;
+}
+/* flush RINEX output buffer -------------------------------------------------*/
+static int flushbuff(FILE *fp, const char *buff, char **p)
+{
+    size_t n=(size_t)(*p-buff);
+    
+    *p=(char *)buff;
+    return n==0||fwrite(buff,1,n,fp)==n;
 }
 /* search observation data index -------------------------------------------*/
 static int obsindex(int rnxver, int sys, const uint8_t *code, const char *tobs,
@@ -2402,30 +2608,31 @@ static int obsindex(int rnxver, int sys, const uint8_t *code, const char *tobs,
     return -1;
 }
 /* output rinex event time ---------------------------------------------------*/
-static void outrinexevent(FILE *fp, const rnxopt_t *opt, const obsd_t *obs,
-                          const double epdiff)
+static char *outrinexevent(char *p, const rnxopt_t *opt, const obsd_t *obs,
+                           const double epdiff)
 {
     int n;
     double epe[6];
 
     /* reject invalid time events (> 1 minute from timestamp of epoch)  */
     if (fabs(epdiff)>60) {
-        return;
+        return p;
     }
 
     time2epoch(obs[0].eventime,epe);
     n = obs->timevalid ? 0 : 1;
 
     if (opt->rnxver<=299) { /* ver.2 */
-        if (epdiff < 0) fprintf(fp,"\n");
-        fprintf(fp," %02d %02.0f %02.0f %02.0f %02.0f%11.7f  %d%3d",
-                (int)epe[0]%100,epe[1],epe[2],epe[3],epe[4],epe[5],5,n);
-        if (epdiff >= 0) fprintf(fp,"\n");
+        if (epdiff < 0) *p++='\n';
+        p+=sprintf(p," %02d %02.0f %02.0f %02.0f %02.0f%11.7f  %d%3d",
+                   (int)epe[0]%100,epe[1],epe[2],epe[3],epe[4],epe[5],5,n);
+        if (epdiff >= 0) *p++='\n';
     } else { /* ver.3 */
-        fprintf(fp,"> %04.0f %02.0f %02.0f %02.0f %02.0f%11.7f  %d%3d\n",
-                epe[0],epe[1],epe[2],epe[3],epe[4],epe[5],5,n);
+        p+=sprintf(p,"> %04.0f %02.0f %02.0f %02.0f %02.0f%11.7f  %d%3d\n",
+                   epe[0],epe[1],epe[2],epe[3],epe[4],epe[5],5,n);
     }
-    if (n) fprintf(fp,"%-60.60s%-20s\n"," Time mark is not valid","COMMENT");
+    if (n) p+=sprintf(p,"%-60.60s%-20s\n"," Time mark is not valid","COMMENT");
+    return p;
 }
 /* output RINEX observation data body ------------------------------------------
 * output RINEX observation data body
@@ -2435,13 +2642,14 @@ static void outrinexevent(FILE *fp, const rnxopt_t *opt, const obsd_t *obs,
 *          int    n         I   number of observation data
 *          int    flag      I   epoch flag (0:ok,1:power failure,>1:event flag)
 * return : status (1:ok, 0:output error)
+* notes  : the epoch is formatted into a buffer and output by one fwrite()
 *-----------------------------------------------------------------------------*/
 extern int outrnxobsb(FILE *fp, const rnxopt_t *opt, const obsd_t *obs, int n,
                       int flag)
 {
     double epdiff,ep[6],dL;
-    char sats[MAXOBS][4]={""};
-    int i,k,ns,sys,ind[MAXOBS],s[MAXOBS]={0};
+    char sats[MAXOBS][4]={""},buff[MAXRNXBUFF],*p=buff;
+    int i,k,ns,sys,ind[MAXOBS],s[MAXOBS]={0},stat=1;
 
     trace(3,"outrnxobsb: n=%d\n",n);
 
@@ -2474,23 +2682,27 @@ extern int outrnxobsb(FILE *fp, const rnxopt_t *opt, const obsd_t *obs, int n,
     time mark, else first output observation record */
     epdiff = timediff(obs[0].time,obs[0].eventime);
     if (flag == 5 && epdiff >= 0) {
-        outrinexevent(fp, opt, obs, epdiff);
+        p=outrinexevent(p, opt, obs, epdiff);
     }
     if (opt->rnxver<=299) { /* ver.2 */
-        fprintf(fp," %02d %02.0f %02.0f %02.0f %02.0f %010.7f  %d%3d",
-                (int)ep[0]%100,ep[1],ep[2],ep[3],ep[4],ep[5],0,ns);
+        p+=sprintf(p," %02d %02.0f %02.0f %02.0f %02.0f %010.7f  %d%3d",
+                   (int)ep[0]%100,ep[1],ep[2],ep[3],ep[4],ep[5],0,ns);
         for (i=0;i<ns;i++) {
-            if (i>0&&i%12==0) fprintf(fp,"\n%32s","");
-            fprintf(fp,"%-3s",sats[i]);
+            if (i>0&&i%12==0) p+=sprintf(p,"\n%32s","");
+            p+=sprintf(p,"%-3s",sats[i]);
         }
     }
     else { /* ver.3 */
-        fprintf(fp,"> %04.0f %02.0f %02.0f %02.0f %02.0f %010.7f  %d%3d%21s\n",
-                ep[0],ep[1],ep[2],ep[3],ep[4],ep[5],0,ns,"");
+        p+=sprintf(p,"> %04.0f %02.0f %02.0f %02.0f %02.0f %010.7f  %d%3d%21s\n",
+                   ep[0],ep[1],ep[2],ep[3],ep[4],ep[5],0,ns,"");
     }
     for (i=0;i<ns;i++) {
         sys=satsys(obs[ind[i]].sat,NULL);
 
+        /* flush buffer if no space for a satellite record */
+        if (p-buff>MAXRNXBUFF-2*MAXRNXLEN) {
+            if (!flushbuff(fp,buff,&p)) stat=0;
+        }
         int m;
         const char *mask;
         if (opt->rnxver<=299) { /* ver.2 */
@@ -2498,19 +2710,19 @@ extern int outrnxobsb(FILE *fp, const rnxopt_t *opt, const obsd_t *obs, int n,
             mask=opt->mask[s[i]];
         }
         else { /* ver.3 */
-            fprintf(fp,"%-3s",sats[i]);
+            p+=sprintf(p,"%-3s",sats[i]);
             m=s[i];
             mask=opt->mask[m];
         }
         for (int j=0;j<opt->nobs[m];j++) {
 
             if (opt->rnxver<=299) { /* ver.2 */
-                if (j%5==0) fprintf(fp,"\n");
+                if (j%5==0) *p++='\n';
             }
             /* search obs data index */
             if ((k=obsindex(opt->rnxver,sys,obs[ind[i]].code,opt->tobs[m][j],
                             mask))<0) {
-                outrnxobsf(fp,0.0,-1,-1);
+                p=outrnxobsf(p,0.0,-1,-1);
                 continue;
             }
             /* phase shift (cyc) */
@@ -2523,17 +2735,17 @@ extern int outrnxobsb(FILE *fp, const rnxopt_t *opt, const obsd_t *obs, int n,
                   // To RTKLib RINEX encoding
                   float std = obs[ind[i]].Pstd[k];
                   int stdi = std > 0.0003125 ? log2(std * 100) - 5 + 0.5 : 0;
-                  outrnxobsf(fp,obs[ind[i]].P[k],-1,stdi);
+                  p=outrnxobsf(p,obs[ind[i]].P[k],-1,stdi);
                   break;
                 }
                 case 'L': {
                   // To RTKLib RINEX encoding
                   int lstdi = obs[ind[i]].Lstd[k] / 0.004 + 0.5;
-                  outrnxobsf(fp,obs[ind[i]].L[k]+dL,obs[ind[i]].LLI[k],lstdi);
+                  p=outrnxobsf(p,obs[ind[i]].L[k]+dL,obs[ind[i]].LLI[k],lstdi);
                   break;
                 }
-                case 'D': outrnxobsf(fp,obs[ind[i]].D[k],-1,-1); break;
-                case 'S': outrnxobsf(fp,obs[ind[i]].SNR[k],-1,-1); break;
+                case 'D': p=outrnxobsf(p,obs[ind[i]].D[k],-1,-1); break;
+                case 'S': p=outrnxobsf(p,obs[ind[i]].SNR[k],-1,-1); break;
             }
         }
 
@@ -2549,27 +2761,61 @@ extern int outrnxobsb(FILE *fp, const rnxopt_t *opt, const obsd_t *obs, int n,
         }
 #endif
 
-        if (opt->rnxver>=300&&fprintf(fp,"\n")==EOF) return 0;
+        if (opt->rnxver>=300) *p++='\n';
     }
 
     if (flag == 5 && epdiff < 0) {
-        outrinexevent(fp, opt, obs, epdiff);
+        p=outrinexevent(p, opt, obs, epdiff);
     }
-    if (opt->rnxver>=300) return 1;
+    if (opt->rnxver<=299) *p++='\n';
 
-    return fprintf(fp,"\n")!=EOF;
+    if (!flushbuff(fp,buff,&p)) stat=0;
+    return stat;
+}
+/* format data field in RINEX navigation data --------------------------------
+* format data field (" %s.%0*.0f%s%+03.0f") without printf. the mantissa is
+* rounded half to even as printf.
+*-----------------------------------------------------------------------------*/
+static char *fmtnavf(char *p, double value, int n)
+{
+    double e=(fabs(value)<1E-99)?0.0:floor(log10(fabs(value))+1.0);
+    double m=fabs(value)/pow(10.0,e-n),r=floor(m),f=m-r;
+    uint64_t u;
+    char digit[32];
+    int k=0,exp;
+
+    if (!(m<1E15)||!(fabs(e)<1000.0)) {
+        return p+sprintf(p," %s.%0*.0f%s%+03.0f",value<0.0?"-":" ",n,m,NAVEXP,e);
+    }
+    u=(uint64_t)r;
+    if (f>0.5||(f==0.5&&(u&1))) u++;
+
+    for (;u>0||k<n;u/=10) {
+        digit[k++]='0'+(char)(u%10);
+    }
+    *p++=' ';
+    *p++=value<0.0?'-':' ';
+    *p++='.';
+    while (k>0) *p++=digit[--k];
+    *p++=NAVEXP[0];
+    exp=(int)e;
+    *p++=exp<0?'-':'+';
+    if (exp<0) exp=-exp;
+    if (exp>=100) *p++='0'+exp/100;
+    *p++='0'+exp/10%10;
+    *p++='0'+exp%10;
+    return p;
 }
 /* output data field in RINEX navigation data --------------------------------*/
 static void outnavf_n(FILE *fp, double value, int n)
 {
-    double e=(fabs(value)<1E-99)?0.0:floor(log10(fabs(value))+1.0);
+    char buff[64];
 
-    fprintf(fp," %s.%0*.0f%s%+03.0f",value<0.0?"-":" ",n,
-            fabs(value)/pow(10.0,e-n),NAVEXP,e);
+    fwrite(buff,1,fmtnavf(buff,value,n)-buff,fp);
 }
-static void outnavf(FILE *fp, double value)
+static char *outnavf(char *p, double value)
 {
-    outnavf_n(fp,value,12);
+    return fmtnavf(p,value,12);
 }
 /* output iono correction for a system ---------------------------------------*/
 static void out_iono_sys(FILE *fp, const char *sys, const double *ion, int n)
@@ -2751,7 +2997,7 @@ extern int outrnxnavb(FILE *fp, const rnxopt_t *opt, const eph_t *eph)
 {
     double ep[6],ttr;
     int week,sys,prn;
-    char code[32],*sep;
+    char code[32],*sep,buff[MAXRNXLEN],*p=buff;
 
     trace(3,"outrnxnavb: sat=%2d\n",eph->sat);
 
@@ -2767,76 +3013,76 @@ extern int outrnxnavb(FILE *fp, const rnxopt_t *opt, const eph_t *eph)
         (opt->rnxver>=302&&sys==SYS_QZS)||(opt->rnxver>=302&&sys==SYS_CMP)||
         (opt->rnxver>=303&&sys==SYS_IRN)) {
         if (!sat2code(eph->sat,code)) return 0;
-        fprintf(fp,"%-3s %04.0f %02.0f %02.0f %02.0f %02.0f %02.0f",code,ep[0],
-                ep[1],ep[2],ep[3],ep[4],ep[5]);
+        p+=sprintf(p,"%-3s %04.0f %02.0f %02.0f %02.0f %02.0f %02.0f",code,ep[0],
+                   ep[1],ep[2],ep[3],ep[4],ep[5]);
         sep="    ";
     }
     else if (opt->rnxver<=299&&sys==SYS_GPS) {
-        fprintf(fp,"%2d %02d %02.0f %02.0f %02.0f %02.0f %04.1f",prn,
-                (int)ep[0]%100,ep[1],ep[2],ep[3],ep[4],ep[5]);
+        p+=sprintf(p,"%2d %02d %02.0f %02.0f %02.0f %02.0f %04.1f",prn,
+                   (int)ep[0]%100,ep[1],ep[2],ep[3],ep[4],ep[5]);
         sep="   ";
     }
     else {
         return 0;
     }
-    outnavf(fp,eph->f0     );
-    outnavf(fp,eph->f1     );
-    outnavf(fp,eph->f2     );
-    fprintf(fp,"\n%s",sep  );
-
-    outnavf(fp,eph->iode   ); /* GPS/QZS: IODE, GAL: IODnav, BDS: AODE */
-    outnavf(fp,eph->crs    );
-    outnavf(fp,eph->deln   );
-    outnavf(fp,eph->M0     );
-    fprintf(fp,"\n%s",sep  );
-
-    outnavf(fp,eph->cuc    );
-    outnavf(fp,eph->e      );
-    outnavf(fp,eph->cus    );
-    outnavf(fp,sqrt(eph->A));
-    fprintf(fp,"\n%s",sep  );
-
-    outnavf(fp,eph->toes   );
-    outnavf(fp,eph->cic    );
-    outnavf(fp,eph->OMG0   );
-    outnavf(fp,eph->cis    );
-    fprintf(fp,"\n%s",sep  );
-
-    outnavf(fp,eph->i0     );
-    outnavf(fp,eph->crc    );
-    outnavf(fp,eph->omg    );
-    outnavf(fp,eph->OMGd   );
-    fprintf(fp,"\n%s",sep  );
-
-    outnavf(fp,eph->idot   );
-    outnavf(fp,eph->code   );
-    outnavf(fp,eph->week   ); /* GPS/QZS: GPS week, GAL: GAL week, BDS: BDT week */
+    p=outnavf(p,eph->f0     );
+    p=outnavf(p,eph->f1     );
+    p=outnavf(p,eph->f2     );
+    p+=sprintf(p,"\n%s",sep );
+
+    p=outnavf(p,eph->iode   ); /* GPS/QZS: IODE, GAL: IODnav, BDS: AODE */
+    p=outnavf(p,eph->crs    );
+    p=outnavf(p,eph->deln   );
+    p=outnavf(p,eph->M0     );
+    p+=sprintf(p,"\n%s",sep );
+
+    p=outnavf(p,eph->cuc    );
+    p=outnavf(p,eph->e      );
+    p=outnavf(p,eph->cus    );
+    p=outnavf(p,sqrt(eph->A));
+    p+=sprintf(p,"\n%s",sep );
+
+    p=outnavf(p,eph->toes   );
+    p=outnavf(p,eph->cic    );
+    p=outnavf(p,eph->OMG0   );
+    p=outnavf(p,eph->cis    );
+    p+=sprintf(p,"\n%s",sep );
+
+    p=outnavf(p,eph->i0     );
+    p=outnavf(p,eph->crc    );
+    p=outnavf(p,eph->omg    );
+    p=outnavf(p,eph->OMGd   );
+    p+=sprintf(p,"\n%s",sep );
+
+    p=outnavf(p,eph->idot   );
+    p=outnavf(p,eph->code   );
+    p=outnavf(p,eph->week   ); /* GPS/QZS: GPS week, GAL: GAL week, BDS: BDT week */
     if (sys==SYS_GPS||sys==SYS_QZS) {
-        outnavf(fp,eph->flag);
+        p=outnavf(p,eph->flag);
     }
     else {
-        outnavf(fp,0.0); /* spare */
+        p=outnavf(p,0.0); /* spare */
     }
-    fprintf(fp,"\n%s",sep  );
+    p+=sprintf(p,"\n%s",sep );
 
     if (sys==SYS_GAL) {
-        outnavf(fp,sisa_value(eph->sva));
+        p=outnavf(p,sisa_value(eph->sva));
     }
     else {
-        outnavf(fp,uravalue(eph->sva));
+        p=outnavf(p,uravalue(eph->sva));
     }
-    outnavf(fp,eph->svh    );
-    outnavf(fp,eph->tgd[0] ); /* GPS/QZS:TGD, GAL:BGD E5a/E1, BDS: TGD1 B1/B3 */
+    p=outnavf(p,eph->svh    );
+    p=outnavf(p,eph->tgd[0] ); /* GPS/QZS:TGD, GAL:BGD E5a/E1, BDS: TGD1 B1/B3 */
     if (sys==SYS_GAL||sys==SYS_CMP) {
-        outnavf(fp,eph->tgd[1]); /* GAL:BGD E5b/E1, BDS: TGD2 B2/B3 */
+        p=outnavf(p,eph->tgd[1]); /* GAL:BGD E5b/E1, BDS: TGD2 B2/B3 */
     }
     else if (sys==SYS_GPS||sys==SYS_QZS) {
-        outnavf(fp,eph->iodc);   /* GPS/QZS:IODC */
+        p=outnavf(p,eph->iodc);   /* GPS/QZS:IODC */
     }
     else {
-        outnavf(fp,0.0); /* spare */
+        p=outnavf(p,0.0); /* spare */
     }
-    fprintf(fp,"\n%s",sep  );
+    p+=sprintf(p,"\n%s",sep );
 
     if (sys!=SYS_CMP) {
         ttr=time2gpst(eph->ttr,&week);
@@ -2844,21 +3090,22 @@ extern int outrnxnavb(FILE *fp, const rnxopt_t *opt, const eph_t *eph)
     else {
         ttr=time2bdt(gpst2bdt(eph->ttr),&week); /* gpst -> bdt */
     }
-    outnavf(fp,ttr+(week-eph->week)*604800.0);
+    p=outnavf(p,ttr+(week-eph->week)*604800.0);
 
     if (sys==SYS_GPS) {
-        outnavf(fp,eph->fit);
+        p=outnavf(p,eph->fit);
     }
     else if (sys==SYS_QZS) {
-        outnavf(fp,eph->fit>2?1.0:0.0);
+        p=outnavf(p,eph->fit>2?1.0:0.0);
     }
     else if (sys==SYS_CMP) {
-        outnavf(fp,eph->iodc); /* AODC */
+        p=outnavf(p,eph->iodc); /* AODC */
     }
     else {
-        outnavf(fp,0.0); /* spare */
+        p=outnavf(p,0.0); /* spare */
     }
-    return fprintf(fp,"\n")!=EOF;
+    *p++='\n';
+    return fwrite(buff,1,p-buff,fp)==(size_t)(p-buff);
 }
 /* output RINEX GNAV file header -----------------------------------------------
 * output RINEX GNAV (GLONASS navigation data) file header
@@ -2908,7 +3155,7 @@ extern int outrnxgnavb(FILE *fp, const rnxopt_t *opt, const geph_t *geph)
     gtime_t toe;
     double ep[6],tof;
     int prn;
-    char code[32],*sep;
+    char code[32],*sep,buff[MAXRNXLEN],*p=buff;
 
     trace(3,"outrnxgnavb: sat=%2d\n",geph->sat);
 
@@ -2921,46 +3168,47 @@ extern int outrnxgnavb(FILE *fp, const rnxopt_t *opt, const geph_t *geph)
     time2epoch(toe,ep);
 
     if (opt->rnxver<=299) { /* ver.2 */
-        fprintf(fp,"%2d %02d %02.0f %02.0f %02.0f %02.0f %04.1f",prn,
-                (int)ep[0]%100,ep[1],ep[2],ep[3],ep[4],ep[5]);
+        p+=sprintf(p,"%2d %02d %02.0f %02.0f %02.0f %02.0f %04.1f",prn,
+                   (int)ep[0]%100,ep[1],ep[2],ep[3],ep[4],ep[5]);
         sep="   ";
     }
     else { /* ver.3 */
         if (!sat2code(geph->sat,code)) return 0;
-        fprintf(fp,"%-3s %04.0f %02.0f %02.0f %02.0f %02.0f %02.0f",code,ep[0],
-                ep[1],ep[2],ep[3],ep[4],ep[5]);
+        p+=sprintf(p,"%-3s %04.0f %02.0f %02.0f %02.0f %02.0f %02.0f",code,ep[0],
+                   ep[1],ep[2],ep[3],ep[4],ep[5]);
         sep="    ";
     }
-    outnavf(fp,-geph->taun     );
-    outnavf(fp,geph->gamn      );
-    outnavf(fp,tof             );
-    fprintf(fp,"\n%s",sep      );
+    p=outnavf(p,-geph->taun     );
+    p=outnavf(p,geph->gamn      );
+    p=outnavf(p,tof             );
+    p+=sprintf(p,"\n%s",sep     );
 
-    outnavf(fp,geph->pos[0]/1E3);
-    outnavf(fp,geph->vel[0]/1E3);
-    outnavf(fp,geph->acc[0]/1E3);
-    outnavf(fp,geph->svh & 1   );
-    fprintf(fp,"\n%s",sep      );
+    p=outnavf(p,geph->pos[0]/1E3);
+    p=outnavf(p,geph->vel[0]/1E3);
+    p=outnavf(p,geph->acc[0]/1E3);
+    p=outnavf(p,geph->svh & 1   );
+    p+=sprintf(p,"\n%s",sep     );
 
-    outnavf(fp,geph->pos[1]/1E3);
-    outnavf(fp,geph->vel[1]/1E3);
-    outnavf(fp,geph->acc[1]/1E3);
-    outnavf(fp,geph->frq       );
-    fprintf(fp,"\n%s",sep      );
+    p=outnavf(p,geph->pos[1]/1E3);
+    p=outnavf(p,geph->vel[1]/1E3);
+    p=outnavf(p,geph->acc[1]/1E3);
+    p=outnavf(p,geph->frq       );
+    p+=sprintf(p,"\n%s",sep     );
 
-    outnavf(fp,geph->pos[2]/1E3);
-    outnavf(fp,geph->vel[2]/1E3);
-    outnavf(fp,geph->acc[2]/1E3);
-    outnavf(fp,geph->age       );
+    p=outnavf(p,geph->pos[2]/1E3);
+    p=outnavf(p,geph->vel[2]/1E3);
+    p=outnavf(p,geph->acc[2]/1E3);
+    p=outnavf(p,geph->age       );
 
     if (opt->rnxver>=305) {
-      fprintf(fp,"\n%s",sep     );
-      outnavf(fp,geph->flags    );
-      outnavf(fp,geph->dtaun    );
-      outnavf(fp,geph->sva      );
-      outnavf(fp,(geph->svh >> 1) & 7);
+      p+=sprintf(p,"\n%s",sep    );
+      p=outnavf(p,geph->flags    );
+      p=outnavf(p,geph->dtaun    );
+      p=outnavf(p,geph->sva      );
+      p=outnavf(p,(geph->svh >> 1) & 7);
     }
-    return fprintf(fp,"\n")!=EOF;
+    *p++='\n';
+    return fwrite(buff,1,p-buff,fp)==(size_t)(p-buff);
 }
 /* output RINEX GEO navigation data file header --------------------------------
 * output RINEX GEO navigation data file header
@@ -3009,7 +3257,7 @@ extern int outrnxhnavb(FILE *fp, const rnxopt_t *opt, const seph_t *seph)
 {
     double ep[6];
     int prn;
-    char code[32],*sep;
+    char code[32],*sep,buff[MAXRNXLEN],*p=buff;
 
     trace(3,"outrnxhnavb: sat=%2d\n",seph->sat);
 
@@ -3018,39 +3266,40 @@ extern int outrnxhnavb(FILE *fp, const rnxopt_t *opt, const seph_t *seph)
     time2epoch(seph->t0,ep);
 
     if (opt->rnxver<=299) { /* ver.2 */
-        fprintf(fp,"%2d %02d %02.0f %02.0f %02.0f %02.0f %04.1f",prn-100,
-                (int)ep[0]%100,ep[1],ep[2],ep[3],ep[4],ep[5]);
+        p+=sprintf(p,"%2d %02d %02.0f %02.0f %02.0f %02.0f %04.1f",prn-100,
+                   (int)ep[0]%100,ep[1],ep[2],ep[3],ep[4],ep[5]);
         sep="   ";
     }
     else { /* ver.3 */
         if (!sat2code(seph->sat,code)) return 0;
-        fprintf(fp,"%-3s %04.0f %02.0f %02.0f %02.0f %02.0f %02.0f",code,ep[0],ep[1],
-                ep[2],ep[3],ep[4],ep[5]);
+        p+=sprintf(p,"%-3s %04.0f %02.0f %02.0f %02.0f %02.0f %02.0f",code,ep[0],ep[1],
+                   ep[2],ep[3],ep[4],ep[5]);
         sep="    ";
     }
-    outnavf(fp,seph->af0          );
-    outnavf(fp,seph->af1          );
-    outnavf(fp,time2gpst(seph->tof,NULL));
-    fprintf(fp,"\n%s",sep         );
-
-    outnavf(fp,seph->pos[0]/1E3   );
-    outnavf(fp,seph->vel[0]/1E3   );
-    outnavf(fp,seph->acc[0]/1E3   );
-    outnavf(fp,seph->svh          );
-    fprintf(fp,"\n%s",sep         );
-
-    outnavf(fp,seph->pos[1]/1E3   );
-    outnavf(fp,seph->vel[1]/1E3   );
-    outnavf(fp,seph->acc[1]/1E3   );
-    outnavf(fp,uravalue(seph->sva));
-    fprintf(fp,"\n%s",sep         );
-
-    outnavf(fp,seph->pos[2]/1E3   );
-    outnavf(fp,seph->vel[2]/1E3   );
-    outnavf(fp,seph->acc[2]/1E3   );
-    outnavf(fp,0                  );
-
-    return fprintf(fp,"\n")!=EOF;
+    p=outnavf(p,seph->af0          );
+    p=outnavf(p,seph->af1          );
+    p=outnavf(p,time2gpst(seph->tof,NULL));
+    p+=sprintf(p,"\n%s",sep        );
+
+    p=outnavf(p,seph->pos[0]/1E3   );
+    p=outnavf(p,seph->vel[0]/1E3   );
+    p=outnavf(p,seph->acc[0]/1E3   );
+    p=outnavf(p,seph->svh          );
+    p+=sprintf(p,"\n%s",sep        );
+
+    p=outnavf(p,seph->pos[1]/1E3   );
+    p=outnavf(p,seph->vel[1]/1E3   );
+    p=outnavf(p,seph->acc[1]/1E3   );
+    p=outnavf(p,uravalue(seph->sva));
+    p+=sprintf(p,"\n%s",sep        );
+
+    p=outnavf(p,seph->pos[2]/1E3   );
+    p=outnavf(p,seph->vel[2]/1E3   );
+    p=outnavf(p,seph->acc[2]/1E3   );
+    p=outnavf(p,0                  );
+
+    *p++='\n';
+    return fwrite(buff,1,p-buff,fp)==(size_t)(p-buff);
 }
 /* output RINEX Galileo NAV header ---------------------------------------------
 * output RINEX Galileo NAV file header (2.12)
@@ -44,6 +44,8 @@
 *                           delete references [2]-[6],[8],[9],[11]-[14]
 *                           update reference [17]
 *                           use integer types in stdint.h
+*           2026/10/18 1.13 add API input_rtcm3b()
+*                           input_rtcm3f() reads a whole frame by fread()
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -57,6 +59,8 @@ extern int encode_rtcm3(rtcm_t *rtcm, int type, int subtype, int sync);
 #define RTCM2PREAMB 0x66        /* rtcm ver.2 frame preamble */
 #define RTCM3PREAMB 0xD3        /* rtcm ver.3 frame preamble */
 
+#define MIN(x,y)    ((x)<(y)?(x):(y))
+
 /* initialize rtcm control -----------------------------------------------------
 * initialize rtcm control struct and reallocate memory for observation and
 * ephemeris buffer in rtcm control struct
@@ -303,6 +307,96 @@ extern int input_rtcm3(rtcm_t *rtcm, uint8_t data)
     /* decode rtcm3 message */
     return decode_rtcm3(rtcm);
 }
+/* resync rtcm 3 frame kept in buffer ---------------------------------------*/
+static void resync_rtcm3(rtcm_t *rtcm, int s, int q)
+{
+    for (;s<q;s++) if (rtcm->buff[s]==RTCM3PREAMB) break;
+    
+    if ((rtcm->nbyte=s<q?q-s:0)>0) memmove(rtcm->buff,rtcm->buff+s,rtcm->nbyte);
+    if (rtcm->nbyte>=3) rtcm->len=getbitu(rtcm->buff,14,10)+3;
+}
+/* input RTCM 3 messages from buffer -------------------------------------------
+* fetch RTCM 3 messages from a buffer and input the first decoded message
+* args   : rtcm_t *rtcm   IO  rtcm control struct
+*          uint8_t *buff  I   stream data
+*          int    n       I   number of bytes in stream data
+*          int    *ret    O   status of input message (same as input_rtcm3())
+* return : number of bytes consumed (0-n)
+* notes  : preambles are searched by memchr() and length and parity of complete
+*          frames are checked in place. only frames with valid parity are
+*          copied to rtcm->buff for decoding. a frame split over buffers is
+*          kept in rtcm->buff/nbyte as the same state as input_rtcm3().
+*          on parity error the search restarts at preamble+1 as input_rtcm3f().
+*          the function returns when a message is input (*ret!=0) or all of
+*          the buffer is consumed. call it again with the rest of buffer.
+*-----------------------------------------------------------------------------*/
+extern int input_rtcm3b(rtcm_t *rtcm, const uint8_t *buff, int n, int *ret)
+{
+    const uint8_t *p;
+    int i=0,j,k,m,q,len;
+    
+    trace(5,"input_rtcm3b: n=%d\n",n);
+    
+    *ret=0;
+    
+    while (i<n) {
+        
+        /* complete frame split over buffers */
+        if (rtcm->nbyte>0) {
+            q=rtcm->nbyte; /* bytes from previous buffers */
+            k=i;
+            if (rtcm->nbyte<3) {
+                m=MIN(3-rtcm->nbyte,n-i);
+                memcpy(rtcm->buff+rtcm->nbyte,buff+i,m);
+                rtcm->nbyte+=m; i+=m;
+                if (rtcm->nbyte<3) break;
+                rtcm->len=getbitu(rtcm->buff,14,10)+3; /* length without parity */
+            }
+            if (rtcm->nbyte<rtcm->len+3) {
+                m=MIN(rtcm->len+3-rtcm->nbyte,n-i);
+                memcpy(rtcm->buff+rtcm->nbyte,buff+i,m);
+                rtcm->nbyte+=m; i+=m;
+                if (rtcm->nbyte<rtcm->len+3) break;
+            }
+            if (rtk_crc24q(rtcm->buff,rtcm->len)!=getbitu(rtcm->buff,rtcm->len*8,24)) {
+                trace(2,"rtcm3 parity error: len=%d\n",rtcm->len);
+                resync_rtcm3(rtcm,1,q); /* rewind to last preamble+1 */
+                i=k;
+                continue;
+            }
+            q=rtcm->nbyte;
+            rtcm->nbyte=0;
+            *ret=decode_rtcm3(rtcm);
+            resync_rtcm3(rtcm,rtcm->len+3,q); /* rest of previous buffers */
+            if (*ret) return i;
+            continue;
+        }
+        /* search preamble */
+        if (!(p=(const uint8_t *)memchr(buff+i,RTCM3PREAMB,n-i))) break;
+        j=(int)(p-buff);
+        
+        /* frame split over buffers */
+        if (n-j<3||n-j<(len=getbitu(p,14,10)+3)+3) {
+            memcpy(rtcm->buff,p,n-j);
+            rtcm->nbyte=n-j;
+            if (rtcm->nbyte>=3) rtcm->len=getbitu(rtcm->buff,14,10)+3;
+            return n;
+        }
+        /* check parity in place */
+        if (rtk_crc24q(p,len)!=getbitu(p,len*8,24)) {
+            trace(2,"rtcm3 parity error: len=%d\n",len);
+            i=j+1;
+            continue;
+        }
+        memcpy(rtcm->buff,p,len+3);
+        rtcm->len=len;
+        i=j+len+3;
+        
+        /* decode rtcm3 message */
+        if ((*ret=decode_rtcm3(rtcm))) return i;
+    }
+    return n;
+}
 /* input RTCM 2 message from file ----------------------------------------------
 * fetch next RTCM 2 message and input a message from file
 * args   : rtcm_t *rtcm IO   rtcm control struct
@@ -333,17 +427,31 @@ extern int input_rtcm3f(rtcm_t *rtcm, FILE *fp)
 {
     int i,data=0,ret;
     
-    trace(4,"input_rtcm3f: data=%02x\n",data);
+    trace(4,"input_rtcm3f:\n");
     
     for (i=0;i<4096;i++) {
+        
+        /* synchronize frame */
         if ((data=fgetc(fp))==EOF) return -2;
-        if ((ret=input_rtcm3(rtcm,(uint8_t)data))) return ret;   /* ret!=0 indicates message complete */
-        if (rtcm->nbyte_invalid!=0) {               /* if last message had error: */
-            fseek(fp,-rtcm->nbyte_invalid+1,SEEK_CUR);  /* rewind to last preamble+1 */
-            i -= rtcm->nbyte_invalid-1;
-            trace(4,"rewind buff %3d bytes, i=%d\n",rtcm->nbyte_invalid-1,i);
-            rtcm->nbyte_invalid=0;
+        if (data!=RTCM3PREAMB) continue;
+        rtcm->buff[0]=(uint8_t)data;
+        
+        /* read header and rest of frame */
+        if (fread(rtcm->buff+1,1,2,fp)<2) return -2;
+        rtcm->len=getbitu(rtcm->buff,14,10)+3; /* length without parity */
+        if (fread(rtcm->buff+3,1,rtcm->len,fp)<(size_t)rtcm->len) return -2;
+        rtcm->nbyte=rtcm->nbyte_invalid=0;
+        
+        /* check parity */
+        if (rtk_crc24q(rtcm->buff,rtcm->len)!=getbitu(rtcm->buff,rtcm->len*8,24)) {
+            trace(2,"rtcm3 parity error: len=%d\n",rtcm->len);
+            fseek(fp,-(long)rtcm->len-2,SEEK_CUR); /* rewind to last preamble+1 */
+            continue;
         }
+        i+=rtcm->len+2;
+        
+        /* decode rtcm3 message */
+        if ((ret=decode_rtcm3(rtcm))) return ret;
     }
     return 0; /* return at every 4k bytes */
 }
@@ -142,6 +142,17 @@
 *                           update obs code strings and priority table
 *                           use integer types in stdint.h
 *                           suppress warnings
+*           2026/10/18 1.46 add API str2dec() to convert fixed-width field
+*                           without copy and use it in API readpcv()
+*           2026/10/18 1.47 add API setprodcache(), getprodcache(),
+*                           loadprodcache() and saveprodcache() for binary
+*                           cache of parsed product files
+*                           use product cache in API readpcv() and readerp()
+*           2026/10/18 1.48 add API tickgetus(), latinit(), latstart(),
+*                           latadd() and latquant() for stage latency
+*           2026/10/18 1.49 cache station and epoch dependent terms of
+*                           troposphere mapping function in API tropmapf()
+*           2026/10/18 1.50 add API condwaitms()
 *-----------------------------------------------------------------------------*/
 #define _POSIX_C_SOURCE 200112L
 #include <stdarg.h>
@@ -153,6 +164,11 @@
 #include <sys/time.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <sys/stat.h>
 #endif
 #include "rtklib.h"
 
@@ -160,10 +176,36 @@
 
 #define POLYCRC32   0xEDB88320u /* CRC32 polynomial */
 #define POLYCRC24Q  0x1864CFBu  /* CRC24Q polynomial */
+#define PCACHE_VER  1           /* product cache format version */
+#define LATWIN      60000       /* window of latency histograms (ms) */
+#define NMAPFC      4           /* number of cached troposphere mapping coef */
 
 #define SQR(x)      ((x)*(x))
 #define MAX_VAR_EPH SQR(300.0)  /* max variance eph to reject satellite (m^2) */
 
+/* increment/load counter shared between threads -----------------------------*/
+#ifdef WIN32
+#define ATOMIC_INC(p)   InterlockedIncrement((volatile LONG *)(p))
+#define ATOMIC_LOAD(p)  (*(volatile int *)(p))
+#elif defined(__GNUC__)
+#define ATOMIC_INC(p)   __atomic_add_fetch(p,1,__ATOMIC_RELAXED)
+#define ATOMIC_LOAD(p)  __atomic_load_n(p,__ATOMIC_RELAXED)
+#else
+#define ATOMIC_INC(p)   (++*(volatile int *)(p))
+#define ATOMIC_LOAD(p)  (*(volatile int *)(p))
+#endif
+
+typedef struct {                /* troposphere mapping function coef type */
+    int stat;                   /* status (0:empty,1:valid) */
+    gtime_t time;               /* time */
+    double pos[3];              /* receiver position {lat,lon,h} (rad,m) */
+#ifdef IERS_MODEL
+    double mjd,hgt;             /* mjd and height above mean sea level (m) */
+#else
+    double ah[3],aw[3];         /* hydrostatic/wet coefficients {a,b,c} */
+#endif
+} mapfc_t;
+
 static const double gpst0[]={1980,1, 6,0,0,0}; /* gps time reference */
 static const double gst0 []={1999,8,22,0,0,0}; /* galileo system time reference */
 static const double bdt0 []={2006,1, 1,0,0,0}; /* beidou time reference */
@@ -1128,8 +1170,8 @@ extern void matmul(const char *tr, int n, int k, int m,
     int lda=tr[0]=='T'?m:n,ldb=tr[1]=='T'?k:m;
     const double alpha=1,beta=0;
 
-    dgemm_((char *)tr,(char *)tr+1,&n,&k,&m,&alpha,(double *)A,&lda,(double *)B,
-           &ldb,&beta,C,&n);
+    dgemm_((char *)tr,(char *)tr+1,&n,&k,&m,(double *)&alpha,(double *)A,&lda,
+           (double *)B,&ldb,(double *)&beta,C,&n);
 }
 /* multiply matrix (wrapper of blas dgemm) -------------------------------------
 * multiply matrix by matrix (C=C+A*B)
@@ -1140,8 +1182,8 @@ extern void matmulp(const char *tr, int n, int k, int m,
     int lda=tr[0]=='T'?m:n,ldb=tr[1]=='T'?k:m;
     const double alpha=1,beta=1;
 
-    dgemm_((char *)tr,(char *)tr+1,&n,&k,&m,&alpha,(double *)A,&lda,(double *)B,
-           &ldb,&beta,C,&n);
+    dgemm_((char *)tr,(char *)tr+1,&n,&k,&m,(double *)&alpha,(double *)A,&lda,
+           (double *)B,&ldb,(double *)&beta,C,&n);
 }
 /* multiply matrix (wrapper of blas dgemm) -------------------------------------
 * multiply matrix by matrix (C=C-A*B)
@@ -1152,8 +1194,8 @@ extern void matmulm(const char *tr, int n, int k, int m,
     int lda=tr[0]=='T'?m:n,ldb=tr[1]=='T'?k:m;
     const double alpha=-1,beta=1;
     
-    dgemm_((char *)tr,(char *)tr+1,&n,&k,&m,&alpha,(double *)A,&lda,(double *)B,
-           &ldb,&beta,C,&n);
+    dgemm_((char *)tr,(char *)tr+1,&n,&k,&m,(double *)&alpha,(double *)A,&lda,
+           (double *)B,&ldb,(double *)&beta,C,&n);
 }
 /* inverse of matrix -----------------------------------------------------------
 * inverse of matrix (A=A^-1)
@@ -1567,22 +1609,14 @@ extern void setstr(char *dst, const char *src, int n)
     *p--='\0';
     while (p>=dst&&(*p==' '||*p=='\r'||*p=='\n'||*p=='\t')) *p--='\0';
 }
-/* string to number ------------------------------------------------------------
-* convert substring in string to number
-* args   : char   *s        I   string ("... nnn.nnn ...")
-*          int    i,n       I   substring position and width
-* return : converted number (0.0:error)
-*-----------------------------------------------------------------------------*/
-extern double str2num(const char *s, int i, int n)
+/* field to number by strtod() ---------------------------------------------*/
+static double str2num_s(const char *s, int n)
 {
     char str[256],*p=str;
 
-    if (i<0||(int)sizeof(str)-1<n) return 0.0;
-    /* Special case i==0, skipping the strlen check.
-     * Note: Could usefully use strnlen(s,i) here */
-    if (i>0&&(int)strlen(s)<i) return 0.0;
+    if (n>(int)sizeof(str)-1) n=(int)sizeof(str)-1;
 
-    for (s+=i;--n>=0;s++) {
+    for (;--n>=0;s++) {
         char c=*s;
         if (!c) break;
         *p++=((c|0x20)=='d')?'E':c;
@@ -1590,6 +1624,75 @@ extern double str2num(const char *s, int i, int n)
     *p='\0';
     return strtod(str,NULL);
 }
+/* fixed-width field to number -------------------------------------------------
+* convert fixed-width decimal field to number without copy of the field
+* args   : char   *s        I   field ("  nnn.nnn", "-n.nnnnD+nn", ...)
+*          int    n         I   field width (the field ends at '\0' in width)
+* return : converted number (0.0:error)
+* notes  : Fortran exponent letter D or d is accepted as E.
+*          the number is exact (same as strtod()) for F14.3, D19.12 and the
+*          other fields with significand < 2^53 and decimal exponent <= 22.
+*          other fields are converted by strtod().
+*-----------------------------------------------------------------------------*/
+extern double str2dec(const char *s, int n)
+{
+    static const double pow10[]={
+        1E0,1E1,1E2,1E3,1E4,1E5,1E6,1E7,1E8,1E9,1E10,1E11,1E12,1E13,1E14,
+        1E15,1E16,1E17,1E18,1E19,1E20,1E21,1E22
+    };
+    const char *p=s,*end=s+n;
+    uint64_t mant=0;
+    double val;
+    int neg=0,nd=0,nsig=0,e10=0,exp=0,eneg=0,ne=0;
+
+    while (p<end&&*p==' ') p++;
+    if (p<end&&(*p=='+'||*p=='-')) neg=*p++=='-';
+
+    for (;p<end&&'0'<=*p&&*p<='9';p++,nd++) { /* integer part */
+        if (!mant&&*p=='0') continue;
+        if (++nsig>19) return str2num_s(s,n);
+        mant=mant*10+(uint64_t)(*p-'0');
+    }
+    if (p<end&&*p=='.') { /* fraction part */
+        for (p++;p<end&&'0'<=*p&&*p<='9';p++,nd++,e10--) {
+            if (!mant&&*p=='0') continue;
+            if (++nsig>19) return str2num_s(s,n);
+            mant=mant*10+(uint64_t)(*p-'0');
+        }
+    }
+    if (!nd||(p<end&&(*p|0x20)=='x')) return str2num_s(s,n);
+
+    if (p<end&&((*p|0x20)=='e'||(*p|0x20)=='d')) { /* exponent */
+        if (++p<end&&(*p=='+'||*p=='-')) eneg=*p++=='-';
+        for (;p<end&&'0'<=*p&&*p<='9'&&ne<4;p++,ne++) {
+            exp=exp*10+(*p-'0');
+        }
+        if (!ne||(p<end&&'0'<=*p&&*p<='9')) return str2num_s(s,n);
+        e10+=eneg?-exp:exp;
+    }
+    if (mant>((uint64_t)1<<53)) return str2num_s(s,n);
+
+    if (!mant) val=0.0;
+    else if (e10>=0&&e10<=22) val=(double)mant*pow10[e10];
+    else if (e10<0&&e10>=-22) val=(double)mant/pow10[-e10];
+    else return str2num_s(s,n);
+
+    return neg?-val:val;
+}
+/* string to number ------------------------------------------------------------
+* convert substring in string to number
+* args   : char   *s        I   string ("... nnn.nnn ...")
+*          int    i,n       I   substring position and width
+* return : converted number (0.0:error)
+*-----------------------------------------------------------------------------*/
+extern double str2num(const char *s, int i, int n)
+{
+    if (i<0||255<n) return 0.0;
+    /* string shorter than i: Note memchr() stops at the first '\0' */
+    if (i>0&&memchr(s,'\0',i)) return 0.0;
+
+    return str2dec(s+i,n);
+}
 /* string to time --------------------------------------------------------------
 * convert substring in string to gtime_t struct
 * args   : char   *s        I   string ("... yyyy mm dd hh mm ss ...")
@@ -2061,6 +2164,136 @@ extern uint32_t tickget(void)
 #endif
 #endif /* WIN32 */
 }
+/* get tick time in us ---------------------------------------------------------
+* get current tick in us (monotonic clock)
+* args   : none
+* return : current tick in us (wrap-around after about 71 min)
+*-----------------------------------------------------------------------------*/
+extern uint32_t tickgetus(void)
+{
+#ifdef WIN32
+    LARGE_INTEGER cnt,freq;
+    
+    if (!QueryPerformanceFrequency(&freq)||!QueryPerformanceCounter(&cnt)) {
+        return (uint32_t)timeGetTime()*1000u;
+    }
+    return (uint32_t)(cnt.QuadPart/freq.QuadPart*1000000+
+                      cnt.QuadPart%freq.QuadPart*1000000/freq.QuadPart);
+#else
+    struct timespec tp={0};
+    struct timeval  tv={0};
+
+#ifdef CLOCK_MONOTONIC_RAW
+    if (!clock_gettime(CLOCK_MONOTONIC_RAW,&tp)) {
+        return tp.tv_sec*1000000u+tp.tv_nsec/1000u;
+    }
+#endif
+    gettimeofday(&tv,NULL);
+    return tv.tv_sec*1000000u+tv.tv_usec;
+#endif /* WIN32 */
+}
+/* latency histogram bin -----------------------------------------------------*/
+static int latbin(uint32_t us)
+{
+    int e=2;
+    
+    if (us<4) return (int)us;
+    while (e<31&&(us>>(e+1))) e++;
+    return 4*(e-1)+(int)((us>>(e-2))&3); /* 4 bins per octave */
+}
+/* upper bound of latency histogram bin --------------------------------------*/
+static double latbinmax(int bin)
+{
+    if (bin<4) return bin;
+    return (double)(4+bin%4+1)*(1u<<(bin/4-1));
+}
+/* initialize stage latency statistics -----------------------------------------
+* initialize stage latency statistics
+* args   : latstat_t *lat   O   stage latency statistics
+*          int    ena       I   enable (0:off,1:on)
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void latinit(latstat_t *lat, int ena)
+{
+    memset(lat,0,sizeof(latstat_t));
+    lat->ena=ena;
+    lat->tick=tickget();
+}
+/* start latency measurement ---------------------------------------------------
+* start latency measurement of a processing stage
+* args   : latstat_t *lat   I   stage latency statistics (NULL: off)
+* return : start tick (us) (0: latency statistics off)
+*-----------------------------------------------------------------------------*/
+extern uint32_t latstart(const latstat_t *lat)
+{
+    return lat&&lat->ena?tickgetus():0;
+}
+/* add latency sample ----------------------------------------------------------
+* add latency of a processing stage to rolling histogram
+* args   : latstat_t *lat   IO  stage latency statistics (NULL: off)
+*          int    stg       I   processing stage (LATSTG_???)
+*          uint32_t t0      I   start tick by latstart() (us)
+* return : none
+* notes  : histograms are rolled over every LATWIN ms. latquant() uses the
+*          current and previous windows
+*-----------------------------------------------------------------------------*/
+extern void latadd(latstat_t *lat, int stg, uint32_t t0)
+{
+    lathist_t *h;
+    uint32_t us,tick;
+    
+    if (!lat||!lat->ena||stg<0||stg>=NLATSTG) return;
+    
+    us=tickgetus()-t0;
+    tick=tickget();
+    
+    if ((int)(tick-lat->tick)>=LATWIN) { /* roll over histograms */
+        memcpy(lat->hist[1],lat->hist[0],sizeof(lat->hist[0]));
+        memset(lat->hist[0],0,sizeof(lat->hist[0]));
+        lat->tick=tick;
+    }
+    h=lat->hist[0]+stg;
+    h->n++;
+    h->bin[latbin(us)]++;
+    if (us>h->max) h->max=us;
+    lat->cnt[stg]++;
+    lat->sum[stg]+=us;
+}
+/* latency quantiles -----------------------------------------------------------
+* get latency quantiles of a processing stage
+* args   : latstat_t *lat   I   stage latency statistics
+*          int    stg       I   processing stage (LATSTG_???)
+*          int    *n        O   number of samples
+*          double *p50,*p99 O   50/99 percentile latency (us)
+*          double *max      O   max latency (us)
+* return : none
+* notes  : percentiles are upper bounds of histogram bins (resolution 25%)
+*-----------------------------------------------------------------------------*/
+extern void latquant(const latstat_t *lat, int stg, int *n, double *p50,
+                     double *p99, double *max)
+{
+    const lathist_t *h0=lat->hist[0]+stg,*h1=lat->hist[1]+stg;
+    uint32_t m,c,k50,k99;
+    int i;
+    
+    *n=(int)(m=h0->n+h1->n);
+    *max=h0->max>h1->max?h0->max:h1->max;
+    *p50=*p99=0.0;
+    if (m<=0) return;
+    
+    k50=(m+1)/2;
+    k99=m-m/100;
+    for (i=0,c=0;i<NLATBIN;i++) {
+        if (c<k50&&c+h0->bin[i]+h1->bin[i]>=k50) *p50=latbinmax(i);
+        c+=h0->bin[i]+h1->bin[i];
+        if (c>=k99) {
+            *p99=latbinmax(i);
+            break;
+        }
+    }
+    if (*p50>*max) *p50=*max;
+    if (*p99>*max) *p99=*max;
+}
 /* sleep ms --------------------------------------------------------------------
 * sleep ms
 * args   : int   ms         I   milliseconds to sleep (<0:no sleep)
@@ -2078,6 +2311,32 @@ extern void sleepms(int ms)
     nanosleep(&ts,NULL);
 #endif
 }
+/* wait condition with timeout -----------------------------------------------
+* wait condition signaled or timeout
+* args   : rtklib_cond_t *cond I condition
+*          rtklib_lock_t *lock I lock (locked by caller)
+*          int   ms         I   timeout (ms)
+* return : none
+* notes  : the lock is released while waiting and locked again on return
+*-----------------------------------------------------------------------------*/
+extern void condwaitms(rtklib_cond_t *cond, rtklib_lock_t *lock, int ms)
+{
+#ifdef WIN32
+    SleepConditionVariableCS(cond,lock,ms<0?0:(DWORD)ms);
+#else
+    struct timespec ts;
+    
+    if (ms<0) ms=0;
+    clock_gettime(CLOCK_REALTIME,&ts);
+    ts.tv_sec+=ms/1000;
+    ts.tv_nsec+=(long)(ms%1000*1000000);
+    if (ts.tv_nsec>=1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec-=1000000000L;
+    }
+    pthread_cond_timedwait(cond,lock,&ts);
+#endif
+}
 /* convert degree to deg-min-sec -----------------------------------------------
 * convert degree to degree-minute-second
 * args   : double deg       I   degree
@@ -2466,7 +2725,7 @@ static int decodef(char *p, int n, double *v)
     for (i=0;i<n;i++) v[i]=0.0;
     char *q;
     for (i=0,p=strtok_r(p," ",&q);p&&i<n;p=strtok_r(NULL," ",&q)) {
-        v[i++]=atof(p)*1E-3;
+        v[i++]=str2dec(p,(int)strlen(p))*1E-3;
     }
     return i;
 }
@@ -2618,18 +2877,24 @@ extern int readpcv(const char *file, pcvs_t *pcvs)
 {
     pcv_t *pcv;
     char *ext;
-    int i,stat;
+    int i,stat,n0[7]={0};
 
     trace(3,"readpcv: file=%s\n",file);
 
     if (!(ext=strrchr(file,'.'))) ext="";
 
+    /* read from product cache */
+    n0[5]=pcvs->n;
+    if (loadprodcache(file,PCACHE_PCV,ext,0,NULL,NULL,pcvs,NULL)) return 1;
+
     if (!strcmp(ext,".atx")||!strcmp(ext,".ATX")) {
         stat=readantex(file,pcvs);
     }
     else {
         stat=readngspcv(file,pcvs);
     }
+    if (stat) saveprodcache(file,PCACHE_PCV,ext,' ',NULL,n0,pcvs,NULL);
+
     for (i=0;i<pcvs->n;i++) {
         pcv=pcvs->pcv+i;
         trace(4,"sat=%2d type=%20s code=%s off=%8.4f %8.4f %8.4f  %8.4f %8.4f %8.4f\n",
@@ -2783,14 +3048,8 @@ extern int readblq(const char *file, const char *sta, double odisp[2][11][3])
     trace(2,"no otl parameters: sta=%s file=%s\n",sta,file);
     return 0;
 }
-/* read earth rotation parameters ----------------------------------------------
-* read earth rotation parameters
-* args   : char   *file       I   IGS ERP file (IGS ERP ver.2)
-*          erp_t  *erp        O   earth rotation parameters
-* return : status (1:ok,0:file open error)
-*-----------------------------------------------------------------------------*/
-extern int readerp(const char *file, erp_t *erp) {
-  trace(3, "readerp: file=%s\n", file);
+/* read IGS ERP file --------------------------------------------------------*/
+static int readerpf(const char *file, erp_t *erp) {
 
   FILE *fp = fopen(file, "r");
   if (!fp) {
@@ -2879,6 +3138,399 @@ extern int readerp(const char *file, erp_t *erp) {
   fclose(fp);
   return 1;
 }
+/* read earth rotation parameters ----------------------------------------------
+* read earth rotation parameters
+* args   : char   *file       I   IGS ERP file (IGS ERP ver.2)
+*          erp_t  *erp        O   earth rotation parameters
+* return : status (1:ok,0:file open error)
+*-----------------------------------------------------------------------------*/
+extern int readerp(const char *file, erp_t *erp) {
+  trace(3, "readerp: file=%s\n", file);
+
+  // Read from product cache.
+  int n0[7] = {0};
+  n0[6] = erp->n;
+  if (loadprodcache(file, PCACHE_ERP, "", 0, NULL, NULL, NULL, erp)) return 1;
+
+  if (!readerpf(file, erp)) return 0;
+  saveprodcache(file, PCACHE_ERP, "", ' ', NULL, n0, NULL, erp);
+  return 1;
+}
+/* product cache file header type --------------------------------------------*/
+typedef struct {
+    char magic[8];      /* magic ("RTKPCACH") */
+    int32_t ver;        /* format version */
+    int32_t kind;       /* product kind (PCACHE_???) */
+    int32_t size[8];    /* record sizes {eph,geph,seph,peph,pclk,pcv,erpd,navh} */
+    int32_t n[7];       /* number of records {eph,geph,seph,peph,pclk,pcv,erpd} */
+    char type;          /* file type */
+    char pad[3];
+    int64_t fsize;      /* source file size (bytes) */
+    int64_t mtime;      /* source file modified time (s) */
+    char file[1024];    /* source file path */
+    char opt[256];      /* read options */
+} pchead_t;
+
+typedef struct {        /* navigation header parameters type */
+    double utc_gps[8],utc_glo[8],utc_gal[8],utc_qzs[8],utc_cmp[8],utc_irn[9];
+    double utc_sbs[4],ion_gps[8],ion_gal[4],ion_qzs[8],ion_cmp[8],ion_irn[8];
+    int glo_fcn[32];
+} pcnavh_t;
+
+static char pcache_dir[1024]="";        /* product cache directory */
+static int pcache_nhit=0,pcache_nmiss=0; /* product cache statistics */
+static int pcache_seq=0;                /* sequence number of temporary file */
+
+/* set product cache -----------------------------------------------------------
+* set directory of product cache for parsed navigation data, precise ephemeris,
+* precise clock, antenna parameters and earth rotation parameters
+* args   : char   *dir        I   product cache directory ("": disable cache)
+* return : none
+* notes  : with the cache enabled, readrnxt(), readrnxc(), readsp3(), readpcv()
+*          and readerp() store the records parsed from each source file to a
+*          binary cache file keyed by the file path, size and modified time.
+*          the records are loaded from the cache file instead of parsing the
+*          source file if the cache file is valid. cache files depend on the
+*          build (record sizes and byte-order) and should not be shared
+*          between different builds.
+*          the cache statistics are reset.
+*-----------------------------------------------------------------------------*/
+extern void setprodcache(const char *dir)
+{
+    trace(3,"setprodcache: dir=%s\n",dir);
+
+    strncpy(pcache_dir,dir,sizeof(pcache_dir)-1);
+    pcache_nhit=pcache_nmiss=0;
+}
+/* get product cache statistics ------------------------------------------------
+* get product cache statistics
+* args   : int    *nhit       O   number of files loaded from cache (NULL: no output)
+*          int    *nmiss      O   number of files parsed and cached (NULL: no output)
+* return : status (1:cache enabled,0:cache disabled)
+*-----------------------------------------------------------------------------*/
+extern int getprodcache(int *nhit, int *nmiss)
+{
+    if (nhit ) *nhit =ATOMIC_LOAD(&pcache_nhit);
+    if (nmiss) *nmiss=ATOMIC_LOAD(&pcache_nmiss);
+    return *pcache_dir!='\0';
+}
+/* set product cache file header and path ------------------------------------*/
+static int pcachehead(const char *file, int kind, const char *opt,
+                      pchead_t *head, char *path)
+{
+    struct stat st;
+    uint64_t hash=14695981039346656037ULL; /* FNV-1a */
+    const char *p;
+
+    if (!*pcache_dir||stat(file,&st)) return 0;
+    if (strlen(file)>=sizeof(head->file)||strlen(opt)>=sizeof(head->opt)) {
+        return 0;
+    }
+    memset(head,0,sizeof(pchead_t));
+    memcpy(head->magic,"RTKPCACH",8);
+    head->ver=PCACHE_VER;
+    head->kind=kind;
+    head->size[0]=(int32_t)sizeof(eph_t);
+    head->size[1]=(int32_t)sizeof(geph_t);
+    head->size[2]=(int32_t)sizeof(seph_t);
+    head->size[3]=(int32_t)sizeof(peph_t);
+    head->size[4]=(int32_t)sizeof(pclk_t);
+    head->size[5]=(int32_t)sizeof(pcv_t);
+    head->size[6]=(int32_t)sizeof(erpd_t);
+    head->size[7]=(int32_t)sizeof(pcnavh_t);
+    head->fsize=(int64_t)st.st_size;
+    head->mtime=(int64_t)st.st_mtime;
+    strcpy(head->file,file);
+    strcpy(head->opt,opt);
+
+    hash=(hash^(uint8_t)kind)*1099511628211ULL;
+    for (p=file;*p;p++) hash=(hash^(uint8_t)*p)*1099511628211ULL;
+    hash=(hash^(uint8_t)'|')*1099511628211ULL;
+    for (p=opt ;*p;p++) hash=(hash^(uint8_t)*p)*1099511628211ULL;
+
+    sprintf(path,"%s%c%08X%08X.pch",pcache_dir,RTKLIB_FILEPATHSEP,
+            (uint32_t)(hash>>32),(uint32_t)hash);
+    return 1;
+}
+/* map product cache file ----------------------------------------------------*/
+static uint8_t *mapcache(const char *path, size_t *size)
+{
+#ifdef WIN32
+    FILE *fp;
+    uint8_t *buff;
+    long len;
+
+    if (!(fp=fopen(path,"rb"))) return NULL;
+    if (fseek(fp,0,SEEK_END)||(len=ftell(fp))<=0||fseek(fp,0,SEEK_SET)||
+        !(buff=(uint8_t *)malloc(len))) {
+        fclose(fp);
+        return NULL;
+    }
+    if (fread(buff,len,1,fp)!=1) {
+        free(buff);
+        fclose(fp);
+        return NULL;
+    }
+    fclose(fp);
+    *size=(size_t)len;
+    return buff;
+#else
+    struct stat st;
+    void *buff;
+    int fd;
+
+    if ((fd=open(path,O_RDONLY))<0) return NULL;
+    if (fstat(fd,&st)||st.st_size<=0) {
+        close(fd);
+        return NULL;
+    }
+    buff=mmap(NULL,(size_t)st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+    close(fd);
+    if (buff==MAP_FAILED) return NULL;
+    *size=(size_t)st.st_size;
+    return (uint8_t *)buff;
+#endif
+}
+/* unmap product cache file --------------------------------------------------*/
+static void unmapcache(uint8_t *buff, size_t size)
+{
+#ifdef WIN32
+    free(buff);
+#else
+    munmap(buff,size);
+#endif
+}
+/* check header and size of product cache ------------------------------------*/
+static int chkcache(const pchead_t *h, const pchead_t *head, size_t size)
+{
+    size_t len=sizeof(pchead_t)+sizeof(pcnavh_t);
+    int i;
+    
+    if (size<len||memcmp(h->magic,head->magic,8)||h->ver!=head->ver||
+        h->kind!=head->kind||memcmp(h->size,head->size,sizeof(head->size))||
+        h->fsize!=head->fsize||h->mtime!=head->mtime||
+        strcmp(h->file,head->file)||strcmp(h->opt,head->opt)) {
+        return 0;
+    }
+    /* record counts within file size */
+    for (i=0;i<7;i++) {
+        if (h->n[i]<0||(size_t)h->n[i]>(size-len)/head->size[i]) return 0;
+        len+=(size_t)h->n[i]*head->size[i];
+    }
+    return len==size;
+}
+/* add records to array ------------------------------------------------------*/
+static int addrecs(void **data, int *n, int *nmax, const uint8_t *recs,
+                   int nrec, size_t size)
+{
+    void *data_;
+
+    if (nrec<=0) return 1;
+    if (*n+nrec>*nmax) {
+        if (!(data_=realloc(*data,size*(*n+nrec)))) return 0;
+        *data=data_;
+        *nmax=*n+nrec;
+    }
+    memcpy((uint8_t *)*data+size*(*n),recs,size*nrec);
+    *n+=nrec;
+    return 1;
+}
+/* load records from product cache ---------------------------------------------
+* load records parsed from a source file from product cache
+* args   : char   *file       I   source file path
+*          int    kind        I   product kind (PCACHE_???)
+*          char   *opt        I   read options of source file
+*          int    index       I   file index for precise ephemeris/clock
+*          char   *type       O   file type (NULL: no output)
+*          nav_t  *nav        IO  navigation data (NULL: no input)
+*          pcvs_t *pcvs       IO  antenna parameters (NULL: no input)
+*          erp_t  *erp        IO  earth rotation parameters (NULL: no input)
+* return : status (1:loaded,0:cache disabled, no valid cache or error)
+* notes  : the records are appended to nav, pcvs or erp.
+*          for PCACHE_NAV and PCACHE_CLK, navigation header parameters stored
+*          are copied to nav.
+*-----------------------------------------------------------------------------*/
+extern int loadprodcache(const char *file, int kind, const char *opt,
+                         int index, char *type, nav_t *nav, pcvs_t *pcvs,
+                         erp_t *erp)
+{
+    pchead_t head,*h;
+    const pcnavh_t *navh;
+    const uint8_t *p;
+    uint8_t *buff;
+    size_t size;
+    char path[1100];
+    int i,n0[7]={0},stat=1;
+
+    if (!pcachehead(file,kind,opt,&head,path)) return 0;
+
+    trace(3,"loadprodcache: file=%s kind=%d opt=%s\n",file,kind,opt);
+
+    if (!(buff=mapcache(path,&size))) return 0;
+
+    h=(pchead_t *)buff;
+    if (!chkcache(h,&head,size)||
+        ((h->n[0]||h->n[1]||h->n[2]||h->n[3]||h->n[4])&&!nav)||
+        (h->n[5]&&!pcvs)||(h->n[6]&&!erp)) {
+        trace(2,"product cache invalid: file=%s cache=%s\n",file,path);
+        unmapcache(buff,size);
+        return 0;
+    }
+    if (nav) {
+        n0[0]=nav->n; n0[1]=nav->ng; n0[2]=nav->ns; n0[3]=nav->ne;
+        n0[4]=nav->nc;
+    }
+    if (pcvs) n0[5]=pcvs->n;
+    if (erp ) n0[6]=erp->n;
+
+    navh=(const pcnavh_t *)(buff+sizeof(pchead_t));
+    p=buff+sizeof(pchead_t)+sizeof(pcnavh_t);
+
+    if (nav) {
+        stat&=addrecs((void **)&nav->eph ,&nav->n ,&nav->nmax ,p,h->n[0],sizeof(eph_t ));
+        p+=(size_t)h->n[0]*sizeof(eph_t);
+        stat&=addrecs((void **)&nav->geph,&nav->ng,&nav->ngmax,p,h->n[1],sizeof(geph_t));
+        p+=(size_t)h->n[1]*sizeof(geph_t);
+        stat&=addrecs((void **)&nav->seph,&nav->ns,&nav->nsmax,p,h->n[2],sizeof(seph_t));
+        p+=(size_t)h->n[2]*sizeof(seph_t);
+        stat&=addrecs((void **)&nav->peph,&nav->ne,&nav->nemax,p,h->n[3],sizeof(peph_t));
+        p+=(size_t)h->n[3]*sizeof(peph_t);
+        stat&=addrecs((void **)&nav->pclk,&nav->nc,&nav->ncmax,p,h->n[4],sizeof(pclk_t));
+        p+=(size_t)h->n[4]*sizeof(pclk_t);
+    }
+    if (pcvs) {
+        stat&=addrecs((void **)&pcvs->pcv,&pcvs->n,&pcvs->nmax,p,h->n[5],sizeof(pcv_t));
+        p+=(size_t)h->n[5]*sizeof(pcv_t);
+    }
+    if (erp) {
+        stat&=addrecs((void **)&erp->data,&erp->n,&erp->nmax,p,h->n[6],sizeof(erpd_t));
+    }
+    if (!stat) {
+        trace(1,"loadprodcache: memory allocation error\n");
+        if (nav) {
+            nav->n=n0[0]; nav->ng=n0[1]; nav->ns=n0[2]; nav->ne=n0[3];
+            nav->nc=n0[4];
+        }
+        if (pcvs) pcvs->n=n0[5];
+        if (erp ) erp->n=n0[6];
+        unmapcache(buff,size);
+        return 0;
+    }
+    if (nav) {
+        for (i=n0[3];i<nav->ne;i++) nav->peph[i].index=index;
+        for (i=n0[4];i<nav->nc;i++) nav->pclk[i].index=index;
+
+        if (kind==PCACHE_NAV||kind==PCACHE_CLK) {
+            memcpy(nav->utc_gps,navh->utc_gps,sizeof(nav->utc_gps));
+            memcpy(nav->utc_glo,navh->utc_glo,sizeof(nav->utc_glo));
+            memcpy(nav->utc_gal,navh->utc_gal,sizeof(nav->utc_gal));
+            memcpy(nav->utc_qzs,navh->utc_qzs,sizeof(nav->utc_qzs));
+            memcpy(nav->utc_cmp,navh->utc_cmp,sizeof(nav->utc_cmp));
+            memcpy(nav->utc_irn,navh->utc_irn,sizeof(nav->utc_irn));
+            memcpy(nav->utc_sbs,navh->utc_sbs,sizeof(nav->utc_sbs));
+            memcpy(nav->ion_gps,navh->ion_gps,sizeof(nav->ion_gps));
+            memcpy(nav->ion_gal,navh->ion_gal,sizeof(nav->ion_gal));
+            memcpy(nav->ion_qzs,navh->ion_qzs,sizeof(nav->ion_qzs));
+            memcpy(nav->ion_cmp,navh->ion_cmp,sizeof(nav->ion_cmp));
+            memcpy(nav->ion_irn,navh->ion_irn,sizeof(nav->ion_irn));
+            memcpy(nav->glo_fcn,navh->glo_fcn,sizeof(nav->glo_fcn));
+        }
+    }
+    if (type) *type=h->type;
+    unmapcache(buff,size);
+    ATOMIC_INC(&pcache_nhit);
+    return 1;
+}
+/* save records to product cache -----------------------------------------------
+* save records parsed from a source file to product cache
+* args   : char   *file       I   source file path
+*          int    kind        I   product kind (PCACHE_???)
+*          char   *opt        I   read options of source file
+*          char   type        I   file type
+*          nav_t  *nav        I   navigation data (NULL: no input)
+*          int    *n0         I   start index of records parsed from the file
+*                                 {eph,geph,seph,peph,pclk,pcv,erpd}
+*          pcvs_t *pcvs       I   antenna parameters (NULL: no input)
+*          erp_t  *erp        I   earth rotation parameters (NULL: no input)
+* return : status (1:ok,0:cache disabled or error)
+* notes  : the cache file is written to a temporary file named by process id,
+*          thread id and sequence number and renamed to be safe for concurrent
+*          processes and threads.
+*-----------------------------------------------------------------------------*/
+extern int saveprodcache(const char *file, int kind, const char *opt,
+                         char type, const nav_t *nav, const int *n0,
+                         const pcvs_t *pcvs, const erp_t *erp)
+{
+    FILE *fp;
+    pchead_t head;
+    pcnavh_t navh={{0}};
+    char path[1100],tmpfile[1200];
+    int stat;
+
+    if (!pcachehead(file,kind,opt,&head,path)) return 0;
+
+    trace(3,"saveprodcache: file=%s kind=%d opt=%s\n",file,kind,opt);
+
+    ATOMIC_INC(&pcache_nmiss);
+    head.type=type;
+    if (nav) {
+        head.n[0]=nav->n -n0[0]; head.n[1]=nav->ng-n0[1];
+        head.n[2]=nav->ns-n0[2]; head.n[3]=nav->ne-n0[3];
+        head.n[4]=nav->nc-n0[4];
+        memcpy(navh.utc_gps,nav->utc_gps,sizeof(navh.utc_gps));
+        memcpy(navh.utc_glo,nav->utc_glo,sizeof(navh.utc_glo));
+        memcpy(navh.utc_gal,nav->utc_gal,sizeof(navh.utc_gal));
+        memcpy(navh.utc_qzs,nav->utc_qzs,sizeof(navh.utc_qzs));
+        memcpy(navh.utc_cmp,nav->utc_cmp,sizeof(navh.utc_cmp));
+        memcpy(navh.utc_irn,nav->utc_irn,sizeof(navh.utc_irn));
+        memcpy(navh.utc_sbs,nav->utc_sbs,sizeof(navh.utc_sbs));
+        memcpy(navh.ion_gps,nav->ion_gps,sizeof(navh.ion_gps));
+        memcpy(navh.ion_gal,nav->ion_gal,sizeof(navh.ion_gal));
+        memcpy(navh.ion_qzs,nav->ion_qzs,sizeof(navh.ion_qzs));
+        memcpy(navh.ion_cmp,nav->ion_cmp,sizeof(navh.ion_cmp));
+        memcpy(navh.ion_irn,nav->ion_irn,sizeof(navh.ion_irn));
+        memcpy(navh.glo_fcn,nav->glo_fcn,sizeof(navh.glo_fcn));
+    }
+    if (pcvs) head.n[5]=pcvs->n-n0[5];
+    if (erp ) head.n[6]=erp->n-n0[6];
+
+    createdir(path);
+#ifdef WIN32
+    sprintf(tmpfile,"%s.%lu.%lu.%d",path,GetCurrentProcessId(),
+            GetCurrentThreadId(),ATOMIC_INC(&pcache_seq));
+#else
+    sprintf(tmpfile,"%s.%ld.%lu.%d",path,(long)getpid(),
+            (unsigned long)pthread_self(),ATOMIC_INC(&pcache_seq));
+#endif
+    if (!(fp=fopen(tmpfile,"wb"))) {
+        trace(2,"product cache open error: %s\n",tmpfile);
+        return 0;
+    }
+    stat=fwrite(&head,sizeof(head),1,fp)==1&&fwrite(&navh,sizeof(navh),1,fp)==1;
+    if (nav) {
+        stat&=fwrite(nav->eph +n0[0],sizeof(eph_t ),head.n[0],fp)==(size_t)head.n[0];
+        stat&=fwrite(nav->geph+n0[1],sizeof(geph_t),head.n[1],fp)==(size_t)head.n[1];
+        stat&=fwrite(nav->seph+n0[2],sizeof(seph_t),head.n[2],fp)==(size_t)head.n[2];
+        stat&=fwrite(nav->peph+n0[3],sizeof(peph_t),head.n[3],fp)==(size_t)head.n[3];
+        stat&=fwrite(nav->pclk+n0[4],sizeof(pclk_t),head.n[4],fp)==(size_t)head.n[4];
+    }
+    if (pcvs) {
+        stat&=fwrite(pcvs->pcv+n0[5],sizeof(pcv_t),head.n[5],fp)==(size_t)head.n[5];
+    }
+    if (erp) {
+        stat&=fwrite(erp->data+n0[6],sizeof(erpd_t),head.n[6],fp)==(size_t)head.n[6];
+    }
+    stat&=fclose(fp)==0;
+#ifdef WIN32
+    if (stat) remove(path);
+#endif
+    if (!stat||rename(tmpfile,path)) {
+        trace(2,"product cache write error: %s\n",path);
+        remove(tmpfile);
+        return 0;
+    }
+    return 1;
+}
 /* get earth rotation parameter values -----------------------------------------
 * get earth rotation parameter values
 * args   : erp_t  *erp        I   earth rotation parameters
@@ -3786,8 +4438,8 @@ static double mapf(double el, double a, double b, double c)
     double sinel=sin(el);
     return (1.0+a/(1.0+b/(1.0+c)))/(sinel+(a/(sinel+b/(sinel+c))));
 }
-static double nmf(gtime_t time, const double pos[], const double azel[],
-                  double *mapfw)
+/* NMF coefficients by latitude and day of year ------------------------------*/
+static void nmf_coef(gtime_t time, const double pos[], double *ah, double *aw)
 {
     /* ref [5] table 3 */
     /* hydro-ave-a,b,c, hydro-amp-a,b,c, wet-a,b,c at latitude 15,30,45,60,75 */
@@ -3804,15 +4456,9 @@ static double nmf(gtime_t time, const double pos[], const double azel[],
         { 1.4275268E-3, 1.5138625E-3, 1.4572752E-3, 1.5007428E-3, 1.7599082E-3},
         { 4.3472961E-2, 4.6729510E-2, 4.3908931E-2, 4.4626982E-2, 5.4736038E-2}
     };
-    const double aht[]={ 2.53E-5, 5.49E-3, 1.14E-3}; /* height correction */
-
-    double y,cosy,ah[3],aw[3],dm,el=azel[1],lat=pos[0]*R2D,hgt=pos[2];
+    double y,cosy,lat=pos[0]*R2D;
     int i;
 
-    if (el<=0.0) {
-        if (mapfw) *mapfw=0.0;
-        return 0.0;
-    }
     /* year from doy 28, added half a year for southern latitudes */
     y=(time2doy(time)-28.0)/365.25+(lat<0.0?0.5:0.0);
 
@@ -3823,6 +4469,18 @@ static double nmf(gtime_t time, const double pos[], const double azel[],
         ah[i]=interpc(coef[i  ],lat)-interpc(coef[i+3],lat)*cosy;
         aw[i]=interpc(coef[i+6],lat);
     }
+}
+static double nmf(const double ah[], const double aw[], double hgt,
+                  const double azel[], double *mapfw)
+{
+    const double aht[]={ 2.53E-5, 5.49E-3, 1.14E-3}; /* height correction */
+
+    double dm,el=azel[1];
+
+    if (el<=0.0) {
+        if (mapfw) *mapfw=0.0;
+        return 0.0;
+    }
     /* ellipsoidal height is used instead of height above sea level */
     dm=(1.0/sin(el)-mapf(el,aht[0],aht[1],aht[2]))*hgt/1E3;
 
@@ -3832,6 +4490,37 @@ static double nmf(gtime_t time, const double pos[], const double azel[],
 }
 #endif /* !IERS_MODEL */
 
+/* coefficients of troposphere mapping function by station and epoch ---------*/
+static const mapfc_t *mapfcoef(gtime_t time, const double pos[])
+{
+    static THREADLOCAL mapfc_t mapfc[NMAPFC];
+    static THREADLOCAL int next=0;
+#ifdef IERS_MODEL
+    const double ep[]={2000,1,1,12,0,0};
+#endif
+    mapfc_t *c;
+    int i;
+
+    for (i=0;i<NMAPFC;i++) {
+        c=mapfc+i;
+        if (c->stat&&c->time.time==time.time&&c->time.sec==time.sec&&
+            c->pos[0]==pos[0]&&c->pos[1]==pos[1]&&c->pos[2]==pos[2]) {
+            return c;
+        }
+    }
+    c=mapfc+next;
+    next=(next+1)%NMAPFC;
+    c->time=time;
+    for (i=0;i<3;i++) c->pos[i]=pos[i];
+#ifdef IERS_MODEL
+    c->mjd=51544.5+(timediff(time,epoch2time(ep)))/86400.0;
+    c->hgt=pos[2]-geoidh(pos); /* height in m (mean sea level) */
+#else
+    nmf_coef(time,pos,c->ah,c->aw);
+#endif
+    c->stat=1;
+    return c;
+}
 /* troposphere mapping function ------------------------------------------------
 * compute tropospheric mapping function by NMF
 * args   : gtime_t t        I   time
@@ -3843,13 +4532,16 @@ static double nmf(gtime_t time, const double pos[], const double azel[],
 *          original JGR paper of [5] has bugs in eq.(4) and (5). the corrected
 *          paper is obtained from:
 *          ftp://web.haystack.edu/pub/aen/nmf/NMF_JGR.pdf
+*          the station and time dependent terms are cached for the last
+*          NMAPFC pairs of receiver position and time, so only the elevation
+*          dependent terms are computed for other satellites of the epoch
 *-----------------------------------------------------------------------------*/
 extern double tropmapf(gtime_t time, const double pos[], const double azel[],
                        double *mapfw)
 {
+    const mapfc_t *c;
 #ifdef IERS_MODEL
-    const double ep[]={2000,1,1,12,0,0};
-    double mjd,lat,lon,hgt,zd,gmfh,gmfw;
+    double lat,lon,hgt,mjd,zd,gmfh,gmfw;
 #endif
     trace(4,"tropmapf: pos=%10.6f %11.6f %6.1f azel=%5.1f %4.1f\n",
           pos[0]*R2D,pos[1]*R2D,pos[2],azel[0]*R2D,azel[1]*R2D);
@@ -3858,11 +4550,12 @@ extern double tropmapf(gtime_t time, const double pos[], const double azel[],
         if (mapfw) *mapfw=0.0;
         return 0.0;
     }
+    c=mapfcoef(time,pos);
 #ifdef IERS_MODEL
-    mjd=51544.5+(timediff(time,epoch2time(ep)))/86400.0;
+    mjd=c->mjd;
     lat=pos[0];
     lon=pos[1];
-    hgt=pos[2]-geoidh(pos); /* height in m (mean sea level) */
+    hgt=c->hgt;
     zd =PI/2.0-azel[1];
 
     /* call GMF */
@@ -3871,7 +4564,7 @@ extern double tropmapf(gtime_t time, const double pos[], const double azel[],
     if (mapfw) *mapfw=gmfw;
     return gmfh;
 #else
-    return nmf(time,pos,azel,mapfw); /* NMF */
+    return nmf(c->ah,c->aw,pos[2],azel,mapfw); /* NMF */
 #endif
 }
 /* interpolate antenna phase center variation --------------------------------*/
@@ -280,6 +280,7 @@ extern "C" {
 #define MAXCOMMENT  100                 /* max number of RINEX comments */
 #define MAXSTRPATH  1024                /* max length of stream path */
 #define MAXSTRMSG   1024                /* max length of stream message */
+#define MAXSTREVT   256                 /* max descriptors of stream event wait */
 #define MAXSTRRTK   8                   /* max number of stream in RTK server */
 #define MAXSBSMSG   32                  /* max number of SBAS msg in RTK server */
 #define MAXSOLLEN   512                 /* max line length of solution message */
@@ -417,9 +418,21 @@ extern "C" {
 #define SOLTYPE_BACKWARD 1              /* solution type: backward */
 #define SOLTYPE_COMBINED 2              /* solution type: combined */
 #define SOLTYPE_COMBINED_NORESET 3      /* solution type: combined no phase reset*/
+
 #define SOLMODE_SINGLE_DIR 0            /* single direction solution */
 #define SOLMODE_COMBINED 1              /* combined solution */
 
+#define LATSTG_READ   0                 /* latency stage: stream read */
+#define LATSTG_DEC    1                 /* latency stage: decode */
+#define LATSTG_SATPOS 2                 /* latency stage: satellite positions */
+#define LATSTG_RES    3                 /* latency stage: residuals */
+#define LATSTG_FILT   4                 /* latency stage: filter update */
+#define LATSTG_AMB    5                 /* latency stage: ambiguity resolution */
+#define LATSTG_FMT    6                 /* latency stage: solution format */
+#define LATSTG_OUT    7                 /* latency stage: solution output */
+#define NLATSTG       8                 /* number of latency stages */
+#define NLATBIN       128               /* number of latency histogram bins */
+
 #define TIMES_GPST  0                   /* time system: gps time */
 #define TIMES_UTC   1                   /* time system: utc */
 #define TIMES_JST   2                   /* time system: jst */
@@ -466,6 +479,12 @@ extern "C" {
 #define POSOPT_RINEX   4                /* pos option: rinex header pos */
 #define POSOPT_RTCM    5                /* pos option: rtcm/raw station pos */
 
+#define PCACHE_NAV   1                  /* product cache: RINEX NAV */
+#define PCACHE_CLK   2                  /* product cache: RINEX CLK */
+#define PCACHE_SP3   3                  /* product cache: SP3 */
+#define PCACHE_PCV   4                  /* product cache: antenna parameters */
+#define PCACHE_ERP   5                  /* product cache: ERP */
+
 #define STR_NONE     0                  /* stream type: none */
 #define STR_SERIAL   1                  /* stream type: serial */
 #define STR_FILE     2                  /* stream type: file */
@@ -560,6 +579,12 @@ extern "C" {
 #define rtklib_initlock(f) InitializeCriticalSection(f)
 #define rtklib_lock(f)     EnterCriticalSection(f)
 #define rtklib_unlock(f)   LeaveCriticalSection(f)
+#define rtklib_freelock(f) DeleteCriticalSection(f)
+#define rtklib_cond_t      CONDITION_VARIABLE
+#define rtklib_initcond(c) InitializeConditionVariable(c)
+#define rtklib_freecond(c) ((void)(c))
+#define rtklib_condwait(c,f) SleepConditionVariableCS(c,f,INFINITE)
+#define rtklib_condsignal(c) WakeAllConditionVariable(c)
 #define RTKLIB_FILEPATHSEP '\\'
 /* strtok_r not supported in Windows */
 #define strtok_r(str,delim,ptr) strtok(str,delim)
@@ -569,6 +594,12 @@ extern "C" {
 #define rtklib_initlock(f) pthread_mutex_init(f,NULL)
 #define rtklib_lock(f)     pthread_mutex_lock(f)
 #define rtklib_unlock(f)   pthread_mutex_unlock(f)
+#define rtklib_freelock(f) pthread_mutex_destroy(f)
+#define rtklib_cond_t      pthread_cond_t
+#define rtklib_initcond(c) pthread_cond_init(c,NULL)
+#define rtklib_freecond(c) pthread_cond_destroy(c)
+#define rtklib_condwait(c,f) pthread_cond_wait(c,f)
+#define rtklib_condsignal(c) pthread_cond_broadcast(c)
 #define RTKLIB_FILEPATHSEP '/'
 #endif
 
@@ -1123,6 +1154,7 @@ typedef struct {        /* file options type */
     char geexe  [MAXSTRPATH]; /* google earth exec file */
     char solstat[MAXSTRPATH]; /* solution statistics file */
     char trace  [MAXSTRPATH]; /* debug trace file */
+    char cache  [MAXSTRPATH]; /* product cache directory ("":off) */
 } filopt_t;
 
 typedef struct {        /* RINEX options type */
@@ -1162,6 +1194,8 @@ typedef struct {        /* RINEX options type */
     int halfcyc;        /* half cycle correction */
     int sortsats;       /* Sort by satellite index */
     int sep_nav;        /* separated nav files */
+    int onepass;        /* single-pass conversion without scan pass */
+    int nthread;        /* number of threads for multiple sessions */
     gtime_t tstart;     /* first obs time */
     gtime_t tend;       /* last obs time */
     gtime_t trtcm;      /* approx log start time for rtcm */
@@ -1204,6 +1238,20 @@ typedef struct {        /* ambiguity control type */
     char flags[MAXSAT]; /* fix flags */
 } ambc_t;
 
+typedef struct {        /* latency histogram type */
+    uint32_t n;         /* number of samples */
+    uint32_t max;       /* max latency (us) */
+    uint32_t bin[NLATBIN]; /* samples in log-scale bins of latency */
+} lathist_t;
+
+typedef struct {        /* processing stage latency statistics type */
+    int ena;            /* enable (0:off,1:on) */
+    uint32_t tick;      /* start tick of current window (ms) */
+    lathist_t hist[2][NLATSTG]; /* histograms {current,previous window} */
+    uint32_t cnt[NLATSTG]; /* number of samples since start */
+    double sum[NLATSTG]; /* sum of latency since start (us) */
+} latstat_t;
+
 typedef struct {        /* RTK control/result type */
     sol_t  sol;         /* RTK solution */
     double rb[6];       /* base position/velocity (ecef) (m|m/s) */
@@ -1224,6 +1272,7 @@ typedef struct {        /* RTK control/result type */
     int epoch;          /* epoch number */
     int intpres_nb;     // Time interpolation of residuals, number of previous base observations.
     obsd_t intpres_obsb[MAXOBS]; // Time interpolation of residuals, previous base observations.
+    latstat_t *lat;     /* stage latency statistics (NULL: off) */
 } rtk_t;
 
 typedef struct {        /* receiver raw data control type */
@@ -1268,12 +1317,28 @@ typedef struct {        /* stream type */
     uint32_t tick_o;    /* output tick */
     uint32_t tact;      /* active tick */
     uint32_t inbt,outbt; /* input/output bytes at tick */
+    uint32_t nopen;     /* number of opens (to identify descriptors) */
     rtklib_lock_t lock; /* lock flag */
     void *port;         /* type dependent port control struct */
     char path[MAXSTRPATH]; /* stream path */
     char msg [MAXSTRMSG];  /* stream message */
 } stream_t;
 
+typedef struct {        /* stream event wait type */
+    int fd;             /* event poll descriptor (-1:not supported) */
+    int n;              /* number of registered descriptors */
+    int fds[MAXSTREVT]; /* registered descriptors */
+    uint32_t gens[MAXSTREVT]; /* socket generations of descriptors */
+} strevt_t;
+
+typedef struct {        /* http server type */
+    int state;          /* state (0:close,1:wait,2:connect) */
+    uint32_t nreq;      /* number of responded requests */
+    void *tcp;          /* tcp server */
+    void *con;          /* client connections */
+    char msg[MAXSTRMSG]; /* server message */
+} httpsvr_t;
+
 typedef struct {        /* stream converter type */
     int itype,otype;    /* input and output stream type */
     uint32_t tick[32];  /* cycle tick of output message */
@@ -1284,12 +1349,88 @@ typedef struct {        /* stream converter type */
     rtcm_t out;         /* rtcm output data buffer */
 } strconv_t;
 
+typedef struct {        /* stream output queue type */
+    int state;          /* writer state (0:stop,1:running) */
+    uint32_t size;      /* ring buffer size (bytes) */
+    uint32_t wp,rp;     /* write/read pointer (free running) */
+    uint32_t drop;      /* dropped data (bytes) */
+    double lat;         /* average write latency (ms) */
+    uint8_t *buff;      /* ring buffer (NULL: no writer thread) */
+    uint8_t *wbuf;      /* write buffer */
+    stream_t *stream;   /* output stream */
+    stream_t *strin;    /* input stream to relay back (NULL: no relay) */
+    stream_t *strlog;   /* return log stream */
+    rtklib_lock_t lock; /* lock flag of wait and latency */
+    rtklib_cond_t cond; /* condition of data queued or written */
+    rtklib_thread_t thread; /* writer thread */
+} strque_t;
+
+typedef struct {        /* RTK server input decoder type */
+    int state;          /* decoder state (0:stop,1:running) */
+    int index;          /* input stream index (0:rover,1:base,2:corr) */
+    uint32_t size;      /* message queue size (bytes) */
+    uint32_t wp,rp;     /* write/read pointer (free running) */
+    uint32_t drop;      /* dropped messages */
+    uint32_t glofcn[32]; /* GLONASS FCN+8 to be set in raw data (0:none) */
+    uint8_t *buff;      /* message queue (NULL: no decoder thread) */
+    uint8_t *mbuf;      /* message buffer */
+    raw_t *raw;         /* receiver raw control owned by decoder thread */
+    rtcm_t *rtcm;       /* rtcm control owned by decoder thread */
+    dgps_t *dgps;       /* dgps corrections decoded from rtcm 2 */
+    void *svr;          /* RTK server */
+    rtklib_thread_t thread; /* decoder thread */
+} rtkdec_t;
+
+typedef struct {        /* satellite status summary type */
+    uint8_t sys;        /* navigation system */
+    uint8_t vs;         /* valid satellite flag single */
+    uint8_t vsat[NFREQ]; /* valid satellite flag */
+    uint8_t fix [NFREQ]; /* ambiguity fix flag (1:float,2:fix,3:hold) */
+    double azel[2];     /* azimuth/elevation angles {az,el} (rad) */
+    double resp[NFREQ]; /* residuals of pseudorange (m) */
+    double resc[NFREQ]; /* residuals of carrier-phase (m) */
+    float snr[NFREQ];   /* rover signal strength (dBHz) */
+    int lock [NFREQ];   /* lock counter of phase */
+    uint32_t slipc[NFREQ]; /* cycle-slip counter */
+    uint32_t rejc [NFREQ]; /* reject counter */
+} satstat_t;
+
+typedef struct {        /* RTK server status snapshot type */
+    uint32_t seq;       /* sequence counter (odd:being updated) */
+    uint32_t count;     /* snapshot count */
+    sol_t sol;          /* solution */
+    double rb[6];       /* base position/velocity (ecef) (m|m/s) */
+    double xf[3],sf[3]; /* float rover position and std (ecef) (m) */
+    double xa[3],sa[3]; /* fixed rover position and std (ecef) (m) */
+    double tt;          /* time difference between current and previous (s) */
+    int nx,na;          /* number of float/fixed states */
+    gtime_t tobs[3];    /* time of observation data {rov,base,corr} */
+    int nobs[3];        /* number of observation data {rov,base,corr} */
+    uint8_t sat[3][MAXOBS]; /* satellites of observation data */
+    float snr[3][MAXOBS][NFREQ]; /* signal strength of observation data (dBHz) */
+    satstat_t ssat[MAXSAT]; /* satellite status */
+    int sstat[MAXSTRRTK]; /* stream status */
+    int state[MAXSTRRTK]; /* stream state (-1:error,0:close,1:open) */
+    uint32_t inb[MAXSTRRTK],inr[MAXSTRRTK]; /* stream input bytes/rate */
+    uint32_t outb[MAXSTRRTK],outr[MAXSTRRTK]; /* stream output bytes/rate */
+    char msg[MAXSTRMSG]; /* stream status messages */
+    int nb[3];          /* bytes in input buffers {rov,base,corr} */
+    uint32_t nmsg[3][10]; /* input message counts */
+    uint32_t nsolq[MAXSOLQ+1]; /* number of solutions by quality */
+    uint32_t qlen[3],qsize[3],qdrop[3]; /* decoder queue bytes/size/drops */
+    int cputime;        /* CPU time (ms) for a processing cycle */
+    int prcout;         /* missing observation data count */
+} svrstat_t;
+
 typedef struct {        /* stream server type */
     int state;          /* server state (0:stop,1:running) */
     int cycle;          /* server cycle (ms) */
     int buffsize;       /* input/monitor buffer size (bytes) */
     int nmeacycle;      /* NMEA request cycle (ms) (0:no) */
     int relayback;      /* relay back of output streams (0:no) */
+    int evtwait;        /* wait for input data events (0:off,1:on) */
+    int qsize;          /* output queue size (bytes) (0:no writer thread) */
+    int qblock;         /* output queue full (0:drop data,1:wait) */
     int nstr;           /* number of streams (1 input + (nstr-1) outputs */
     int npb;            /* data length in peek buffer (bytes) */
     char cmds_periodic[16][MAXRCVCMD]; /* periodic commands */
@@ -1300,6 +1441,9 @@ typedef struct {        /* stream server type */
     stream_t stream[16]; /* input/output streams */
     stream_t strlog[16]; /* return log streams */
     strconv_t *conv[16]; /* stream converter */
+    int convdec[16];    /* index of converter decoding input for converter */
+    int convenc[16];    /* index of converter encoding output for converter */
+    strque_t que[16];   /* output queues of writer threads */
     rtklib_thread_t thread; /* server thread */
     rtklib_lock_t lock; /* lock flag */
 } strsvr_t;
@@ -1307,6 +1451,10 @@ typedef struct {        /* stream server type */
 typedef struct {        /* RTK server type */
     int state;          /* server state (0:stop,1:running) */
     int cycle;          /* processing cycle (ms) */
+    int evtwait;        /* wait for input data events (0:off,1:on) */
+    int decthread;      /* decode inputs in decoder threads (0:off,1:on) */
+    int replay;         /* replay inputs by time-tags with no wait (0:off,1:on) */
+    latstat_t lat;      /* stage latency statistics */
     int nmeacycle;      /* NMEA request cycle (ms) (0:no req) */
     int nmeareq;        /* NMEA request (0:no,1:nmeapos,2:single sol) */
     double nmeapos[3];  /* NMEA request position (ecef) (m) */
@@ -1336,8 +1484,15 @@ typedef struct {        /* RTK server type */
     stream_t *moni;     /* monitor stream */
     uint32_t tick;      /* start tick */
     rtklib_thread_t thread; /* server thread */
+    rtkdec_t dec[3];    /* input decoders {rov,base,corr} */
+    rtklib_lock_t qlock; /* lock flag of decoder queue wait */
+    rtklib_cond_t qcond; /* condition of decoder queue read or written */
     int cputime;        /* CPU time (ms) for a processing cycle */
     int prcout;         /* missing observation data count */
+    uint32_t nsolq[MAXSOLQ+1]; /* number of solutions by quality */
+    svrstat_t stat[2];  /* status snapshots (double buffer) */
+    uint32_t nstat;     /* number of status snapshots published */
+    uint32_t navseq;    /* update count of navigation data */
     int nave;           /* number of averaging base pos */
     double rb_ave[3];   /* averaging base pos */
     char cmds_periodic[3][MAXRCVCMD]; /* periodic commands */
@@ -1347,6 +1502,44 @@ typedef struct {        /* RTK server type */
     rtklib_lock_t lock; /* lock flag */
 } rtksvr_t;
 
+typedef struct {        /* multi-rover RTK server rover type */
+    int format;         /* input format (STRFMT_???) */
+    int nb;             /* bytes in input buffer */
+    uint8_t *buff;      /* input buffer */
+    rtk_t rtk;          /* RTK control/result struct */
+    solopt_t solopt;    /* solution options */
+    raw_t *raw;         /* receiver raw control (NULL: RTCM input) */
+    rtcm_t *rtcm;       /* RTCM control (NULL: receiver raw input) */
+    obs_t obs;          /* observation data {rover+base} */
+    int strs[3];        /* stream types {input,solution,log} */
+    char paths[3][MAXSTRPATH]; /* stream paths {input,solution,log} */
+    stream_t stream[3]; /* streams {input,solution,log} */
+    uint32_t nmsg[10];  /* input message counts */
+    uint32_t nsol[MAXSOLQ+1]; /* number of solutions by quality */
+} rtkrov_t;
+
+typedef struct {        /* multi-rover RTK server worker type */
+    int index;          /* worker index */
+    uint32_t navseq;    /* update count of navigation data of snapshot */
+    nav_t nav;          /* navigation data snapshot */
+    obs_t base;         /* base station observation data snapshot */
+    double rb[6];       /* base station position/velocity (ecef) (m|m/s) */
+    double optrb[3];    /* averaged base station position (ecef) (m) */
+    void *msvr;         /* multi-rover RTK server */
+    rtklib_thread_t thread; /* worker thread */
+} rtkwork_t;
+
+typedef struct {        /* multi-rover RTK server type */
+    int state;          /* server state (0:stop,1:running) */
+    int cycle;          /* processing cycle (ms) */
+    int buffsize;       /* input buffer size (bytes) */
+    int nrov,nrovmax;   /* number of rovers */
+    int nwork;          /* number of worker threads */
+    rtkrov_t **rov;     /* rovers */
+    rtkwork_t *work;    /* worker threads */
+    rtksvr_t *svr;      /* RTK server of base station and corrections */
+} rtkmsvr_t;
+
 typedef struct {        /* GIS data point type */
     double pos[3];      /* point data {lat,lon,height} (rad,m) */
 } gis_pnt_t;
@@ -1438,6 +1631,7 @@ EXPORT void add_fatal(fatalfunc_t *func);
 /* time and string functions -------------------------------------------------*/
 EXPORT void    setstr(char *dst, const char *src, int n);
 EXPORT double  str2num(const char *s, int i, int n);
+EXPORT double  str2dec(const char *s, int n);
 EXPORT int     str2time(const char *s, int i, int n, gtime_t *t);
 EXPORT char    *time2str(gtime_t t, char str[40], int n);
 EXPORT gtime_t epoch2time(const double *ep);
@@ -1465,7 +1659,14 @@ EXPORT int read_leaps(const char *file);
 
 EXPORT int adjgpsweek(int week);
 EXPORT uint32_t tickget(void);
+EXPORT uint32_t tickgetus(void);
+EXPORT void latinit (latstat_t *lat, int ena);
+EXPORT uint32_t latstart(const latstat_t *lat);
+EXPORT void latadd  (latstat_t *lat, int stg, uint32_t t0);
+EXPORT void latquant(const latstat_t *lat, int stg, int *n, double *p50,
+                     double *p99, double *max);
 EXPORT void sleepms(int ms);
+EXPORT void condwaitms(rtklib_cond_t *cond, rtklib_lock_t *lock, int ms);
 
 EXPORT int reppath(const char *path, char *rpath, gtime_t time, const char *rov,
                    const char *base);
@@ -1496,6 +1697,14 @@ EXPORT void freenav(nav_t *nav, int opt);
 EXPORT int  readblq(const char *file, const char *sta, double odisp[2][11][3]);
 EXPORT int  readerp(const char *file, erp_t *erp);
 EXPORT int  geterp (const erp_t *erp, gtime_t time, double *val);
+EXPORT void setprodcache(const char *dir);
+EXPORT int  getprodcache(int *nhit, int *nmiss);
+EXPORT int  loadprodcache(const char *file, int kind, const char *opt,
+                          int index, char *type, nav_t *nav, pcvs_t *pcvs,
+                          erp_t *erp);
+EXPORT int  saveprodcache(const char *file, int kind, const char *opt,
+                          char type, const nav_t *nav, const int *n0,
+                          const pcvs_t *pcvs, const erp_t *erp);
 
 /* debug trace functions -----------------------------------------------------*/
 #ifdef TRACE
@@ -1607,6 +1816,8 @@ EXPORT int readrnxt(const char *file, int rcv, gtime_t ts, gtime_t te,
                     double tint, const char *opt, obs_t *obs, nav_t *nav,
                     sta_t *sta);
 EXPORT int readrnxc(const char *file, nav_t *nav);
+EXPORT void initnavh(nav_t *nav);
+EXPORT int mergenav(nav_t *nav, const nav_t *src);
 EXPORT int outrnxobsh(FILE *fp, const rnxopt_t *opt, const nav_t *nav);
 EXPORT int outrnxobsb(FILE *fp, const rnxopt_t *opt, const obsd_t *obs, int n,
                       int epflag);
@@ -1663,6 +1874,11 @@ EXPORT int tle_name_read(const char *file, tle_t *tle);
 EXPORT int tle_pos(gtime_t time, const char *name, const char *satno,
                    const char *desig, const tle_t *tle, const erp_t *erp,
                    double *rs);
+EXPORT int tle_index(const char *name, const char *satno, const char *desig,
+                     const tle_t *tle);
+EXPORT int tle_pos_batch(const gtime_t *time, int nt, const int *index, int ns,
+                         const tle_t *tle, const erp_t *erp, double *rs,
+                         int *stat);
 
 /* receiver raw data functions -----------------------------------------------*/
 EXPORT uint32_t getbitu(const uint8_t *buff, int pos, int len);
@@ -1691,6 +1907,8 @@ EXPORT int init_raw   (raw_t *raw, int format);
 EXPORT void free_raw  (raw_t *raw);
 EXPORT int input_raw  (raw_t *raw, int format, uint8_t data);
 EXPORT int input_rawf (raw_t *raw, int format, FILE *fp);
+EXPORT int input_rawb (raw_t *raw, int format, const uint8_t *buff, int n,
+                       int *ret);
 
 EXPORT int init_rt17  (raw_t *raw);
 EXPORT int init_sbf   (raw_t *raw);
@@ -1710,6 +1928,8 @@ EXPORT int input_rt17  (raw_t *raw, uint8_t data);
 EXPORT int input_sbf   (raw_t *raw, uint8_t data);
 EXPORT int input_tersus(raw_t *raw, uint8_t data);
 EXPORT int input_unicore(raw_t *raw, uint8_t data);
+EXPORT int input_ubxb  (raw_t *raw, const uint8_t *buff, int n, int *ret);
+EXPORT int input_sbfb  (raw_t *raw, const uint8_t *buff, int n, int *ret);
 EXPORT int input_oem4f (raw_t *raw, FILE *fp);
 EXPORT int input_cnavf (raw_t *raw, FILE *fp);
 EXPORT int input_ubxf  (raw_t *raw, FILE *fp);
@@ -1733,6 +1953,7 @@ EXPORT int init_rtcm   (rtcm_t *rtcm);
 EXPORT void free_rtcm  (rtcm_t *rtcm);
 EXPORT int input_rtcm2 (rtcm_t *rtcm, uint8_t data);
 EXPORT int input_rtcm3 (rtcm_t *rtcm, uint8_t data);
+EXPORT int input_rtcm3b(rtcm_t *rtcm, const uint8_t *buff, int n, int *ret);
 EXPORT int input_rtcm2f(rtcm_t *rtcm, FILE *fp);
 EXPORT int input_rtcm3f(rtcm_t *rtcm, FILE *fp);
 EXPORT int gen_rtcm2   (rtcm_t *rtcm, int type, int sync);
@@ -1825,6 +2046,8 @@ EXPORT void strclose (stream_t *stream);
 EXPORT int  strread  (stream_t *stream, uint8_t *buff, int n);
 EXPORT int  strwrite (stream_t *stream, uint8_t *buff, int n);
 EXPORT void strsync  (stream_t *stream1, stream_t *stream2);
+EXPORT int  strreptime(stream_t *stream, gtime_t *time);
+EXPORT void strsetreptime(stream_t *stream, gtime_t time);
 EXPORT int  strstat  (stream_t *stream, char *msg);
 EXPORT int  strstatx (stream_t *stream, char *msg);
 EXPORT void strsum   (stream_t *stream, int *inb, int *inr, int *outb, int *outr);
@@ -1835,6 +2058,15 @@ EXPORT void strsendcmd(stream_t *stream, const char *cmd);
 EXPORT void strsettimeout(stream_t *stream, int toinact, int tirecon);
 EXPORT void strsetdir(const char *dir);
 EXPORT void strsetproxy(const char *addr);
+EXPORT void strsetmaxcli(int n);
+EXPORT int  strevtinit(strevt_t *evt);
+EXPORT void strevtfree(strevt_t *evt);
+EXPORT int  strevtwait(strevt_t *evt, stream_t *stream, int n, int timeout);
+EXPORT int  httpsvropen (httpsvr_t *svr, const char *path, char *msg);
+EXPORT void httpsvrclose(httpsvr_t *svr);
+EXPORT int  httpsvrreq  (httpsvr_t *svr, char *url);
+EXPORT void httpsvrrsp  (httpsvr_t *svr, int i, int code, const char *type,
+                         const char *body, int n);
 
 /* integer ambiguity resolution ----------------------------------------------*/
 EXPORT int lambda(int n, int m, const double *a, const double *Q, double *F,
@@ -1878,7 +2110,7 @@ EXPORT int  strsvrstart(strsvr_t *svr, int *opts, int *strs, const char **paths,
                         const char **cmds_periodic, const double *nmeapos);
 EXPORT void strsvrstop (strsvr_t *svr, const char **cmds);
 EXPORT void strsvrstat (strsvr_t *svr, int *stat, int *log_stat, int *byte,
-                        int *bps, char *msg);
+                        int *bps, int *qlen, int *qdrop, int *qlat, char *msg);
 EXPORT strconv_t *strconvnew(int itype, int otype, const char *msgs, int staid,
                              int stasel, const char *opt);
 EXPORT void strconvfree(strconv_t *conv);
@@ -1900,7 +2132,18 @@ EXPORT void rtksvrunlock(rtksvr_t *svr);
 EXPORT int  rtksvrostat (rtksvr_t *svr, int type, gtime_t *time, int *sat,
                          double *az, double *el, int **snr, int *vsat);
 EXPORT void rtksvrsstat (rtksvr_t *svr, int *sstat, char *msg);
+EXPORT int  rtksvrstat  (rtksvr_t *svr, svrstat_t *stat);
 EXPORT int  rtksvrmark(rtksvr_t *svr, const char *name, const char *comment);
+EXPORT int  rtksvrlstat(rtksvr_t *svr, int *n, double *p50, double *p99,
+                        double *max);
+EXPORT int  rtkmsvrinit (rtkmsvr_t *msvr, rtksvr_t *svr, int nwork);
+EXPORT void rtkmsvrfree (rtkmsvr_t *msvr);
+EXPORT int  rtkmsvradd  (rtkmsvr_t *msvr, const int *strs, const char **paths,
+                         int format, const char *rcvopt, const prcopt_t *prcopt,
+                         const solopt_t *solopt);
+EXPORT int  rtkmsvrstart(rtkmsvr_t *msvr, int cycle, int buffsize,
+                         char *errmsg);
+EXPORT void rtkmsvrstop (rtkmsvr_t *msvr);
 
 /* downloader functions ------------------------------------------------------*/
 EXPORT int dl_readurls(const char *file, const char **types, int ntype, url_t *urls,
@@ -1913,6 +2156,7 @@ EXPORT int dl_exec(gtime_t ts, gtime_t te, double ti, int seqnos, int seqnoe,
 EXPORT void dl_test(gtime_t ts, gtime_t te, double ti, const url_t *urls,
                     int nurl, const char **stas, int nsta, const char *dir,
                     int ncol, int datefmt, FILE *fp);
+EXPORT void dl_setconc(int nthread, int nhost, int nretry, double tretry);
 
 /* GIS data functions --------------------------------------------------------*/
 EXPORT int gis_read(const char *file, gis_t *gis, int layer);
@@ -46,6 +46,8 @@
 *                           add detecting cycle slips by L1-Lx GF phase jump
 *                           delete GLONASS IFB correction in ddres()
 *                           use integer types in stdint.h
+*           2026/10/18 1.17 add stage latency statistics in relpos()
+*                           structure of arrays of satellites in zdres(),ddres()
 *-----------------------------------------------------------------------------*/
 #include <stdarg.h>
 #include "rtklib.h"
@@ -98,6 +100,19 @@ static double ar_poly_coeffs[3][5] = {
     {6.42237302e-01, -8.39813962e+00,  2.92107285e+01, -2.37577308e+01, -1.14307128e+00},
     {-2.22600390e-02,  3.23169103e-01, -1.39837429e+00, 2.19282996e+00, -5.34583971e-02}};
 
+typedef struct {                /* satellite data of epoch (structure of arrays) */
+    int n;                      /* number of satellites */
+    double rs[3][MAXOBS];       /* satellite positions {x,y,z} ecef (m) */
+    double e[3][MAXOBS];        /* line-of-sight unit vectors {x,y,z} ecef */
+    double r[MAXOBS];           /* geometric ranges (m) */
+    double az[MAXOBS],el[MAXOBS]; /* azimuth/elevation angles (rad) */
+    double freq[NFREQ][MAXOBS]; /* carrier frequencies (Hz) */
+    double dant[NFREQ][MAXOBS]; /* receiver antenna corrections (m) */
+    double L[NFREQ][MAXOBS];    /* carrier-phases (cycle) */
+    double P[NFREQ][MAXOBS];    /* pseudoranges (m) */
+    uint8_t valid[MAXOBS];      /* valid satellite flags */
+} epsat_t;
+
 /* global variables ----------------------------------------------------------*/
 static int statlevel=0;          /* rtk status output level (0:off) */
 static FILE *fp_stat=NULL;       /* rtk status file pointer */
@@ -958,49 +973,112 @@ static void udstate(rtk_t *rtk, const obsd_t *obs, const int *sat,
         udbias(rtk,tt,obs,sat,iu,ir,ns,nav);
     }
 }
-/* UD (undifferenced) phase/code residual for satellite ----------------------*/
-static void zdres_sat(int base, double r, const obsd_t *obs, const nav_t *nav,
-                      const double *azel, const double *dant,
-                      const prcopt_t *opt, double *y, double *freq)
+/* geometry of satellites ------------------------------------------------------
+* geometric ranges, line-of-sight vectors and azimuth/elevation angles of all
+* satellites of epoch in batch (equivalent to geodist() and satazel())
+*-----------------------------------------------------------------------------*/
+static void epsat_geom(epsat_t *ep, const double *rs, const double *rr,
+                       const double *pos)
+{
+    double E[9],enu[3],r;
+    int i,j;
+
+    for (i=0;i<ep->n;i++) for (j=0;j<3;j++) ep->rs[j][i]=rs[j+i*6];
+
+    /* geometric ranges with sagnac effect and line-of-sight vectors */
+    for (i=0;i<ep->n;i++) {
+        ep->valid[i]=sqrt(ep->rs[2][i]*ep->rs[2][i]+ep->rs[1][i]*ep->rs[1][i]+
+                          ep->rs[0][i]*ep->rs[0][i])>=RE_WGS84;
+        for (j=0;j<3;j++) ep->e[j][i]=ep->rs[j][i]-rr[j];
+        r=sqrt(ep->e[2][i]*ep->e[2][i]+ep->e[1][i]*ep->e[1][i]+
+               ep->e[0][i]*ep->e[0][i]);
+        for (j=0;j<3;j++) ep->e[j][i]/=r;
+        ep->r[i]=r+OMGE*(ep->rs[0][i]*rr[1]-ep->rs[1][i]*rr[0])/CLIGHT;
+    }
+    /* azimuth/elevation angles by local coordinates */
+    if (pos[2]<=-RE_WGS84) {
+        for (i=0;i<ep->n;i++) {ep->az[i]=0.0; ep->el[i]=PI/2.0;}
+        return;
+    }
+    xyz2enu(pos,E);
+    for (i=0;i<ep->n;i++) {
+        for (j=0;j<3;j++) {
+            enu[j]=E[j]*ep->e[0][i]+E[j+3]*ep->e[1][i]+E[j+6]*ep->e[2][i];
+        }
+        ep->az[i]=enu[0]*enu[0]+enu[1]*enu[1]<1E-12?0.0:atan2(enu[0],enu[1]);
+        if (ep->az[i]<0.0) ep->az[i]+=2*PI;
+        ep->el[i]=asin(enu[2]);
+    }
+}
+/* UD (undifferenced) phase/code residuals by iono-free LC -------------------*/
+static void zdres_lc(int base, const epsat_t *ep, const obsd_t *obs,
+                     const nav_t *nav, const prcopt_t *opt, double *y,
+                     double *freq)
 {
     double freq1,freq2,C1,C2,dant_if;
-    int i,nf=NF(opt),f2;
+    int i,f2;
 
-    if (opt->ionoopt==IONOOPT_IFLC) { /* iono-free linear combination */
-        freq1=sat2freq(obs->sat,obs->code[0],nav);
-        f2=seliflc(opt->nf,satsys(obs->sat,NULL));
-        freq2=sat2freq(obs->sat,obs->code[f2],nav);
+    for (i=0;i<ep->n;i++) {
+        if (!ep->valid[i]) continue;
 
-        if (freq1==0.0||freq2==0.0) return;
+        freq1=sat2freq(obs[i].sat,obs[i].code[0],nav);
+        f2=seliflc(opt->nf,satsys(obs[i].sat,NULL));
+        freq2=sat2freq(obs[i].sat,obs[i].code[f2],nav);
 
-        if (testsnr(base,0,azel[1],obs->SNR[0],&opt->snrmask)||
-            testsnr(base,f2,azel[1],obs->SNR[f2],&opt->snrmask)) return;
+        if (freq1==0.0||freq2==0.0) continue;
+
+        if (testsnr(base,0,ep->el[i],obs[i].SNR[0],&opt->snrmask)||
+            testsnr(base,f2,ep->el[i],obs[i].SNR[f2],&opt->snrmask)) continue;
 
         C1= SQR(freq1)/(SQR(freq1)-SQR(freq2));
         C2=-SQR(freq2)/(SQR(freq1)-SQR(freq2));
-        dant_if=C1*dant[0]+C2*dant[f2];
+        dant_if=C1*ep->dant[0][i]+C2*ep->dant[f2][i];
 
-        if (obs->L[0]!=0.0&&obs->L[f2]!=0.0) {
-            y[0]=C1*obs->L[0]*CLIGHT/freq1+C2*obs->L[f2]*CLIGHT/freq2-r-dant_if;
+        if (obs[i].L[0]!=0.0&&obs[i].L[f2]!=0.0) {
+            y[i*2]=C1*obs[i].L[0]*CLIGHT/freq1+C2*obs[i].L[f2]*CLIGHT/freq2-
+                   ep->r[i]-dant_if;
         }
-        if (obs->P[0]!=0.0&&obs->P[f2]!=0.0) {
-            y[nf]=C1*obs->P[0]+C2*obs->P[f2]-r-dant_if;
+        if (obs[i].P[0]!=0.0&&obs[i].P[f2]!=0.0) {
+            y[1+i*2]=C1*obs[i].P[0]+C2*obs[i].P[f2]-ep->r[i]-dant_if;
         }
-        freq[0]=1.0;
+        freq[i]=1.0;
     }
-    else {
-        for (i=0;i<nf;i++) {
-            if ((freq[i]=sat2freq(obs->sat,obs->code[i],nav))==0.0) continue;
+}
+/* UD (undifferenced) phase/code residuals by frequency ----------------------*/
+static void zdres_frq(int base, epsat_t *ep, const obsd_t *obs,
+                      const nav_t *nav, const prcopt_t *opt, double *y,
+                      double *freq)
+{
+    int i,j,nf=NF(opt);
+
+    /* frequencies and measurements */
+    for (i=0;i<ep->n;i++) {
+        if (!ep->valid[i]) continue;
+        for (j=0;j<nf;j++) {
+            ep->freq[j][i]=sat2freq(obs[i].sat,obs[i].code[j],nav);
+            ep->L[j][i]=obs[i].L[j];
+            ep->P[j][i]=obs[i].P[j];
+        }
+    }
+    for (j=0;j<nf;j++) {
+        for (i=0;i<ep->n;i++) {
+            if (!ep->valid[i]) continue;
+            if ((freq[j+i*nf]=ep->freq[j][i])==0.0) continue;
 
             /* check SNR mask */
-            if (testsnr(base,i,azel[1],obs->SNR[i],&opt->snrmask)) {
+            if (testsnr(base,j,ep->el[i],obs[i].SNR[j],&opt->snrmask)) {
                 continue;
             }
             /* residuals = observable - estimated range */
-            if (obs->L[i]!=0.0) y[i   ]=obs->L[i]*CLIGHT/freq[i]-r-dant[i];
-            if (obs->P[i]!=0.0) y[i+nf]=obs->P[i]               -r-dant[i];
-            trace(4,"zdres_sat: %d: L=%.6f P=%.6f r=%.6f f=%.0f\n",obs->sat,obs->L[i],
-                obs->P[i],r,freq[i]);
+            if (ep->L[j][i]!=0.0) {
+                y[j+i*nf*2]=ep->L[j][i]*CLIGHT/ep->freq[j][i]-ep->r[i]-
+                            ep->dant[j][i];
+            }
+            if (ep->P[j][i]!=0.0) {
+                y[j+nf+i*nf*2]=ep->P[j][i]-ep->r[i]-ep->dant[j][i];
+            }
+            trace(4,"zdres_frq: %d: L=%.6f P=%.6f r=%.6f f=%.0f\n",obs[i].sat,
+                  ep->L[j][i],ep->P[j][i],ep->r[i],ep->freq[j][i]);
         }
     }
 }
@@ -1019,15 +1097,18 @@ static void zdres_sat(int base, double r, const obsd_t *obs, const nav_t *nav,
         I   opt  = options
         O   y[(0:1)+i*2] = zero diff residuals {phase,code} (m)
         O   e    = line of sight unit vectors to sats
-        O   azel = [az, el] to sats                                           */
+        O   azel = [az, el] to sats
+ notes: the satellites of the epoch are gathered into structure of arrays and
+        geometry, troposphere, antenna and residuals are computed in batches */
 static int zdres(int base, const obsd_t *obs, int n, const double *rs,
                  const double *dts, const double *var, const int *svh,
                  const nav_t *nav, const double *rr, const prcopt_t *opt,
                  double *y, double *e, double *azel, double *freq)
 {
-    double r,rr_[3],pos[3],dant[NFREQ]={0},disp[3];
+    epsat_t ep;
+    double rr_[3],pos[3],dant[NFREQ]={0},disp[3];
     double mapfh,zhd,zazel[]={0.0,90.0*D2R};
-    int i,nf=NF(opt);
+    int i,j,nf=NF(opt);
 
     trace(3,"zdres   : n=%d rr=%.2f %.2f %.2f\n",n,rr[0], rr[1], rr[2]);
 
@@ -1048,30 +1129,43 @@ static int zdres(int base, const obsd_t *obs, int n, const double *rs,
     /* translate rcvr pos from ecef to geodetic */
     ecef2pos(rr_,pos);
 
-    /* loop through satellites */
-    for (i=0;i<n;i++) {
-        /* compute geometric-range and azimuth/elevation angle */
-        if ((r=geodist(rs+i*6,rr_,e+i*3))<=0.0) continue;
-        if (satazel(pos,e+i*3,azel+i*2)<opt->elmin) continue;
-
-        /* excluded satellite? */
-        if (satexclude(obs[i].sat,var[i],svh[i],opt)) continue;
-
-        /* adjust range for satellite clock-bias */
-        r+=-CLIGHT*dts[i*2];
-
-        /* adjust range for troposphere delay model (hydrostatic) */
-        zhd=tropmodel(obs[0].time,pos,zazel,0.0);
+    /* compute geometric-range and azimuth/elevation angle */
+    ep.n=MIN(n,MAXOBS);
+    epsat_geom(&ep,rs,rr_,pos);
+
+    for (i=0;i<ep.n;i++) {
+        if (!ep.valid[i]) continue;
+        for (j=0;j<3;j++) e[j+i*3]=ep.e[j][i];
+        azel[i*2]=ep.az[i]; azel[1+i*2]=ep.el[i];
+
+        /* elevation mask and excluded satellite */
+        ep.valid[i]=!(ep.el[i]<opt->elmin)&&
+                    !satexclude(obs[i].sat,var[i],svh[i],opt);
+    }
+    /* adjust range for satellite clock-bias and troposphere delay model
+       (hydrostatic) */
+    zhd=tropmodel(obs[0].time,pos,zazel,0.0);
+    for (i=0;i<ep.n;i++) {
+        if (!ep.valid[i]) continue;
+        ep.r[i]+=-CLIGHT*dts[i*2];
         mapfh=tropmapf(obs[i].time,pos,azel+i*2,NULL);
-        r+=mapfh*zhd;
-
-        /* calc receiver antenna phase center correction */
+        ep.r[i]+=mapfh*zhd;
+        trace(4,"sat=%d r=%.6f c*dts=%.6f zhd=%.6f map=%.6f\n",obs[i].sat,
+              ep.r[i],CLIGHT*dts[i*2],zhd,mapfh);
+    }
+    /* calc receiver antenna phase center correction */
+    for (i=0;i<ep.n;i++) {
+        if (!ep.valid[i]) continue;
         antmodel(opt->pcvr+base,opt->antdel[base],azel+i*2,opt->posopt[1],
                  dant);
-
-        /* calc undifferenced phase/code residual for satellite */
-        trace(4,"sat=%d r=%.6f c*dts=%.6f zhd=%.6f map=%.6f\n",obs[i].sat,r,CLIGHT*dts[i*2],zhd,mapfh);
-        zdres_sat(base,r,obs+i,nav,azel+i*2,dant,opt,y+i*nf*2,freq+i*nf);
+        for (j=0;j<NFREQ;j++) ep.dant[j][i]=dant[j];
+    }
+    /* calc undifferenced phase/code residuals */
+    if (opt->ionoopt==IONOOPT_IFLC) {
+        zdres_lc(base,&ep,obs,nav,opt,y,freq);
+    }
+    else {
+        zdres_frq(base,&ep,obs,nav,opt,y,freq);
     }
     trace(4,"rr_=%.3f %.3f %.3f\n",rr_[0],rr_[1],rr_[2]);
     trace(4,"pos=%.9f %.9f %.3f\n",pos[0]*R2D,pos[1]*R2D,pos[2]);
@@ -1219,7 +1313,9 @@ static int ddres(rtk_t *rtk, const obsd_t *obs, double dt, const double *x,
     prcopt_t *opt=&rtk->opt;
     double bl,dr[3],posu[3],posr[3],didxi=0.0,didxj=0.0,*im;
     double *tropr,*tropu,*dtdxr,*dtdxu,*Ri,*Rj,freqi,freqj,*Hi=NULL,df;
+    double *els,*frqs;
     int i,j,k,m,f,nv=0,nb[NFREQ*NSYS*2+2]={0},b=0,sysi,sysj,nf=NF(opt);
+    int *syss;
     int frq,code;
 
     trace(3,"ddres   : dt=%.4f ns=%d\n",dt,ns);
@@ -1231,11 +1327,20 @@ static int ddres(rtk_t *rtk, const obsd_t *obs, double dt, const double *x,
 
     Ri=mat(ns*nf*2+2,1); Rj=mat(ns*nf*2+2,1); im=mat(ns,1);
     tropu=mat(ns,1); tropr=mat(ns,1); dtdxu=mat(ns,3); dtdxr=mat(ns,3);
+    els=mat(ns,1); frqs=mat(ns,nf); syss=imat(ns,1);
 
     /* zero out residual phase and code biases for all satellites */
     for (i=0;i<MAXSAT;i++) for (j=0;j<NFREQ;j++) {
         rtk->ssat[i].resp[j]=rtk->ssat[i].resc[j]=0.0;
     }
+    /* gather elevations, systems and frequencies of common sats */
+    for (i=0;i<ns;i++) {
+        els[i]=azel[1+iu[i]*2];
+        syss[i]=rtk->ssat[sat[i]-1].sys;
+    }
+    for (f=0;f<nf;f++) for (i=0;i<ns;i++) {
+        frqs[i+f*ns]=freq[f+iu[i]*nf];
+    }
     /* compute factors of ionospheric and tropospheric delay
            - only used if kalman filter contains states for ION and TROP delays
            usually insignificant for short baselines (<10km)*/
@@ -1257,22 +1362,22 @@ static int ddres(rtk_t *rtk, const obsd_t *obs, double dt, const double *x,
 
             /* find reference satellite with highest elevation, set to i */
             for (i=-1,j=0;j<ns;j++) {
-                sysi=rtk->ssat[sat[j]-1].sys;
+                sysi=syss[j];
                 if (!test_sys(sysi,m) || sysi==SYS_SBS) continue;
                 if (!validobs(iu[j],ir[j],f,nf,y)) continue;
                 /* skip sat with slip unless no other valid sat */
                 if (i>=0&&rtk->ssat[sat[j]-1].slip[frq]&LLI_SLIP) continue;
-                if (i<0||azel[1+iu[j]*2]>=azel[1+iu[i]*2]) i=j;
+                if (i<0||els[j]>=els[i]) i=j;
             }
             if (i<0) continue;
 
             /* calculate double differences of residuals (code/phase) for each sat */
             for (j=0;j<ns;j++) {
                 if (i==j) continue;  /* skip ref sat */
-                sysi=rtk->ssat[sat[i]-1].sys;
-                sysj=rtk->ssat[sat[j]-1].sys;
-                freqi=freq[frq+iu[i]*nf];
-                freqj=freq[frq+iu[j]*nf];
+                sysi=syss[i];
+                sysj=syss[j];
+                freqi=frqs[i+frq*ns];
+                freqj=frqs[j+frq*ns];
                 if (freqi<=0.0||freqj<=0.0) continue;
                 if (!test_sys(sysj,m)) continue;
                 if (!validobs(iu[j],ir[j],f,nf,y)) continue;
@@ -1382,11 +1487,11 @@ static int ddres(rtk_t *rtk, const obsd_t *obs, double dt, const double *x,
                 }
 
                 /* single-differenced measurement error variances (m) */
-                Ri[nv] = varerr(sat[i], sysi, azel[1+iu[i]*2],
+                Ri[nv] = varerr(sat[i], sysi, els[i],
                                 rtk->ssat[sat[i]-1].snr_rover[frq],
                                 rtk->ssat[sat[i]-1].snr_base[frq],
                                 bl,dt,f,opt,&obs[iu[i]]);
-                Rj[nv] = varerr(sat[j], sysj, azel[1+iu[j]*2],
+                Rj[nv] = varerr(sat[j], sysj, els[j],
                                 rtk->ssat[sat[j]-1].snr_rover[frq],
                                 rtk->ssat[sat[j]-1].snr_base[frq],
                                 bl,dt,f,opt,&obs[iu[j]]);
@@ -1440,6 +1545,7 @@ static int ddres(rtk_t *rtk, const obsd_t *obs, double dt, const double *x,
 
     free(Ri); free(Rj); free(im);
     free(tropu); free(tropr); free(dtdxu); free(dtdxr);
+    free(els); free(frqs); free(syss);
 
     return nv;
 }
@@ -1979,9 +2085,10 @@ static int relpos(rtk_t *rtk, const obsd_t *obs, int nu, int nr,
     gtime_t time=obs[0].time;
     double *rs,*dts,*var,*y,*e,*azel,*freq,*v,*H,*R,*xp,*Pp,*xa,*bias,dt;
     int i,j,f,n=nu+nr,ns,ny,nv,sat[MAXSAT],iu[MAXSAT],ir[MAXSAT];
-    int info,vflg[MAXOBS*NFREQ*2+1],svh[MAXOBS*2];
+    int info,nb,vflg[MAXOBS*NFREQ*2+1],svh[MAXOBS*2];
     int stat=rtk->opt.mode<=PMODE_DGPS?SOLQ_DGPS:SOLQ_FLOAT;
     int nf=opt->ionoopt==IONOOPT_IFLC?1:opt->nf;
+    uint32_t t0;
 
     trace(3,"relpos  : nu=%d nr=%d\n",nu,nr);
 
@@ -2004,7 +2111,9 @@ static int relpos(rtk_t *rtk, const obsd_t *obs, int nu, int nr,
         }
     }
     /* compute satellite positions, velocities and clocks for base and rover */
+    t0=latstart(rtk->lat);
     satposs(time,obs,n,nav,opt->sateph,rs,dts,var,svh);
+    latadd(rtk->lat,LATSTG_SATPOS,t0);
 
     /* calculate [range - measured pseudorange] for base station (phase and code)
          output is in y[nu:nu+nr], see call for rover below for more details                                                 */
@@ -2074,6 +2183,7 @@ static int relpos(rtk_t *rtk, const obsd_t *obs, int nu, int nr,
                 y    = zero diff residuals (code and phase)
                 e    = line of sight unit vectors to sats
                 azel = [az, el] to sats                                   */
+        t0=latstart(rtk->lat);
         if (!zdres(0,obs,nu,rs,dts,var,svh,nav,xp,opt,y,e,azel,freq)) {
             errmsg(rtk,"rover initial position error\n");
             stat=SOLQ_NONE;
@@ -2096,16 +2206,19 @@ static int relpos(rtk_t *rtk, const obsd_t *obs, int nu, int nr,
             stat=SOLQ_NONE;
             break;
         }
+        latadd(rtk->lat,LATSTG_RES,t0);
         /* kalman filter measurement update, updates x,y,z,sat phase biases, etc
                 K=P*H*(H'*P*H+R)^-1
                 xp=x+K*v
                 Pp=(I-K*H')*P                  */
         trace(3,"before filter x=");tracemat(3,rtk->x,1,9,13,6);
+        t0=latstart(rtk->lat);
         if ((info=filter(xp,Pp,H,v,R,rtk->nx,nv))) {
             errmsg(rtk,"filter error (info=%d)\n",info);
             stat=SOLQ_NONE;
             break;
         }
+        latadd(rtk->lat,LATSTG_FILT,t0);
         trace(3,"after filter x=");tracemat(3,xp,1,9,13,6);
         trace(4,"x(%d)=",i+1); tracemat(4,xp,1,NR(opt),13,4);
     }
@@ -2137,7 +2250,10 @@ static int relpos(rtk_t *rtk, const obsd_t *obs, int nu, int nr,
     /* resolve integer ambiguity by LAMBDA */
     if (stat==SOLQ_FLOAT) {
         /* if valid fixed solution, process it */
-        if (manage_amb_LAMBDA(rtk,bias,xa,sat,nf,ns)>1) {
+        t0=latstart(rtk->lat);
+        nb=manage_amb_LAMBDA(rtk,bias,xa,sat,nf,ns);
+        latadd(rtk->lat,LATSTG_AMB,t0);
+        if (nb>1) {
 
             /* find zero-diff residuals for fixed solution */
             if (zdres(0,obs,nu,rs,dts,var,svh,nav,xa,opt,y,e,azel,freq)) {
@@ -2247,6 +2363,7 @@ extern void rtkinit(rtk_t *rtk, const prcopt_t *opt)
 
     rtk->sol=sol0;
     for (i=0;i<6;i++) rtk->rb[i]=0.0;
+    rtk->lat=NULL;
     rtk->nx=opt->mode<=PMODE_FIXED?NX(opt):pppnx(opt);
     rtk->na=opt->mode<=PMODE_FIXED?NR(opt):pppnx(opt);
     rtk->tt=0.0;
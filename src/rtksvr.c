@@ -42,10 +42,59 @@
 *                            handle multiple ephemeris sets in updatesvr()
 *                            use API sat2freq() to get carrier frequency
 *                            use integer types in stdint.h
+*           2026/10/18  1.23 support event-driven wait of input streams
+*                            input stream data by buffer in decoderaw()
+*                            support decoding inputs in decoder threads
+*                            add api rtkmsvrinit(),rtkmsvrfree(),rtkmsvradd(),
+*                                rtkmsvrstart(),rtkmsvrstop()
+*                            add api rtksvrlstat() for stage latency
+*                            count solutions by quality in nsolq
+*                            add api rtksvrstat() for status snapshot
+*                            add replay mode driven by time-tags of inputs
+*                            read status by rtksvrostat(),rtksvrsstat() from
+*                                status snapshot without lock
+*                            count updates of navigation data in navseq
+*                            wait decoder queues on condition
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
 #define MIN_INT_RESET   30000   /* mininum interval of reset command (ms) */
+#define MIN_INT_STAT    100     /* mininum interval of status snapshot (ms) */
+#define DECQSIZE        0x100000 /* size of decoded message queue (bytes) */
+#define DECQWAIT        100     /* max wait for free space of queue (ms) */
+#define DECQBATCH       16      /* messages read from queue per lock */
+
+#define MAXDECMSG ((int)(MAXSAT*(sizeof(ssr_t)+sizeof(int32_t)))) /* max msg */
+
+#define SQRT(x)     ((x)<=0.0||(x)!=(x)?0.0:sqrt(x))
+#define MIN(x,y)    ((x)<=(y)?(x):(y))
+
+/* load/store pointer of message queue shared between threads ----------------*/
+#ifdef __GNUC__
+#define LOAD_ACQ(p)     __atomic_load_n(p,__ATOMIC_ACQUIRE)
+#define STORE_REL(p,v)  __atomic_store_n(p,v,__ATOMIC_RELEASE)
+#define FENCE_ACQ()     __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define FENCE_REL()     __atomic_thread_fence(__ATOMIC_RELEASE)
+#else
+#define LOAD_ACQ(p)     (*(volatile uint32_t *)(p))
+#define STORE_REL(p,v)  (*(volatile uint32_t *)(p)=(v))
+#define FENCE_ACQ()
+#define FENCE_REL()
+#endif
+
+typedef struct {        /* ion/utc parameters type */
+    double utc_gps[8],utc_glo[8],utc_gal[8],utc_qzs[8],utc_cmp[8];
+    double utc_irn[9],utc_sbs[4];
+    double ion_gps[8],ion_gal[4],ion_qzs[8],ion_cmp[8],ion_irn[8];
+} ionutc_t;
+
+typedef struct {        /* decoded message header type */
+    int32_t ret;        /* decoder return value (1:obs,2:eph,...) */
+    int32_t len;        /* message body length (bytes) */
+    int32_t ephsat;     /* satellite of ephemeris */
+    int32_t ephset;     /* set of ephemeris */
+    int32_t staid;      /* station id */
+} decmsg_t;
 
 /* write solution header to output stream ------------------------------------*/
 static void writesolhead(stream_t *stream, const solopt_t *solopt, const prcopt_t *prcopt)
@@ -91,12 +140,14 @@ static void writesol(rtksvr_t *svr, int index)
 {
     solopt_t solopt=solopt_default;
     uint8_t buff[MAXSOLMSG+1];
+    uint32_t t0;
     int i,n;
     
     tracet(4,"writesol: index=%d\n",index);
     
     for (i=0;i<2;i++) {
         
+        t0=latstart(&svr->lat);
         if (svr->solopt[i].posf==SOLF_STAT) {
             /* output solution status */
             rtksvrlock(svr);
@@ -107,10 +158,16 @@ static void writesol(rtksvr_t *svr, int index)
             /* output solution */
             n=outsols(buff,&svr->rtk.sol,svr->rtk.rb,svr->solopt+i);
         }
+        rtksvrlock(svr);
+        latadd(&svr->lat,LATSTG_FMT,t0);
+        rtksvrunlock(svr);
+        
+        t0=latstart(&svr->lat);
         strwrite(svr->stream+i+3,buff,n);
 
         /* save output buffer */
         rtksvrlock(svr);
+        latadd(&svr->lat,LATSTG_OUT,t0);
         saveoutbuf(svr,buff,n,i);
         rtksvrunlock(svr);
 
@@ -136,10 +193,18 @@ static void writesol(rtksvr_t *svr, int index)
     }
 }
 /* update glonass frequency channel number in raw data struct ----------------*/
-static void update_glofcn(rtksvr_t *svr)
+static void update_glofcn(rtksvr_t *svr, const geph_t *geph)
 {
-    int i,j,sat,frq;
+    int i,j,sat,frq,prn;
     
+    if (svr->dec[0].buff) {
+        /* raw data structs are owned by decoder threads */
+        if (geph->frq<-7||geph->frq>6||satsys(geph->sat,&prn)!=SYS_GLO) return;
+        for (j=0;j<3;j++) {
+            STORE_REL(svr->dec[j].glofcn+prn-1,(uint32_t)(geph->frq+8));
+        }
+        return;
+    }
     for (i=0;i<MAXPRNGLO;i++) {
         sat=satno(SYS_GLO,i+1);
         
@@ -177,16 +242,15 @@ static void update_obs(rtksvr_t *svr, obs_t *obs, int index, int iobs)
         svr->nmsg[index][0]++;
     }
 /* update ephemeris ----------------------------------------------------------*/
-static void update_eph(rtksvr_t *svr, nav_t *nav, int ephsat, int ephset,
-                       int index)
+static void update_eph(rtksvr_t *svr, const eph_t *eph1, const geph_t *geph1,
+                       int ephsat, int ephset, int index)
 {
-    eph_t *eph1,*eph2,*eph3;
+    eph_t *eph2,*eph3;
     int prn;
     
     if (satsys(ephsat,&prn)!=SYS_GLO) {
             if (!svr->navsel||svr->navsel==index+1) {
             /* svr->nav.eph={current_set1,current_set2,prev_set1,prev_set2} */
-            eph1=nav->eph+ephsat-1+MAXSAT*ephset;         /* received */
             eph2=svr->nav.eph+ephsat-1+MAXSAT*ephset;     /* current */
             eph3=svr->nav.eph+ephsat-1+MAXSAT*(2+ephset); /* previous */
                 if (eph2->ttr.time==0||
@@ -203,15 +267,14 @@ static void update_eph(rtksvr_t *svr, nav_t *nav, int ephsat, int ephset,
         }
     else {
            if (!svr->navsel||svr->navsel==index+1) {
-               geph_t *geph1,*geph2,*geph3;
-               geph1=nav->geph+prn-1;
+               geph_t *geph2,*geph3;
                geph2=svr->nav.geph+prn-1;
                geph3=svr->nav.geph+prn-1+MAXPRNGLO;
                if (geph2->tof.time==0||
                    (geph1->iode!=geph3->iode&&geph1->iode!=geph2->iode)) {
                    *geph3=*geph2;
                    *geph2=*geph1;
-                update_glofcn(svr);
+                update_glofcn(svr,geph1);
                }
            }
            svr->nmsg[index][6]++;
@@ -235,8 +298,24 @@ static void update_sbs(rtksvr_t *svr, sbsmsg_t *sbsmsg, int index)
         }
         svr->nmsg[index][3]++;
     }
+/* get ion/utc parameters ----------------------------------------------------*/
+static void get_ionutc(ionutc_t *ionutc, const nav_t *nav)
+{
+    matcpy(ionutc->utc_gps,nav->utc_gps,8,1);
+    matcpy(ionutc->utc_glo,nav->utc_glo,8,1);
+    matcpy(ionutc->utc_gal,nav->utc_gal,8,1);
+    matcpy(ionutc->utc_qzs,nav->utc_qzs,8,1);
+    matcpy(ionutc->utc_cmp,nav->utc_cmp,8,1);
+    matcpy(ionutc->utc_irn,nav->utc_irn,9,1);
+    matcpy(ionutc->utc_sbs,nav->utc_sbs,4,1);
+    matcpy(ionutc->ion_gps,nav->ion_gps,8,1);
+    matcpy(ionutc->ion_gal,nav->ion_gal,4,1);
+    matcpy(ionutc->ion_qzs,nav->ion_qzs,8,1);
+    matcpy(ionutc->ion_cmp,nav->ion_cmp,8,1);
+    matcpy(ionutc->ion_irn,nav->ion_irn,8,1);
+}
 /* update ion/utc parameters -------------------------------------------------*/
-static void update_ionutc(rtksvr_t *svr, nav_t *nav, int index)
+static void update_ionutc(rtksvr_t *svr, const ionutc_t *nav, int index)
 {
         if (svr->navsel==0||svr->navsel==index+1) {
         matcpy(svr->nav.utc_gps,nav->utc_gps,8,1);
@@ -255,13 +334,7 @@ static void update_ionutc(rtksvr_t *svr, nav_t *nav, int index)
         svr->nmsg[index][2]++;
     }
 // Update antenna position ---------------------------------------------------
-static void update_antpos(rtksvr_t *svr, int index) {
-  sta_t *sta;
-  if (svr->format[index] == STRFMT_RTCM2 || svr->format[index] == STRFMT_RTCM3) {
-    sta = &svr->rtcm[index].sta;
-  } else {
-    sta = &svr->raw[index].sta;
-  }
+static void update_antpos(rtksvr_t *svr, const sta_t *sta, int index) {
   if (index == 1 && svr->rtk.opt.refpos == POSOPT_RTCM) {
     // Update base station position.
     for (int i = 0; i < 3; i++) svr->rtk.rb[i] = sta->pos[i];
@@ -309,10 +382,32 @@ static void update_antpos(rtksvr_t *svr, int index) {
   }
   svr->nmsg[index][4]++;
 }
+/* update ssr correction of satellite ----------------------------------------*/
+static void update_ssrsat(rtksvr_t *svr, int sat, const ssr_t *ssr)
+{
+    int i=sat-1,sys,prn;
+    
+    sys=satsys(sat,&prn);
+    
+    /* check corresponding ephemeris exists */
+    if (sys==SYS_GPS||sys==SYS_GAL||sys==SYS_QZS) {
+        if (svr->nav.eph[i       ].iode!=ssr->iode&&
+            svr->nav.eph[i+MAXSAT].iode!=ssr->iode) {
+            return;
+        }
+    }
+    else if (sys==SYS_GLO) {
+        if (svr->nav.geph[prn-1          ].iode!=ssr->iode&&
+            svr->nav.geph[prn-1+MAXPRNGLO].iode!=ssr->iode) {
+            return;
+        }
+    }
+    svr->nav.ssr[i]=*ssr;
+}
 /* update ssr corrections ----------------------------------------------------*/
 static void update_ssr(rtksvr_t *svr, int index)
 {
-    int i,sys,prn,iode;
+    int i;
 
         for (i=0;i<MAXSAT;i++) {
             if (!svr->rtcm[index].ssr[i].update) continue;
@@ -323,23 +418,7 @@ static void update_ssr(rtksvr_t *svr, int index)
         }
             svr->rtcm[index].ssr[i].update=0;
             
-            iode=svr->rtcm[index].ssr[i].iode;
-            sys=satsys(i+1,&prn);
-            
-            /* check corresponding ephemeris exists */
-            if (sys==SYS_GPS||sys==SYS_GAL||sys==SYS_QZS) {
-                if (svr->nav.eph[i       ].iode!=iode&&
-                    svr->nav.eph[i+MAXSAT].iode!=iode) {
-                    continue;
-                }
-            }
-            else if (sys==SYS_GLO) {
-                if (svr->nav.geph[prn-1          ].iode!=iode&&
-                    svr->nav.geph[prn-1+MAXPRNGLO].iode!=iode) {
-                    continue;
-                }
-            }
-            svr->nav.ssr[i]=svr->rtcm[index].ssr[i];
+            update_ssrsat(svr,i+1,svr->rtcm[index].ssr+i);
         }
         svr->nmsg[index][7]++;
     }
@@ -348,6 +427,9 @@ static void update_svr(rtksvr_t *svr, int ret, obs_t *obs, nav_t *nav,
                        int ephsat, int ephset, sbsmsg_t *sbsmsg, int index,
                        int iobs)
 {
+    ionutc_t ionutc;
+    int prn;
+    
     tracet(4,"updatesvr: ret=%d ephsat=%d ephset=%d index=%d\n",ret,ephsat,
            ephset,index);
     
@@ -355,16 +437,28 @@ static void update_svr(rtksvr_t *svr, int ret, obs_t *obs, nav_t *nav,
         update_obs(svr,obs,index,iobs);
     }
     else if (ret==2) { /* ephemeris */
-        update_eph(svr,nav,ephsat,ephset,index);
+        if (satsys(ephsat,&prn)!=SYS_GLO) {
+            update_eph(svr,nav->eph+ephsat-1+MAXSAT*ephset,NULL,ephsat,ephset,
+                       index);
+        }
+        else {
+            update_eph(svr,NULL,nav->geph+prn-1,ephsat,ephset,index);
+        }
     }
     else if (ret==3) { /* sbas message */
         update_sbs(svr,sbsmsg,index);
     }
     else if (ret==9) { /* ion/utc parameters */
-        update_ionutc(svr,nav,index);
+        get_ionutc(&ionutc,nav);
+        update_ionutc(svr,&ionutc,index);
     }
     else if (ret==5) { /* antenna position */
-        update_antpos(svr,index);
+        if (svr->format[index]==STRFMT_RTCM2||svr->format[index]==STRFMT_RTCM3) {
+            update_antpos(svr,&svr->rtcm[index].sta,index);
+        }
+        else {
+            update_antpos(svr,&svr->raw[index].sta,index);
+        }
     }
     else if (ret==7) { /* dgps correction */
         svr->nmsg[index][5]++;
@@ -375,6 +469,7 @@ static void update_svr(rtksvr_t *svr, int ret, obs_t *obs, nav_t *nav,
     else if (ret==-1) { /* error */
         svr->nmsg[index][9]++;
     }
+    if (ret>=2) svr->navseq++; /* navigation data may be updated */
 }
 /* decode receiver raw/rtcm data ---------------------------------------------*/
 static int decoderaw(rtksvr_t *svr, int index)
@@ -382,37 +477,35 @@ static int decoderaw(rtksvr_t *svr, int index)
     obs_t *obs;
     nav_t *nav;
     sbsmsg_t *sbsmsg=NULL;
-    int i,ret,ephsat,ephset,fobs=0;
+    uint32_t t0=latstart(&svr->lat);
+    int i,m,n,ret,ephsat,ephset,fobs=0;
     
     tracet(4,"decoderaw: index=%d\n",index);
     
     rtksvrlock(svr);
     
-    for (i=0;i<svr->nb[index];i++) {
+    for (i=0,n=svr->nb[index];i<n;i+=m) {
         
         /* input rtcm/receiver raw data from stream */
         if (svr->format[index]==STRFMT_RTCM2) {
             ret=input_rtcm2(svr->rtcm+index,svr->buff[index][i]);
+            m=1;
             obs=&svr->rtcm[index].obs;
             nav=&svr->rtcm[index].nav;
             ephsat=svr->rtcm[index].ephsat;
             ephset=svr->rtcm[index].ephset;
         }
         else if (svr->format[index]==STRFMT_RTCM3) {
-            ret=input_rtcm3(svr->rtcm+index,svr->buff[index][i]);
-            if (svr->rtcm[index].nbyte_invalid!=0) {    /* If last message had error: */
-                i-=svr->rtcm[index].nbyte_invalid-1;      /* rewind to last preamble+1 */
-                i=i>=0?i:0;                         /* or beginning of buffer */
-                trace(4,"rewind buff %3d bytes, i=%d\n",svr->rtcm[index].nbyte_invalid-1,i);
-                svr->rtcm[index].nbyte_invalid=0;
-            }
+            /* parity errors are rewound to preamble+1 in input_rtcm3b() */
+            m=input_rtcm3b(svr->rtcm+index,svr->buff[index]+i,n-i,&ret);
             obs=&svr->rtcm[index].obs;
             nav=&svr->rtcm[index].nav;
             ephsat=svr->rtcm[index].ephsat;
             ephset=svr->rtcm[index].ephset;
         }
         else {
-            ret=input_raw(svr->raw+index,svr->format[index],svr->buff[index][i]);
+            m=input_rawb(svr->raw+index,svr->format[index],svr->buff[index]+i,
+                         n-i,&ret);
             obs=&svr->raw[index].obs;
             nav=&svr->raw[index].nav;
             ephsat=svr->raw[index].ephsat;
@@ -435,6 +528,7 @@ static int decoderaw(rtksvr_t *svr, int index)
             if (fobs<MAXOBSBUF) fobs++; else svr->prcout++;
         }
     }
+    if (svr->nb[index]>0) latadd(&svr->lat,LATSTG_DEC,t0);
     svr->nb[index]=0;
     
     rtksvrunlock(svr);
@@ -484,6 +578,7 @@ static void decodefile(rtksvr_t *svr, int index)
         svr->nav.ne = nav->ne;
         svr->nav.nemax = nav->nemax;
         svr->nav.peph=nav->peph;
+        svr->navseq++;
         svr->ftime[index]=utc2gpst(timeget());
         strcpy(svr->files[index],file);
         
@@ -504,6 +599,7 @@ static void decodefile(rtksvr_t *svr, int index)
         svr->nav.nc = nav->nc;
         svr->nav.ncmax = nav->ncmax;
         svr->nav.pclk=nav->pclk;
+        svr->navseq++;
         svr->ftime[index]=utc2gpst(timeget());
         strcpy(svr->files[index],file);
         
@@ -511,6 +607,501 @@ static void decodefile(rtksvr_t *svr, int index)
     }
     free(nav);
 }
+/* read receiver raw/rtcm data from input stream -----------------------------*/
+static int readstr(rtksvr_t *svr, int index)
+{
+    uint8_t *p=svr->buff[index]+svr->nb[index],*q=svr->buff[index]+svr->buffsize;
+    uint32_t t0=latstart(&svr->lat);
+    int n,m;
+    
+    if ((n=strread(svr->stream+index,p,q-p))<=0) return 0;
+    
+    /* write receiver raw/rtcm data to log stream */
+    strwrite(svr->stream+index+5,p,n);
+    svr->nb[index]+=n;
+    
+    /* save peek buffer */
+    rtksvrlock(svr);
+    latadd(&svr->lat,LATSTG_READ,t0);
+    m=n<svr->buffsize-svr->npb[index]?n:svr->buffsize-svr->npb[index];
+    memcpy(svr->pbuf[index]+svr->npb[index],p,m);
+    svr->npb[index]+=m;
+    rtksvrunlock(svr);
+    
+    return n;
+}
+/* put/get data to/from message queue ----------------------------------------*/
+static void ringput(rtkdec_t *dec, uint32_t p, const uint8_t *data, uint32_t n)
+{
+    uint32_t i=p&(dec->size-1),m=dec->size-i;
+    
+    if (n<=m) {
+        memcpy(dec->buff+i,data,n);
+    }
+    else {
+        memcpy(dec->buff+i,data,m);
+        memcpy(dec->buff,data+m,n-m);
+    }
+}
+static void ringget(const rtkdec_t *dec, uint32_t p, uint8_t *data, uint32_t n)
+{
+    uint32_t i=p&(dec->size-1),m=dec->size-i;
+    
+    if (n<=m) {
+        memcpy(data,dec->buff+i,n);
+    }
+    else {
+        memcpy(data,dec->buff+i,m);
+        memcpy(data+m,dec->buff,n-m);
+    }
+}
+/* put decoded message to message queue --------------------------------------*/
+static int decqput(rtkdec_t *dec, const decmsg_t *hdr, const uint8_t *data)
+{
+    uint32_t wp=dec->wp,rp=LOAD_ACQ(&dec->rp),n=sizeof(decmsg_t)+hdr->len;
+    
+    if (dec->size-(wp-rp)<n) return 0;
+    
+    ringput(dec,wp,(const uint8_t *)hdr,sizeof(decmsg_t));
+    if (hdr->len>0) ringput(dec,wp+sizeof(decmsg_t),data,hdr->len);
+    STORE_REL(&dec->wp,wp+n);
+    return 1;
+}
+/* output decoded message to message queue -----------------------------------*/
+static void outdecmsg(rtksvr_t *svr, rtkdec_t *dec, int ret)
+{
+    decmsg_t hdr={0};
+    ionutc_t ionutc;
+    const uint8_t *data=NULL;
+    obs_t *obs;
+    nav_t *nav;
+    sta_t *sta;
+    ssr_t *ssr;
+    int32_t sats[MAXSAT];
+    int i,n,prn,rtcm;
+    
+    rtcm=dec->rtcm!=NULL;
+    if (rtcm) {
+        obs=&dec->rtcm->obs;
+        nav=&dec->rtcm->nav;
+        sta=&dec->rtcm->sta;
+        hdr.ephsat=dec->rtcm->ephsat;
+        hdr.ephset=dec->rtcm->ephset;
+        hdr.staid=dec->rtcm->staid;
+    }
+    else {
+        obs=&dec->raw->obs;
+        nav=&dec->raw->nav;
+        sta=&dec->raw->sta;
+        hdr.ephsat=dec->raw->ephsat;
+        hdr.ephset=dec->raw->ephset;
+    }
+    hdr.ret=ret;
+    
+    switch (ret) {
+        case 1: /* observation data */
+            n=obs->n<MAXOBS?obs->n:MAXOBS;
+            data=(uint8_t *)obs->data;
+            hdr.len=n*sizeof(obsd_t);
+            break;
+        case 2: /* ephemeris */
+            if (satsys(hdr.ephsat,&prn)==SYS_GLO) {
+                data=(uint8_t *)(nav->geph+prn-1);
+                hdr.len=sizeof(geph_t);
+            }
+            else {
+                data=(uint8_t *)(nav->eph+hdr.ephsat-1+MAXSAT*hdr.ephset);
+                hdr.len=sizeof(eph_t);
+            }
+            break;
+        case 3: /* sbas message */
+            if (!rtcm) {
+                data=(uint8_t *)&dec->raw->sbsmsg;
+                hdr.len=sizeof(sbsmsg_t);
+            }
+            break;
+        case 5: /* antenna position */
+            data=(uint8_t *)sta;
+            hdr.len=sizeof(sta_t);
+            break;
+        case 9: /* ion/utc parameters */
+            get_ionutc(&ionutc,nav);
+            data=(uint8_t *)&ionutc;
+            hdr.len=sizeof(ionutc_t);
+            break;
+        case 10: /* ssr message */
+            ssr=(ssr_t *)dec->mbuf;
+            for (i=n=0;i<MAXSAT;i++) {
+                if (!dec->rtcm->ssr[i].update) continue;
+                
+                /* check consistency between iods of orbit and clock */
+                if (dec->rtcm->ssr[i].iod[0]!=
+                    dec->rtcm->ssr[i].iod[1]) {
+                    continue;
+                }
+                dec->rtcm->ssr[i].update=0;
+                ssr[n]=dec->rtcm->ssr[i];
+                sats[n++]=i+1;
+            }
+            memcpy(ssr+n,sats,sizeof(int32_t)*n);
+            data=dec->mbuf;
+            hdr.len=n*(sizeof(ssr_t)+sizeof(int32_t));
+            break;
+        case 7: /* dgps correction */
+        case -1: /* error */
+            break;
+        default:
+            return;
+    }
+    /* wait for free space of message queue */
+    while (!decqput(dec,&hdr,data)) {
+        if (!dec->state) {
+            dec->drop++;
+            return;
+        }
+        rtklib_lock(&svr->qlock);
+        rtklib_condsignal(&svr->qcond); /* wake up server to read queue */
+        if (dec->state&&
+            dec->size-(dec->wp-LOAD_ACQ(&dec->rp))<sizeof(decmsg_t)+hdr.len) {
+            condwaitms(&svr->qcond,&svr->qlock,DECQWAIT);
+        }
+        rtklib_unlock(&svr->qlock);
+    }
+}
+/* signal decoder queues read or written -------------------------------------*/
+static void decqsignal(rtksvr_t *svr)
+{
+    rtklib_lock(&svr->qlock);
+    rtklib_condsignal(&svr->qcond);
+    rtklib_unlock(&svr->qlock);
+}
+/* set glonass frequency channel number to raw data struct -------------------*/
+static void set_glofcn(rtksvr_t *svr, rtkdec_t *dec)
+{
+    geph_t *geph;
+    uint32_t frq;
+    int i,sat;
+    
+    if (!dec->raw) return;
+    geph=dec->raw->nav.geph;
+    
+    for (i=0;i<MAXPRNGLO;i++) {
+        if (!(frq=LOAD_ACQ(dec->glofcn+i))) continue;
+        sat=satno(SYS_GLO,i+1);
+        if (geph[i].sat==sat) continue;
+        geph[i].sat=sat;
+        geph[i].frq=(int)frq-8;
+    }
+}
+/* publish decoder status to rtk server --------------------------------------*/
+static void pubdecstat(rtksvr_t *svr, const rtkdec_t *dec, int ret)
+{
+    raw_t *raw=svr->raw+dec->index;
+    rtcm_t *rtcm=svr->rtcm+dec->index;
+    int i,n;
+    
+    rtksvrlock(svr);
+    
+    if (dec->rtcm) {
+        rtcm->time=dec->rtcm->time;
+        rtcm->sta=dec->rtcm->sta;
+        rtcm->staid=dec->rtcm->staid;
+        strcpy(rtcm->msgtype,dec->rtcm->msgtype);
+        memcpy(rtcm->nmsg2,dec->rtcm->nmsg2,sizeof(rtcm->nmsg2));
+        memcpy(rtcm->nmsg3,dec->rtcm->nmsg3,sizeof(rtcm->nmsg3));
+        
+        if (ret==7) { /* dgps corrections of the message */
+            for (i=0;i<MAXSAT;i++) {
+                if (timediff(dec->dgps[i].t0,dec->rtcm->time)!=0.0) continue;
+                svr->nav.dgps[i]=dec->dgps[i];
+            }
+            svr->navseq++;
+        }
+        else if (ret==10) { /* ssr corrections to be output */
+            for (i=0;i<MAXSAT;i++) {
+                if (dec->rtcm->ssr[i].update) rtcm->ssr[i]=dec->rtcm->ssr[i];
+            }
+        }
+    }
+    else if (dec->raw) {
+        raw->time=dec->raw->time;
+        raw->sta=dec->raw->sta;
+        strcpy(raw->msgtype,dec->raw->msgtype);
+        raw->obs.rcvcount=dec->raw->obs.rcvcount;
+        raw->obs.tmcount=dec->raw->obs.tmcount;
+        
+        if (ret==1&&raw->obs.data) { /* observation data */
+            n=MIN(dec->raw->obs.n,MAXOBS);
+            memcpy(raw->obs.data,dec->raw->obs.data,sizeof(obsd_t)*n);
+            raw->obs.n=n;
+        }
+    }
+    rtksvrunlock(svr);
+}
+/* decode receiver raw/rtcm data to message queue ----------------------------*/
+static void decoderawq(rtksvr_t *svr, rtkdec_t *dec)
+{
+    uint32_t t0=latstart(&svr->lat);
+    int i,m,n,ret,index=dec->index;
+    
+    tracet(4,"decoderawq: index=%d\n",index);
+    
+    set_glofcn(svr,dec);
+    
+    for (i=0,n=svr->nb[index];i<n;i+=m) {
+        
+        /* input rtcm/receiver raw data from stream */
+        if (svr->format[index]==STRFMT_RTCM2) {
+            /* dgps corrections are input to dec->dgps */
+            ret=input_rtcm2(dec->rtcm,svr->buff[index][i]);
+            m=1;
+        }
+        else if (svr->format[index]==STRFMT_RTCM3) {
+            m=input_rtcm3b(dec->rtcm,svr->buff[index]+i,n-i,&ret);
+        }
+        else {
+            m=input_rawb(dec->raw,svr->format[index],svr->buff[index]+i,n-i,
+                         &ret);
+        }
+        if (ret==0) continue;
+        
+        /* publish status once per message and output to message queue */
+        pubdecstat(svr,dec,ret);
+        outdecmsg(svr,dec,ret);
+    }
+    if (dec->wp!=LOAD_ACQ(&dec->rp)) decqsignal(svr);
+    if (svr->nb[index]>0&&svr->lat.ena) {
+        rtksvrlock(svr);
+        latadd(&svr->lat,LATSTG_DEC,t0);
+        rtksvrunlock(svr);
+    }
+    svr->nb[index]=0;
+}
+/* input decoder thread ------------------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI decoderthread(void *arg)
+#else
+static void *decoderthread(void *arg)
+#endif
+{
+    rtkdec_t *dec=(rtkdec_t *)arg;
+    rtksvr_t *svr=(rtksvr_t *)dec->svr;
+    strevt_t evt;
+    int i=dec->index,n;
+    
+    tracet(3,"decoderthread: index=%d\n",i);
+    
+    if (svr->evtwait&&!strevtinit(&evt)) {
+        tracet(2,"decoderthread: event wait not supported\n");
+    }
+    while (dec->state) {
+        n=readstr(svr,i);
+        
+        if (svr->format[i]==STRFMT_SP3||svr->format[i]==STRFMT_RNXCLK) {
+            /* decode download file */
+            decodefile(svr,i);
+        }
+        else {
+            /* decode receiver raw/rtcm data to message queue */
+            decoderawq(svr,dec);
+        }
+        if (n>0) continue;
+        
+        if (svr->evtwait) {
+            /* wait for input stream data */
+            strevtwait(&evt,svr->stream+i,1,svr->cycle);
+        }
+        else {
+            sleepms(svr->cycle);
+        }
+    }
+    if (svr->evtwait) strevtfree(&evt);
+    return 0;
+}
+/* stop input decoder threads ------------------------------------------------*/
+static void decstop(rtksvr_t *svr)
+{
+    int i;
+    
+    for (i=0;i<3;i++) {
+        if (!svr->dec[i].buff) continue;
+        
+        if (svr->dec[i].state) {
+            svr->dec[i].state=0;
+            decqsignal(svr);
+#ifdef WIN32
+            WaitForSingleObject(svr->dec[i].thread,10000);
+            CloseHandle(svr->dec[i].thread);
+#else
+            pthread_join(svr->dec[i].thread,NULL);
+#endif
+        }
+        if (svr->dec[i].drop>0) {
+            tracet(2,"decstop: index=%d drop=%u\n",i,svr->dec[i].drop);
+        }
+        free(svr->dec[i].buff); svr->dec[i].buff=NULL;
+        free(svr->dec[i].mbuf); svr->dec[i].mbuf=NULL;
+        if (svr->dec[i].raw ) {free_raw (svr->dec[i].raw ); free(svr->dec[i].raw );}
+        if (svr->dec[i].rtcm) {free_rtcm(svr->dec[i].rtcm); free(svr->dec[i].rtcm);}
+        free(svr->dec[i].dgps);
+        svr->dec[i].raw=NULL; svr->dec[i].rtcm=NULL; svr->dec[i].dgps=NULL;
+    }
+    rtklib_freecond(&svr->qcond);
+    rtklib_freelock(&svr->qlock);
+}
+/* initialize receiver raw/rtcm control of input decoder ---------------------*/
+static int decinit(rtksvr_t *svr, rtkdec_t *dec)
+{
+    int i=dec->index;
+    
+    if (svr->format[i]==STRFMT_RTCM2||svr->format[i]==STRFMT_RTCM3) {
+        if (!(dec->dgps=(dgps_t *)calloc(MAXSAT,sizeof(dgps_t)))||
+            !(dec->rtcm=(rtcm_t *)malloc(sizeof(rtcm_t)))) {
+            return 0;
+        }
+        if (!init_rtcm(dec->rtcm)) {
+            free(dec->rtcm); dec->rtcm=NULL;
+            return 0;
+        }
+        strcpy(dec->rtcm->opt,svr->rtcm[i].opt);
+        dec->rtcm->time=svr->rtcm[i].time;
+        dec->rtcm->dgps=dec->dgps;
+    }
+    else {
+        if (!(dec->raw=(raw_t *)malloc(sizeof(raw_t)))) return 0;
+        if (!init_raw(dec->raw,svr->format[i])) {
+            free(dec->raw); dec->raw=NULL;
+            return 0;
+        }
+        strcpy(dec->raw->opt,svr->raw[i].opt);
+        dec->raw->time=svr->raw[i].time;
+    }
+    return 1;
+}
+/* start input decoder threads -----------------------------------------------*/
+static int decstart(rtksvr_t *svr)
+{
+    rtkdec_t *dec;
+    int i;
+    
+    tracet(3,"decstart:\n");
+    
+    rtklib_initlock(&svr->qlock);
+    rtklib_initcond(&svr->qcond);
+    
+    for (i=0;i<3;i++) {
+        dec=svr->dec+i;
+        memset(dec,0,sizeof(rtkdec_t));
+        dec->index=i;
+        dec->size=DECQSIZE;
+        dec->svr=svr;
+        if (!(dec->buff=(uint8_t *)malloc(DECQSIZE))||
+            !(dec->mbuf=(uint8_t *)malloc(MAXDECMSG))||!decinit(svr,dec)) {
+            tracet(1,"decstart: malloc error\n");
+            decstop(svr);
+            return 0;
+        }
+    }
+    for (i=0;i<3;i++) {
+        dec=svr->dec+i;
+        dec->state=1;
+#ifdef WIN32
+        if (!(dec->thread=CreateThread(NULL,0,decoderthread,dec,0,NULL))) {
+#else
+        if (pthread_create(&dec->thread,NULL,decoderthread,dec)) {
+#endif
+            tracet(1,"decstart: thread create error index=%d\n",i);
+            dec->state=0;
+            decstop(svr);
+            return 0;
+        }
+    }
+    return 1;
+}
+/* read decoded messages from message queue ----------------------------------*/
+static int decqread(rtksvr_t *svr, int index, uint8_t *buff, int *staid)
+{
+    rtkdec_t *dec=svr->dec+index;
+    decmsg_t hdr;
+    obs_t obs;
+    const int32_t *sats;
+    uint32_t rp=dec->rp,wp=LOAD_ACQ(&dec->wp);
+    int i,n,nmsg,fobs=0;
+    
+    tracet(4,"decqread: index=%d\n",index);
+    
+    if (rp==wp) return 0;
+    
+    /* lock by batches of messages not to block status readers */
+    rtksvrlock(svr);
+    
+    /* leave messages after full observation buffer for next cycle */
+    for (nmsg=0;rp!=wp&&fobs<MAXOBSBUF;nmsg++) {
+        if (nmsg>0&&nmsg%DECQBATCH==0) {
+            rtksvrunlock(svr);
+            rtksvrlock(svr);
+        }
+        ringget(dec,rp,(uint8_t *)&hdr,sizeof(decmsg_t));
+        ringget(dec,rp+sizeof(decmsg_t),buff,hdr.len);
+        rp+=sizeof(decmsg_t)+hdr.len;
+        STORE_REL(&dec->rp,rp);
+        
+        if (staid&&hdr.staid>0) *staid=hdr.staid;
+        
+        /* update rtk server */
+        if (hdr.ret==1) { /* observation data */
+            obs.data=(obsd_t *)buff;
+            obs.n=obs.nmax=hdr.len/sizeof(obsd_t);
+            update_obs(svr,&obs,index,fobs++);
+        }
+        else if (hdr.ret==2) { /* ephemeris */
+            if (satsys(hdr.ephsat,NULL)!=SYS_GLO) {
+                update_eph(svr,(eph_t *)buff,NULL,hdr.ephsat,hdr.ephset,index);
+            }
+            else {
+                update_eph(svr,NULL,(geph_t *)buff,hdr.ephsat,hdr.ephset,index);
+            }
+        }
+        else if (hdr.ret==3) { /* sbas message */
+            update_sbs(svr,hdr.len>0?(sbsmsg_t *)buff:NULL,index);
+        }
+        else if (hdr.ret==9) { /* ion/utc parameters */
+            update_ionutc(svr,(ionutc_t *)buff,index);
+        }
+        else if (hdr.ret==5) { /* antenna position */
+            update_antpos(svr,(sta_t *)buff,index);
+        }
+        else if (hdr.ret==7) { /* dgps correction */
+            svr->nmsg[index][5]++;
+        }
+        else if (hdr.ret==10) { /* ssr message */
+            n=hdr.len/(sizeof(ssr_t)+sizeof(int32_t));
+            sats=(const int32_t *)((ssr_t *)buff+n);
+            for (i=0;i<n;i++) update_ssrsat(svr,sats[i],(ssr_t *)buff+i);
+            svr->nmsg[index][7]++;
+        }
+        else if (hdr.ret==-1) { /* error */
+            svr->nmsg[index][9]++;
+        }
+        if (hdr.ret>=2) svr->navseq++; /* navigation data may be updated */
+    }
+    rtksvrunlock(svr);
+    
+    decqsignal(svr); /* wake up decoder waiting for free space */
+    return fobs;
+}
+/* wait for decoded messages in queues ---------------------------------------*/
+static void decqwait(rtksvr_t *svr, int ms)
+{
+    int i;
+    
+    rtklib_lock(&svr->qlock);
+    for (i=0;i<3;i++) {
+        if (svr->dec[i].rp!=LOAD_ACQ(&svr->dec[i].wp)) break;
+    }
+    if (i>=3&&ms>0) condwaitms(&svr->qcond,&svr->qlock,ms);
+    rtklib_unlock(&svr->qlock);
+}
 /* carrier-phase bias (fcb) correction ---------------------------------------*/
 static void corr_phase_bias(obsd_t *obs, int n, const nav_t *nav)
 {
@@ -616,6 +1207,98 @@ static void send_nmea(rtksvr_t *svr, uint32_t *tickreset)
                sol_nmea.rr[2]);
     }
 }
+/* publish status snapshot ---------------------------------------------------*/
+static void pubstat(rtksvr_t *svr)
+{
+    svrstat_t *stat=svr->stat+((svr->nstat+1)&1);
+    const rtk_t *rtk=&svr->rtk;
+    char s[MAXSTRMSG],*p=stat->msg,*q=stat->msg+MAXSTRMSG;
+    int i,j,n,inb,inr,outb,outr;
+    
+    tracet(4,"pubstat: n=%u\n",svr->nstat);
+    
+    /* sequence counter odd while updating the snapshot */
+    STORE_REL(&stat->seq,stat->seq+1);
+    FENCE_REL();
+    
+    stat->count=svr->nstat+1;
+    stat->sol=rtk->sol;
+    for (i=0;i<6;i++) stat->rb[i]=rtk->rb[i];
+    for (i=0;i<3;i++) {
+        stat->xf[i]=rtk->x &&i<rtk->nx?rtk->x[i]:0.0;
+        stat->sf[i]=rtk->P &&i<rtk->nx?SQRT(rtk->P[i+i*rtk->nx]):0.0;
+        stat->xa[i]=rtk->xa&&i<rtk->na?rtk->xa[i]:0.0;
+        stat->sa[i]=rtk->Pa&&i<rtk->na?SQRT(rtk->Pa[i+i*rtk->na]):0.0;
+    }
+    stat->tt=rtk->tt;
+    stat->nx=rtk->nx;
+    stat->na=rtk->na;
+    for (i=0;i<3;i++) {
+        n=stat->nobs[i]=MIN(svr->obs[i][0].n,MAXOBS);
+        if (n>0) stat->tobs[i]=svr->obs[i][0].data[0].time;
+        for (j=0;j<n;j++) {
+            stat->sat[i][j]=svr->obs[i][0].data[j].sat;
+            memcpy(stat->snr[i][j],svr->obs[i][0].data[j].SNR,sizeof(float)*NFREQ);
+        }
+    }
+    for (i=0;i<MAXSAT;i++) {
+        stat->ssat[i].sys=rtk->ssat[i].sys;
+        stat->ssat[i].vs =rtk->ssat[i].vs;
+        stat->ssat[i].azel[0]=rtk->ssat[i].azel[0];
+        stat->ssat[i].azel[1]=rtk->ssat[i].azel[1];
+        for (j=0;j<NFREQ;j++) {
+            stat->ssat[i].vsat [j]=rtk->ssat[i].vsat[j];
+            stat->ssat[i].fix  [j]=rtk->ssat[i].fix [j];
+            stat->ssat[i].resp [j]=rtk->ssat[i].resp[j];
+            stat->ssat[i].resc [j]=rtk->ssat[i].resc[j];
+            stat->ssat[i].snr  [j]=rtk->ssat[i].snr_rover[j];
+            stat->ssat[i].lock [j]=rtk->ssat[i].lock [j];
+            stat->ssat[i].slipc[j]=rtk->ssat[i].slipc[j];
+            stat->ssat[i].rejc [j]=rtk->ssat[i].rejc [j];
+        }
+    }
+    *p='\0';
+    for (i=0;i<MAXSTRRTK;i++) {
+        stat->sstat[i]=strstat(svr->stream+i,s);
+        stat->state[i]=svr->stream[i].state;
+        if (*s&&p<q) p+=snprintf(p,q-p,"(%d) %s ",i+1,s);
+        strsum(svr->stream+i,&inb,&inr,&outb,&outr);
+        stat->inb [i]=(uint32_t)inb;  stat->inr [i]=(uint32_t)inr;
+        stat->outb[i]=(uint32_t)outb; stat->outr[i]=(uint32_t)outr;
+    }
+    /* counters updated by input decoders and commands */
+    rtksvrlock(svr);
+    for (i=0;i<3;i++) {
+        stat->nb[i]=svr->nb[i];
+        for (j=0;j<10;j++) stat->nmsg[i][j]=svr->nmsg[i][j];
+        stat->qlen [i]=svr->dec[i].buff?svr->dec[i].wp-svr->dec[i].rp:0;
+        stat->qsize[i]=svr->dec[i].buff?svr->dec[i].size:0;
+        stat->qdrop[i]=svr->dec[i].drop;
+    }
+    for (i=0;i<=MAXSOLQ;i++) stat->nsolq[i]=svr->nsolq[i];
+    rtksvrunlock(svr);
+    
+    stat->cputime=svr->cputime;
+    stat->prcout=svr->prcout;
+    
+    STORE_REL(&stat->seq,stat->seq+1);
+    STORE_REL(&svr->nstat,svr->nstat+1);
+}
+/* advance replay time to next input data -----------------------------------*/
+static int setreptime(rtksvr_t *svr)
+{
+    gtime_t time,tnext={0};
+    int i,n=0;
+    
+    for (i=0;i<3;i++) {
+        if (!strreptime(svr->stream+i,&time)) continue;
+        if (n++==0||timediff(time,tnext)<0.0) tnext=time;
+    }
+    if (n<=0) return 0;
+    
+    for (i=0;i<3;i++) strsetreptime(svr->stream+i,tnext);
+    return 1;
+}
 /* rtk server thread ---------------------------------------------------------*/
 #ifdef WIN32
 static DWORD WINAPI rtksvrthread(void *arg)
@@ -624,13 +1307,14 @@ static void *rtksvrthread(void *arg)
 #endif
 {
     rtksvr_t *svr=(rtksvr_t *)arg;
+    strevt_t evt;
     obs_t obs;
     sol_t sol={{0}};
     double tt;
-    uint32_t tick,ticknmea,tick1hz,tickreset;
-    uint8_t *p,*q;
+    uint32_t tick,ticknmea,tick1hz,tickreset,tickstat;
+    uint8_t *mbuf=NULL;
     char msg[128];
-    int i,j,n,cycle,cputime;
+    int i,j,cycle,ncmd,cputime,staid=0,qdec=0,rep=0;
     
     tracet(3,"rtksvrthread:\n");
     
@@ -639,45 +1323,54 @@ static void *rtksvrthread(void *arg)
       trace(1, "rtksvrthread: obsd_t alloc failed\n");
       return 0;
     }
+    /* start input decoder threads */
+    if (svr->decthread&&!svr->replay) {
+        if (!(mbuf=(uint8_t *)malloc(MAXDECMSG))||!decstart(svr)) {
+            tracet(2,"rtksvrthread: decoder thread start error\n");
+            free(mbuf); mbuf=NULL;
+        }
+        qdec=mbuf!=NULL;
+    }
     obs.data = data;
     obs.n = 0;
     obs.nmax = MAXOBS * 2;
 
     svr->state=1;
     svr->tick=tickget();
-    ticknmea=tick1hz=svr->tick-1000;
+    ticknmea=tick1hz=tickstat=svr->tick-1000;
     tickreset=svr->tick-MIN_INT_RESET;
-
-    for (cycle=0;svr->state;cycle++) {
+    
+    if (svr->evtwait&&!strevtinit(&evt)) {
+        tracet(2,"rtksvrthread: event wait not supported\n");
+    }
+    for (cycle=ncmd=0;svr->state;) {
         tick=tickget();
-        for (i=0;i<3;i++) {
-            p=svr->buff[i]+svr->nb[i]; q=svr->buff[i]+svr->buffsize;
-            
-            /* read receiver raw/rtcm data from input stream */
-            if ((n=strread(svr->stream+i,p,q-p))<=0) {
-                continue;
-            }
-            /* write receiver raw/rtcm data to log stream */
-            strwrite(svr->stream+i+5,p,n);
-            svr->nb[i]+=n;
-            
-            /* save peek buffer */
-            rtksvrlock(svr);
-            n=n<svr->buffsize-svr->npb[i]?n:svr->buffsize-svr->npb[i];
-            memcpy(svr->pbuf[i]+svr->npb[i],p,n);
-            svr->npb[i]+=n;
-            rtksvrunlock(svr);
-        }
         int fobs[3]={0};
-        for (i=0;i<3;i++) {
-            if (svr->format[i]==STRFMT_SP3||svr->format[i]==STRFMT_RNXCLK) {
-                /* decode download file */
-                decodefile(svr,i);
+        
+        /* advance replay time of inputs */
+        if (svr->replay) rep=setreptime(svr);
+        
+        if (qdec) {
+            /* read decoded messages from input decoder threads */
+            for (i=0;i<3;i++) {
+                fobs[i]=decqread(svr,i,mbuf,i==1?&staid:NULL);
             }
-            else {
-                /* decode receiver raw/rtcm data */
-                fobs[i]=decoderaw(svr,i);
-                if (1==i&&svr->rtcm[1].staid>0) sol.refstationid=svr->rtcm[1].staid; 
+            if (staid>0) sol.refstationid=staid;
+        }
+        else {
+            /* read receiver raw/rtcm data from input streams */
+            for (i=0;i<3;i++) readstr(svr,i);
+            
+            for (i=0;i<3;i++) {
+                if (svr->format[i]==STRFMT_SP3||svr->format[i]==STRFMT_RNXCLK) {
+                    /* decode download file */
+                    decodefile(svr,i);
+                }
+                else {
+                    /* decode receiver raw/rtcm data */
+                    fobs[i]=decoderaw(svr,i);
+                    if (1==i&&svr->rtcm[1].staid>0) sol.refstationid=svr->rtcm[1].staid; 
+                }
             }
         }
         /* averaging single base pos */
@@ -707,30 +1400,31 @@ static void *rtksvrthread(void *arg)
             /* rtk positioning */
             rtksvrlock(svr);
             rtkpos(&svr->rtk,obs.data,obs.n,&svr->nav);
+            svr->nsolq[svr->rtk.sol.stat]++;
             rtksvrunlock(svr);
             
             if (svr->rtk.sol.stat!=SOLQ_NONE) {
                 
                 /* adjust current time */
-                tt=(int)(tickget()-tick)/1000.0+DTTOL;
+                tt=(svr->replay?0:(int)(tickget()-tick)/1000.0)+DTTOL;
                 timeset(gpst2utc(timeadd(svr->rtk.sol.time,tt)));
                 
                 /* write solution */
                 writesol(svr,i);
             }
             /* if cpu overload, increment obs outage counter and break */
-            if ((int)(tickget()-tick)>=svr->cycle) {
+            if (!rep&&(int)(tickget()-tick)>=svr->cycle) {
                 svr->prcout+=fobs[0]-i-1;
             }
         }
         /* send null solution if no solution (1hz) */
-        if (svr->rtk.sol.stat==SOLQ_NONE&&(int)(tick-tick1hz)>=1000) {
+        if (!rep&&svr->rtk.sol.stat==SOLQ_NONE&&(int)(tick-tick1hz)>=1000) {
             writesol(svr,0);
             tick1hz=tick;
         }
         /* write periodic command to input stream */
-        for (i=0;i<3;i++) {
-            periodic_cmd(cycle*svr->cycle,svr->cmds_periodic[i],svr->stream+i);
+        for (;ncmd<=cycle;ncmd++) for (i=0;i<3;i++) {
+            periodic_cmd(ncmd*svr->cycle,svr->cmds_periodic[i],svr->stream+i);
         }
         /* send nmea request to base/nrtk input stream */
         if (svr->nmeacycle>0&&(int)(tick-ticknmea)>=svr->nmeacycle) {
@@ -739,10 +1433,35 @@ static void *rtksvrthread(void *arg)
         }
         if ((cputime=(int)(tickget()-tick))>0) svr->cputime=cputime;
         
-        /* sleep until next cycle */
-        sleepms(svr->cycle-cputime);
+        /* publish status snapshot for readers */
+        if (fobs[0]>0||(int)(tick-tickstat)>=MIN_INT_STAT) {
+            pubstat(svr);
+            tickstat=tick;
+        }
+        if (rep) {
+            /* no wait until all inputs replayed */
+            cycle++;
+        }
+        else if (qdec) {
+            /* wait for decoded messages until next cycle */
+            decqwait(svr,svr->cycle-cputime);
+            cycle=svr->cycle>0?(int)(tickget()-svr->tick)/svr->cycle:cycle+1;
+        }
+        else if (svr->evtwait) {
+            /* wait for input stream data until next cycle */
+            strevtwait(&evt,svr->stream,3,svr->cycle-cputime);
+            cycle=svr->cycle>0?(int)(tickget()-svr->tick)/svr->cycle:cycle+1;
+        }
+        else {
+            /* sleep until next cycle */
+            sleepms(svr->cycle-cputime);
+            cycle++;
+        }
     }
+    if (svr->evtwait) strevtfree(&evt);
+    if (qdec) decstop(svr);
     free(data);
+    free(mbuf);
     for (i=0;i<MAXSTRRTK;i++) strclose(svr->stream+i);
     for (i=0;i<3;i++) {
         svr->nb[i]=svr->npb[i]=0;
@@ -772,7 +1491,8 @@ extern int rtksvrinit(rtksvr_t *svr)
     
     tracet(3,"rtksvrinit:\n");
     
-    svr->state=svr->cycle=svr->nmeacycle=svr->nmeareq=0;
+    svr->state=svr->cycle=svr->evtwait=svr->decthread=svr->replay=0;
+    svr->nmeacycle=svr->nmeareq=0;
     for (i=0;i<3;i++) svr->nmeapos[i]=0.0;
     svr->buffsize=0;
     for (i=0;i<3;i++) svr->format[i]=0;
@@ -792,7 +1512,12 @@ extern int rtksvrinit(rtksvr_t *svr)
     svr->moni=NULL;
     svr->tick=0;
     svr->thread=0;
+    memset(svr->dec,0,sizeof(svr->dec));
+    latinit(&svr->lat,0);
     svr->cputime=svr->prcout=svr->nave=0;
+    for (i=0;i<=MAXSOLQ;i++) svr->nsolq[i]=0;
+    memset(svr->stat,0,sizeof(svr->stat));
+    svr->nstat=svr->navseq=0;
     for (i=0;i<3;i++) svr->rb_ave[i]=0.0;
     
     memset(&svr->nav,0,sizeof(nav_t));
@@ -941,8 +1666,12 @@ extern int rtksvrstart(rtksvr_t *svr, int cycle, int buffsize, int *strs,
     svr->nsbs=0;
     svr->nsol=0;
     svr->prcout=0;
+    for (i=0;i<=MAXSOLQ;i++) svr->nsolq[i]=0;
+    svr->nstat=0;
     rtkfree(&svr->rtk);
     rtkinit(&svr->rtk,prcopt);
+    latinit(&svr->lat,svr->lat.ena);
+    if (svr->lat.ena) svr->rtk.lat=&svr->lat;
     
     if (prcopt->initrst) { /* init averaging pos by restart */
         svr->nave=0;
@@ -1146,31 +1875,35 @@ extern void rtksvrclosestr(rtksvr_t *svr, int index)
 extern int rtksvrostat(rtksvr_t *svr, int rcv, gtime_t *time, int *sat,
                        double *az, double *el, int **snr, int *vsat)
 {
+    svrstat_t *stat;
     int i,j,ns;
     
     tracet(4,"rtksvrostat: rcv=%d\n",rcv);
     
-    if (!svr->state) return 0;
-    rtksvrlock(svr);
-    ns=svr->obs[rcv][0].n;
+    if (!svr->state||!(stat=(svrstat_t *)malloc(sizeof(svrstat_t)))) return 0;
+    if (!rtksvrstat(svr,stat)) {
+        free(stat);
+        return 0;
+    }
+    ns=stat->nobs[rcv];
     if (ns>0) {
-        *time=svr->obs[rcv][0].data[0].time;
+        *time=stat->tobs[rcv];
     }
     for (i=0;i<ns;i++) {
-        sat [i]=svr->obs[rcv][0].data[i].sat;
-        az  [i]=svr->rtk.ssat[sat[i]-1].azel[0];
-        el  [i]=svr->rtk.ssat[sat[i]-1].azel[1];
+        sat [i]=stat->sat[rcv][i];
+        az  [i]=stat->ssat[sat[i]-1].azel[0];
+        el  [i]=stat->ssat[sat[i]-1].azel[1];
         for (j=0;j<NFREQ;j++) {
-            snr[i][j]=(int)(svr->obs[rcv][0].data[i].SNR[j]);
+            snr[i][j]=(int)(stat->snr[rcv][i][j]);
         }
-        if (svr->rtk.sol.stat==SOLQ_NONE||svr->rtk.sol.stat==SOLQ_SINGLE) {
-            vsat[i]=svr->rtk.ssat[sat[i]-1].vs;
+        if (stat->sol.stat==SOLQ_NONE||stat->sol.stat==SOLQ_SINGLE) {
+            vsat[i]=stat->ssat[sat[i]-1].vs;
         }
         else {
-            vsat[i]=svr->rtk.ssat[sat[i]-1].vsat[0];
+            vsat[i]=stat->ssat[sat[i]-1].vsat[0];
         }
     }
-    rtksvrunlock(svr);
+    free(stat);
     return ns;
 }
 /* get stream status -----------------------------------------------------------
@@ -1179,14 +1912,25 @@ extern int rtksvrostat(rtksvr_t *svr, int rcv, gtime_t *time, int *sat,
 *          int     *sstat   O  status of streams
 *          char    *msg     O  status messages
 * return : none
+* notes  : status is taken from status snapshot while the server is running
 *-----------------------------------------------------------------------------*/
 extern void rtksvrsstat(rtksvr_t *svr, int *sstat, char *msg)
 {
+    svrstat_t *stat;
     int i;
     char s[MAXSTRMSG],*p=msg;
     
     tracet(4,"rtksvrsstat:\n");
     
+    if (svr->state&&(stat=(svrstat_t *)malloc(sizeof(svrstat_t)))) {
+        if (rtksvrstat(svr,stat)) {
+            for (i=0;i<MAXSTRRTK;i++) sstat[i]=stat->sstat[i];
+            strcpy(msg,stat->msg);
+            free(stat);
+            return;
+        }
+        free(stat);
+    }
     rtksvrlock(svr);
     for (i=0;i<MAXSTRRTK;i++) {
         sstat[i]=strstat(svr->stream+i,s);
@@ -1194,6 +1938,59 @@ extern void rtksvrsstat(rtksvr_t *svr, int *sstat, char *msg)
     }
     rtksvrunlock(svr);
 }
+/* get status snapshot ---------------------------------------------------------
+* get status snapshot of rtk server (solution, satellite status, observation
+* data status, stream status and counters)
+* args   : rtksvr_t *svr    I  rtk server
+*          svrstat_t *stat  O  status snapshot
+* return : status (1:ok,0:no snapshot)
+* notes  : the snapshot is published by the server thread every epoch or
+*          MIN_INT_STAT ms to one of double buffers with a sequence counter.
+*          readers copy the latest snapshot without rtksvrlock() and retry if
+*          the server thread updated it during the copy, so readers never
+*          block the server thread
+*-----------------------------------------------------------------------------*/
+extern int rtksvrstat(rtksvr_t *svr, svrstat_t *stat)
+{
+    uint32_t n,seq;
+    int k;
+    
+    tracet(4,"rtksvrstat:\n");
+    
+    for (;;) {
+        if (!(n=LOAD_ACQ(&svr->nstat))) return 0;
+        k=n&1;
+        if ((seq=LOAD_ACQ(&svr->stat[k].seq))&1) continue;
+        memcpy(stat,svr->stat+k,sizeof(svrstat_t));
+        FENCE_ACQ();
+        if (LOAD_ACQ(&svr->stat[k].seq)==seq) break;
+    }
+    return 1;
+}
+/* get stage latency statistics of rtk server ----------------------------------
+* get latency quantiles of processing stages of rtk server
+* args   : rtksvr_t *svr    I  rtk server
+*          int    *n        O  number of samples   {stage 1,...,NLATSTG}
+*          double *p50,*p99 O  50/99 percentile latency (us) {stage 1,...}
+*          double *max      O  max latency (us)    {stage 1,...}
+* return : status (1:enabled,0:disabled)
+* notes  : stages are LATSTG_READ,LATSTG_DEC,...,LATSTG_OUT. latency
+*          statistics are enabled by svr->lat.ena=1 before rtksvrstart()
+*-----------------------------------------------------------------------------*/
+extern int rtksvrlstat(rtksvr_t *svr, int *n, double *p50, double *p99,
+                       double *max)
+{
+    int i;
+    
+    tracet(4,"rtksvrlstat:\n");
+    
+    rtksvrlock(svr);
+    for (i=0;i<NLATSTG;i++) {
+        latquant(&svr->lat,i,n+i,p50+i,p99+i,max+i);
+    }
+    rtksvrunlock(svr);
+    return svr->lat.ena;
+}
 /* mark current position -------------------------------------------------------
 * open output/log stream
 * args   : rtksvr_t *svr    IO rtk server
@@ -1249,3 +2046,491 @@ extern int rtksvrmark(rtksvr_t *svr, const char *name, const char *comment)
     rtksvrunlock(svr);
     return 1;
 }
+/* copy array of navigation data ---------------------------------------------*/
+static void *copyarr(void *p, int *nmax, const void *src, int n, size_t size)
+{
+    if (n>*nmax) {
+        free(p);
+        if (!(p=malloc(size*n))) {
+            *nmax=0;
+            return NULL;
+        }
+        *nmax=n;
+    }
+    if (n>0) memcpy(p,src,size*n);
+    return p;
+}
+/* free tec grid data of snapshot --------------------------------------------*/
+static void freetec(nav_t *nav)
+{
+    int i;
+    
+    for (i=0;i<nav->nt;i++) {
+        free(nav->tec[i].data);
+        free(nav->tec[i].rms);
+    }
+    nav->nt=0;
+}
+/* copy tec grid data to snapshot --------------------------------------------*/
+static int copytec(nav_t *dst, const nav_t *src)
+{
+    tec_t *tec=dst->tec;
+    int i,n;
+    
+    freetec(dst);
+    if (!(dst->tec=copyarr(tec,&dst->ntmax,src->tec,src->nt,sizeof(tec_t)))) {
+        return 0;
+    }
+    for (i=0;i<src->nt;i++) {
+        n=src->tec[i].ndata[0]*src->tec[i].ndata[1]*src->tec[i].ndata[2];
+        dst->tec[i].data=NULL;
+        dst->tec[i].rms=NULL;
+        if (n<=0) continue;
+        if (!(dst->tec[i].data=(double *)malloc(sizeof(double)*n))||
+            !(dst->tec[i].rms=(float *)malloc(sizeof(float)*n))) {
+            free(dst->tec[i].data);
+            dst->nt=i;
+            return 0;
+        }
+        memcpy(dst->tec[i].data,src->tec[i].data,sizeof(double)*n);
+        memcpy(dst->tec[i].rms,src->tec[i].rms,sizeof(float)*n);
+    }
+    dst->nt=src->nt;
+    return 1;
+}
+/* copy navigation data to snapshot ------------------------------------------*/
+static void copynav(nav_t *dst, const nav_t *src)
+{
+    nav_t nav=*dst;
+    
+    *dst=*src;
+    
+    /* arrays of snapshot not shared with source */
+    dst->eph =nav.eph ; dst->nmax =nav.nmax ;
+    dst->geph=nav.geph; dst->ngmax=nav.ngmax;
+    dst->seph=nav.seph; dst->nsmax=nav.nsmax;
+    dst->peph=nav.peph; dst->nemax=nav.nemax;
+    dst->pclk=nav.pclk; dst->ncmax=nav.ncmax;
+    dst->alm =nav.alm ; dst->namax=nav.namax;
+    dst->tec =nav.tec ; dst->ntmax=nav.ntmax; dst->nt=nav.nt;
+    dst->erp.data=nav.erp.data; dst->erp.nmax=nav.erp.nmax;
+    
+    if (!(dst->eph =copyarr(dst->eph ,&dst->nmax ,src->eph ,src->n ,sizeof(eph_t )))) {
+        dst->n=0;
+    }
+    if (!(dst->geph=copyarr(dst->geph,&dst->ngmax,src->geph,src->ng,sizeof(geph_t)))) {
+        dst->ng=0;
+    }
+    if (!(dst->seph=copyarr(dst->seph,&dst->nsmax,src->seph,src->ns,sizeof(seph_t)))) {
+        dst->ns=0;
+    }
+    if (!(dst->peph=copyarr(dst->peph,&dst->nemax,src->peph,src->ne,sizeof(peph_t)))) {
+        dst->ne=0;
+    }
+    if (!(dst->pclk=copyarr(dst->pclk,&dst->ncmax,src->pclk,src->nc,sizeof(pclk_t)))) {
+        dst->nc=0;
+    }
+    if (!(dst->alm =copyarr(dst->alm ,&dst->namax,src->alm ,src->na,sizeof(alm_t )))) {
+        dst->na=0;
+    }
+    if (!(dst->erp.data=copyarr(dst->erp.data,&dst->erp.nmax,src->erp.data,
+                                src->erp.n,sizeof(erpd_t)))) {
+        dst->erp.n=0;
+    }
+    copytec(dst,src);
+}
+/* set glonass frequency channel number to rover raw data struct -------------*/
+static void set_rovfcn(rtkrov_t *rov, const nav_t *nav)
+{
+    int i,sat;
+    
+    for (i=0;i<MAXPRNGLO&&i<nav->ng;i++) {
+        sat=satno(SYS_GLO,i+1);
+        if (rov->raw->nav.geph[i].sat==sat||nav->geph[i].sat!=sat) continue;
+        rov->raw->nav.geph[i].sat=sat;
+        rov->raw->nav.geph[i].frq=nav->geph[i].frq;
+    }
+}
+/* rtk positioning of rover epoch --------------------------------------------*/
+static void posrov(rtkrov_t *rov, const rtkwork_t *work, const obs_t *obs)
+{
+    uint8_t buff[MAXSOLMSG+1];
+    int i,n,sat,sys;
+    
+    /* rover observation data */
+    for (i=rov->obs.n=0;i<obs->n&&rov->obs.n<MAXOBS;i++) {
+        sat=obs->data[i].sat;
+        sys=satsys(sat,NULL);
+        if (rov->rtk.opt.exsats[sat-1]==1||!(sys&rov->rtk.opt.navsys)) {
+            continue;
+        }
+        rov->obs.data[rov->obs.n]=obs->data[i];
+        rov->obs.data[rov->obs.n++].rcv=1;
+    }
+    sortobs(&rov->obs);
+    
+    /* base station observation data */
+    for (i=0;i<work->base.n&&rov->obs.n<MAXOBS*2;i++) {
+        rov->obs.data[rov->obs.n++]=work->base.data[i];
+    }
+    /* base station position by rtk server */
+    if (rov->rtk.opt.refpos==POSOPT_RTCM) {
+        matcpy(rov->rtk.rb,work->rb,6,1);
+    }
+    else if (rov->rtk.opt.refpos==POSOPT_SINGLE) {
+        matcpy(rov->rtk.opt.rb,work->optrb,3,1);
+    }
+    /* carrier phase bias correction */
+    if (!strstr(rov->rtk.opt.pppopt,"-DIS_FCB")) {
+        corr_phase_bias(rov->obs.data,rov->obs.n,&work->nav);
+    }
+    /* rtk positioning */
+    rtkpos(&rov->rtk,rov->obs.data,rov->obs.n,&work->nav);
+    
+    if (rov->rtk.sol.stat==SOLQ_NONE) return;
+    
+    rov->nsol[rov->rtk.sol.stat]++;
+    
+    /* write solution */
+    n=outsols(buff,&rov->rtk.sol,rov->rtk.rb,&rov->solopt);
+    strwrite(rov->stream+1,buff,n);
+    n=outsolexs(buff,&rov->rtk.sol,rov->rtk.ssat,&rov->solopt);
+    strwrite(rov->stream+1,buff,n);
+}
+/* process rover input -------------------------------------------------------*/
+static void procrov(rtkrov_t *rov, const rtkwork_t *work, int buffsize)
+{
+    obs_t *obs=rov->raw?&rov->raw->obs:&rov->rtcm->obs;
+    uint8_t *p=rov->buff+rov->nb;
+    int i,m,n,ret;
+    
+    tracet(4,"procrov: format=%d\n",rov->format);
+    
+    /* read rover raw/rtcm data from input stream */
+    if ((n=strread(rov->stream,p,buffsize-rov->nb))<=0) return;
+    
+    /* write rover raw/rtcm data to log stream */
+    strwrite(rov->stream+2,p,n);
+    rov->nb+=n;
+    
+    if (rov->raw) set_rovfcn(rov,&work->nav);
+    
+    for (i=0,n=rov->nb;i<n;i+=m) {
+        
+        /* input rtcm/receiver raw data (ephemerides of rover not used) */
+        if (rov->format==STRFMT_RTCM2) {
+            ret=input_rtcm2(rov->rtcm,rov->buff[i]);
+            m=1;
+        }
+        else if (rov->format==STRFMT_RTCM3) {
+            m=input_rtcm3b(rov->rtcm,rov->buff+i,n-i,&ret);
+        }
+        else {
+            m=input_rawb(rov->raw,rov->format,rov->buff+i,n-i,&ret);
+        }
+        if (ret==1) { /* observation data */
+            posrov(rov,work,obs);
+            rov->nmsg[0]++;
+        }
+        else if (ret==2) { /* ephemeris */
+            rov->nmsg[1]++;
+        }
+        else if (ret==-1) { /* error */
+            rov->nmsg[9]++;
+        }
+    }
+    rov->nb=0;
+}
+/* multi-rover rtk server worker thread --------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI rtkworkthread(void *arg)
+#else
+static void *rtkworkthread(void *arg)
+#endif
+{
+    rtkwork_t *work=(rtkwork_t *)arg;
+    rtkmsvr_t *msvr=(rtkmsvr_t *)work->msvr;
+    rtksvr_t *svr=msvr->svr;
+    uint32_t tick;
+    int i;
+    
+    tracet(3,"rtkworkthread: index=%d\n",work->index);
+    
+    while (msvr->state) {
+        tick=tickget();
+        
+        /* update snapshot of navigation data and base station data */
+        rtksvrlock(svr);
+        if (svr->navseq!=work->navseq||!work->nav.eph) {
+            copynav(&work->nav,&svr->nav);
+            work->navseq=svr->navseq;
+        }
+        for (i=work->base.n=0;i<svr->obs[1][0].n&&i<MAXOBS;i++) {
+            work->base.data[work->base.n++]=svr->obs[1][0].data[i];
+        }
+        matcpy(work->rb,svr->rtk.rb,6,1);
+        matcpy(work->optrb,svr->rtk.opt.rb,3,1);
+        rtksvrunlock(svr);
+        
+        /* process rovers assigned to worker */
+        for (i=work->index;i<msvr->nrov;i+=msvr->nwork) {
+            procrov(msvr->rov[i],work,msvr->buffsize);
+        }
+        sleepms(msvr->cycle-(int)(tickget()-tick));
+    }
+    return 0;
+}
+/* initialize multi-rover rtk server -------------------------------------------
+* initialize multi-rover rtk server sharing base station and navigation data
+* args   : rtkmsvr_t *msvr  IO multi-rover rtk server
+*          rtksvr_t *svr    I  rtk server for base station and corrections
+*                              (input streams: {none,base,corr})
+*          int    nwork     I  number of worker threads
+* return : status (0:error,1:ok)
+* notes  : rovers are processed by nwork worker threads. each worker takes a
+*          snapshot of svr->nav and base station observation data svr->obs[1][0]
+*          and processes rovers i=index,index+nwork,... with them
+*-----------------------------------------------------------------------------*/
+extern int rtkmsvrinit(rtkmsvr_t *msvr, rtksvr_t *svr, int nwork)
+{
+    int i;
+    
+    tracet(3,"rtkmsvrinit: nwork=%d\n",nwork);
+    
+    memset(msvr,0,sizeof(rtkmsvr_t));
+    msvr->svr=svr;
+    msvr->nwork=nwork>0?nwork:1;
+    
+    if (!(msvr->work=(rtkwork_t *)calloc(msvr->nwork,sizeof(rtkwork_t)))) {
+        tracet(1,"rtkmsvrinit: malloc error\n");
+        return 0;
+    }
+    for (i=0;i<msvr->nwork;i++) {
+        msvr->work[i].index=i;
+        msvr->work[i].msvr=msvr;
+        if (!(msvr->work[i].base.data=(obsd_t *)malloc(sizeof(obsd_t)*MAXOBS))) {
+            tracet(1,"rtkmsvrinit: malloc error\n");
+            rtkmsvrfree(msvr);
+            return 0;
+        }
+        msvr->work[i].base.nmax=MAXOBS;
+    }
+    return 1;
+}
+/* free multi-rover rtk server -------------------------------------------------
+* free multi-rover rtk server (stop server if running)
+* args   : rtkmsvr_t *msvr  IO multi-rover rtk server
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void rtkmsvrfree(rtkmsvr_t *msvr)
+{
+    rtkrov_t *rov;
+    nav_t *nav;
+    int i;
+    
+    tracet(3,"rtkmsvrfree:\n");
+    
+    if (msvr->state) rtkmsvrstop(msvr);
+    
+    for (i=0;i<msvr->nrov;i++) {
+        rov=msvr->rov[i];
+        rtkfree(&rov->rtk);
+        if (rov->raw ) {free_raw (rov->raw ); free(rov->raw );}
+        if (rov->rtcm) {free_rtcm(rov->rtcm); free(rov->rtcm);}
+        free(rov->obs.data);
+        free(rov);
+    }
+    for (i=0;msvr->work&&i<msvr->nwork;i++) {
+        nav=&msvr->work[i].nav;
+        freetec(nav);
+        free(nav->eph); free(nav->geph); free(nav->seph);
+        free(nav->peph); free(nav->pclk); free(nav->alm);
+        free(nav->tec); free(nav->erp.data);
+        free(msvr->work[i].base.data);
+    }
+    free(msvr->rov);
+    free(msvr->work);
+    msvr->rov=NULL; msvr->work=NULL;
+    msvr->nrov=msvr->nrovmax=0;
+}
+/* add rover to multi-rover rtk server -----------------------------------------
+* add rover to multi-rover rtk server
+* args   : rtkmsvr_t *msvr  IO multi-rover rtk server
+*          int    *strs     I  stream types {input,solution,log} (STR_???)
+*          char   **paths   I  stream paths {input,solution,log}
+*          int    format    I  input format (STRFMT_???)
+*          char   *rcvopt   I  receiver options
+*          prcopt_t *prcopt I  processing options
+*          solopt_t *solopt I  solution options
+* return : rover index (-1:error)
+* notes  : rovers can be added only while the server is stopped. navigation
+*          data decoded from rover input are not used
+*-----------------------------------------------------------------------------*/
+extern int rtkmsvradd(rtkmsvr_t *msvr, const int *strs, const char **paths,
+                      int format, const char *rcvopt, const prcopt_t *prcopt,
+                      const solopt_t *solopt)
+{
+    rtkrov_t *rov,**rov_p;
+    int i;
+    
+    tracet(3,"rtkmsvradd: format=%d\n",format);
+    
+    if (msvr->state) return -1;
+    
+    if (msvr->nrov>=msvr->nrovmax) {
+        msvr->nrovmax=msvr->nrovmax<=0?16:msvr->nrovmax*2;
+        if (!(rov_p=(rtkrov_t **)realloc(msvr->rov,sizeof(rtkrov_t *)*
+                                         msvr->nrovmax))) {
+            tracet(1,"rtkmsvradd: malloc error\n");
+            msvr->nrovmax=msvr->nrov;
+            return -1;
+        }
+        msvr->rov=rov_p;
+    }
+    if (!(rov=(rtkrov_t *)calloc(1,sizeof(rtkrov_t)))||
+        !(rov->obs.data=(obsd_t *)malloc(sizeof(obsd_t)*MAXOBS*2))) {
+        tracet(1,"rtkmsvradd: malloc error\n");
+        free(rov);
+        return -1;
+    }
+    rov->obs.nmax=MAXOBS*2;
+    rov->format=format;
+    rov->solopt=*solopt;
+    for (i=0;i<3;i++) {
+        rov->strs[i]=strs[i];
+        strcpy(rov->paths[i],paths[i]?paths[i]:"");
+        strinit(rov->stream+i);
+    }
+    /* initialize receiver raw or rtcm control */
+    if (format==STRFMT_RTCM2||format==STRFMT_RTCM3) {
+        if (!(rov->rtcm=(rtcm_t *)malloc(sizeof(rtcm_t)))||!init_rtcm(rov->rtcm)) {
+            tracet(1,"rtkmsvradd: init rtcm error\n");
+            free(rov->rtcm); free(rov->obs.data); free(rov);
+            return -1;
+        }
+        strcpy(rov->rtcm->opt,rcvopt?rcvopt:"");
+    }
+    else {
+        if (!(rov->raw=(raw_t *)malloc(sizeof(raw_t)))||!init_raw(rov->raw,format)) {
+            tracet(1,"rtkmsvradd: init raw error\n");
+            free(rov->raw); free(rov->obs.data); free(rov);
+            return -1;
+        }
+        strcpy(rov->raw->opt,rcvopt?rcvopt:"");
+    }
+    rtkinit(&rov->rtk,prcopt);
+    
+    msvr->rov[msvr->nrov]=rov;
+    return msvr->nrov++;
+}
+/* start multi-rover rtk server ------------------------------------------------
+* open rover streams and start worker threads of multi-rover rtk server
+* args   : rtkmsvr_t *msvr  IO multi-rover rtk server
+*          int    cycle     I  worker cycle (ms)
+*          int    buffsize  I  rover input buffer size (bytes)
+*          char   *errmsg   O  error message
+* return : status (1:ok 0:error)
+* notes  : the rtk server of base station and corrections should be started
+*          by rtksvrstart() separately
+*-----------------------------------------------------------------------------*/
+extern int rtkmsvrstart(rtkmsvr_t *msvr, int cycle, int buffsize, char *errmsg)
+{
+    rtkrov_t *rov;
+    gtime_t time;
+    int i,j,rw;
+    
+    tracet(3,"rtkmsvrstart: cycle=%d buffsize=%d nrov=%d\n",cycle,buffsize,
+           msvr->nrov);
+    
+    if (msvr->state) {
+        sprintf(errmsg,"server already started");
+        return 0;
+    }
+    strinitcom();
+    msvr->cycle=cycle>1?cycle:1;
+    msvr->buffsize=buffsize>4096?buffsize:4096;
+    
+    for (i=0;i<msvr->nrov;i++) {
+        rov=msvr->rov[i];
+        rov->nb=0;
+        if (!(rov->buff=(uint8_t *)malloc(msvr->buffsize))) {
+            sprintf(errmsg,"rtk server malloc error");
+            rtkmsvrstop(msvr);
+            return 0;
+        }
+        /* open rover streams */
+        for (j=0;j<3;j++) {
+            rw=j<1?STR_MODE_R:STR_MODE_W;
+            if (rov->strs[j]!=STR_FILE) rw|=STR_MODE_W;
+            if (!stropen(rov->stream+j,rov->strs[j],rw,rov->paths[j])) {
+                sprintf(errmsg,"rover %d str%d open error path=%s",i+1,j+1,
+                        rov->paths[j]);
+                rtkmsvrstop(msvr);
+                return 0;
+            }
+        }
+        /* set initial time for rtcm and raw */
+        time=rov->strs[0]==STR_FILE?strgettime(rov->stream):utc2gpst(timeget());
+        if (rov->raw ) rov->raw ->time=time;
+        if (rov->rtcm) rov->rtcm->time=time;
+        
+        /* write solution header to solution stream */
+        writesolhead(rov->stream+1,&rov->solopt,&rov->rtk.opt);
+    }
+    msvr->state=1;
+    
+    /* create worker threads */
+    for (i=0;i<msvr->nwork;i++) {
+#ifdef WIN32
+        if (!(msvr->work[i].thread=CreateThread(NULL,0,rtkworkthread,
+                                                msvr->work+i,0,NULL))) {
+#else
+        if (pthread_create(&msvr->work[i].thread,NULL,rtkworkthread,
+                           msvr->work+i)) {
+#endif
+            sprintf(errmsg,"thread create error\n");
+            msvr->state=0;
+            for (j=0;j<i;j++) {
+#ifdef WIN32
+                WaitForSingleObject(msvr->work[j].thread,10000);
+                CloseHandle(msvr->work[j].thread);
+#else
+                pthread_join(msvr->work[j].thread,NULL);
+#endif
+            }
+            rtkmsvrstop(msvr);
+            return 0;
+        }
+    }
+    return 1;
+}
+/* stop multi-rover rtk server -------------------------------------------------
+* stop worker threads and close rover streams of multi-rover rtk server
+* args   : rtkmsvr_t *msvr  IO multi-rover rtk server
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void rtkmsvrstop(rtkmsvr_t *msvr)
+{
+    int i,j;
+    
+    tracet(3,"rtkmsvrstop:\n");
+    
+    if (msvr->state) {
+        msvr->state=0;
+        
+        for (i=0;i<msvr->nwork;i++) {
+#ifdef WIN32
+            WaitForSingleObject(msvr->work[i].thread,10000);
+            CloseHandle(msvr->work[i].thread);
+#else
+            pthread_join(msvr->work[i].thread,NULL);
+#endif
+        }
+    }
+    for (i=0;i<msvr->nrov;i++) {
+        for (j=0;j<3;j++) strclose(msvr->rov[i]->stream+j);
+        free(msvr->rov[i]->buff);
+        msvr->rov[i]->buff=NULL;
+        msvr->rov[i]->nb=0;
+    }
+}
@@ -74,6 +74,13 @@
 *                           accept HTTP/1.1 as protocol for NTRIP caster
 *                           suppress warning for buffer overflow by sprintf()
 *                           use integer types in stdint.h
+*           2026/10/18 1.30 add api strevtinit(),strevtfree(),strevtwait()
+*                           add api strsetmaxcli()
+*                           wait tcp server clients by epoll and queue output
+*                           to slow clients, evict clients on queue overflow
+*                           add api strreptime(),strsetreptime()
+*           2026/10/18 1.31 add api httpsvropen(),httpsvrclose(),httpsvrreq(),
+*                           httpsvrrsp()
 *-----------------------------------------------------------------------------*/
 #define _POSIX_C_SOURCE 200112L
 #include <ctype.h>
@@ -94,6 +101,11 @@
 #include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <netdb.h>
+#include <poll.h>
+#endif
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #endif
 
 /* constants -----------------------------------------------------------------*/
@@ -101,7 +113,8 @@
 #define TINTACT             200         /* period for stream active (ms) */
 #define SERIBUFFSIZE        4096        /* serial buffer size (bytes) */
 #define TIMETAGH_LEN        64          /* time tag file header length */
-#define MAXCLI              32          /* max client connection for tcp svr */
+#define MAXCLI              32          /* default max client connection for tcp svr */
+#define MAXCLIEVT           256         /* max client events per wait for tcp svr */
 #define MAXSTATMSG          32          /* max length of status message */
 #define DEFAULT_MEMBUF_SIZE 4096        /* default memory buffer size (bytes) */
 
@@ -120,6 +133,8 @@
 #define NTRIP_RSP_ERR_PWD   "ERROR - Bad Password\r\n"
 #define NTRIP_RSP_ERR_MNTP  "ERROR - Bad Mountpoint\r\n"
 
+#define HTTP_MAXREQ         4096        /* max size of http request */
+
 #define FTP_CMD             "wget"      /* ftp/http command */
 #define FTP_TIMEOUT         30          /* ftp/http timeout (s) */
 
@@ -160,6 +175,8 @@ typedef struct {            /* file control type */
     double start;           /* start offset (s) */
     double speed;           /* replay speed (time factor) */
     double swapintv;        /* swap interval (hr) (0: no swap) */
+    int vclock;             /* replay by virtual clock (0:off,1:on) */
+    gtime_t vtime;          /* virtual clock time for replay */
     rtklib_lock_t lock;     /* lock flag */
 } file_t;
 
@@ -172,11 +189,26 @@ typedef struct {            /* tcp control type */
     int tcon;               /* reconnect time (ms) (-1:never,0:now) */
     uint32_t tact;          /* data active tick */
     uint32_t tdis;          /* disconnect tick */
+    uint32_t gen;           /* socket generation (changed on new socket) */
 } tcp_t;
 
+typedef struct {            /* tcp client output queue type */
+    uint8_t *buff;          /* queue buffer (NULL: not allocated) */
+    int rp,n;               /* read pointer,queued bytes */
+    int wait;               /* waiting for writable (0:off,1:on) */
+} cliq_t;
+
 typedef struct tcpsvr_tag { /* tcp server type */
     tcp_t svr;              /* tcp server control */
-    tcp_t cli[MAXCLI];      /* tcp client controls */
+    tcp_t *cli;             /* tcp client controls */
+    cliq_t *que;            /* tcp client output queues */
+    int maxcli;             /* max number of clients */
+    int ncli;               /* number of connected clients */
+    int nrdy;               /* number of clients ready to read */
+    int *act;               /* indexes of connected clients */
+    int *rdy;               /* indexes of clients ready to read */
+    int nrej,nevict;        /* number of rejected/evicted clients */
+    int epfd;               /* epoll descriptor (-1:none) */
 } tcpsvr_t;
 
 typedef struct {            /* tcp cilent type */
@@ -216,7 +248,7 @@ typedef struct {            /* ntrip client/server connection type */
     char mntpnt[256];       /* mountpoint */
     char str[NTRIP_MAXSTR]; /* mountpoint string for server */
     int nb;                 /* request buffer size */
-    uint8_t buff[NTRIP_MAXRSP]; /* request buffer */
+    uint8_t *buff;          /* request buffer (NTRIP_MAXRSP bytes) */
 } ntripc_con_t;
 
 typedef struct {            /* ntrip caster control type */
@@ -227,9 +259,15 @@ typedef struct {            /* ntrip caster control type */
     char passwd[256];       /* password */
     char srctbl[NTRIP_MAXSTR]; /* source table */
     tcpsvr_t *tcp;          /* tcp server */
-    ntripc_con_t con[MAXCLI]; /* ntrip client/server connections */
+    ntripc_con_t *con;      /* ntrip client/server connections */
 } ntripc_t;
 
+typedef struct {            /* http server connection type */
+    int state;              /* state (0:request,1:response sent) */
+    int nb;                 /* request buffer size */
+    char *buff;             /* request buffer (HTTP_MAXREQ bytes) */
+} httpcon_t;
+
 typedef struct {            /* udp type */
     int state;              /* state (0:close,1:open) */
     int type;               /* type (0:server,1:client) */
@@ -257,6 +295,7 @@ typedef struct {            /* ftp download control type */
 typedef struct {            /* memory buffer type */
     int state,wp,rp;        /* state,write/read pointer */
     int bufsize;            /* buffer size (bytes) */
+    int evfd;               /* event descriptor for data written (-1:none) */
     rtklib_lock_t lock;     /* lock flag */
     uint8_t *buf;           /* write buffer */
 } membuf_t;
@@ -273,6 +312,7 @@ static int toinact  =10000; /* inactive timeout (ms) */
 static int ticonnect=10000; /* interval to re-connect (ms) */
 static int tirate   =1000;  /* averaging time for data rate (ms) */
 static int buffsize =32768; /* receive/send buffer size (bytes) */
+static int maxcli   =MAXCLI; /* max clients of tcp server/ntrip caster */
 static char localdir[1024]=""; /* local directory for ftp/http */
 static char proxyaddr[256]=""; /* http/ntrip/ftp proxy address */
 static uint32_t tick_master=0; /* time tick master for replay */
@@ -728,6 +768,8 @@ static file_t *openfile(const char *path, int mode, char *msg)
     file->start=start;
     file->speed=speed;
     file->swapintv=swapintv;
+    file->vclock=0;
+    file->vtime=time0;
     rtklib_initlock(&file->lock);
     
     time=utc2gpst(timeget());
@@ -820,6 +862,7 @@ static int readfile(file_t *file, uint8_t *buff, int nmax, char *msg)
     fd_set rs;
     uint64_t fpos_8B;
     uint32_t t,tick,fpos_4B;
+    double dt;
     long pos,n;
     int nr=0;
     
@@ -841,7 +884,12 @@ static int readfile(file_t *file, uint8_t *buff, int nmax, char *msg)
     if (file->fp_tag) {
         
         /* target tick */
-        if (file->repmode) { /* slave */
+        if (file->vclock) { /* virtual clock */
+            if ((dt=timediff(file->vtime,file->time))<0.0) return 0;
+            if (dt<file->start) dt=file->start;
+            t=(uint32_t)(dt*1000.0+0.5);
+        }
+        else if (file->repmode) { /* slave */
             t=(uint32_t)(tick_master+file->offset);
         }
         else { /* master */
@@ -1040,13 +1088,28 @@ static int setsock(socket_t sock, char *msg)
     }
     return 1;
 }
+/* test socket readable/writable without blocking ----------------------------*/
+static int pollsock(socket_t sock, int wr)
+{
+#ifdef WIN32
+    struct timeval tv={0};
+    fd_set fs;
+    
+    FD_ZERO(&fs); FD_SET(sock,&fs);
+    return wr?select(sock+1,NULL,&fs,NULL,&tv):select(sock+1,&fs,NULL,NULL,&tv);
+#else
+    struct pollfd pfd;
+    
+    pfd.fd=sock;
+    pfd.events=wr?POLLOUT:POLLIN;
+    pfd.revents=0;
+    return poll(&pfd,1,0); /* no FD_SETSIZE limit on socket number */
+#endif
+}
 /* non-block accept ----------------------------------------------------------*/
 static socket_t accept_nb(socket_t sock, struct sockaddr *addr, socklen_t *len, int *err)
 {
-    fd_set rs;
-    FD_ZERO(&rs); FD_SET(sock, &rs);
-    struct timeval tv = {0};
-    int ret = select(sock + 1, &rs, NULL, NULL, &tv);
+    int ret = pollsock(sock, 0);
     if (ret == 0) {
       *err = 0;
       return (socket_t)ret;
@@ -1081,10 +1144,7 @@ static int connect_nb(socket_t sock, struct sockaddr *addr, socklen_t len, int *
     if (connect(sock, addr, len) == -1) {
         *err = errsock();
         if (*err != EISCONN && *err != EINPROGRESS && *err != EALREADY) return -1;
-        fd_set rs, ws;
-        FD_ZERO(&rs); FD_SET(sock, &rs); ws = rs;
-        struct timeval tv = {0};
-        if (select(sock + 1, &rs, &ws, NULL, &tv) == 0) {
+        if (pollsock(sock, 1) == 0) {
           *err = 0;
           return 0;
         }
@@ -1098,10 +1158,7 @@ static int connect_nb(socket_t sock, struct sockaddr *addr, socklen_t len, int *
 /* non-block receive ---------------------------------------------------------*/
 static int recv_nb(socket_t sock, uint8_t *buff, int n, int *err)
 {
-    fd_set rs;
-    FD_ZERO(&rs); FD_SET(sock, &rs);
-    struct timeval tv = {0};
-    int ret = select(sock + 1, &rs, NULL, NULL, &tv);
+    int ret = pollsock(sock, 0);
     if (ret < 0) {
       *err = errsock();
       return ret;
@@ -1125,10 +1182,7 @@ static int recv_nb(socket_t sock, uint8_t *buff, int n, int *err)
 /* non-block send ------------------------------------------------------------*/
 static int send_nb(socket_t sock, uint8_t *buff, int n, int *err)
 {
-    fd_set ws;
-    FD_ZERO(&ws); FD_SET(sock, &ws);
-    struct timeval tv = {0};
-    int ret = select(sock + 1, NULL, &ws, NULL, &tv);
+    int ret = pollsock(sock, 1);
     if (ret < 0) {
       *err = errsock();
       return ret;
@@ -1156,6 +1210,7 @@ static int gentcp(tcp_t *tcp, int type, char *msg)
     tracet(3,"gentcp: type=%d\n",type);
     
     /* generate socket */
+    tcp->gen++;
     if ((tcp->sock=socket(AF_INET,SOCK_STREAM,0))==(socket_t)-1) {
         sprintf(msg,"socket error (%d)",errsock());
         tracet(1,"gentcp: socket error err=%d\n",errsock());
@@ -1195,7 +1250,7 @@ static int gentcp(tcp_t *tcp, int type, char *msg)
             tcp->state=-1;
             return 0;
         }
-        listen(tcp->sock,5);
+        listen(tcp->sock,SOMAXCONN);
     }
     else { /* client socket */
         if (!(hp=gethostbyname(tcp->saddr))) {
@@ -1230,23 +1285,51 @@ static tcpsvr_t *opentcpsvr(const char *path, char *msg)
 {
     tcpsvr_t *tcpsvr,tcpsvr0={{0}};
     char port[256]="";
+#ifdef __linux__
+    struct epoll_event ev={0};
+#endif
     
-    tracet(3,"opentcpsvr: path=%s\n",path);
+    tracet(3,"opentcpsvr: path=%s maxcli=%d\n",path,maxcli);
     
     if (!(tcpsvr=(tcpsvr_t *)malloc(sizeof(tcpsvr_t)))) return NULL;
     *tcpsvr=tcpsvr0;
+    tcpsvr->epfd=-1;
+    tcpsvr->maxcli=maxcli;
+    if (!(tcpsvr->cli=(tcp_t  *)calloc(maxcli,sizeof(tcp_t )))||
+        !(tcpsvr->que=(cliq_t *)calloc(maxcli,sizeof(cliq_t)))||
+        !(tcpsvr->act=(int    *)malloc(sizeof(int)*maxcli))||
+        !(tcpsvr->rdy=(int    *)malloc(sizeof(int)*maxcli))) {
+        sprintf(msg,"memory allocation error");
+        free(tcpsvr->cli); free(tcpsvr->que); free(tcpsvr->act);
+        free(tcpsvr);
+        return NULL;
+    }
     decodetcppath(path,tcpsvr->svr.saddr,port,NULL,NULL,NULL,NULL);
     if (sscanf(port,"%d",&tcpsvr->svr.port)<1) {
         sprintf(msg,"port error: %s",port);
         tracet(1,"opentcpsvr: port error port=%s\n",port);
+        free(tcpsvr->cli); free(tcpsvr->que); free(tcpsvr->act); free(tcpsvr->rdy);
         free(tcpsvr);
         return NULL;
     }
     if (!gentcp(&tcpsvr->svr,0,msg)) {
+        free(tcpsvr->cli); free(tcpsvr->que); free(tcpsvr->act); free(tcpsvr->rdy);
         free(tcpsvr);
         return NULL;
     }
     tcpsvr->svr.tcon=0;
+#ifdef __linux__
+    /* wait for client connection and data by epoll */
+    if ((tcpsvr->epfd=epoll_create1(0))>=0) {
+        ev.events=EPOLLIN;
+        ev.data.u32=(uint32_t)-1;
+        if (epoll_ctl(tcpsvr->epfd,EPOLL_CTL_ADD,tcpsvr->svr.sock,&ev)<0) {
+            tracet(2,"opentcpsvr: epoll_ctl error err=%d\n",errno);
+            close(tcpsvr->epfd);
+            tcpsvr->epfd=-1;
+        }
+    }
+#endif
     return tcpsvr;
 }
 /* close tcp server ----------------------------------------------------------*/
@@ -1256,34 +1339,72 @@ static void closetcpsvr(tcpsvr_t *tcpsvr)
     
     tracet(3,"closetcpsvr:\n");
     
-    for (i=0;i<MAXCLI;i++) {
-        if (tcpsvr->cli[i].state) closesocket(tcpsvr->cli[i].sock);
+    for (i=0;i<tcpsvr->ncli;i++) {
+        closesocket(tcpsvr->cli[tcpsvr->act[i]].sock);
+    }
+    for (i=0;i<tcpsvr->maxcli;i++) {
+        free(tcpsvr->que[i].buff);
     }
     closesocket(tcpsvr->svr.sock);
+#ifdef __linux__
+    if (tcpsvr->epfd>=0) close(tcpsvr->epfd);
+#endif
+    free(tcpsvr->cli); free(tcpsvr->que); free(tcpsvr->act); free(tcpsvr->rdy);
     free(tcpsvr);
 }
 /* update tcp server ---------------------------------------------------------*/
 static void updatetcpsvr(tcpsvr_t *tcpsvr, char *msg)
 {
-    char saddr[256]="";
-    int i,n=0;
-    
     tracet(4,"updatetcpsvr: state=%d\n",tcpsvr->svr.state);
     
     if (tcpsvr->svr.state==0) return;
     
-    for (i=0;i<MAXCLI;i++) {
-        if (!tcpsvr->cli[i].state) continue;
-        strcpy(saddr,tcpsvr->cli[i].saddr);
-        n++;
-    }
-    if (n==0) {
+    if (tcpsvr->ncli==0) {
         tcpsvr->svr.state=1;
         sprintf(msg,"waiting...");
         return;
     }
     tcpsvr->svr.state=2;
-    if (n==1) sprintf(msg,"%s",saddr); else sprintf(msg,"%d clients",n);
+    if (tcpsvr->ncli==1) sprintf(msg,"%s",tcpsvr->cli[tcpsvr->act[0]].saddr);
+    else sprintf(msg,"%d clients",tcpsvr->ncli);
+}
+/* set client events to wait -------------------------------------------------*/
+static void setclievt(tcpsvr_t *tcpsvr, int i, int add)
+{
+#ifdef __linux__
+    struct epoll_event ev={0};
+    
+    if (tcpsvr->epfd<0) return;
+    ev.events=EPOLLIN|(tcpsvr->que[i].wait?EPOLLOUT:0);
+    ev.data.u32=(uint32_t)i;
+    if (epoll_ctl(tcpsvr->epfd,add?EPOLL_CTL_ADD:EPOLL_CTL_MOD,
+                  tcpsvr->cli[i].sock,&ev)<0) {
+        tracet(2,"setclievt: epoll_ctl error i=%d err=%d\n",i,errno);
+    }
+#endif
+}
+/* disconnect tcp server client ----------------------------------------------*/
+static void discli(tcpsvr_t *tcpsvr, int i)
+{
+    int j;
+    
+    tracet(3,"discli: i=%d sock=%d\n",i,tcpsvr->cli[i].sock);
+    
+    /* closing the socket also removes it from epoll */
+    discontcp(tcpsvr->cli+i,ticonnect);
+    free(tcpsvr->que[i].buff);
+    tcpsvr->que[i].buff=NULL;
+    tcpsvr->que[i].rp=tcpsvr->que[i].n=tcpsvr->que[i].wait=0;
+    
+    for (j=0;j<tcpsvr->ncli;j++) {
+        if (tcpsvr->act[j]==i) {
+            tcpsvr->act[j]=tcpsvr->act[--tcpsvr->ncli];
+            break;
+        }
+    }
+    for (j=0;j<tcpsvr->nrdy;j++) {
+        if (tcpsvr->rdy[j]==i) tcpsvr->rdy[j]=tcpsvr->rdy[--tcpsvr->nrdy];
+    }
 }
 /* accept client connection --------------------------------------------------*/
 static int accsock(tcpsvr_t *tcpsvr, char *msg)
@@ -1295,13 +1416,6 @@ static int accsock(tcpsvr_t *tcpsvr, char *msg)
     
     tracet(4,"accsock: sock=%d\n",tcpsvr->svr.sock);
     
-    for (i=0;i<MAXCLI;i++) {
-        if (tcpsvr->cli[i].state==0) break;
-    }
-    if (i>=MAXCLI) {
-        tracet(2,"accsock: too many clients sock=%d\n",tcpsvr->svr.sock);
-        return 0;
-    }
     if ((sock=accept_nb(tcpsvr->svr.sock,(struct sockaddr *)&addr,&len,&err))==(socket_t)-1) {
         sprintf(msg,"accept error (%d)",err);
         tracet(1,"accsock: accept error sock=%d err=%d\n",tcpsvr->svr.sock,err);
@@ -1310,9 +1424,21 @@ static int accsock(tcpsvr_t *tcpsvr, char *msg)
         return 0;
     }
     if (sock==0) return 0;
+    
+    if (tcpsvr->ncli>=tcpsvr->maxcli) { /* reject client over limit */
+        tracet(2,"accsock: too many clients sock=%d maxcli=%d\n",
+               tcpsvr->svr.sock,tcpsvr->maxcli);
+        closesocket(sock);
+        tcpsvr->nrej++;
+        return 1;
+    }
     if (!setsock(sock,msg)) return 0;
     
+    for (i=0;i<tcpsvr->maxcli;i++) {
+        if (tcpsvr->cli[i].state==0) break;
+    }
     tcpsvr->cli[i].sock=sock;
+    tcpsvr->cli[i].gen++;
     memcpy(&tcpsvr->cli[i].addr,&addr,sizeof(addr));
     strcpy(tcpsvr->cli[i].saddr,inet_ntoa(addr.sin_addr));
     sprintf(msg,"%s",tcpsvr->cli[i].saddr);
@@ -1320,17 +1446,123 @@ static int accsock(tcpsvr_t *tcpsvr, char *msg)
            tcpsvr->cli[i].sock,tcpsvr->cli[i].saddr,i);
     tcpsvr->cli[i].state=2;
     tcpsvr->cli[i].tact=tickget();
+    tcpsvr->act[tcpsvr->ncli++]=i;
+    setclievt(tcpsvr,i,1);
     return 1;
 }
-/* wait socket accept --------------------------------------------------------*/
+/* flush client output queue -------------------------------------------------*/
+static int flushcli(tcpsvr_t *tcpsvr, int i)
+{
+    cliq_t *q=tcpsvr->que+i;
+    int ns,err;
+    
+    if (q->n<=0) return 1;
+    
+    if ((ns=send_nb(tcpsvr->cli[i].sock,q->buff+q->rp,q->n,&err))<0) {
+        tracet(2,"flushcli: send error i=%d sock=%d err=%d\n",i,
+               tcpsvr->cli[i].sock,err);
+        return 0;
+    }
+    if (ns>0) {
+        q->rp+=ns; q->n-=ns;
+        tcpsvr->cli[i].tact=tickget();
+    }
+    if (q->n<=0) q->rp=0;
+    
+    /* wait for writable only while data queued */
+    if (q->wait!=(q->n>0)) {
+        q->wait=q->n>0;
+        setclievt(tcpsvr,i,0);
+    }
+    return 1;
+}
+/* send data to client via output queue --------------------------------------*/
+static int sendcli(tcpsvr_t *tcpsvr, int i, uint8_t *buff, int n)
+{
+    cliq_t *q=tcpsvr->que+i;
+    int ns=0,err;
+    
+    if (!flushcli(tcpsvr,i)) return 0;
+    
+    if (q->n<=0) {
+        if ((ns=send_nb(tcpsvr->cli[i].sock,buff,n,&err))<0) {
+            tracet(2,"sendcli: send error i=%d sock=%d err=%d\n",i,
+                   tcpsvr->cli[i].sock,err);
+            return 0;
+        }
+        if (ns>0) tcpsvr->cli[i].tact=tickget();
+        if (ns>=n) return 1;
+    }
+    /* evict slow client on queue overflow or no progress in timeout */
+    if (q->n+n-ns>buffsize||
+        (q->n>0&&toinact>0&&(int)(tickget()-tcpsvr->cli[i].tact)>toinact)) {
+        tracet(2,"sendcli: slow client evicted i=%d addr=%s queued=%d\n",i,
+               tcpsvr->cli[i].saddr,q->n);
+        tcpsvr->nevict++;
+        return 0;
+    }
+    if (!q->buff&&!(q->buff=(uint8_t *)malloc(buffsize))) return 0;
+    
+    if (q->rp+q->n+n-ns>buffsize) {
+        memmove(q->buff,q->buff+q->rp,q->n);
+        q->rp=0;
+    }
+    memcpy(q->buff+q->rp+q->n,buff+ns,n-ns);
+    q->n+=n-ns;
+    if (!q->wait) {
+        q->wait=1;
+        setclievt(tcpsvr,i,0);
+    }
+    return 1;
+}
+/* wait socket accept and client events --------------------------------------*/
 static int waittcpsvr(tcpsvr_t *tcpsvr, char *msg)
 {
+#ifdef __linux__
+    struct epoll_event evs[MAXCLIEVT];
+    int j,nev;
+#endif
+    int i;
+    
     tracet(4,"waittcpsvr: sock=%d state=%d\n",tcpsvr->svr.sock,tcpsvr->svr.state);
     
     if (tcpsvr->svr.state<=0) return 0;
     
+    tcpsvr->nrdy=0;
+#ifdef __linux__
+    if (tcpsvr->epfd>=0) {
+        nev=epoll_wait(tcpsvr->epfd,evs,MAXCLIEVT,0);
+        
+        for (j=0;j<nev;j++) {
+            if (evs[j].data.u32==(uint32_t)-1) {
+                while (accsock(tcpsvr,msg)) ;
+                continue;
+            }
+            i=(int)evs[j].data.u32;
+            if (tcpsvr->cli[i].state!=2) continue;
+            
+            if ((evs[j].events&EPOLLOUT)&&!flushcli(tcpsvr,i)) {
+                discli(tcpsvr,i);
+                continue;
+            }
+            if (evs[j].events&(EPOLLIN|EPOLLHUP|EPOLLERR)) {
+                tcpsvr->rdy[tcpsvr->nrdy++]=i;
+            }
+        }
+        updatetcpsvr(tcpsvr,msg);
+        return tcpsvr->svr.state==2;
+    }
+#endif
     while (accsock(tcpsvr,msg)) ;
     
+    /* test all clients without epoll */
+    for (i=0;i<tcpsvr->ncli;i++) {
+        if (!flushcli(tcpsvr,tcpsvr->act[i])) {
+            discli(tcpsvr,tcpsvr->act[i--]);
+            continue;
+        }
+        tcpsvr->rdy[tcpsvr->nrdy++]=tcpsvr->act[i];
+    }
     updatetcpsvr(tcpsvr,msg);
     return tcpsvr->svr.state==2;
 }
@@ -1343,15 +1575,15 @@ static int readtcpsvr(tcpsvr_t *tcpsvr, uint8_t *buff, int n, char *msg)
     
     if (!waittcpsvr(tcpsvr,msg)) return 0;
     
-    for (i=0;i<MAXCLI;i++) {
-        if (tcpsvr->cli[i].state!=2) continue;
+    while (tcpsvr->nrdy>0) {
+        i=tcpsvr->rdy[--tcpsvr->nrdy];
         
         if ((nr=recv_nb(tcpsvr->cli[i].sock,buff,n,&err))==-1) {
             if (err) {
                 tracet(2,"readtcpsvr: recv error sock=%d err=%d\n",
                        tcpsvr->cli[i].sock,err);
             }
-            discontcp(&tcpsvr->cli[i],ticonnect);
+            discli(tcpsvr,i);
             updatetcpsvr(tcpsvr,msg);
         }
         if (nr>0) {
@@ -1364,29 +1596,18 @@ static int readtcpsvr(tcpsvr_t *tcpsvr, uint8_t *buff, int n, char *msg)
 /* write tcp server ----------------------------------------------------------*/
 static int writetcpsvr(tcpsvr_t *tcpsvr, uint8_t *buff, int n, char *msg)
 {
-    int i,ns=0,nmax=0,err;
+    int i;
     
     tracet(4,"writetcpsvr: state=%d n=%d\n",tcpsvr->svr.state,n);
     
     if (!waittcpsvr(tcpsvr,msg)) return 0;
     
-    for (i=0;i<MAXCLI;i++) {
-        if (tcpsvr->cli[i].state!=2) continue;
-        
-        if ((ns=send_nb(tcpsvr->cli[i].sock,buff,n,&err))==-1) {
-            if (err) {
-                tracet(2,"writetcpsvr: send error i=%d sock=%d err=%d\n",i,
-                       tcpsvr->cli[i].sock,err);
-            }
-            discontcp(&tcpsvr->cli[i],ticonnect);
-            updatetcpsvr(tcpsvr,msg);
-        }
-        else {
-            if (ns>nmax) nmax=ns;
-            if (ns>0) tcpsvr->cli[i].tact=tickget();
-        }
+    for (i=0;i<tcpsvr->ncli;i++) {
+        if (sendcli(tcpsvr,tcpsvr->act[i],buff,n)) continue;
+        discli(tcpsvr,tcpsvr->act[i--]);
     }
-    return nmax;
+    updatetcpsvr(tcpsvr,msg);
+    return tcpsvr->ncli>0?n:0;
 }
 /* get state tcp server ------------------------------------------------------*/
 static int statetcpsvr(tcpsvr_t *tcpsvr)
@@ -1409,19 +1630,31 @@ static int statextcp(tcp_t *tcp, char *msg)
 #endif
     return (int)(p-msg);
 }
+/* print extended state tcp server clients -----------------------------------*/
+static int statexcli(tcpsvr_t *tcpsvr, char *msg)
+{
+    char *p=msg;
+    
+    p+=sprintf(p,"  maxcli  = %d\n",tcpsvr->maxcli);
+    p+=sprintf(p,"  ncli    = %d\n",tcpsvr->ncli);
+    p+=sprintf(p,"  nrej    = %d\n",tcpsvr->nrej);
+    p+=sprintf(p,"  nevict  = %d\n",tcpsvr->nevict);
+    return (int)(p-msg);
+}
 /* get extended state tcp server ---------------------------------------------*/
 static int statextcpsvr(tcpsvr_t *tcpsvr, char *msg)
 {
     char *p=msg;
-    int i,state=tcpsvr?tcpsvr->svr.state:0;
+    int i,j,state=tcpsvr?tcpsvr->svr.state:0;
     
     p+=sprintf(p,"tcpsvr:\n");
     p+=sprintf(p,"  state   = %d\n",state);
     if (!state) return 0;
+    p+=statexcli(tcpsvr,p);
     p+=sprintf(p,"  svr:\n");
     p+=statextcp(&tcpsvr->svr,p);
-    for (i=0;i<MAXCLI;i++) {
-        if (!tcpsvr->cli[i].state) continue;
+    for (j=0;j<tcpsvr->ncli&&j<MAXCLI;j++) { /* list up to MAXCLI clients */
+        i=tcpsvr->act[j];
         p+=sprintf(p,"  cli#%d:\n",i);
         p+=statextcp(tcpsvr->cli+i,p);
     }
@@ -1884,10 +2117,14 @@ static ntripc_t *openntripc(const char *path, char *msg)
     
     ntripc->state=0;
     ntripc->mntpnt[0]=ntripc->user[0]=ntripc->passwd[0]=ntripc->srctbl[0]='\0';
-    for (i=0;i<MAXCLI;i++) {
+    if (!(ntripc->con=(ntripc_con_t *)malloc(sizeof(ntripc_con_t)*maxcli))) {
+        free(ntripc);
+        return NULL;
+    }
+    for (i=0;i<maxcli;i++) {
         ntripc->con[i].state=0;
         ntripc->con[i].nb=0;
-        memset(ntripc->con[i].buff,0,NTRIP_MAXRSP);
+        ntripc->con[i].buff=NULL;
     }
     /* decode tcp/ntrip path */
     decodetcppath(path,NULL,port,ntripc->user,ntripc->passwd,ntripc->mntpnt,
@@ -1895,6 +2132,7 @@ static ntripc_t *openntripc(const char *path, char *msg)
     
     if (!*ntripc->mntpnt) {
         tracet(2,"openntripc: no mountpoint path=%s\n",path);
+        free(ntripc->con);
         free(ntripc);
         return NULL;
     }
@@ -1907,6 +2145,7 @@ static ntripc_t *openntripc(const char *path, char *msg)
     /* open tcp server stream */
     if (!(ntripc->tcp=opentcpsvr(tpath,msg))) {
         tracet(2,"openntripc: opentcpsvr error port=%d\n",port);
+        free(ntripc->con);
         free(ntripc);
         return NULL;
     }
@@ -1915,9 +2154,13 @@ static ntripc_t *openntripc(const char *path, char *msg)
 /* close ntrip-caster --------------------------------------------------------*/
 static void closentripc(ntripc_t *ntripc)
 {
+    int i;
+    
     tracet(3,"closentripc: state=%d\n",ntripc->state);
     
+    for (i=0;i<ntripc->tcp->maxcli;i++) free(ntripc->con[i].buff);
     closetcpsvr(ntripc->tcp);
+    free(ntripc->con);
     free(ntripc);
 }
 /* disconnect ntrip-caster connection ----------------------------------------*/
@@ -1925,9 +2168,10 @@ static void discon_ntripc(ntripc_t *ntripc, int i)
 {
     tracet(3,"discon_ntripc: i=%d\n",i);
     
-    discontcp(&ntripc->tcp->cli[i],ticonnect);
+    discli(ntripc->tcp,i);
+    free(ntripc->con[i].buff);
+    ntripc->con[i].buff=NULL;
     ntripc->con[i].nb=0;
-    ntripc->con[i].buff[0]='\0';
     ntripc->con[i].state=0;
 }
 /* send ntrip source table ---------------------------------------------------*/
@@ -2011,12 +2255,15 @@ static void rsp_ntripc(ntripc_t *ntripc, int i)
     
     con->state=1;
     strcpy(con->mntpnt,mntpnt);
+    free(con->buff); /* request buffer no more needed */
+    con->buff=NULL;
+    con->nb=0;
 }
 /* handle ntrip client connect request ---------------------------------------*/
 static void wait_ntripc(ntripc_t *ntripc, char *msg)
 {
     uint8_t *buff;
-    int i,n,nmax,err;
+    int i,j,n,nmax,err;
     
     tracet(4,"wait_ntripc\n");
     
@@ -2024,9 +2271,16 @@ static void wait_ntripc(ntripc_t *ntripc, char *msg)
     
     if (!waittcpsvr(ntripc->tcp,msg)) return;
     
-    for (i=0;i<MAXCLI;i++) {
-        if (ntripc->tcp->cli[i].state!=2||ntripc->con[i].state) continue;
+    for (j=0;j<ntripc->tcp->nrdy;j++) {
+        i=ntripc->tcp->rdy[j];
+        if (ntripc->con[i].state) continue;
         
+        if (!ntripc->con[i].buff&&
+            !(ntripc->con[i].buff=(uint8_t *)malloc(NTRIP_MAXRSP))) {
+            discon_ntripc(ntripc,i);
+            j--;
+            continue;
+        }
         /* receive ntrip client request */
         buff=ntripc->con[i].buff+ntripc->con[i].nb;
         nmax=NTRIP_MAXRSP-ntripc->con[i].nb-1;
@@ -2037,6 +2291,7 @@ static void wait_ntripc(ntripc_t *ntripc, char *msg)
                        ntripc->tcp->cli[i].sock,err);
             }
             discon_ntripc(ntripc,i);
+            j--;
             continue;
         }
         if (n<=0) continue;
@@ -2044,6 +2299,7 @@ static void wait_ntripc(ntripc_t *ntripc, char *msg)
         /* test ntrip client request */
         ntripc->con[i].nb+=n;
         rsp_ntripc(ntripc,i);
+        if (!ntripc->tcp->cli[i].state) j--; /* disconnected by response */
     }
 }
 /* read ntrip-caster ---------------------------------------------------------*/
@@ -2055,7 +2311,8 @@ static int readntripc(ntripc_t *ntripc, uint8_t *buff, int n, char *msg)
     
     wait_ntripc(ntripc,msg);
     
-    for (i=0;i<MAXCLI;i++) {
+    while (ntripc->tcp->nrdy>0) {
+        i=ntripc->tcp->rdy[--ntripc->tcp->nrdy];
         if (!ntripc->con[i].state) continue;
         
         nr=recv_nb(ntripc->tcp->cli[i].sock,buff,n,&err);
@@ -2077,27 +2334,22 @@ static int readntripc(ntripc_t *ntripc, uint8_t *buff, int n, char *msg)
 /* write ntrip-caster --------------------------------------------------------*/
 static int writentripc(ntripc_t *ntripc, uint8_t *buff, int n, char *msg)
 {
-    int i,ns=0,err;
+    int i,j,ns=0;
 
     tracet(4,"writentripc: n=%d\n",n);
     
     wait_ntripc(ntripc,msg);
     
-    for (i=0;i<MAXCLI;i++) {
+    for (j=0;j<ntripc->tcp->ncli;j++) {
+        i=ntripc->tcp->act[j];
         if (!ntripc->con[i].state) continue;
         
-        ns=send_nb(ntripc->tcp->cli[i].sock,buff,n,&err);
-        
-        if (ns<n) {
-            if (err) {
-                tracet(2,"writentripc: send error i=%d sock=%d err=%d\n",i,
-                       ntripc->tcp->cli[i].sock,err);
-            }
+        if (!sendcli(ntripc->tcp,i,buff,n)) {
             discon_ntripc(ntripc,i);
+            j--;
+            continue;
         }
-        else {
-            ntripc->tcp->cli[i].tact=tickget();
-        }
+        ns=n;
     }
     return ns;
 }
@@ -2110,7 +2362,7 @@ static int statentripc(ntripc_t *ntripc)
 static int statexntripc(ntripc_t *ntripc, char *msg)
 {
     char *p=msg;
-    int i,state=!ntripc?0:ntripc->state;
+    int i,j,state=!ntripc?0:ntripc->state;
     
     p+=sprintf(p,"ntripc:\n");
     p+=sprintf(p,"  state   = %d\n",ntripc->state);
@@ -2120,10 +2372,11 @@ static int statexntripc(ntripc_t *ntripc, char *msg)
     p+=sprintf(p,"  user    = %s\n",ntripc->user);
     p+=sprintf(p,"  passwd  = %s\n",ntripc->passwd);
     p+=sprintf(p,"  srctbl  = %s\n",ntripc->srctbl);
+    p+=statexcli(ntripc->tcp,p);
     p+=sprintf(p,"  svr:\n");
     p+=statextcp(&ntripc->tcp->svr,p);
-    for (i=0;i<MAXCLI;i++) {
-        if (!ntripc->tcp->cli[i].state) continue;
+    for (j=0;j<ntripc->tcp->ncli&&j<MAXCLI;j++) { /* list up to MAXCLI clients */
+        i=ntripc->tcp->act[j];
         p+=sprintf(p,"  cli#%d:\n",i);
         p+=statextcp(ntripc->tcp->cli+i,p);
         p+=sprintf(p,"    mntpnt= %s\n",ntripc->con[i].mntpnt);
@@ -2581,6 +2834,11 @@ static membuf_t *openmembuf(const char *path, char *msg)
         return NULL;
     }
     membuf->bufsize=bufsize;
+#ifdef __linux__
+    membuf->evfd=eventfd(0,EFD_NONBLOCK);
+#else
+    membuf->evfd=-1;
+#endif
     rtklib_initlock(&membuf->lock);
     
     sprintf(msg,"membuf sizebuf=%d",bufsize);
@@ -2592,6 +2850,9 @@ static void closemembuf(membuf_t *membuf)
 {
     tracet(3,"closemembufp\n");
     
+#ifdef __linux__
+    if (membuf->evfd>=0) close(membuf->evfd);
+#endif
     free(membuf->buf);
     free(membuf);
 }
@@ -2611,6 +2872,12 @@ static int readmembuf(membuf_t *membuf, uint8_t *buff, int n, char *msg)
         if (++i>=membuf->bufsize) i=0;
     }
     membuf->rp=i;
+#ifdef __linux__
+    if (membuf->rp==membuf->wp&&membuf->evfd>=0) { /* clear data event */
+        uint64_t cnt;
+        if (read(membuf->evfd,&cnt,sizeof(cnt))<0) cnt=0;
+    }
+#endif
     rtklib_unlock(&membuf->lock);
     return nr;
 }
@@ -2635,6 +2902,12 @@ static int writemembuf(membuf_t *membuf, uint8_t *buff, int n, char *msg)
            return i+1;
         }
     }
+#ifdef __linux__
+    if (n>0&&membuf->evfd>=0) { /* signal data event */
+        uint64_t cnt=1;
+        if (write(membuf->evfd,&cnt,sizeof(cnt))<0) cnt=0;
+    }
+#endif
     rtklib_unlock(&membuf->lock);
     return i;
 }
@@ -2657,6 +2930,64 @@ static int statexmembuf(membuf_t *membuf, char *msg)
     sprintf(p,"  rp      = %d\n",membuf->rp);
     return state;
 }
+/* get descriptors to wait for input data -----------------------------------*/
+static int tcpfds(tcp_t *tcp, int *fds, uint32_t *gens, int nmax)
+{
+    if (tcp->state<=0||nmax<=0) return 0;
+    fds[0]=(int)tcp->sock;
+    gens[0]=tcp->gen;
+    return 1;
+}
+static int tcpsvrfds(tcpsvr_t *tcpsvr, int *fds, uint32_t *gens, int nmax)
+{
+    int i,n;
+    
+    if (tcpsvr->svr.state<=0||nmax<=0) return 0;
+    
+    if (tcpsvr->epfd>=0) { /* epoll of server and clients */
+        fds[0]=tcpsvr->epfd;
+        gens[0]=0;
+        return 1;
+    }
+    n=tcpfds(&tcpsvr->svr,fds,gens,nmax); /* for accepting clients */
+    
+    for (i=0;i<tcpsvr->ncli;i++) {
+        n+=tcpfds(tcpsvr->cli+tcpsvr->act[i],fds+n,gens+n,nmax-n);
+    }
+    return n;
+}
+static int strfds(stream_t *stream, int *fds, uint32_t *gens, int nmax)
+{
+    int i,n=0;
+    
+    if (nmax<=0) return 0;
+    gens[0]=0; /* descriptors other than tcp are fixed while opened */
+    
+    switch (stream->type) {
+#ifndef WIN32
+        case STR_SERIAL  :
+            if (((serial_t *)stream->port)->error) break;
+            fds[n++]=((serial_t *)stream->port)->dev;
+            break;
+#endif
+        case STR_TCPSVR  : n=tcpsvrfds((tcpsvr_t *)stream->port,fds,gens,nmax); break;
+        case STR_TCPCLI  : n=tcpfds(&((tcpcli_t *)stream->port)->svr,fds,gens,nmax); break;
+        case STR_NTRIPSVR:
+        case STR_NTRIPCLI: n=tcpfds(&((ntrip_t *)stream->port)->tcp->svr,fds,gens,nmax); break;
+        case STR_NTRIPCAS: n=tcpsvrfds(((ntripc_t *)stream->port)->tcp,fds,gens,nmax); break;
+        case STR_UDPSVR  :
+            if (((udp_t *)stream->port)->state<=0) break;
+            fds[n++]=(int)((udp_t *)stream->port)->sock;
+            break;
+        case STR_MEMBUF  :
+            if (((membuf_t *)stream->port)->evfd<0) break;
+            fds[n++]=((membuf_t *)stream->port)->evfd;
+            break;
+    }
+    /* descriptors of reopened port are distinguished by number of opens */
+    for (i=0;i<n;i++) gens[i]+=stream->nopen<<16;
+    return n; /* file, ftp and http streams are polled by timeout */
+}
 /* initialize stream environment -----------------------------------------------
 * initialize stream environment
 * args   : none
@@ -2687,6 +3018,7 @@ extern void strinit(stream_t *stream)
     stream->state=0;
     stream->inb=stream->inr=stream->outb=stream->outr=0;
     stream->tick_i=stream->tick_o=stream->tact=stream->inbt=stream->outbt=0;
+    stream->nopen=0;
     rtklib_initlock(&stream->lock);
     stream->port=NULL;
     stream->path[0]='\0';
@@ -2814,6 +3146,7 @@ extern int stropen(stream_t *stream, int type, int mode, const char *path)
     stream->inbt=stream->outbt=0;
     stream->msg[0]='\0';
     stream->port=NULL;
+    stream->nopen++;
     switch (type) {
         case STR_SERIAL  : stream->port=openserial(path,mode,stream->msg); break;
         case STR_FILE    : stream->port=openfile  (path,mode,stream->msg); break;
@@ -2887,6 +3220,56 @@ extern void strsync(stream_t *stream1, stream_t *stream2)
     file2=(file_t*)stream2->port;
     if (file1&&file2) syncfile(file1,file2);
 }
+/* get next replay time of stream ----------------------------------------------
+* get time of next input data in time-tagged replay file
+* args   : stream_t *stream I  stream (file with time-tag)
+*          gtime_t *time    O  time of next input data (gpst)
+* return : status (1:ok,0:no time-tag or end of file)
+* notes  : if data until the last time-tag are not read yet, current replay
+*          time set by strsetreptime() is returned
+*-----------------------------------------------------------------------------*/
+extern int strreptime(stream_t *stream, gtime_t *time)
+{
+    file_t *file;
+    int stat=0;
+    
+    if (stream->type!=STR_FILE||!(stream->mode&STR_MODE_R)) return 0;
+    
+    strlock(stream);
+    if ((file=(file_t *)stream->port)&&file->fp&&file->fp_tag) {
+        if (file->vclock&&ftell(file->fp)<file->fpos_n) {
+            *time=file->vtime;
+            stat=1;
+        }
+        else if (file->tick_n!=(uint32_t)(-1)) {
+            *time=timeadd(file->time,file->tick_n*0.001);
+            stat=1;
+        }
+    }
+    strunlock(stream);
+    return stat;
+}
+/* set replay time of stream ---------------------------------------------------
+* set time of virtual clock to replay time-tagged file
+* args   : stream_t *stream I  stream (file with time-tag)
+*          gtime_t time     I  replay time (gpst)
+* return : none
+* notes  : after the call, the file is read up to the replay time regardless
+*          of wall clock, replay speed and sync of streams
+*-----------------------------------------------------------------------------*/
+extern void strsetreptime(stream_t *stream, gtime_t time)
+{
+    file_t *file;
+    
+    if (stream->type!=STR_FILE) return;
+    
+    strlock(stream);
+    if ((file=(file_t *)stream->port)&&file->fp_tag) {
+        file->vclock=1;
+        file->vtime=time;
+    }
+    strunlock(stream);
+}
 /* lock/unlock stream ----------------------------------------------------------
 * lock/unlock stream
 * args   : stream_t *stream I  stream
@@ -3096,6 +3479,106 @@ extern void strsum(stream_t *stream, int *inb, int *inr, int *outb, int *outr)
     if (outr) *outr=stream->outr;
     strunlock(stream);
 }
+/* initialize stream event wait -----------------------------------------------
+* initialize stream event wait used by servers to wake up on input data
+* args   : strevt_t *evt    IO  stream event wait
+* return : status (1:ok,0:not supported, sleep in strevtwait())
+* notes  : supported on linux by epoll(7). socket, serial and memory buffer
+*          streams wake up the waiting thread when data arrives. memory buffer
+*          streams signal an eventfd(2) on write.
+*-----------------------------------------------------------------------------*/
+extern int strevtinit(strevt_t *evt)
+{
+    tracet(3,"strevtinit:\n");
+    
+    evt->n=0;
+#ifdef __linux__
+    evt->fd=epoll_create1(0);
+#else
+    evt->fd=-1;
+#endif
+    return evt->fd>=0;
+}
+/* free stream event wait ------------------------------------------------------
+* free stream event wait
+* args   : strevt_t *evt    IO  stream event wait
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void strevtfree(strevt_t *evt)
+{
+    tracet(3,"strevtfree:\n");
+    
+#ifdef __linux__
+    if (evt->fd>=0) close(evt->fd);
+#endif
+    evt->fd=-1;
+    evt->n=0;
+}
+/* wait for input stream data --------------------------------------------------
+* wait until any of input streams has data to read or timeout
+* args   : strevt_t *evt    IO  stream event wait
+*          stream_t *stream I   streams
+*          int    n         I   number of streams
+*          int    timeout   I   timeout (ms)
+* return : number of ready descriptors (0:timeout or not supported)
+* notes  : streams without descriptors (file, ftp, http) are polled by the
+*          caller after the timeout. if not supported, sleep for timeout.
+*          a descriptor is registered to epoll once when the stream opens or
+*          a socket is connected, and unregistered when it is closed.
+*-----------------------------------------------------------------------------*/
+extern int strevtwait(strevt_t *evt, stream_t *stream, int n, int timeout)
+{
+#ifdef __linux__
+    struct epoll_event ev={0},evs[MAXSTREVT];
+    uint32_t gens[MAXSTREVT];
+    int i,j,nfd=0,fds[MAXSTREVT];
+    
+    tracet(4,"strevtwait: n=%d timeout=%d\n",n,timeout);
+    
+    if (evt->fd<0) {
+        sleepms(timeout);
+        return 0;
+    }
+    for (i=0;i<n;i++) {
+        if (!(stream[i].mode&STR_MODE_R)||!stream[i].port) continue;
+        strlock(stream+i);
+        nfd+=strfds(stream+i,fds+nfd,gens+nfd,MAXSTREVT-nfd);
+        strunlock(stream+i);
+    }
+    /* unregister descriptors closed or replaced by new sockets */
+    for (i=0;i<evt->n;i++) {
+        for (j=0;j<nfd;j++) {
+            if (fds[j]==evt->fds[i]&&gens[j]==evt->gens[i]) break;
+        }
+        if (j<nfd) continue;
+        epoll_ctl(evt->fd,EPOLL_CTL_DEL,evt->fds[i],&ev); /* may be closed */
+    }
+    /* register descriptors opened or connected since the last call */
+    for (i=0;i<nfd;i++) {
+        for (j=0;j<evt->n;j++) {
+            if (evt->fds[j]==fds[i]&&evt->gens[j]==gens[i]) break;
+        }
+        if (j<evt->n) continue;
+        ev.events=EPOLLIN;
+        ev.data.fd=fds[i];
+        if (epoll_ctl(evt->fd,EPOLL_CTL_ADD,fds[i],&ev)<0) {
+            tracet(2,"strevtwait: epoll_ctl error fd=%d errno=%d\n",fds[i],
+                   errno);
+        }
+    }
+    memcpy(evt->fds,fds,sizeof(int)*nfd);
+    memcpy(evt->gens,gens,sizeof(uint32_t)*nfd);
+    evt->n=nfd;
+    
+    if ((n=epoll_wait(evt->fd,evs,MAXSTREVT,timeout>0?timeout:0))<0) {
+        return 0; /* interrupted */
+    }
+    return n;
+#else
+    sleepms(timeout);
+    return 0;
+#endif
+}
 /* set global stream options ---------------------------------------------------
 * set global stream options
 * args   : int    *opt      I   options
@@ -3166,6 +3649,20 @@ extern void strsetproxy(const char *addr)
     
     strcpy(proxyaddr,addr);
 }
+/* set max number of clients ---------------------------------------------------
+* set max number of clients of tcp server and ntrip caster opened after
+* args   : int    n         I   max number of clients (0: default)
+* return : none
+* notes  : output data to a client is queued up to the receive/send buffer size
+*          while the client can not receive. the client is disconnected if the
+*          queue overflows or does not progress in the inactive timeout.
+*-----------------------------------------------------------------------------*/
+extern void strsetmaxcli(int n)
+{
+    tracet(3,"strsetmaxcli: n=%d\n",n);
+    
+    maxcli=n<=0?MAXCLI:n;
+}
 /* get stream time -------------------------------------------------------------
 * get stream time
 * args   : stream_t *stream I   stream
@@ -3290,3 +3787,201 @@ extern void strsendcmd(stream_t *str, const char *cmd)
         if (*q=='\0') break; else p=q+1;
     }
 }
+/* disconnect http server client --------------------------------------------*/
+static void discon_http(httpsvr_t *svr, int i)
+{
+    httpcon_t *con=(httpcon_t *)svr->con+i;
+    
+    tracet(3,"discon_http: i=%d\n",i);
+    
+    discli((tcpsvr_t *)svr->tcp,i);
+    free(con->buff);
+    con->buff=NULL;
+    con->nb=con->state=0;
+}
+/* open http server ------------------------------------------------------------
+* open http server to respond GET requests of clients
+* args   : httpsvr_t *svr   O   http server
+*          char   *path     I   server path ([addr]:port)
+*          char   *msg      O   error message
+* return : status (1:ok,0:error)
+* notes  : the number of clients is limited by strsetmaxcli(). the server is
+*          not thread-safe. call httpsvrreq() and httpsvrrsp() from one thread
+*-----------------------------------------------------------------------------*/
+extern int httpsvropen(httpsvr_t *svr, const char *path, char *msg)
+{
+    tcpsvr_t *tcp;
+    
+    tracet(3,"httpsvropen: path=%s\n",path);
+    
+    svr->state=0;
+    svr->nreq=0;
+    svr->msg[0]='\0';
+    if (!(tcp=opentcpsvr(path,msg))) return 0;
+    
+    if (!(svr->con=calloc(tcp->maxcli,sizeof(httpcon_t)))) {
+        closetcpsvr(tcp);
+        sprintf(msg,"memory allocation error");
+        return 0;
+    }
+    svr->tcp=tcp;
+    svr->state=tcp->svr.state;
+    return 1;
+}
+/* close http server -----------------------------------------------------------
+* close http server and disconnect all clients
+* args   : httpsvr_t *svr   IO  http server
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void httpsvrclose(httpsvr_t *svr)
+{
+    tcpsvr_t *tcp=(tcpsvr_t *)svr->tcp;
+    int i;
+    
+    tracet(3,"httpsvrclose:\n");
+    
+    if (!tcp) return;
+    
+    for (i=0;i<tcp->maxcli;i++) free(((httpcon_t *)svr->con)[i].buff);
+    closetcpsvr(tcp);
+    free(svr->con);
+    svr->tcp=svr->con=NULL;
+    svr->state=0;
+}
+/* get http request ------------------------------------------------------------
+* accept clients and get next complete GET request of http server
+* args   : httpsvr_t *svr   IO  http server
+*          char   *url      O   request url (path and query) (256 bytes)
+* return : client index of request (-1: no request)
+* notes  : respond to the request by httpsvrrsp(). the client is disconnected
+*          after the response is sent. call the function periodically until
+*          it returns -1 to serve all clients
+*-----------------------------------------------------------------------------*/
+extern int httpsvrreq(httpsvr_t *svr, char *url)
+{
+    tcpsvr_t *tcp=(tcpsvr_t *)svr->tcp;
+    httpcon_t *con;
+    char method[16],proto[16],buff[256];
+    int i,j,n,err;
+    
+    tracet(4,"httpsvrreq:\n");
+    
+    if (!tcp) return -1;
+    
+    /* disconnect clients with response sent */
+    for (j=0;j<tcp->ncli;j++) {
+        i=tcp->act[j];
+        if (!((httpcon_t *)svr->con)[i].state) continue;
+        if (flushcli(tcp,i)&&tcp->que[i].n>0&&
+            (toinact<=0||(int)(tickget()-tcp->cli[i].tact)<toinact)) continue;
+        discon_http(svr,i);
+        j--;
+    }
+    n=waittcpsvr(tcp,svr->msg);
+    svr->state=tcp->svr.state;
+    if (!n) return -1;
+    
+    for (j=0;j<tcp->nrdy;j++) {
+        i=tcp->rdy[j];
+        con=(httpcon_t *)svr->con+i;
+        
+        if (con->state) { /* discard data after request */
+            if (recv_nb(tcp->cli[i].sock,(uint8_t *)buff,sizeof(buff),&err)==-1) {
+                discon_http(svr,i);
+                j--;
+            }
+            continue;
+        }
+        if (!con->buff&&!(con->buff=(char *)malloc(HTTP_MAXREQ))) {
+            discon_http(svr,i);
+            j--;
+            continue;
+        }
+        /* receive http request */
+        if ((n=recv_nb(tcp->cli[i].sock,(uint8_t *)con->buff+con->nb,
+                       HTTP_MAXREQ-con->nb-1,&err))==-1) {
+            if (err) {
+                tracet(2,"httpsvrreq: recv error sock=%d err=%d\n",
+                       tcp->cli[i].sock,err);
+            }
+            discon_http(svr,i);
+            j--;
+            continue;
+        }
+        if (n<=0) continue;
+        
+        tcp->cli[i].tact=tickget();
+        con->nb+=n;
+        con->buff[con->nb]='\0';
+        
+        if (!strstr(con->buff,"\r\n\r\n")&&!strstr(con->buff,"\n\n")) {
+            if (con->nb>=HTTP_MAXREQ-1) { /* buffer overflow */
+                tracet(2,"httpsvrreq: request buffer overflow\n");
+                httpsvrrsp(svr,i,400,"text/plain","",0);
+                if (tcp->cli[i].state!=2) j--; /* disconnected by response */
+            }
+            continue;
+        }
+        tracet(5,"httpsvrreq: i=%d request=\n%s\n",i,con->buff);
+        
+        if (sscanf(con->buff,"%15s %255s %15s",method,url,proto)<3||
+            strncmp(proto,"HTTP/1.",7)) {
+            tracet(2,"httpsvrreq: http request error\n");
+            httpsvrrsp(svr,i,400,"text/plain","",0);
+            if (tcp->cli[i].state!=2) j--;
+            continue;
+        }
+        if (strcmp(method,"GET")) {
+            tracet(2,"httpsvrreq: unsupported method=%s\n",method);
+            httpsvrrsp(svr,i,405,"text/plain","",0);
+            if (tcp->cli[i].state!=2) j--;
+            continue;
+        }
+        return i;
+    }
+    return -1;
+}
+/* send http response ----------------------------------------------------------
+* send response to a client request of http server
+* args   : httpsvr_t *svr   IO  http server
+*          int    i         I   client index by httpsvrreq()
+*          int    code      I   http status code (200,400,404,...)
+*          char   *type     I   content type
+*          char   *body     I   response body
+*          int    n         I   size of response body (bytes)
+* return : none
+* notes  : the response is queued for the client up to the receive/send buffer
+*          size and the client is disconnected after the response is sent
+*-----------------------------------------------------------------------------*/
+extern void httpsvrrsp(httpsvr_t *svr, int i, int code, const char *type,
+                       const char *body, int n)
+{
+    tcpsvr_t *tcp=(tcpsvr_t *)svr->tcp;
+    httpcon_t *con=(httpcon_t *)svr->con+i;
+    const char *stat=code==200?"OK":(code==400?"Bad Request":
+                     (code==404?"Not Found":(code==405?"Method Not Allowed":
+                     "Internal Server Error")));
+    char buff[512],*p=buff;
+    
+    tracet(3,"httpsvrrsp: i=%d code=%d n=%d\n",i,code,n);
+    
+    if (!tcp||i<0||i>=tcp->maxcli||tcp->cli[i].state!=2||con->state) return;
+    
+    p+=sprintf(p,"HTTP/1.1 %d %s\r\n",code,stat);
+    p+=sprintf(p,"Server: %s %s %s\r\n","RTKLIB",VER_RTKLIB,PATCH_LEVEL);
+    p+=sprintf(p,"Connection: close\r\n");
+    p+=sprintf(p,"Content-Type: %.64s\r\n",type);
+    p+=sprintf(p,"Content-Length: %d\r\n\r\n",n);
+    
+    con->state=1;
+    free(con->buff); /* request buffer no more needed */
+    con->buff=NULL;
+    con->nb=0;
+    
+    if (!sendcli(tcp,i,(uint8_t *)buff,(int)(p-buff))||
+        (n>0&&!sendcli(tcp,i,(uint8_t *)body,n))) {
+        discon_http(svr,i);
+        return;
+    }
+    svr->nreq++;
+}
@@ -31,10 +31,30 @@
 *                           support multiple ephemeris sets (e.g. I/NAV-F/NAV)
 *                           delete API strsvrsetsrctbl()
 *                           use integer types in stdint.h
+*           2026/10/18 1.16 support event-driven wait of input streams
+*                           decode input once for stream converters with same
+*                           input format and encode once for same messages
+*                           add writer threads with queues for output streams
+*                           read back output streams in writer threads
+*                           wait writer threads on condition of output queue
+*                           change api strsvrstat()
+*                           input stream data by buffer in strconv()
 *-----------------------------------------------------------------------------*/
 #define _POSIX_C_SOURCE 200112L
 #include "rtklib.h"
 
+#define MINQSIZE    32768       /* min size of output queue (bytes) */
+#define QWAIT       10          /* max wait of writer thread (ms) */
+
+/* load/store pointer of output queue shared between threads -----------------*/
+#ifdef __GNUC__
+#define LOAD_ACQ(p)     __atomic_load_n(p,__ATOMIC_ACQUIRE)
+#define STORE_REL(p,v)  __atomic_store_n(p,v,__ATOMIC_RELEASE)
+#else
+#define LOAD_ACQ(p)     (*(volatile uint32_t *)(p))
+#define STORE_REL(p,v)  (*(volatile uint32_t *)(p)=(v))
+#endif
+
 /* test observation data message ---------------------------------------------*/
 static int is_obsmsg(int msg)
 {
@@ -61,6 +81,208 @@ static int is_tint(gtime_t time, double tint)
     if (tint<=0.0) return 1;
     return fmod(time2gpst(time,NULL)+DTTOL,tint)<=2.0*DTTOL;
 }
+/* put/get data to/from ring buffer of output queue -------------------------*/
+static void ringput(strque_t *q, uint32_t p, const uint8_t *data, uint32_t n)
+{
+    uint32_t i=p&(q->size-1),m=q->size-i;
+    
+    if (n<=m) {
+        memcpy(q->buff+i,data,n);
+    }
+    else {
+        memcpy(q->buff+i,data,m);
+        memcpy(q->buff,data+m,n-m);
+    }
+}
+static void ringget(const strque_t *q, uint32_t p, uint8_t *data, uint32_t n)
+{
+    uint32_t i=p&(q->size-1),m=q->size-i;
+    
+    if (n<=m) {
+        memcpy(data,q->buff+i,n);
+    }
+    else {
+        memcpy(data,q->buff+i,m);
+        memcpy(data+m,q->buff,n-m);
+    }
+}
+/* put data to output queue --------------------------------------------------*/
+static int strqput(strque_t *q, const uint8_t *buff, uint32_t n, uint32_t tick)
+{
+    uint32_t hdr[2],wp=q->wp,rp=LOAD_ACQ(&q->rp);
+    
+    if (q->size-(wp-rp)<n+sizeof(hdr)) return 0;
+    
+    hdr[0]=n; hdr[1]=tick; /* data length and enqueue tick */
+    ringput(q,wp,(uint8_t *)hdr,sizeof(hdr));
+    ringput(q,wp+sizeof(hdr),buff,n);
+    STORE_REL(&q->wp,wp+(uint32_t)sizeof(hdr)+n);
+    return 1;
+}
+/* read message from output stream and relay back to input stream ------------*/
+static void readback(stream_t *stream, stream_t *strin, stream_t *strlog)
+{
+    uint8_t buff[1024];
+    int n;
+    
+    if (!(stream->mode&STR_MODE_R)) return;
+    
+    /* read message from output stream if connected */
+    while (strstat(stream,NULL)>=2&&(n=strread(stream,buff,sizeof(buff)))>0) {
+        
+        /* relay back message from output stream to input stream */
+        if (strin) strwrite(strin,buff,n);
+        
+        /* write data to log stream */
+        strwrite(strlog,buff,n);
+    }
+}
+/* output queue writer thread ------------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI strqthread(void *arg)
+#else
+static void *strqthread(void *arg)
+#endif
+{
+    strque_t *q=(strque_t *)arg;
+    uint32_t hdr[2],rp,wp;
+    int lat,stop;
+    
+    tracet(3,"strqthread:\n");
+    
+    for (;;) {
+        /* read back output stream in writer not to block server thread */
+        readback(q->stream,q->strin,q->strlog);
+        
+        rp=q->rp;
+        wp=LOAD_ACQ(&q->wp);
+        
+        if (rp==wp) { /* write all queued data before stop */
+            rtklib_lock(&q->lock);
+            if (q->state&&LOAD_ACQ(&q->wp)==rp) {
+                condwaitms(&q->cond,&q->lock,QWAIT);
+            }
+            stop=!q->state&&LOAD_ACQ(&q->wp)==rp;
+            rtklib_unlock(&q->lock);
+            if (stop) break;
+            continue;
+        }
+        ringget(q,rp,(uint8_t *)hdr,sizeof(hdr));
+        ringget(q,rp+sizeof(hdr),q->wbuf,hdr[0]);
+        STORE_REL(&q->rp,rp+(uint32_t)sizeof(hdr)+hdr[0]);
+        
+        strwrite(q->stream,q->wbuf,(int)hdr[0]);
+        
+        lat=(int)(tickget()-hdr[1]);
+        rtklib_lock(&q->lock);
+        q->lat=q->lat*0.9+lat*0.1;
+        rtklib_condsignal(&q->cond); /* wake up writer waiting for queue */
+        rtklib_unlock(&q->lock);
+    }
+    return 0;
+}
+/* start writer threads of output queues -------------------------------------*/
+static void strqstart(strsvr_t *svr)
+{
+    strque_t *q;
+    uint32_t size;
+    int i;
+    
+    for (i=1;i<svr->nstr;i++) {
+        q=svr->que+i;
+        q->buff=q->wbuf=NULL;
+        q->wp=q->rp=q->drop=0;
+        q->lat=0.0;
+        q->stream=svr->stream+i;
+        q->strin=i==svr->relayback?svr->stream:NULL;
+        q->strlog=svr->strlog+i;
+        q->state=0;
+        if (svr->qsize<=0) continue;
+        
+        for (size=MINQSIZE;size<(uint32_t)svr->qsize&&size<0x40000000;size*=2) ;
+        
+        if (!(q->buff=(uint8_t *)malloc(size))||
+            !(q->wbuf=(uint8_t *)malloc(size/4))) {
+            free(q->buff); q->buff=NULL;
+            continue;
+        }
+        q->size=size;
+        q->state=1;
+        rtklib_initlock(&q->lock);
+        rtklib_initcond(&q->cond);
+#ifdef WIN32
+        if (!(q->thread=CreateThread(NULL,0,strqthread,q,0,NULL))) {
+#else
+        if (pthread_create(&q->thread,NULL,strqthread,q)) {
+#endif
+            tracet(2,"strqstart: writer thread error i=%d\n",i);
+            rtklib_freecond(&q->cond);
+            rtklib_freelock(&q->lock);
+            free(q->buff); free(q->wbuf);
+            q->buff=q->wbuf=NULL;
+            q->state=0;
+        }
+    }
+}
+/* stop writer threads of output queues --------------------------------------*/
+static void strqstop(strsvr_t *svr)
+{
+    strque_t *q;
+    int i;
+    
+    for (i=1;i<svr->nstr;i++) {
+        q=svr->que+i;
+        if (!q->buff) continue;
+        rtklib_lock(&q->lock);
+        q->state=0;
+        rtklib_condsignal(&q->cond);
+        rtklib_unlock(&q->lock);
+#ifdef WIN32
+        WaitForSingleObject(q->thread,10000);
+        CloseHandle(q->thread);
+#else
+        pthread_join(q->thread,NULL);
+#endif
+        rtklib_freecond(&q->cond);
+        rtklib_freelock(&q->lock);
+        free(q->buff); free(q->wbuf);
+        q->buff=q->wbuf=NULL;
+    }
+}
+/* write data to output stream via output queue ------------------------------*/
+static void strqwrite(strsvr_t *svr, int i, uint8_t *buff, int n)
+{
+    strque_t *q=svr->que+i;
+    uint32_t tick=tickget();
+    int m;
+    
+    if (!q->buff) {
+        strwrite(svr->stream+i,buff,n);
+        return;
+    }
+    for (;n>0;buff+=m,n-=m) {
+        m=n<(int)q->size/4?n:(int)q->size/4;
+        
+        while (!strqput(q,buff,m,tick)) {
+            
+            /* drop data or wait for writer on queue full */
+            if (!svr->qblock||!svr->state) {
+                tracet(3,"strqwrite: queue full drop i=%d n=%d\n",i,m);
+                q->drop+=m;
+                break;
+            }
+            rtklib_lock(&q->lock);
+            rtklib_condsignal(&q->cond);
+            if (q->size-(q->wp-LOAD_ACQ(&q->rp))<m+2*sizeof(uint32_t)) {
+                condwaitms(&q->cond,&q->lock,QWAIT);
+            }
+            rtklib_unlock(&q->lock);
+        }
+    }
+    rtklib_lock(&q->lock);
+    rtklib_condsignal(&q->cond); /* wake up writer thread */
+    rtklib_unlock(&q->lock);
+}
 /* new stream converter --------------------------------------------------------
 * generate new stream converter
 * args   : int    itype     I   input stream type  (STRFMT_???)
@@ -221,8 +443,82 @@ static void rtcm2rtcm(rtcm_t *out, const rtcm_t *rtcm, int ret, int stasel)
         if (!stasel) out->sta=rtcm->sta;
     }
 }
+/* test same station info ---------------------------------------------------*/
+static int is_samesta(const sta_t *a, const sta_t *b)
+{
+    int i;
+    
+    if (strcmp(a->name,b->name)||strcmp(a->markerno,b->markerno)||
+        strcmp(a->antdes,b->antdes)||strcmp(a->antsno,b->antsno)||
+        strcmp(a->rectype,b->rectype)||strcmp(a->recver,b->recver)||
+        strcmp(a->recsno,b->recsno)||a->antsetup!=b->antsetup||
+        a->itrf!=b->itrf||a->deltype!=b->deltype||a->hgt!=b->hgt||
+        a->glo_cp_align!=b->glo_cp_align) return 0;
+    
+    for (i=0;i<3;i++) {
+        if (a->pos[i]!=b->pos[i]||a->del[i]!=b->del[i]) return 0;
+    }
+    for (i=0;i<4;i++) {
+        if (a->glo_cp_bias[i]!=b->glo_cp_bias[i]) return 0;
+    }
+    return 1;
+}
+/* test same output messages of stream converters ----------------------------*/
+static int is_sameout(const strconv_t *a, const strconv_t *b)
+{
+    int i;
+    
+    if (a->otype!=b->otype||a->stasel!=b->stasel||a->out.nmsg!=b->out.nmsg||
+        (a->stasel&&a->out.staid!=b->out.staid)||
+        (a->stasel&&!is_samesta(&a->out.sta,&b->out.sta))) return 0;
+    
+    for (i=0;i<a->out.nmsg;i++) {
+        if (a->out.msgs[i]!=b->out.msgs[i]||a->out.tint[i]!=b->out.tint[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+/* share input decoders and output encoders among stream converters ----------*/
+static void share_conv(strsvr_t *svr)
+{
+    strconv_t *ci,*cj;
+    int i,j;
+    
+    for (i=0;i<svr->nstr-1;i++) {
+        svr->convdec[i]=svr->convenc[i]=i;
+        if (!(ci=svr->conv[i])) continue;
+        
+        /* decode same input format and options once */
+        for (j=0;j<i;j++) {
+            if (!(cj=svr->conv[j])||svr->convdec[j]!=j) continue;
+            if (ci->itype!=cj->itype||strcmp(ci->rtcm.opt,cj->rtcm.opt)) continue;
+            svr->convdec[i]=j;
+            break;
+        }
+        /* encode same output messages once */
+        for (j=0;j<i;j++) {
+            if (!(cj=svr->conv[j])||svr->convenc[j]!=j||
+                svr->convdec[j]!=svr->convdec[i]||!is_sameout(ci,cj)) continue;
+            svr->convenc[i]=j;
+            break;
+        }
+        tracet(3,"share_conv: conv=%d dec=%d enc=%d\n",i,svr->convdec[i],
+               svr->convenc[i]);
+    }
+}
+/* write messages to output streams sharing encoder --------------------------*/
+static void write_out(strsvr_t *svr, int k, uint8_t *buff, int n)
+{
+    int i;
+    
+    for (i=k;i<svr->nstr-1;i++) {
+        if (svr->conv[i]&&svr->convenc[i]==k) strqwrite(svr,i+1,buff,n);
+    }
+}
 /* write rtcm3 msm to stream -------------------------------------------------*/
-static void write_rtcm3_msm(stream_t *str, rtcm_t *out, int msg, int sync)
+static void write_rtcm3_msm(strsvr_t *svr, int k, rtcm_t *out, int msg,
+                            int sync)
 {
     obsd_t *data,buff[MAXOBS];
     int i,j,n,ns,sys,nobs,code,nsat=0,nsig=0,nmsg,mask[MAXCODE]={0};
@@ -270,15 +566,16 @@ static void write_rtcm3_msm(stream_t *str, rtcm_t *out, int msg, int sync)
         out->obs.n=n;
         
         if (gen_rtcm3(out,msg,0,i<nmsg-1?1:sync)) {
-            strwrite(str,out->buff,out->nbyte);
+            write_out(svr,k,out->buff,out->nbyte);
         }
     }
     out->obs.data=data;
     out->obs.n=nobs;
 }
 /* write obs data messages ---------------------------------------------------*/
-static void write_obs(gtime_t time, stream_t *str, strconv_t *conv)
+static void write_obs(gtime_t time, strsvr_t *svr, int k)
 {
+    strconv_t *conv=svr->conv[k];
     int i,j=0;
     
     for (i=0;i<conv->out.nmsg;i++) {
@@ -294,23 +591,24 @@ static void write_obs(gtime_t time, stream_t *str, strconv_t *conv)
             if (!gen_rtcm2(&conv->out,conv->out.msgs[i],i!=j)) continue;
             
             /* write messages to stream */
-            strwrite(str,conv->out.buff,conv->out.nbyte);
+            write_out(svr,k,conv->out.buff,conv->out.nbyte);
         }
         else if (conv->otype==STRFMT_RTCM3) {
             if (conv->out.msgs[i]<=1012) {
                 if (!gen_rtcm3(&conv->out,conv->out.msgs[i],0,i!=j)) continue;
-                strwrite(str,conv->out.buff,conv->out.nbyte);
+                write_out(svr,k,conv->out.buff,conv->out.nbyte);
             }
             else { /* write rtcm3 msm to stream */
-                write_rtcm3_msm(str,&conv->out,conv->out.msgs[i],i!=j);
+                write_rtcm3_msm(svr,k,&conv->out,conv->out.msgs[i],i!=j);
             }
         }
     }
 }
 /* write nav data messages ---------------------------------------------------*/
-static void write_nav(gtime_t time, stream_t *str, strconv_t *conv)
+static void write_nav(gtime_t time, strsvr_t *svr, int k)
 {
     (void)time;
+    strconv_t *conv=svr->conv[k];
     int i;
     
     for (i=0;i<conv->out.nmsg;i++) {
@@ -326,7 +624,7 @@ static void write_nav(gtime_t time, stream_t *str, strconv_t *conv)
         else continue;
         
         /* write messages to stream */
-        strwrite(str,conv->out.buff,conv->out.nbyte);
+        write_out(svr,k,conv->out.buff,conv->out.nbyte);
     }
 }
 /* next ephemeris satellite --------------------------------------------------*/
@@ -362,8 +660,9 @@ static int nextsat(nav_t *nav, int sat, int msg)
     return 0;
 }
 /* write cyclic nav data messages --------------------------------------------*/
-static void write_nav_cycle(stream_t *str, strconv_t *conv)
+static void write_nav_cycle(strsvr_t *svr, int k)
 {
+    strconv_t *conv=svr->conv[k];
     uint32_t tick=tickget();
     int i,sat,tint;
     
@@ -391,12 +690,13 @@ static void write_nav_cycle(stream_t *str, strconv_t *conv)
         else continue;
         
         /* write messages to stream */
-        strwrite(str,conv->out.buff,conv->out.nbyte);
+        write_out(svr,k,conv->out.buff,conv->out.nbyte);
     }
 }
 /* write cyclic station info messages ----------------------------------------*/
-static void write_sta_cycle(stream_t *str, strconv_t *conv)
+static void write_sta_cycle(strsvr_t *svr, int k)
 {
+    strconv_t *conv=svr->conv[k];
     uint32_t tick=tickget();
     int i,tint;
 
@@ -418,40 +718,58 @@ static void write_sta_cycle(stream_t *str, strconv_t *conv)
         else continue;
         
         /* write messages to stream */
-        strwrite(str,conv->out.buff,conv->out.nbyte);
+        write_out(svr,k,conv->out.buff,conv->out.nbyte);
     }
 }
 /* convert stearm ------------------------------------------------------------*/
-static void strconv(stream_t *str, strconv_t *conv, uint8_t *buff, int n)
+static void strconv(strsvr_t *svr, uint8_t *buff, int n)
 {
-    int i,ret;
+    strconv_t *dec,*conv;
+    int i,j,k,m,ret;
     
-    for (i=0;i<n;i++) {
+    for (k=0;k<svr->nstr-1;k++) {
+        if (!(dec=svr->conv[k])||svr->convdec[k]!=k) continue;
         
-        /* input rtcm 2 messages */
-        if (conv->itype==STRFMT_RTCM2) {
-            ret=input_rtcm2(&conv->rtcm,buff[i]);
-            rtcm2rtcm(&conv->out,&conv->rtcm,ret,conv->stasel);
-        }
-        /* input rtcm 3 messages */
-        else if (conv->itype==STRFMT_RTCM3) {
-            ret=input_rtcm3(&conv->rtcm,buff[i]);
-            rtcm2rtcm(&conv->out,&conv->rtcm,ret,conv->stasel);
-        }
-        /* input receiver raw messages */
-        else {
-            ret=input_raw(&conv->raw,conv->itype,buff[i]);
-            raw2rtcm(&conv->out,&conv->raw,ret);
-        }
-        /* write obs and nav data messages to stream */
-        switch (ret) {
-            case 1: write_obs(conv->out.time,str,conv); break;
-            case 2: write_nav(conv->out.time,str,conv); break;
+        for (i=0;i<n;i+=m) {
+            
+            /* input rtcm 2 messages */
+            if (dec->itype==STRFMT_RTCM2) {
+                ret=input_rtcm2(&dec->rtcm,buff[i]);
+                m=1;
+            }
+            /* input rtcm 3 messages */
+            else if (dec->itype==STRFMT_RTCM3) {
+                m=input_rtcm3b(&dec->rtcm,buff+i,n-i,&ret);
+            }
+            /* input receiver raw messages */
+            else {
+                m=input_rawb(&dec->raw,dec->itype,buff+i,n-i,&ret);
+            }
+            /* copy decoded data to converters sharing the decoder */
+            for (j=0;j<svr->nstr-1;j++) {
+                if (!(conv=svr->conv[j])||svr->convdec[j]!=k||
+                    svr->convenc[j]!=j) continue;
+                
+                if (dec->itype==STRFMT_RTCM2||dec->itype==STRFMT_RTCM3) {
+                    rtcm2rtcm(&conv->out,&dec->rtcm,ret,conv->stasel);
+                }
+                else {
+                    raw2rtcm(&conv->out,&dec->raw,ret);
+                }
+                /* write obs and nav data messages to streams */
+                switch (ret) {
+                    case 1: write_obs(conv->out.time,svr,j); break;
+                    case 2: write_nav(conv->out.time,svr,j); break;
+                }
+            }
         }
     }
-    /* write cyclic nav data and station info messages to stream */
-    write_nav_cycle(str,conv);
-    write_sta_cycle(str,conv);
+    /* write cyclic nav data and station info messages to streams */
+    for (j=0;j<svr->nstr-1;j++) {
+        if (!svr->conv[j]||svr->convenc[j]!=j) continue;
+        write_nav_cycle(svr,j);
+        write_sta_cycle(svr,j);
+    }
 }
 /* periodic command ----------------------------------------------------------*/
 static void periodic_cmd(int cycle, const char *cmd, stream_t *stream)
@@ -490,17 +808,22 @@ static void *strsvrthread(void *arg)
 #endif
 {
     strsvr_t *svr=(strsvr_t *)arg;
+    strevt_t evt;
     sol_t sol_nmea={{0}};
     uint32_t tick,tick_nmea;
-    uint8_t buff[1024];
-    int i,n,cyc;
+    int i,n,cyc,ncmd;
     
     tracet(3,"strsvrthread:\n");
     
     svr->tick=tickget();
     tick_nmea=svr->tick-1000;
     
-    for (cyc=0;svr->state;cyc++) {
+    if (svr->evtwait&&!strevtinit(&evt)) {
+        tracet(2,"strsvrthread: event wait not supported\n");
+    }
+    strqstart(svr);
+    
+    for (cyc=ncmd=0;svr->state;) {
         tick=tickget();
         
         /* read data from input stream */
@@ -508,13 +831,10 @@ static void *strsvrthread(void *arg)
             
             /* write data to output streams */
             for (i=1;i<svr->nstr;i++) {
-                if (svr->conv[i-1]) {
-                    strconv(svr->stream+i,svr->conv[i-1],svr->buff,n);
-                }
-                else {
-                    strwrite(svr->stream+i,svr->buff,n);
-                }
+                if (!svr->conv[i-1]) strqwrite(svr,i,svr->buff,n);
             }
+            /* convert data to output streams with converter */
+            strconv(svr,svr->buff,n);
             /* write data to log stream */
             strwrite(svr->strlog,svr->buff,n);
             
@@ -526,20 +846,15 @@ static void *strsvrthread(void *arg)
         }
         for (i=1;i<svr->nstr;i++) {
             
-            /* read message from output stream if connected */
-            while (strstat(svr->stream+i,NULL)>=2 &&
-                  (n=strread(svr->stream+i,buff,sizeof(buff)))>0) {
-                /* relay back message from output stream to input stream */
-                if (i==svr->relayback) {
-                    strwrite(svr->stream,buff,n);
-                }
-                /* write data to log stream */
-                strwrite(svr->strlog+i,buff,n);
-            }
+            /* output stream with writer thread is read back by the writer */
+            if (svr->que[i].buff) continue;
+            
+            readback(svr->stream+i,i==svr->relayback?svr->stream:NULL,
+                     svr->strlog+i);
         }
         /* write periodic command to input stream */
-        for (i=0;i<svr->nstr;i++) {
-            periodic_cmd(cyc*svr->cycle,svr->cmds_periodic[i],svr->stream+i);
+        for (;ncmd<=cyc;ncmd++) for (i=0;i<svr->nstr;i++) {
+            periodic_cmd(ncmd*svr->cycle,svr->cmds_periodic[i],svr->stream+i);
         }
         /* write nmea messages to input stream */
         if (svr->nmeacycle>0&&(int)(tick-tick_nmea)>=svr->nmeacycle) {
@@ -550,8 +865,20 @@ static void *strsvrthread(void *arg)
             strsendnmea(svr->stream,&sol_nmea);
             tick_nmea=tick;
         }
-        sleepms(svr->cycle-(int)(tickget()-tick));
+        if (svr->evtwait) {
+            /* wait for input/output stream data until next cycle (outputs
+               with writer threads are not locked by server thread) */
+            strevtwait(&evt,svr->stream,svr->qsize>0?1:svr->nstr,
+                       svr->cycle-(int)(tickget()-tick));
+            cyc=svr->cycle>0?(int)(tickget()-svr->tick)/svr->cycle:cyc+1;
+        }
+        else {
+            sleepms(svr->cycle-(int)(tickget()-tick));
+            cyc++;
+        }
     }
+    if (svr->evtwait) strevtfree(&evt);
+    strqstop(svr);
     for (i=0;i<svr->nstr;i++) strclose(svr->stream+i);
     for (i=0;i<svr->nstr;i++) strclose(svr->strlog+i);
     svr->npb=0;
@@ -577,6 +904,8 @@ extern void strsvrinit(strsvr_t *svr, int nout)
     svr->buffsize=0;
     svr->nmeacycle=0;
     svr->relayback=0;
+    svr->evtwait=0;
+    svr->qsize=svr->qblock=0;
     svr->npb=0;
     for (i=0;i<16;i++) *svr->cmds_periodic[i]='\0';
     for (i=0;i<3;i++) svr->nmeapos[i]=0.0;
@@ -586,6 +915,7 @@ extern void strsvrinit(strsvr_t *svr, int nout)
     for (i=0;i<nout+1&&i<16;i++) strinit(svr->strlog+i);
     svr->nstr=i;
     for (i=0;i<16;i++) svr->conv[i]=NULL;
+    for (i=0;i<16;i++) svr->que[i].buff=svr->que[i].wbuf=NULL;
     svr->thread=0;
     rtklib_initlock(&svr->lock);
 }
@@ -664,6 +994,7 @@ extern int strsvrstart(strsvr_t *svr, int *opts, int *strs, const char **paths,
         strcpy(svr->cmds_periodic[i],!cmds_periodic[i]?"":cmds_periodic[i]);
     }
     for (i=0;i<svr->nstr-1;i++) svr->conv[i]=conv[i];
+    share_conv(svr);
     
     if (!(svr->buff=(uint8_t *)malloc(svr->buffsize))||
         !(svr->pbuf=(uint8_t *)malloc(svr->buffsize))) {
@@ -758,12 +1089,19 @@ extern void strsvrstop(strsvr_t *svr, const char **cmds)
 *          int    *log_stat O   log status
 *          int    *byte     O   bytes received/sent
 *          int    *bps      O   bitrate received/sent
+*          int    *qlen     O   queued data of output streams (bytes) (NULL: no)
+*          int    *qdrop    O   dropped data of output streams (bytes) (NULL: no)
+*          int    *qlat     O   average write latency of output streams (ms)
+*                               (NULL: no)
 *          char   *msg      O   messages
 * return : none
+* notes  : qlen, qdrop and qlat are 0 for input stream and output streams
+*          without writer thread (svr->qsize=0)
 *-----------------------------------------------------------------------------*/
 extern void strsvrstat(strsvr_t *svr, int *stat, int *log_stat, int *byte,
-                       int *bps, char *msg)
+                       int *bps, int *qlen, int *qdrop, int *qlat, char *msg)
 {
+    strque_t *q;
     char s[MAXSTRMSG]="",*p=msg;
     int i,bps_in;
     
@@ -779,6 +1117,18 @@ extern void strsvrstat(strsvr_t *svr, int *stat, int *log_stat, int *byte,
         stat[i]=strstat(svr->stream+i,s);
         if (*s) p+=sprintf(p,"(%d) %s ",i,s);
         log_stat[i]=strstat(svr->strlog+i,s);
+        
+        q=svr->que+i;
+        if (qlen ) qlen [i]=i>0&&q->buff?(int)(q->wp-q->rp):0;
+        if (qdrop) qdrop[i]=i>0&&q->buff?(int)q->drop:0;
+        if (qlat ) {
+            qlat[i]=0;
+            if (i>0&&q->buff) {
+                rtklib_lock(&q->lock);
+                qlat[i]=(int)(q->lat+0.5);
+                rtklib_unlock(&q->lock);
+            }
+        }
     }
 }
 /* peek input/output stream ----------------------------------------------------
@@ -15,6 +15,7 @@
 *           2013/01/25 1.1  fix bug on binary search
 *           2014/08/26 1.2  fix bug on tle_pos() to get tle by satid or desig
 *           2020/11/30 1.3  fix problem on duplicated names in a satellite
+*           2026/10/18 1.4  add api tle_index(), tle_pos_batch()
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -40,20 +41,24 @@
 #define QOMS2T      1.88027916E-9       /* = pow((QO-SO)*AE/XKMPER,4.0) */
 #define S           1.01222928          /* = AE*(1.0+SO/XKMPER) */
 
-static void SGP4_STR3(double tsince, const tled_t *data, double *rs)
+typedef struct {                /* SGP4 model parameters of TLE data */
+    double xnodeo,omegao,xmo,eo,xincl,bstar,xnodp,aodp,eta,c1,c4,c5;
+    double xmdot,omgdot,xnodot,omgcof,xmcof,xnodcf,t2cof,xlcof,aycof,delmo;
+    double sinmo,d2,d3,d4,t3cof,t4cof,t5cof,cosio,sinio,x3thm1,x1mth2,x7thm1;
+    int isimp;
+} sgp4_t;
+
+/* initialize SGP4 model parameters independent of time ----------------------*/
+static void SGP4_init(const tled_t *data, sgp4_t *p)
 {
-    double xnodeo,omegao,xmo,eo,xincl,xno,xndt2o,xndd6o,bstar;
+    double xnodeo,omegao,xmo,eo,xincl,xno,bstar;
     double a1,cosio,theta2,x3thm1,eosq,betao2,betao,del1,ao,delo,xnodp,aodp,s4;
     double qoms24,perige,pinvsq,tsi,eta,etasq,eeta,psisq,coef,coef1,c1,c2,c3,c4;
     double c5,sinio,a3ovk2,x1mth2,theta4,xmdot,x1m5th,omgdot,xhdot1,xnodot;
     double omgcof,xmcof,xnodcf,t2cof,xlcof,aycof,delmo,sinmo,x7thm1,c1sq,d2,d3;
-    double d4,t3cof,t4cof,t5cof,xmdf,omgadf,xnoddf,omega,xmp,tsq,xnode,delomg;
-    double delm,tcube,tfour,a,e,xl,beta,xn,axn,xll,aynl,xlt,ayn,capu,sinepw;
-    double cosepw,epw,ecose,esine,elsq,pl,r,rdot,rfdot,betal,cosu,sinu,u,sin2u;
-    double cos2u,rk,uk,xnodek,xinck,rdotk,rfdotk,sinuk,cosuk,sinik,cosik,sinnok;
-    double cosnok,xmx,xmy,ux,uy,uz,vx,vy,vz,x,y,z,xdot,ydot,zdot;
-    double temp,temp1,temp2,temp3,temp4,temp5,temp6,tempa,tempe,templ;
-    int i,isimp;
+    double d4,t3cof,t4cof,t5cof;
+    double temp,temp1,temp2,temp3;
+    int isimp;
 
     xnodeo=data->OMG*DE2RA;
     omegao=data->omg*DE2RA;
@@ -61,8 +66,6 @@ static void SGP4_STR3(double tsince, const tled_t *data, double *rs)
     xincl=data->inc*DE2RA;
     temp=TWOPI/XMNPDA/XMNPDA;
     xno=data->n*temp*XMNPDA;
-    xndt2o=data->ndot*temp;
-    xndd6o=data->nddot*temp/XMNPDA;
     bstar=data->bstar/AE;
     eo=data->ecc;
     /*
@@ -157,40 +160,60 @@ static void SGP4_STR3(double tsince, const tled_t *data, double *rs)
     else {
         d2=d3=d4=t3cof=t4cof=t5cof=0.0;
     }
+    p->xnodeo=xnodeo; p->omegao=omegao; p->xmo=xmo; p->eo=eo; p->xincl=xincl;
+    p->bstar=bstar; p->xnodp=xnodp; p->aodp=aodp; p->eta=eta; p->c1=c1;
+    p->c4=c4; p->c5=c5; p->xmdot=xmdot; p->omgdot=omgdot; p->xnodot=xnodot;
+    p->omgcof=omgcof; p->xmcof=xmcof; p->xnodcf=xnodcf; p->t2cof=t2cof;
+    p->xlcof=xlcof; p->aycof=aycof; p->delmo=delmo; p->sinmo=sinmo; p->d2=d2;
+    p->d3=d3; p->d4=d4; p->t3cof=t3cof; p->t4cof=t4cof; p->t5cof=t5cof;
+    p->cosio=cosio; p->sinio=sinio; p->x3thm1=x3thm1; p->x1mth2=x1mth2;
+    p->x7thm1=x7thm1; p->isimp=isimp;
+}
+/* propagate SGP4 model by time since epoch ----------------------------------*/
+static void SGP4_prop(double tsince, const sgp4_t *p, double *rs)
+{
+    double xmdf,omgadf,xnoddf,omega,xmp,tsq,xnode,delomg,delm,tcube,tfour,a,e;
+    double xl,beta,xn,axn,xll,aynl,xlt,ayn,capu,sinepw,cosepw,epw,ecose,esine;
+    double elsq,pl,r,rdot,rfdot,betal,cosu,sinu,u,sin2u,cos2u,rk,uk,xnodek;
+    double xinck,rdotk,rfdotk,sinuk,cosuk,sinik,cosik,sinnok,cosnok,xmx,xmy;
+    double ux,uy,uz,vx,vy,vz,x,y,z,xdot,ydot,zdot;
+    double temp,temp1,temp2,temp3,temp4,temp5,temp6,tempa,tempe,templ;
+    int i;
+
     /* update for secular gravity and atmospheric drag */
-    xmdf=xmo+xmdot*tsince;
-    omgadf=omegao+omgdot*tsince;
-    xnoddf=xnodeo+xnodot*tsince;
+    xmdf=p->xmo+p->xmdot*tsince;
+    omgadf=p->omegao+p->omgdot*tsince;
+    xnoddf=p->xnodeo+p->xnodot*tsince;
     omega=omgadf;
     xmp=xmdf;
     tsq=tsince*tsince;
-    xnode=xnoddf+xnodcf*tsq;
-    tempa=1.0-c1*tsince;
-    tempe=bstar*c4*tsince;
-    templ=t2cof*tsq;
-    if (isimp==1) {
-        delomg=omgcof*tsince;
-        delm=xmcof*(pow(1.0+eta*cos(xmdf),3.0)-delmo);
+    xnode=xnoddf+p->xnodcf*tsq;
+    tempa=1.0-p->c1*tsince;
+    tempe=p->bstar*p->c4*tsince;
+    templ=p->t2cof*tsq;
+    if (p->isimp==1) {
+        delomg=p->omgcof*tsince;
+        delm=p->xmcof*(pow(1.0+p->eta*cos(xmdf),3.0)-p->delmo);
         temp=delomg+delm;
         xmp=xmdf+temp;
         omega=omgadf-temp;
         tcube=tsq*tsince;
         tfour=tsince*tcube;
-        tempa=tempa-d2*tsq-d3*tcube-d4*tfour;
-        tempe=tempe+bstar*c5*(sin(xmp)-sinmo);
-        templ=templ+t3cof*tcube+tfour*(t4cof+tsince*t5cof);
+        tempa=tempa-p->d2*tsq-p->d3*tcube-p->d4*tfour;
+        tempe=tempe+p->bstar*p->c5*(sin(xmp)-p->sinmo);
+        templ=templ+p->t3cof*tcube+tfour*(p->t4cof+tsince*p->t5cof);
     }
-    a=aodp*pow(tempa,2.0);
-    e=eo-tempe;
-    xl=xmp+omega+xnode+xnodp*templ;
+    a=p->aodp*pow(tempa,2.0);
+    e=p->eo-tempe;
+    xl=xmp+omega+xnode+p->xnodp*templ;
     beta=sqrt(1.0-e*e);
     xn=XKE/pow(a,1.5);
 
     /* long period periodics */
     axn=e*cos(omega);
     temp=1.0/(a*beta*beta);
-    xll=temp*xlcof*axn;
-    aynl=temp*aycof;
+    xll=temp*p->xlcof*axn;
+    aynl=temp*p->aycof;
     xlt=xl+xll;
     ayn=e*sin(omega)+aynl;
 
@@ -231,12 +254,12 @@ static void SGP4_STR3(double tsince, const tled_t *data, double *rs)
     temp2=temp1*temp;
 
     /* update for short periodics */
-    rk=r*(1.0-1.5*temp2*betal*x3thm1)+0.5*temp1*x1mth2*cos2u;
-    uk=u-0.25*temp2*x7thm1*sin2u;
-    xnodek=xnode+1.5*temp2*cosio*sin2u;
-    xinck=xincl+1.5*temp2*cosio*sinio*cos2u;
-    rdotk=rdot-xn*temp1*x1mth2*sin2u;
-    rfdotk=rfdot+xn*temp1*(x1mth2*cos2u+1.5*x3thm1);
+    rk=r*(1.0-1.5*temp2*betal*p->x3thm1)+0.5*temp1*p->x1mth2*cos2u;
+    uk=u-0.25*temp2*p->x7thm1*sin2u;
+    xnodek=xnode+1.5*temp2*p->cosio*sin2u;
+    xinck=p->xincl+1.5*temp2*p->cosio*p->sinio*cos2u;
+    rdotk=rdot-xn*temp1*p->x1mth2*sin2u;
+    rfdotk=rfdot+xn*temp1*(p->x1mth2*cos2u+1.5*p->x3thm1);
 
     /* orientation vectors */
     sinuk=sin(uk);
@@ -269,6 +292,14 @@ static void SGP4_STR3(double tsince, const tled_t *data, double *rs)
     rs[4]=ydot*XKMPER/AE*XMNPDA/86400.0*1E3;
     rs[5]=zdot*XKMPER/AE*XMNPDA/86400.0*1E3;
 }
+/* SGP4 model propagation of TLE data ----------------------------------------*/
+static void SGP4_STR3(double tsince, const tled_t *data, double *rs)
+{
+    sgp4_t p;
+
+    SGP4_init(data,&p);
+    SGP4_prop(tsince,&p,rs);
+}
 /* drop spaces at string tail ------------------------------------------------*/
 static void chop(char *buff)
 {
@@ -500,26 +531,19 @@ extern int tle_name_read(const char *file, tle_t *tle)
     if (tle->n>0) qsort(tle->data,tle->n,sizeof(tled_t),cmp_tle_data);
     return 1;
 }
-/* satellite position and velocity with TLE data -------------------------------
-* compute satellite position and velocity in ECEF with TLE data
-* args   : gtime_t time     I   time (GPST)
-*          char   *name     I   satellite name           ("": not specified)
+/* search TLE data -------------------------------------------------------------
+* search TLE data of a satellite
+* args   : char   *name     I   satellite name           ("": not specified)
 *          char   *satno    I   satellite catalog number ("": not specified)
 *          char   *desig    I   international designator ("": not specified)
 *          tle_t  *tle      I   TLE data
-*          erp_t  *erp      I   EOP data (NULL: not used)
-*          double *rs       O   sat position/velocity {x,y,z,vx,vy,vz} (m,m/s)
-* return : status (1:ok,0:error)
-* notes  : the coordinates of the position and velocity are ECEF (ITRF)
-*          if erp == NULL, polar motion and ut1-utc are neglected
+* return : index of TLE data (-1: no TLE data)
+* notes  : satellite is searched by name (or alias if name is empty) first and
+*          then by catalog number or international designator
 *-----------------------------------------------------------------------------*/
-extern int tle_pos(gtime_t time, const char *name, const char *satno,
-                   const char *desig, const tle_t *tle, const erp_t *erp,
-                   double *rs)
+extern int tle_index(const char *name, const char *satno, const char *desig,
+                     const tle_t *tle)
 {
-    gtime_t tutc;
-    double tsince,rs_tle[6],rs_pef[6],gmst;
-    double R1[9]={0},R2[9]={0},R3[9]={0},W[9],erpv[5]={0};
     int i=0,stat=1;
 
     /* serial search by satellite name or alias if name is empty */
@@ -552,32 +576,133 @@ extern int tle_pos(gtime_t time, const char *name, const char *satno,
     }
     if (stat) {
         trace(4,"no tle data: name=%s satno=%s desig=%s\n",name,satno,desig);
-        return 0;
+        return -1;
     }
-    tutc=gpst2utc(time);
+    return i;
+}
+/* TEME to ECEF transformation matrices --------------------------------------*/
+static void teme2ecef(gtime_t time, const erp_t *erp, gtime_t *tutc,
+                      double *R3, double *W)
+{
+    double R1[9]={0},R2[9]={0},erpv[5]={0},gmst;
+    int i;
 
-    /* time since epoch (min) */
-    tsince=timediff(tutc,tle->data[i].epoch)/60.0;
-
-    /* SGP4 model propagator by STR#3 */
-    SGP4_STR3(tsince,tle->data+i,rs_tle);
+    *tutc=gpst2utc(time);
 
     /* erp values */
     if (erp) geterp(erp,time,erpv);
 
     /* GMST (rad) */
-    gmst=utc2gmst(tutc,erpv[2]);
+    gmst=utc2gmst(*tutc,erpv[2]);
 
     /* TEME (true equator, mean eqinox) -> ECEF (ref [2] IID, Appendix C) */
+    for (i=0;i<9;i++) R3[i]=0.0;
     R1[0]=1.0; R1[4]=R1[8]=cos(-erpv[1]); R1[7]=sin(-erpv[1]); R1[5]=-R1[7];
     R2[4]=1.0; R2[0]=R2[8]=cos(-erpv[0]); R2[2]=sin(-erpv[0]); R2[6]=-R2[2];
     R3[8]=1.0; R3[0]=R3[4]=cos(gmst); R3[3]=sin(gmst); R3[1]=-R3[3];
+    matmul("NN",3,3,3,R1,R2,W);
+}
+/* TEME position and velocity to ECEF ----------------------------------------*/
+static void rs2ecef(const double *R3, const double *W, const double *rs_tle,
+                    double *rs)
+{
+    double rs_pef[6];
+
     matmul("NN",3,1,3,R3,rs_tle  ,rs_pef  );
     matmul("NN",3,1,3,R3,rs_tle+3,rs_pef+3);
     rs_pef[3]+=OMGE*rs_pef[1];
     rs_pef[4]-=OMGE*rs_pef[0];
-    matmul("NN",3,3,3,R1,R2,W);
     matmul("NN",3,1,3,W,rs_pef  ,rs  );
     matmul("NN",3,1,3,W,rs_pef+3,rs+3);
+}
+/* satellite position and velocity with TLE data -------------------------------
+* compute satellite position and velocity in ECEF with TLE data
+* args   : gtime_t time     I   time (GPST)
+*          char   *name     I   satellite name           ("": not specified)
+*          char   *satno    I   satellite catalog number ("": not specified)
+*          char   *desig    I   international designator ("": not specified)
+*          tle_t  *tle      I   TLE data
+*          erp_t  *erp      I   EOP data (NULL: not used)
+*          double *rs       O   sat position/velocity {x,y,z,vx,vy,vz} (m,m/s)
+* return : status (1:ok,0:error)
+* notes  : the coordinates of the position and velocity are ECEF (ITRF)
+*          if erp == NULL, polar motion and ut1-utc are neglected
+*-----------------------------------------------------------------------------*/
+extern int tle_pos(gtime_t time, const char *name, const char *satno,
+                   const char *desig, const tle_t *tle, const erp_t *erp,
+                   double *rs)
+{
+    gtime_t tutc;
+    double tsince,rs_tle[6],R3[9],W[9];
+    int i;
+
+    if ((i=tle_index(name,satno,desig,tle))<0) return 0;
+
+    teme2ecef(time,erp,&tutc,R3,W);
+
+    /* time since epoch (min) */
+    tsince=timediff(tutc,tle->data[i].epoch)/60.0;
+
+    /* SGP4 model propagator by STR#3 */
+    SGP4_STR3(tsince,tle->data+i,rs_tle);
+
+    rs2ecef(R3,W,rs_tle,rs);
     return 1;
 }
+/* satellite positions and velocities at times with TLE data -------------------
+* compute positions and velocities in ECEF of satellites at times with TLE data
+* args   : gtime_t *time    I   times (GPST)
+*          int    nt        I   number of times
+*          int    *index    I   indexes of TLE data of satellites by tle_index()
+*                               (-1: no TLE data)
+*          int    ns        I   number of satellites
+*          tle_t  *tle      I   TLE data
+*          erp_t  *erp      I   EOP data (NULL: not used)
+*          double *rs       O   sat position/velocity {x,y,z,vx,vy,vz} (m,m/s)
+*                               rs[(i*ns+j)*6+k]: time i, satellite j
+*          int    *stat     O   status (1:ok,0:error) (NULL: not output)
+*                               stat[i*ns+j]: time i, satellite j
+* return : number of computed positions and velocities (-1: error)
+* notes  : results are same as tle_pos() by the time and the satellite.
+*          the SGP4 model is initialized once by a satellite and the TEME to
+*          ECEF transformation is computed once by a time
+*-----------------------------------------------------------------------------*/
+extern int tle_pos_batch(const gtime_t *time, int nt, const int *index, int ns,
+                         const tle_t *tle, const erp_t *erp, double *rs,
+                         int *stat)
+{
+    sgp4_t *p;
+    gtime_t tutc;
+    double tsince,rs_tle[6],R3[9],W[9];
+    int i,j,n=0;
+
+    if (ns<=0||nt<=0) return 0;
+
+    if (!(p=(sgp4_t *)malloc(sizeof(sgp4_t)*ns))) {
+        trace(1,"tle_pos_batch: malloc error ns=%d\n",ns);
+        return -1;
+    }
+    for (j=0;j<ns;j++) {
+        if (index[j]>=0&&index[j]<tle->n) SGP4_init(tle->data+index[j],p+j);
+    }
+    for (i=0;i<nt;i++) {
+        teme2ecef(time[i],erp,&tutc,R3,W);
+
+        for (j=0;j<ns;j++) {
+            if (index[j]<0||index[j]>=tle->n) {
+                if (stat) stat[i*ns+j]=0;
+                continue;
+            }
+            /* time since epoch (min) */
+            tsince=timediff(tutc,tle->data[index[j]].epoch)/60.0;
+
+            SGP4_prop(tsince,p+j,rs_tle);
+
+            rs2ecef(R3,W,rs_tle,rs+(i*ns+j)*6);
+            if (stat) stat[i*ns+j]=1;
+            n++;
+        }
+    }
+    free(p);
+    return n;
+}
@@ -0,0 +1,90 @@
+/*------------------------------------------------------------------------------
+* rtklib benchmark : ionosphere delay by IONEX tec grid data
+*
+* usage : b_ionex [nrep [tint]]
+*
+*   nrep : number of repetitions [4]
+*   tint : time interval of epochs (s) [30]
+*
+* notes : compute ionospheric delays by iontec() for a set of receivers and
+*         satellite directions at every epoch over the period of the IONEX
+*         files for each model option (earth-fixed/sun-fixed, single-layer/
+*         modified single-layer). checksum of delays is output to compare
+*         results among versions
+*-----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "../../src/rtklib.h"
+
+#define NREP        4           /* default number of repetitions */
+#define TINT        30.0        /* default time interval of epochs (s) */
+#define NRCV        8           /* number of receivers */
+#define NAZ         8           /* number of azimuth angles */
+#define NEL         4           /* number of elevation angles */
+
+/* ionospheric delays over period --------------------------------------------*/
+static double iondelays(const nav_t *nav, int opt, double tint, int *ncall,
+                        int *nok)
+{
+    const double rcv[NRCV][2]={ /* receiver {lat,lon} (deg) */
+        {35.7,139.8},{-33.9,151.2},{51.5,-0.1},{40.7,-74.0},
+        {-23.5,-46.6},{1.3,103.8},{64.1,-21.9},{-77.8,166.7}
+    };
+    gtime_t ts,te,time;
+    double pos[3],azel[2],delay,var,sum=0.0;
+    int i,j,k;
+
+    ts=timeadd(nav->tec[0].time,tint);
+    te=nav->tec[nav->nt-1].time;
+
+    for (time=ts;timediff(time,te)<0.0;time=timeadd(time,tint)) {
+        for (i=0;i<NRCV;i++) {
+            pos[0]=rcv[i][0]*D2R;
+            pos[1]=rcv[i][1]*D2R;
+            pos[2]=100.0;
+            for (j=0;j<NAZ;j++) for (k=0;k<NEL;k++) {
+                azel[0]=(j*360.0/NAZ+7.0)*D2R;
+                azel[1]=(10.0+k*80.0/NEL)*D2R;
+                (*ncall)++;
+                if (!iontec(time,nav,pos,azel,opt,&delay,&var)) continue;
+                sum+=delay+var;
+                (*nok)++;
+            }
+        }
+    }
+    return sum;
+}
+static void bench_iontec(const nav_t *nav, int opt, double tint, int nrep)
+{
+    uint32_t tick;
+    double sum=0.0;
+    int k,ncall=0,nok=0;
+
+    tick=tickget();
+    for (k=0;k<nrep;k++) {
+        sum=iondelays(nav,opt,tint,&ncall,&nok);
+    }
+    tick=tickget()-tick;
+
+    printf("opt=%d: calls=%8d ok=%8d time=%6.3f s %6.3f Mcall/s checksum=%.16E\n",
+           opt,ncall,nok,tick*1E-3,ncall/(tick*1E-3+1E-9)/1E6,sum);
+}
+int main(int argc, char **argv)
+{
+    nav_t nav={0};
+    int opt,nrep=argc>1?atoi(argv[1]):NREP;
+    double tint=argc>2?atof(argv[2]):TINT;
+
+    readtec("../data/sp3/igrg33*0.10i",&nav,0);
+    if (nav.nt<2) {
+        fprintf(stderr,"no tec grid data\n");
+        return -1;
+    }
+    printf("tec grid maps: %d\n",nav.nt);
+
+    for (opt=0;opt<4;opt++) {
+        bench_iontec(&nav,opt,tint,nrep);
+    }
+    freenav(&nav,0xFF);
+    return 0;
+}
@@ -0,0 +1,379 @@
+/*------------------------------------------------------------------------------
+* rtklib benchmark : end-to-end processing throughput
+*
+* usage : b_proc [-n nrep] [-d datadir] [-o outfile] [-b baseline [-t tol]]
+*                [bench ...]
+*
+*   -n nrep     : number of repetitions of each benchmark [10]
+*   -d datadir  : test data directory [../data]
+*   -o outfile  : output benchmark results [stdout]
+*   -b baseline : compare results with baseline (results of previous run)
+*   -t tol      : tolerance ratio to baseline [0.2]
+*   bench       : benchmarks {rnxin,spp,rtk,ppp,pppg,rtcm3,conv} [all]
+*
+* notes : results are output as a line for each benchmark as:
+*
+*           name nrep epochs msgs time(s) epochs/s msgs/s rss(kB)
+*
+*         epochs and msgs are counts for all repetitions. time excludes
+*         loading and counting of input data for the benchmark. rss is peak
+*         resident set size of the process at the end of the benchmark, so
+*         run each benchmark by a separate process to get its own peak
+*
+*         if baseline specified, exit with status 1 if epochs/s or msgs/s
+*         is lower than baseline by tol or rss is higher than baseline by
+*         tol
+*-----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef WIN32
+#include <sys/resource.h>
+#endif
+#include "../../src/rtklib.h"
+
+#define NREP        10          /* default number of repetitions */
+#define TOL         0.2         /* default tolerance ratio to baseline */
+#define MAXBENCH    16          /* max number of benchmarks */
+#define OUTFILE     "b_proc_out" /* temporary output file */
+
+typedef struct {                /* benchmark result type */
+    char name[16];              /* benchmark name */
+    int nrep;                   /* number of repetitions */
+    double epochs;              /* number of processed epochs */
+    double msgs;                /* number of decoded messages */
+    double time;                /* processing time (s) */
+    double rss;                 /* peak resident set size (kB) */
+} result_t;
+
+static const double rb[]={-3978241.958,3382840.234,3649900.853}; /* base pos */
+static char datadir[512]="../data"; /* test data directory */
+
+/* dummy functions of application --------------------------------------------*/
+extern int showmsg(const char *format, ...) {return 0;}
+extern void settspan(gtime_t ts, gtime_t te) {}
+extern void settime(gtime_t time) {}
+
+/* test data path ------------------------------------------------------------*/
+static char *datapath(const char *file, char *path)
+{
+    sprintf(path,"%s/%s",datadir,file);
+    return path;
+}
+/* peak resident set size (kB) -----------------------------------------------*/
+static double peakrss(void)
+{
+#ifdef WIN32
+    return 0.0;
+#else
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF,&ru)) return 0.0;
+#ifdef __APPLE__
+    return ru.ru_maxrss/1024.0; /* bytes */
+#else
+    return (double)ru.ru_maxrss;
+#endif
+#endif
+}
+/* number of observation epochs in RINEX OBS file ----------------------------*/
+static int rnxepochs(const char *file)
+{
+    gtime_t t0={0};
+    obs_t obs={0};
+    nav_t nav={0};
+    sta_t sta={""};
+    int i,n=0;
+
+    readrnxt(file,1,t0,t0,0.0,"",&obs,&nav,&sta);
+    for (i=0;i<obs.n;i++) {
+        if (i==0||timediff(obs.data[i].time,obs.data[i-1].time)!=0.0) n++;
+    }
+    freeobs(&obs);
+    freenav(&nav,0xFF);
+    return n;
+}
+/* read file to memory -------------------------------------------------------*/
+static uint8_t *readbuff(const char *file, long *len)
+{
+    FILE *fp;
+    uint8_t *buff;
+
+    if (!(fp=fopen(file,"rb"))) return NULL;
+    fseek(fp,0,SEEK_END);
+    *len=ftell(fp);
+    fseek(fp,0,SEEK_SET);
+    if (!(buff=(uint8_t *)malloc(*len))||fread(buff,1,*len,fp)<(size_t)*len) {
+        free(buff);
+        buff=NULL;
+    }
+    fclose(fp);
+    return buff;
+}
+/* benchmark: RINEX OBS/NAV read ---------------------------------------------*/
+static int b_rnxin(result_t *res)
+{
+    gtime_t t0={0};
+    obs_t obs={0};
+    nav_t nav={0};
+    sta_t sta={""};
+    uint32_t tick=tickget();
+    char path[1024];
+    int i,k;
+
+    for (k=0;k<res->nrep;k++) {
+        readrnxt(datapath("rinex/07590920.05o",path),1,t0,t0,0.0,"",&obs,&nav,
+                 &sta);
+        readrnxt(datapath("rinex/30400920.05n",path),1,t0,t0,0.0,"",&obs,&nav,
+                 &sta);
+        for (i=0;i<obs.n;i++) {
+            if (i==0||timediff(obs.data[i].time,obs.data[i-1].time)!=0.0) {
+                res->epochs++;
+            }
+        }
+        if (obs.n<=0||nav.n<=0) return 0;
+        freeobs(&obs);
+        freenav(&nav,0xFF);
+    }
+    res->time=(tickget()-tick)*1E-3;
+    return 1;
+}
+/* benchmark: post-processing positioning ------------------------------------*/
+static int b_postpos(result_t *res, int mode, int tropopt)
+{
+    gtime_t t0={0};
+    prcopt_t popt=prcopt_default;
+    solopt_t sopt=solopt_default;
+    filopt_t fopt={""};
+    uint32_t tick;
+    char path[3][1024];
+    const char *infile[3];
+    int i,k,n=2,nep;
+
+    infile[0]=datapath("rinex/07590920.05o",path[0]);
+    infile[1]=datapath("rinex/30400920.05n",path[1]);
+    infile[2]=datapath("rinex/30400920.05o",path[2]);
+
+    popt.mode=mode;
+    popt.navsys=SYS_GPS;
+    if (mode==PMODE_KINEMA) {
+        popt.nf=2;
+        popt.refpos=POSOPT_POS_XYZ;
+        for (i=0;i<3;i++) popt.rb[i]=rb[i];
+        n=3;
+    }
+    else if (mode==PMODE_PPP_STATIC) {
+        popt.nf=2;
+        popt.ionoopt=IONOOPT_IFLC;
+        popt.tropopt=tropopt;
+    }
+    if ((nep=rnxepochs(infile[0]))<=0) return 0;
+
+    tick=tickget();
+    for (k=0;k<res->nrep;k++) {
+        if (postpos(t0,t0,0.0,0.0,&popt,&sopt,&fopt,infile,n,OUTFILE,"","")) {
+            return 0;
+        }
+        res->epochs+=nep;
+    }
+    res->time=(tickget()-tick)*1E-3;
+    remove(OUTFILE);
+    remove(OUTFILE"_events.pos");
+    return 1;
+}
+/* benchmark: RTCM3 decode ---------------------------------------------------*/
+static int b_rtcm3(result_t *res)
+{
+    const double ep[]={2012,10,14,0,0,0};
+    rtcm_t rtcm;
+    uint8_t *buff;
+    uint32_t tick;
+    char path[1024];
+    long i,len;
+    int k,ret;
+
+    if (!(buff=readbuff(datapath("rcvraw/GMSD7_20121014.rtcm3",path),&len))) {
+        return 0;
+    }
+    tick=tickget();
+    for (k=0;k<res->nrep;k++) {
+        if (!init_rtcm(&rtcm)) break;
+        rtcm.time=utc2gpst(epoch2time(ep));
+
+        for (i=0;i<len;i++) {
+            if ((ret=input_rtcm3(&rtcm,buff[i]))==1) res->epochs++;
+            if (ret>0) res->msgs++;
+        }
+        free_rtcm(&rtcm);
+    }
+    res->time=(tickget()-tick)*1E-3;
+    free(buff);
+    return res->msgs>0.0;
+}
+/* benchmark: receiver raw to RINEX conversion -------------------------------*/
+static int b_conv(result_t *res)
+{
+    rnxopt_t opt={{0}};
+    raw_t raw;
+    uint8_t *buff;
+    double nep=0.0,nmsg=0.0;
+    uint32_t tick;
+    char path[1024],ofile_[9][32]={OUTFILE".obs",OUTFILE".nav"},*ofile[9];
+    long i,len;
+    int j,k,ret;
+
+    datapath("rcvraw/ubx_20080526.ubx",path);
+
+    /* count epochs and messages by decoding raw data */
+    if (!(buff=readbuff(path,&len))||!init_raw(&raw,STRFMT_UBX)) {
+        free(buff);
+        return 0;
+    }
+    for (i=0;i<len;i++) {
+        if ((ret=input_raw(&raw,STRFMT_UBX,buff[i]))==1) nep++;
+        if (ret>0) nmsg++;
+    }
+    free_raw(&raw);
+    free(buff);
+
+    opt.rnxver=304;
+    opt.obstype=OBSTYPE_PR|OBSTYPE_CP;
+    opt.navsys=SYS_GPS|SYS_GLO|SYS_GAL|SYS_QZS|SYS_SBS|SYS_CMP|SYS_IRN;
+    opt.freqtype=FREQTYPE_L1|FREQTYPE_L2;
+    opt.ttol=0.005;
+    for (i=0;i<RNX_NUMSYS;i++) {
+        for (j=0;j<MAXCODE;j++) opt.mask[i][j]='1';
+        opt.mask[i][MAXCODE]='\0';
+    }
+    for (i=0;i<9;i++) ofile[i]=ofile_[i];
+
+    tick=tickget();
+    for (k=0;k<res->nrep;k++) {
+        if (!convrnx(STRFMT_UBX,&opt,path,ofile)) return 0;
+        res->epochs+=nep;
+        res->msgs+=nmsg;
+    }
+    res->time=(tickget()-tick)*1E-3;
+    remove(ofile[0]);
+    remove(ofile[1]);
+    return 1;
+}
+/* run benchmark -------------------------------------------------------------*/
+static int runbench(const char *name, int nrep, result_t *res)
+{
+    int stat;
+
+    memset(res,0,sizeof(result_t));
+    strcpy(res->name,name);
+    res->nrep=nrep>0?nrep:NREP;
+
+    if      (!strcmp(name,"rnxin")) stat=b_rnxin(res);
+    else if (!strcmp(name,"spp"  )) stat=b_postpos(res,PMODE_SINGLE,0);
+    else if (!strcmp(name,"rtk"  )) stat=b_postpos(res,PMODE_KINEMA,0);
+    else if (!strcmp(name,"ppp"  )) stat=b_postpos(res,PMODE_PPP_STATIC,TROPOPT_EST);
+    else if (!strcmp(name,"pppg" )) stat=b_postpos(res,PMODE_PPP_STATIC,TROPOPT_ESTG);
+    else if (!strcmp(name,"rtcm3")) stat=b_rtcm3(res);
+    else if (!strcmp(name,"conv" )) stat=b_conv(res);
+    else {
+        fprintf(stderr,"unknown benchmark: %s\n",name);
+        return 0;
+    }
+    res->rss=peakrss();
+    if (!stat) fprintf(stderr,"benchmark error: %s\n",name);
+    return stat;
+}
+/* throughput (/s) -----------------------------------------------------------*/
+static double rate(double n, double time)
+{
+    return n/(time>1E-3?time:1E-3);
+}
+/* output benchmark results --------------------------------------------------*/
+static void outresult(FILE *fp, const result_t *res, int n)
+{
+    int i;
+
+    fprintf(fp,"%% %-6s %5s %9s %9s %8s %10s %10s %9s\n","name","nrep",
+            "epochs","msgs","time(s)","epochs/s","msgs/s","rss(kB)");
+    for (i=0;i<n;i++) {
+        fprintf(fp,"%-8s %5d %9.0f %9.0f %8.3f %10.1f %10.1f %9.0f\n",
+                res[i].name,res[i].nrep,res[i].epochs,res[i].msgs,res[i].time,
+                rate(res[i].epochs,res[i].time),rate(res[i].msgs,res[i].time),
+                res[i].rss);
+    }
+}
+/* compare results with baseline ---------------------------------------------*/
+static int cmpbase(const char *file, const result_t *res, int n, double tol)
+{
+    FILE *fp;
+    result_t base;
+    double ep,msg,rb_ep,rb_msg;
+    char buff[256];
+    int i,nrep,stat=1;
+
+    if (!(fp=fopen(file,"r"))) {
+        fprintf(stderr,"baseline open error: %s\n",file);
+        return 0;
+    }
+    while (fgets(buff,sizeof(buff),fp)) {
+        if (buff[0]=='%'||sscanf(buff,"%15s %d %lf %lf %lf %lf %lf %lf",
+            base.name,&nrep,&base.epochs,&base.msgs,&base.time,&rb_ep,&rb_msg,
+            &base.rss)<8) continue;
+
+        for (i=0;i<n;i++) {
+            if (strcmp(res[i].name,base.name)) continue;
+            ep =rate(res[i].epochs,res[i].time);
+            msg=rate(res[i].msgs  ,res[i].time);
+
+            if (rb_ep>0.0&&ep<rb_ep*(1.0-tol)) {
+                printf("%-8s: epochs/s %.1f < baseline %.1f\n",base.name,ep,rb_ep);
+                stat=0;
+            }
+            if (rb_msg>0.0&&msg<rb_msg*(1.0-tol)) {
+                printf("%-8s: msgs/s %.1f < baseline %.1f\n",base.name,msg,rb_msg);
+                stat=0;
+            }
+            if (base.rss>0.0&&res[i].rss>base.rss*(1.0+tol)) {
+                printf("%-8s: rss %.0f kB > baseline %.0f kB\n",base.name,
+                       res[i].rss,base.rss);
+                stat=0;
+            }
+        }
+    }
+    fclose(fp);
+    return stat;
+}
+int main(int argc, char **argv)
+{
+    const char *benchs[]={"rnxin","spp","rtk","ppp","pppg","rtcm3","conv"};
+    const char *names[MAXBENCH],*outfile="",*basefile="";
+    result_t res[MAXBENCH];
+    FILE *fp=stdout;
+    double tol=TOL;
+    int i,n=0,nrep=NREP,stat=1;
+
+    for (i=1;i<argc;i++) {
+        if      (!strcmp(argv[i],"-n")&&i+1<argc) nrep=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-d")&&i+1<argc) sprintf(datadir,"%.511s",argv[++i]);
+        else if (!strcmp(argv[i],"-o")&&i+1<argc) outfile=argv[++i];
+        else if (!strcmp(argv[i],"-b")&&i+1<argc) basefile=argv[++i];
+        else if (!strcmp(argv[i],"-t")&&i+1<argc) tol=atof(argv[++i]);
+        else if (n<MAXBENCH) names[n++]=argv[i];
+    }
+    if (n<=0) {
+        for (i=0;i<(int)(sizeof(benchs)/sizeof(*benchs));i++) names[n++]=benchs[i];
+    }
+    for (i=0;i<n;i++) {
+        if (!runbench(names[i],nrep,res+i)) stat=0;
+    }
+    if (*outfile&&!(fp=fopen(outfile,"w"))) {
+        fprintf(stderr,"output open error: %s\n",outfile);
+        return 1;
+    }
+    outresult(fp,res,n);
+    if (fp!=stdout) {
+        fclose(fp);
+        outresult(stdout,res,n);
+    }
+    if (*basefile&&!cmpbase(basefile,res,n,tol)) stat=0;
+
+    return stat?0:1;
+}
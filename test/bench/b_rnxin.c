@@ -0,0 +1,125 @@
+/*------------------------------------------------------------------------------
+* rtklib benchmark : RINEX OBS/NAV/CLK, SP3 and ANTEX input throughput
+*
+* usage : b_rnxin [nrep [cachedir]]
+*
+*   cachedir : product cache directory to measure reading NAV/SP3/CLK/ANTEX
+*              via product cache in addition [none]
+*-----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include "../../src/rtklib.h"
+
+#define NREP        20          /* default number of repetitions */
+
+/* file size (bytes) ---------------------------------------------------------*/
+static double filesize(const char *file)
+{
+    struct stat st;
+    return stat(file,&st)?0.0:(double)st.st_size;
+}
+/* checksum of read data -----------------------------------------------------*/
+static double checksum(const obs_t *obs, const nav_t *nav, const pcvs_t *pcvs)
+{
+    double sum=0.0;
+    int i,j,k;
+
+    for (i=0;i<obs->n;i++) {
+        for (j=0;j<NFREQ+NEXOBS;j++) {
+            sum+=obs->data[i].P[j]+obs->data[i].L[j]+obs->data[i].D[j];
+            sum+=obs->data[i].SNR[j]+obs->data[i].LLI[j];
+        }
+    }
+    for (i=0;i<nav->n;i++) {
+        sum+=nav->eph[i].A+nav->eph[i].e+nav->eph[i].f0+nav->eph[i].cuc;
+    }
+    for (i=0;i<nav->ng;i++) {
+        sum+=nav->geph[i].pos[0]+nav->geph[i].vel[1]+nav->geph[i].acc[2];
+    }
+    for (i=0;i<nav->ne;i++) {
+        for (j=0;j<MAXSAT;j++) {
+            for (k=0;k<4;k++) sum+=nav->peph[i].pos[j][k]+nav->peph[i].std[j][k];
+        }
+    }
+    for (i=0;i<nav->nc;i++) {
+        for (j=0;j<MAXSAT;j++) sum+=nav->pclk[i].clk[j][0]+nav->pclk[i].std[j][0];
+    }
+    for (i=0;pcvs&&i<pcvs->n;i++) {
+        for (j=0;j<NFREQ;j++) {
+            for (k=0;k<3;k++) sum+=pcvs->pcv[i].off[j][k];
+            for (k=0;k<19;k++) sum+=pcvs->pcv[i].var[j][k];
+        }
+    }
+    return sum;
+}
+/* read files ----------------------------------------------------------------*/
+static double readfiles(const char *type, const char **files, int nfile,
+                        int sum)
+{
+    gtime_t t0={0};
+    obs_t obs={0};
+    nav_t nav={0};
+    pcvs_t pcvs={0};
+    sta_t sta={""};
+    double val=0.0;
+    int i;
+
+    for (i=0;i<nfile;i++) {
+        if      (!strcmp(type,"sp3")) readsp3(files[i],&nav,0);
+        else if (!strcmp(type,"clk")) readrnxc(files[i],&nav);
+        else if (!strcmp(type,"atx")) readpcv(files[i],&pcvs);
+        else readrnxt(files[i],1,t0,t0,0.0,"",&obs,&nav,&sta);
+    }
+    if (sum) val=checksum(&obs,&nav,&pcvs);
+    freeobs(&obs);
+    freenav(&nav,0xFF);
+    free(pcvs.pcv);
+    return val;
+}
+static void bench_read(const char *type, const char **files, int nfile,
+                       int nrep)
+{
+    uint32_t tick;
+    double bytes=0.0,sum=0.0;
+    int i,k;
+
+    for (i=0;i<nfile;i++) bytes+=filesize(files[i])*nrep;
+
+    /* store files to product cache before measurement */
+    if (getprodcache(NULL,NULL)) readfiles(type,files,nfile,0);
+
+    tick=tickget();
+    for (k=0;k<nrep;k++) {
+        sum=readfiles(type,files,nfile,k==nrep-1);
+    }
+    tick=tickget()-tick;
+
+    printf("%-4s: bytes=%10.0f time=%6.3f s %6.1f MB/s checksum=%.16E\n",type,
+           bytes,tick*1E-3,bytes/(tick*1E-3+1E-9)/1E6,sum);
+}
+int main(int argc, char **argv)
+{
+    const char *obs[]={"../data/rinex/07590920.05o","../data/rinex/30400920.05o"};
+    const char *nav[]={"../data/rinex/brdc1820.10n","../data/rinex/brdc0910.09g"};
+    const char *sp3[]={"../data/sp3/igs15904.sp3","../data/sp3/esa15253.sp3"};
+    const char *clk[]={"../data/sp3/igs15904.clk","../data/sp3/esa15253.clk"};
+    const char *atx[]={"../../data/ant/gnssant_ext.atx"};
+    int nrep=argc>1?atoi(argv[1]):NREP;
+
+    bench_read("obs",obs,2,nrep);
+    bench_read("nav",nav,2,nrep);
+    bench_read("sp3",sp3,2,nrep);
+    bench_read("clk",clk,2,nrep/4>0?nrep/4:1);
+    bench_read("atx",atx,1,nrep*4);
+
+    if (argc>2) { /* read via product cache */
+        setprodcache(argv[2]);
+        printf("product cache: %s\n",argv[2]);
+        bench_read("nav",nav,2,nrep);
+        bench_read("sp3",sp3,2,nrep);
+        bench_read("clk",clk,2,nrep/4>0?nrep/4:1);
+        bench_read("atx",atx,1,nrep*4);
+    }
+    return 0;
+}
@@ -0,0 +1,118 @@
+/*------------------------------------------------------------------------------
+* rtklib benchmark : RINEX OBS/NAV output throughput
+*
+* usage : b_rnxout [nrep]
+*-----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "../../src/rtklib.h"
+
+#define NREP        20          /* default number of repetitions */
+
+/* set RINEX options ---------------------------------------------------------*/
+static void setopt(rnxopt_t *opt, int rnxver)
+{
+    const char *tobs2[]={"C1","P1","L1","D1","S1","P2","L2","D2","S2"};
+    const char *tobs3[]={"C1C","L1C","D1C","S1C","C2W","L2W","D2W","S2W"};
+    int i,j;
+
+    memset(opt,0,sizeof(rnxopt_t));
+    opt->rnxver=rnxver;
+    opt->navsys=SYS_GPS;
+    for (i=0;i<RNX_NUMSYS;i++) {
+        for (j=0;j<MAXCODE;j++) opt->mask[i][j]='1';
+    }
+    if (rnxver<=299) {
+        opt->nobs[0]=9;
+        for (i=0;i<9;i++) strcpy(opt->tobs[0][i],tobs2[i]);
+    }
+    else {
+        opt->nobs[0]=8;
+        for (i=0;i<8;i++) strcpy(opt->tobs[0][i],tobs3[i]);
+    }
+}
+/* output RINEX OBS body -----------------------------------------------------*/
+static void bench_obs(const obs_t *obs, int rnxver, int nrep)
+{
+    rnxopt_t opt;
+    FILE *fp;
+    uint32_t tick;
+    long bytes;
+    int i,j,k,nep=0;
+
+    setopt(&opt,rnxver);
+    if (!(fp=tmpfile())) return;
+
+    tick=tickget();
+    for (k=0;k<nrep;k++) {
+        for (i=0;i<obs->n;i=j) {
+            for (j=i+1;j<obs->n;j++) {
+                if (timediff(obs->data[j].time,obs->data[i].time)>DTTOL) break;
+            }
+            outrnxobsb(fp,&opt,obs->data+i,j-i,0);
+            nep++;
+        }
+    }
+    fflush(fp);
+    tick=tickget()-tick;
+    bytes=ftell(fp);
+    fclose(fp);
+
+    printf("obs ver=%.2f : epochs=%7d bytes=%9ld time=%6.3f s %8.0f epochs/s %6.1f MB/s\n",
+           rnxver/100.0,nep,bytes,tick*1E-3,nep/(tick*1E-3+1E-9),
+           bytes/(tick*1E-3+1E-9)/1E6);
+}
+/* output RINEX NAV body -----------------------------------------------------*/
+static void bench_nav(const nav_t *nav, int rnxver, int nrep)
+{
+    rnxopt_t opt;
+    FILE *fp;
+    uint32_t tick;
+    long bytes;
+    int i,k,neph=0;
+
+    setopt(&opt,rnxver);
+    if (!(fp=tmpfile())) return;
+
+    tick=tickget();
+    for (k=0;k<nrep*4;k++) {
+        for (i=0;i<nav->n;i++) {
+            outrnxnavb(fp,&opt,nav->eph+i);
+            neph++;
+        }
+    }
+    fflush(fp);
+    tick=tickget()-tick;
+    bytes=ftell(fp);
+    fclose(fp);
+
+    printf("nav ver=%.2f : ephs  =%7d bytes=%9ld time=%6.3f s %8.0f ephs/s   %6.1f MB/s\n",
+           rnxver/100.0,neph,bytes,tick*1E-3,neph/(tick*1E-3+1E-9),
+           bytes/(tick*1E-3+1E-9)/1E6);
+}
+int main(int argc, char **argv)
+{
+    const char *file1="../data/rinex/07590920.05o";
+    const char *file2="../data/rinex/brdc1820.10n";
+    gtime_t t0={0};
+    obs_t obs={0};
+    nav_t nav={0};
+    sta_t sta={""};
+    int nrep=argc>1?atoi(argv[1]):NREP;
+
+    if (readrnxt(file1,1,t0,t0,0.0,"",&obs,&nav,&sta)<=0||
+        readrnxt(file2,1,t0,t0,0.0,"",&obs,&nav,&sta)<=0) {
+        fprintf(stderr,"file read error\n");
+        return -1;
+    }
+    sortobs(&obs);
+
+    bench_obs(&obs,211,nrep);
+    bench_obs(&obs,304,nrep);
+    bench_nav(&nav,211,nrep);
+    bench_nav(&nav,304,nrep);
+
+    freeobs(&obs);
+    freenav(&nav,0xFF);
+    return 0;
+}
@@ -0,0 +1,341 @@
+/*------------------------------------------------------------------------------
+* rtklib benchmark : microbenchmarks of numeric kernels
+*
+* usage : b_rtkcmn [-s size[,size...]] [-n nsample] [-t tsample] [kernel ...]
+*
+*   -s size     : matrix sizes of matrix kernels [4,8,16,32,64]
+*   -n nsample  : number of samples for statistics [11]
+*   -t tsample  : min time of a sample (ms) [10]
+*   kernel      : kernels to measure [all]
+*                 matrix: matmul,matinv,lsq,filter,smoother,lambda
+*                 scalar: eph2pos,geph2pos,tropmodel,tropmapf,ionmodel,
+*                         ecef2pos,pos2ecef,getbitu
+*
+* notes : a sample repeats a kernel for the number of iterations calibrated
+*         to take longer than tsample. output min, median, mean and standard
+*         deviation of time per kernel call among samples
+*
+*         matrix routines are built in-tree or with LAPACK/BLAS or MKL by
+*         -DLAPACK or -DMKL as rtkcmn.c
+*
+*         matrix kernels are as follows (n: matrix size):
+*           matmul   : C=A*B (n x n)
+*           matinv   : inverse of symmetric positive definite matrix (n x n)
+*           lsq      : least square with n parameters and 2n measurements
+*           filter   : kalman filter with n states and n/2 measurements
+*           smoother : smoother of n states
+*           lambda   : integer least square of n ambiguities, 2 candidates
+*
+*         getbitu is measured by extracting 1024 bit fields of 1-32 bits
+*-----------------------------------------------------------------------------*/
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../../src/rtklib.h"
+
+#define NSAMPLE     11          /* default number of samples */
+#define TSAMPLE     10.0        /* default min time of a sample (ms) */
+#define MAXSIZE     16          /* max number of matrix sizes */
+#define MAXITER     (1<<30)     /* max iterations of a sample */
+#define NBITS       1024        /* number of bit fields for getbitu */
+
+#ifdef MKL
+#define MATLIB      "MKL"
+#elif defined(LAPACK)
+#define MATLIB      "LAPACK/BLAS"
+#else
+#define MATLIB      "in-tree"
+#endif
+
+typedef struct {                /* kernel arguments type */
+    int n,m;                    /* matrix sizes */
+    double *A,*B,*C,*Q,*P,*x,*y,*v,*R,*F,*s; /* matrices and vectors */
+    double *xf,*Qf,*xb,*Qb;     /* forward/backward solutions for smoother */
+    double *amb,*Qa;            /* float ambiguities and covariance */
+    eph_t eph;                  /* GPS ephemeris */
+    geph_t geph;                /* GLONASS ephemeris */
+    gtime_t time;               /* time */
+    double pos[3],rr[3],azel[2]; /* position and azimuth/elevation */
+    double ion[8];              /* ionosphere parameters (0:default) */
+    uint8_t buff[NBITS*4];      /* bit buffer */
+} arg_t;
+
+typedef void (*kernel_t)(arg_t *arg);
+
+static volatile double sink=0.0; /* result sink against optimization */
+
+/* time (ns) -----------------------------------------------------------------*/
+static double nstime(void)
+{
+#ifdef WIN32
+    LARGE_INTEGER t,f;
+    QueryPerformanceCounter(&t);
+    QueryPerformanceFrequency(&f);
+    return (double)t.QuadPart*1E9/f.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    return ts.tv_sec*1E9+ts.tv_nsec;
+#endif
+}
+/* random matrix -------------------------------------------------------------*/
+static void randmat(double *A, int n, int m)
+{
+    int i;
+    for (i=0;i<n*m;i++) A[i]=(double)rand()/RAND_MAX*2.0-1.0;
+}
+/* symmetric positive definite matrix (n x n) --------------------------------*/
+static void spdmat(double *A, int n)
+{
+    double *B=mat(n,n);
+    int i;
+
+    randmat(B,n,n);
+    matmul("NT",n,n,n,B,B,A);
+    for (i=0;i<n;i++) A[i+i*n]+=n;
+    free(B);
+}
+/* kernels -------------------------------------------------------------------*/
+static void k_matmul(arg_t *a)
+{
+    matmul("NN",a->n,a->n,a->n,a->A,a->B,a->C);
+    sink+=a->C[0];
+}
+static void k_matinv(arg_t *a)
+{
+    matcpy(a->C,a->Q,a->n,a->n);
+    matinv(a->C,a->n);
+    sink+=a->C[0];
+}
+static void k_lsq(arg_t *a)
+{
+    lsq(a->A,a->y,a->n,2*a->n,a->x,a->C);
+    sink+=a->x[0];
+}
+static void k_filter(arg_t *a)
+{
+    matcpy(a->x,a->s,a->n,1);
+    matcpy(a->P,a->Q,a->n,a->n);
+    filter(a->x,a->P,a->B,a->v,a->R,a->n,a->m);
+    sink+=a->x[0];
+}
+static void k_smoother(arg_t *a)
+{
+    smoother(a->xf,a->Qf,a->xb,a->Qb,a->n,a->x,a->C);
+    sink+=a->x[0];
+}
+static void k_lambda(arg_t *a)
+{
+    double s[2];
+    lambda(a->n,2,a->amb,a->Qa,a->F,s);
+    sink+=s[0];
+}
+static void k_eph2pos(arg_t *a)
+{
+    double rs[3],dts,var;
+    eph2pos(a->time,&a->eph,rs,&dts,&var);
+    sink+=rs[0];
+}
+static void k_geph2pos(arg_t *a)
+{
+    double rs[3],dts,var;
+    geph2pos(a->time,&a->geph,rs,&dts,&var);
+    sink+=rs[0];
+}
+static void k_tropmodel(arg_t *a)
+{
+    sink+=tropmodel(a->time,a->pos,a->azel,0.7);
+}
+static void k_tropmapf(arg_t *a)
+{
+    double mapfw;
+    sink+=tropmapf(a->time,a->pos,a->azel,&mapfw);
+}
+static void k_ionmodel(arg_t *a)
+{
+    sink+=ionmodel(a->time,a->ion,a->pos,a->azel);
+}
+static void k_ecef2pos(arg_t *a)
+{
+    double pos[3];
+    ecef2pos(a->rr,pos);
+    sink+=pos[0];
+}
+static void k_pos2ecef(arg_t *a)
+{
+    double rr[3];
+    pos2ecef(a->pos,rr);
+    sink+=rr[0];
+}
+static void k_getbitu(arg_t *a)
+{
+    uint32_t sum=0;
+    int i;
+
+    for (i=0;i<NBITS;i++) sum+=getbitu(a->buff,i*3,1+i%32);
+    sink+=sum;
+}
+static const struct {            /* kernel table */
+    const char *name;            /* kernel name */
+    kernel_t func;               /* kernel function */
+    int ismat;                   /* matrix kernel (0:no,1:yes) */
+} kernels[]={
+    {"matmul"   ,k_matmul   ,1},
+    {"matinv"   ,k_matinv   ,1},
+    {"lsq"      ,k_lsq      ,1},
+    {"filter"   ,k_filter   ,1},
+    {"smoother" ,k_smoother ,1},
+    {"lambda"   ,k_lambda   ,1},
+    {"eph2pos"  ,k_eph2pos  ,0},
+    {"geph2pos" ,k_geph2pos ,0},
+    {"tropmodel",k_tropmodel,0},
+    {"tropmapf" ,k_tropmapf ,0},
+    {"ionmodel" ,k_ionmodel ,0},
+    {"ecef2pos" ,k_ecef2pos ,0},
+    {"pos2ecef" ,k_pos2ecef ,0},
+    {"getbitu"  ,k_getbitu  ,0}
+};
+#define NKERNEL ((int)(sizeof(kernels)/sizeof(*kernels)))
+
+/* initialize kernel arguments -----------------------------------------------*/
+static void initarg(arg_t *a, int n)
+{
+    const double ep[]={2010,7,1,12,0,0};
+    int i;
+
+    memset(a,0,sizeof(arg_t));
+    srand(0);
+    a->n=n;
+    a->m=a->n/2>0?a->n/2:1;
+    a->A=mat(n,2*n); a->B=mat(n,n); a->C=mat(n,n); a->Q=mat(n,n);
+    a->P=mat(n,n); a->x=mat(n,1); a->y=mat(2*n,1); a->v=mat(n,1);
+    a->R=zeros(a->m,a->m); a->F=mat(n,2); a->s=mat(n,1);
+    a->xf=mat(n,1); a->Qf=mat(n,n); a->xb=mat(n,1); a->Qb=mat(n,n);
+    a->amb=mat(n,1); a->Qa=mat(n,n);
+
+    randmat(a->A,n,2*n);
+    randmat(a->B,n,n);
+    randmat(a->y,2*n,1);
+    randmat(a->v,n,1);
+    randmat(a->xf,n,1);
+    randmat(a->xb,n,1);
+    spdmat(a->Q,n);
+    spdmat(a->Qf,n);
+    spdmat(a->Qb,n);
+    spdmat(a->Qa,n);
+    for (i=0;i<n*n;i++) a->Qa[i]*=1E-3/n;
+    for (i=0;i<n;i++) {
+        a->s[i]=10.0*rand()/RAND_MAX+0.1; /* non-zero states */
+        a->amb[i]=floor(a->s[i]*100.0)+(double)rand()/RAND_MAX*0.04-0.02;
+    }
+    for (i=0;i<a->m;i++) a->R[i+i*a->m]=0.01;
+    /* GPS and GLONASS broadcast ephemeris */
+    a->time=utc2gpst(epoch2time(ep));
+    a->eph.sat=satno(SYS_GPS,1);
+    a->eph.toe=a->eph.toc=timeadd(a->time,-1800.0);
+    a->eph.A=26560E3; a->eph.e=0.01; a->eph.i0=0.96; a->eph.OMG0=1.0;
+    a->eph.omg=0.5; a->eph.M0=2.0; a->eph.deln=4.5E-9; a->eph.OMGd=-8.0E-9;
+    a->eph.idot=1E-10; a->eph.crc=200.0; a->eph.crs=-20.0; a->eph.cuc=-1E-6;
+    a->eph.cus=5E-6; a->eph.cic=1E-7; a->eph.cis=-1E-7; a->eph.f0=1E-4;
+    a->eph.f1=1E-12;
+    a->geph.sat=satno(SYS_GLO,1);
+    a->geph.toe=timeadd(a->time,-900.0);
+    a->geph.pos[0]=1.2E7; a->geph.pos[1]=-1.5E7; a->geph.pos[2]=1.3E7;
+    a->geph.vel[0]=1.5E3; a->geph.vel[1]=2.0E3; a->geph.vel[2]=0.8E3;
+    a->geph.acc[0]=1E-6; a->geph.taun=1E-5; a->geph.gamn=1E-12;
+
+    /* receiver position and satellite direction */
+    a->pos[0]=35.0*D2R; a->pos[1]=139.0*D2R; a->pos[2]=50.0;
+    pos2ecef(a->pos,a->rr);
+    a->azel[0]=120.0*D2R; a->azel[1]=30.0*D2R;
+    for (i=0;i<(int)sizeof(a->buff);i++) a->buff[i]=(uint8_t)rand();
+}
+/* free kernel arguments -----------------------------------------------------*/
+static void freearg(arg_t *a)
+{
+    free(a->A); free(a->B); free(a->C); free(a->Q); free(a->P); free(a->x);
+    free(a->y); free(a->v); free(a->R); free(a->F); free(a->s);
+    free(a->xf); free(a->Qf); free(a->xb); free(a->Qb); free(a->amb);
+    free(a->Qa);
+}
+/* time of a sample (ns) -----------------------------------------------------*/
+static double sample(kernel_t func, arg_t *arg, int niter)
+{
+    double t=nstime();
+    int i;
+
+    for (i=0;i<niter;i++) func(arg);
+    return nstime()-t;
+}
+/* compare values ------------------------------------------------------------*/
+static int cmpval(const void *p1, const void *p2)
+{
+    double d=*(const double *)p1-*(const double *)p2;
+    return d<0.0?-1:(d>0.0?1:0);
+}
+/* run kernel and output statistics ------------------------------------------*/
+static void runkernel(int k, int size, int nsample, double tsample)
+{
+    arg_t arg;
+    double *t,mean=0.0,var=0.0;
+    int i,niter=1;
+
+    initarg(&arg,size);
+    t=mat(nsample,1);
+
+    /* calibrate iterations of a sample */
+    while (niter<MAXITER&&sample(kernels[k].func,&arg,niter)<tsample*1E6) {
+        niter*=2;
+    }
+    for (i=0;i<nsample;i++) {
+        t[i]=sample(kernels[k].func,&arg,niter)/niter;
+        mean+=t[i]/nsample;
+    }
+    for (i=0;i<nsample;i++) var+=(t[i]-mean)*(t[i]-mean)/nsample;
+    qsort(t,nsample,sizeof(double),cmpval);
+
+    if (kernels[k].ismat) printf("%-10s %5d",kernels[k].name,size);
+    else printf("%-10s %5s",kernels[k].name,"-");
+    printf(" %10d %12.1f %12.1f %12.1f %10.1f\n",niter,t[0],t[nsample/2],mean,
+           sqrt(var));
+    free(t);
+    freearg(&arg);
+}
+int main(int argc, char **argv)
+{
+    const char *names[NKERNEL];
+    double tsample=TSAMPLE;
+    int i,j,k,n=0,nsize=0,nsample=NSAMPLE,size[MAXSIZE]={4,8,16,32,64};
+    char *p;
+
+    for (i=1;i<argc;i++) {
+        if (!strcmp(argv[i],"-s")&&i+1<argc) {
+            for (p=strtok(argv[++i],",");p&&nsize<MAXSIZE;p=strtok(NULL,",")) {
+                if ((size[nsize]=atoi(p))>0) nsize++;
+            }
+        }
+        else if (!strcmp(argv[i],"-n")&&i+1<argc) nsample=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-t")&&i+1<argc) tsample=atof(argv[++i]);
+        else if (n<NKERNEL) names[n++]=argv[i];
+    }
+    if (nsize<=0) nsize=5;
+    if (nsample<=0) nsample=1;
+
+    printf("%% matrix routines: %s\n",MATLIB);
+    printf("%% %-8s %5s %10s %12s %12s %12s %10s\n","kernel","size","iter",
+           "min(ns)","median(ns)","mean(ns)","sd(ns)");
+
+    for (k=0;k<NKERNEL;k++) {
+        for (i=0;i<n;i++) if (!strcmp(names[i],kernels[k].name)) break;
+        if (n>0&&i>=n) continue;
+
+        if (!kernels[k].ismat) {
+            runkernel(k,1,nsample,tsample);
+            continue;
+        }
+        for (j=0;j<nsize;j++) runkernel(k,size[j],nsample,tsample);
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+/*------------------------------------------------------------------------------
+* rtklib benchmark : multi-rover RTK server load test
+*
+* usage : b_rtkmsvr [nrov [nwork [file [format]]]]
+*
+*   nrov   : number of simulated rovers [50]
+*   nwork  : number of worker threads [2]
+*   file   : receiver log replayed by base station and all rovers
+*            [../data/rcvraw/ubx_20080526.ubx]
+*   format : receiver log format (STRFMT_???) [STRFMT_UBX]
+*
+* notes : base station and rovers read the same log at the same buffer size
+*         per cycle, so each rover forms a short baseline against the base
+*         station epoch of about the same time
+*-----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "../../src/rtklib.h"
+
+#define NROV        50          /* default number of rovers */
+#define NWORK       2           /* default number of worker threads */
+#define CYCLE       10          /* server cycle (ms) */
+#define BUFFSIZE    32768       /* input buffer size (bytes) */
+#define TIDLE       2000        /* idle time to end test (ms) */
+
+static rtksvr_t svr;            /* rtk server of base station */
+static rtkmsvr_t msvr;          /* multi-rover rtk server */
+
+/* dummy functions of application --------------------------------------------*/
+extern int showmsg(const char *format, ...) {return 0;}
+extern void settspan(gtime_t ts, gtime_t te) {}
+extern void settime(gtime_t time) {}
+
+/* total rover observation epochs ----------------------------------------------*/
+static uint32_t nepoch(void)
+{
+    uint32_t n=0;
+    int i;
+
+    for (i=0;i<msvr.nrov;i++) n+=msvr.rov[i]->nmsg[0];
+    return n;
+}
+int main(int argc, char **argv)
+{
+    prcopt_t prcopt=prcopt_default;
+    solopt_t solopt[2]={{0}};
+    const char *file=argc>3?argv[3]:"../data/rcvraw/ubx_20080526.ubx";
+    const char *paths[8]={"",file,"","","","","",""};
+    const char *rpaths[3]={file,"",""};
+    const char *cmds[3]={0},*ropts[3]={"","",""};
+    double npos[3]={0},nsol[MAXSOLQ+1]={0};
+    char errmsg[256];
+    uint32_t tick,tick0,tickl,n,nl=0;
+    int strs[8]={STR_NONE,STR_FILE},rstrs[3]={STR_FILE,STR_NONE,STR_NONE};
+    int nrov=argc>1?atoi(argv[1]):NROV,nwork=argc>2?atoi(argv[2]):NWORK;
+    int format=argc>4?atoi(argv[4]):STRFMT_UBX,formats[3];
+    int i,j;
+
+    prcopt.mode=PMODE_KINEMA;
+    prcopt.navsys=SYS_GPS|SYS_GLO;
+    prcopt.refpos=POSOPT_SINGLE;
+    solopt[0]=solopt[1]=solopt_default;
+    formats[0]=formats[1]=format; formats[2]=STRFMT_RTCM3;
+
+    if (!rtksvrinit(&svr)||!rtkmsvrinit(&msvr,&svr,nwork)) {
+        fprintf(stderr,"server init error\n");
+        return -1;
+    }
+    for (i=0;i<nrov;i++) {
+        if (rtkmsvradd(&msvr,rstrs,rpaths,format,"",&prcopt,solopt)<0) {
+            fprintf(stderr,"rover add error\n");
+            return -1;
+        }
+    }
+    tick0=tickget();
+
+    if (!rtksvrstart(&svr,CYCLE,BUFFSIZE,strs,paths,formats,0,cmds,cmds,ropts,
+                     0,0,npos,&prcopt,solopt,NULL,errmsg)||
+        !rtkmsvrstart(&msvr,CYCLE,BUFFSIZE,errmsg)) {
+        fprintf(stderr,"server start error: %s\n",errmsg);
+        return -1;
+    }
+    /* wait for end of rover logs */
+    for (tickl=tick0;;) {
+        sleepms(100);
+        tick=tickget();
+        if ((n=nepoch())!=nl) {
+            nl=n;
+            tickl=tick;
+        }
+        else if ((int)(tick-tickl)>=TIDLE) break;
+    }
+    rtkmsvrstop(&msvr);
+    rtksvrstop(&svr,cmds);
+
+    for (i=0;i<msvr.nrov;i++) for (j=0;j<=MAXSOLQ;j++) {
+        nsol[j]+=msvr.rov[i]->nsol[j];
+    }
+    printf("rovers=%4d workers=%2d epochs=%8u time=%7.3f s %9.0f epochs/s "
+           "fix=%.0f float=%.0f single=%.0f\n",nrov,msvr.nwork,nl,
+           (tickl-tick0)*1E-3,nl/((tickl-tick0)*1E-3+1E-9),nsol[SOLQ_FIX],
+           nsol[SOLQ_FLOAT],nsol[SOLQ_SINGLE]);
+
+    rtkmsvrfree(&msvr);
+    rtksvrfree(&svr);
+    return 0;
+}
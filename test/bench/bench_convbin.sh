@@ -0,0 +1,50 @@
+#!/bin/sh
+#
+# benchmark of convbin converting a week of hourly u-blox logs
+#
+# usage: bench_convbin.sh [convbin [nthread [nfile]]]
+#
+#   convbin : convbin executable [../../bin/convbin]
+#   nthread : number of threads for parallel conversion [number of cpus]
+#   nfile   : number of hourly log files [168]
+#
+
+CONVBIN=${1:-../../bin/convbin}
+NTHREAD=${2:-`getconf _NPROCESSORS_ONLN 2>/dev/null || echo 1`}
+NFILE=${3:-168}
+LOG=../data/rcvraw/ubx_20080526.ubx
+WORK=${TMPDIR:-/tmp}/bench_convbin.$$
+
+mkdir -p $WORK/seq $WORK/par || exit 1
+trap 'rm -rf $WORK' 0 1 2 15
+
+i=0
+while [ $i -lt $NFILE ]
+do
+    file=`printf "log_%03d.ubx" $i`
+    cp $LOG $WORK/seq/$file
+    cp $LOG $WORK/par/$file
+    i=`expr $i + 1`
+done
+
+# convert input files and print elapsed time (s)
+run() {
+    t0=`date +%s.%N`
+    $CONVBIN -j $1 $2/*.ubx 2>/dev/null || echo "convbin error" >&2
+    t1=`date +%s.%N`
+    echo "$t0 $t1" | awk '{printf("%.3f",$2-$1)}'
+}
+t1=`run 1 $WORK/seq`
+tn=`run $NTHREAD $WORK/par`
+
+# check outputs identical except program/date and log file comment lines
+for file in $WORK/seq/*.obs $WORK/seq/*.nav
+do
+    grep -v "PGM / RUN BY / DATE" $file | grep -v "^log: " > $WORK/a
+    grep -v "PGM / RUN BY / DATE" $WORK/par/`basename $file` | grep -v "^log: " > $WORK/b
+    cmp -s $WORK/a $WORK/b || echo "output differs: `basename $file`" >&2
+done
+
+echo "$NFILE $NTHREAD $t1 $tn" |
+awk '{printf("files=%d  -j 1: %.3f s  -j %d: %.3f s  speedup=%.2f\n",
+             $1,$3,$2,$4,$4>0?$3/$4:0)}'
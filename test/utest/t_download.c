@@ -0,0 +1,271 @@
+/*------------------------------------------------------------------------------
+* rtklib unit test driver : concurrent downloader with local http server
+*-----------------------------------------------------------------------------*/
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "../../src/rtklib.h"
+
+/* dummy functions of application --------------------------------------------*/
+extern int showmsg(const char *format, ...) {return 0;}
+extern void settspan(gtime_t ts, gtime_t te) {}
+extern void settime(gtime_t time) {}
+
+#ifndef WIN32
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define NSERV       2           /* number of servers (hosts) */
+#define NSTA        8           /* number of stations */
+#define FILESIZE    65536       /* size of served file (bytes) */
+#define TDELAY      100         /* response delay (ms) */
+#define DIR         "dltest"    /* local directory */
+
+typedef struct {                /* local http server type */
+    int sock;                   /* listening socket */
+    int port;                   /* port number */
+    int active,maxactive;       /* number and max number of connections */
+} serv_t;
+
+static serv_t serv[NSERV];
+static rtklib_lock_t lock;
+static int nfail=0;             /* number of failed requests of /fail/ */
+static int nrange=0;            /* number of requests with range */
+
+/* contents of served file ---------------------------------------------------*/
+static void genfile(const char *name, char *buff)
+{
+    int i;
+    for (i=0;i<FILESIZE;i++) buff[i]=(char)('a'+(i*7+name[0])%26);
+}
+/* http connection thread ----------------------------------------------------*/
+static void *connthread(void *arg)
+{
+    serv_t *sv=(serv_t *)((void **)arg)[0];
+    int sock=(int)(size_t)((void **)arg)[1],n=0,m,start=0,fail=0;
+    char req[4096]="",path[1024]="",name[256]="",*p,*file;
+
+    free(arg);
+    rtklib_lock(&lock);
+    if (++sv->active>sv->maxactive) sv->maxactive=sv->active;
+    rtklib_unlock(&lock);
+
+    while (n<(int)sizeof(req)-1&&!strstr(req,"\r\n\r\n")) {
+        m=recv(sock,req+n,sizeof(req)-1-n,0);
+        if (m<=0) break;
+        req[n+=m]='\0';
+    }
+    sscanf(req,"GET %1023s",path);
+    if ((p=strrchr(path,'/'))) strcpy(name,p+1);
+    if ((p=strstr(req,"Range: bytes="))) {
+        start=atoi(p+13);
+        rtklib_lock(&lock); nrange++; rtklib_unlock(&lock);
+    }
+    if (!strncmp(path,"/fail/",6)) {
+        rtklib_lock(&lock); fail=nfail++<1; rtklib_unlock(&lock);
+    }
+    sleepms(TDELAY);
+
+    file=(char *)malloc(FILESIZE);
+    genfile(name,file);
+
+    if (strncmp(path,"/data/",6)&&strncmp(path,"/fail/",6)) {
+        sprintf(req,"HTTP/1.0 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+        send(sock,req,strlen(req),0);
+    }
+    else if (fail) {
+        sprintf(req,"HTTP/1.0 500 Internal Server Error\r\nContent-Length: 0\r\n\r\n");
+        send(sock,req,strlen(req),0);
+    }
+    else if (start>0&&start<FILESIZE) {
+        sprintf(req,"HTTP/1.0 206 Partial Content\r\nContent-Length: %d\r\n"
+                "Content-Range: bytes %d-%d/%d\r\n\r\n",FILESIZE-start,start,
+                FILESIZE-1,FILESIZE);
+        send(sock,req,strlen(req),0);
+        send(sock,file+start,FILESIZE-start,0);
+    }
+    else {
+        sprintf(req,"HTTP/1.0 200 OK\r\nContent-Length: %d\r\n\r\n",FILESIZE);
+        send(sock,req,strlen(req),0);
+        send(sock,file,FILESIZE,0);
+    }
+    free(file);
+    close(sock);
+
+    rtklib_lock(&lock);
+    sv->active--;
+    rtklib_unlock(&lock);
+    return NULL;
+}
+/* http server thread --------------------------------------------------------*/
+static void *servthread(void *arg)
+{
+    serv_t *sv=(serv_t *)arg;
+    pthread_t thread;
+    void **args;
+    int sock;
+
+    while ((sock=accept(sv->sock,NULL,NULL))>=0) {
+        args=(void **)malloc(sizeof(void *)*2);
+        args[0]=sv;
+        args[1]=(void *)(size_t)sock;
+        if (pthread_create(&thread,NULL,connthread,args)) break;
+        pthread_detach(thread);
+    }
+    return NULL;
+}
+/* open local http server ----------------------------------------------------*/
+static void openserv(serv_t *sv)
+{
+    struct sockaddr_in addr={0};
+    socklen_t len=sizeof(addr);
+    pthread_t thread;
+    int ret;
+
+    addr.sin_family=AF_INET;
+    addr.sin_addr.s_addr=htonl(INADDR_LOOPBACK);
+    sv->sock=socket(AF_INET,SOCK_STREAM,0);
+        assert(sv->sock>=0);
+    ret=bind(sv->sock,(struct sockaddr *)&addr,sizeof(addr));
+        assert(!ret);
+    ret=listen(sv->sock,64);
+        assert(!ret);
+    ret=getsockname(sv->sock,(struct sockaddr *)&addr,&len);
+        assert(!ret);
+    sv->port=ntohs(addr.sin_port);
+    ret=pthread_create(&thread,NULL,servthread,sv);
+        assert(!ret);
+    pthread_detach(thread);
+}
+/* compare local file with served file ---------------------------------------*/
+static int cmpfile(const char *file, const char *name)
+{
+    FILE *fp;
+    char *buff1=(char *)malloc(FILESIZE),*buff2=(char *)malloc(FILESIZE+1);
+    int n=0;
+
+    genfile(name,buff1);
+    if ((fp=fopen(file,"rb"))) {
+        n=(int)fread(buff2,1,FILESIZE+1,fp);
+        fclose(fp);
+    }
+    n=n==FILESIZE&&!memcmp(buff1,buff2,FILESIZE);
+    free(buff1); free(buff2);
+    return n;
+}
+/* execute download and get counts -------------------------------------------*/
+static void download(const url_t *urls, int nurl, const char **stas, int nsta,
+                     int *n)
+{
+    const double ep[6]={2020,1,1,0,0,0};
+    gtime_t time=epoch2time(ep);
+    char msg[1024];
+    int ret;
+
+    ret=dl_exec(time,time,86400.0,0,0,urls,nurl,stas,nsta,DIR,"","","",0,msg,
+                stdout);
+        assert(ret);
+    printf("%s\n",msg);
+    ret=sscanf(msg,"OK=%d No_File=%d Skip=%d Error=%d",n,n+1,n+2,n+3);
+        assert(ret==4);
+}
+/* concurrent download limited by host */
+static void utest1(void)
+{
+    url_t urls[NSERV]={{""}};
+    char stas_[NSTA][8],*stas[NSTA],file[1024];
+    int i,j,n[4];
+    uint32_t tick;
+
+    for (i=0;i<NSTA;i++) sprintf(stas[i]=stas_[i],"st%02d",i);
+    for (i=0;i<NSERV;i++) {
+        sprintf(urls[i].type,"T%d",i);
+        sprintf(urls[i].path,"http://127.0.0.1:%d/data/%%s%d.txt",serv[i].port,i);
+    }
+    dl_setconc(8,2,1,0.1);
+
+    tick=tickget();
+    download(urls,NSERV,(const char **)stas,NSTA,n);
+    tick=tickget()-tick;
+
+    assert(n[0]==NSERV*NSTA&&n[1]==0&&n[2]==0&&n[3]==0);
+    for (i=0;i<NSERV;i++) {
+        printf("server %d: max connections=%d\n",i,serv[i].maxactive);
+        assert(serv[i].maxactive==2);
+        for (j=0;j<NSTA;j++) {
+            sprintf(file,DIR"/%s%d.txt",stas[j],i);
+            assert(cmpfile(file,stas[j]));
+        }
+    }
+    /* concurrent transfers faster than sequential ones */
+    printf("time=%.3f s (sequential>%.3f s)\n",tick*1E-3,NSERV*NSTA*TDELAY*1E-3);
+    assert(tick<(uint32_t)(NSERV*NSTA*TDELAY));
+
+    /* skip existing files */
+    download(urls,NSERV,(const char **)stas,NSTA,n);
+    assert(n[0]==0&&n[2]==NSERV*NSTA);
+
+    printf("%s utest1 : OK\n",__FILE__);
+}
+/* no file, retry and resume of partial file */
+static void utest2(void)
+{
+    url_t urls[3]={{""}};
+    const char *stas[]={"rs00"};
+    FILE *fp;
+    char buff[FILESIZE];
+    int n[4];
+
+    sprintf(urls[0].path,"http://127.0.0.1:%d/none/%%s.nf.txt",serv[0].port);
+    sprintf(urls[1].path,"http://127.0.0.1:%d/fail/%%s.txt",serv[0].port);
+    sprintf(urls[2].path,"http://127.0.0.1:%d/data/%%s.part.txt",serv[1].port);
+
+    /* partial file of previous download */
+    genfile("rs00",buff);
+    fp=fopen(DIR"/rs00.part.txt.part","wb");
+        assert(fp);
+    fwrite(buff,1,FILESIZE/2,fp);
+    fclose(fp);
+
+    dl_setconc(4,2,2,0.1);
+    download(urls,3,stas,1,n);
+
+    assert(n[0]==2&&n[1]==1&&n[3]==0);
+    assert(nfail==2); /* failed once and retried */
+    assert(nrange==1); /* resumed from partial file */
+    assert(cmpfile(DIR"/rs00.txt","rs00"));
+    assert(cmpfile(DIR"/rs00.part.txt","rs00"));
+    fp=fopen(DIR"/rs00.part.txt.part","rb");
+        assert(!fp);
+
+    printf("%s utest2 : OK\n",__FILE__);
+}
+int main(void)
+{
+    int i;
+
+    if (system("wget --version > /dev/null 2>&1")) {
+        printf("wget not available: skipped\n");
+        return 0;
+    }
+    system("rm -rf "DIR);
+    rtklib_initlock(&lock);
+    for (i=0;i<NSERV;i++) openserv(serv+i);
+
+    utest1();
+    utest2();
+
+    system("rm -rf "DIR);
+    return 0;
+}
+#else
+int main(void)
+{
+    printf("local http server not supported: skipped\n");
+    return 0;
+}
+#endif
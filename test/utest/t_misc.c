@@ -2,6 +2,7 @@
 * rtklib unit test driver : misc functions
 *-----------------------------------------------------------------------------*/
 #include <stdio.h>
+#include <stdlib.h>
 #include <assert.h>
 #include "../../src/rtklib.h"
 
@@ -182,11 +183,77 @@ void utest4(void)
     
     printf("%s utset4 : OK\n",__FILE__);
 }
+/* str2dec(), str2num() */
+void utest5(void)
+{
+    const char *str[]={
+        "  20123456.789","-100000000.001","      -123.000","         0.005",
+        " 0.123456789012D+02","-0.123456789012D-08"," 0.100000000000D+01",
+        "   1.5e3","  -0","  .5","5.","1.5E","1.5D+","abc","  0x10","inf",
+        "1234567890123456789012","1E-400","  12  34",""
+    };
+    char buff[64],*p;
+    double v1,v2;
+    int i,n;
+
+    for (i=0;i<(int)(sizeof(str)/sizeof(*str));i++) {
+        for (n=0;n<=(int)strlen(str[i]);n++) {
+            strncpy(buff,str[i],n); buff[n]='\0';
+            for (p=buff;*p;p++) if (*p=='D'||*p=='d') *p='E';
+            v1=str2dec(str[i],n);
+            v2=strtod(buff,NULL);
+            assert(v1==v2&&signbit(v1)==signbit(v2));
+        }
+    }
+    for (i=0;i<100000;i++) { /* F14.3 and D19.12 */
+        v2=(rand()/(double)RAND_MAX-0.5)*pow(10.0,rand()%10);
+        sprintf(buff,"%14.3f",v2);
+        assert(str2dec(buff,14)==strtod(buff,NULL));
+        sprintf(buff,"%19.12E",v2);
+        v1=strtod(buff,NULL);
+        buff[15]='D';
+        assert(str2dec(buff,19)==v1);
+    }
+    strcpy(buff,"ABC   12.500");
+    assert(str2num(buff,3,9)==12.5);
+    assert(str2num(buff,12,3)==0.0&&str2num(buff,13,3)==0.0);
+
+    printf("%s utset5 : OK\n",__FILE__);
+}
+/* latinit(), latadd(), latquant() */
+void utest6(void)
+{
+    static latstat_t lat;
+    double p50,p99,max;
+    int i,n;
+
+    latinit(&lat,0);
+    assert(latstart(&lat)==0);
+    latadd(&lat,LATSTG_FILT,0);
+    latquant(&lat,LATSTG_FILT,&n,&p50,&p99,&max);
+    assert(n==0&&p50==0.0&&p99==0.0&&max==0.0);
+
+    latinit(&lat,1);
+    for (i=0;i<100;i++) {
+        latadd(&lat,LATSTG_FILT,latstart(&lat));
+    }
+    latadd(&lat,LATSTG_OUT,tickgetus()-5000);
+    latquant(&lat,LATSTG_FILT,&n,&p50,&p99,&max);
+    assert(n==100&&p50<=p99&&p99<=max*1.25+1.0);
+    latquant(&lat,LATSTG_OUT,&n,&p50,&p99,&max);
+    assert(n==1&&max>=5000.0&&p50>=5000.0&&p50<=max*1.25);
+    latquant(&lat,LATSTG_READ,&n,&p50,&p99,&max);
+    assert(n==0);
+
+    printf("%s utset6 : OK\n",__FILE__);
+}
 int main(void)
 {
     utest1();
     utest2();
     utest3();
     utest4();
+    utest5();
+    utest6();
     return 0;
 }
@@ -0,0 +1,240 @@
+/*------------------------------------------------------------------------------
+* rtklib unit test driver : rtcm and receiver raw data input by buffer
+*-----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <assert.h>
+#include "../../src/rtklib.h"
+
+#define MAXMSG      100000
+#define MAXBUFF     (1024*1024)
+
+typedef struct {            /* decoded message record */
+    int ret,n;
+    double time,sum;
+} msg_t;
+
+/* record decoded message ----------------------------------------------------*/
+static void recmsg(msg_t *msg, int *nmsg, int ret, const obs_t *obs,
+                   const nav_t *nav, gtime_t time)
+{
+    int i;
+
+    if (!ret||*nmsg>=MAXMSG) return;
+    msg[*nmsg].ret=ret;
+    msg[*nmsg].n=ret==1?obs->n:0;
+    msg[*nmsg].time=time2gpst(time,NULL);
+    msg[*nmsg].sum=0.0;
+    if (ret==1) {
+        for (i=0;i<obs->n;i++) {
+            msg[*nmsg].sum+=obs->data[i].P[0]+obs->data[i].L[0];
+        }
+    }
+    else if (ret==9) {
+        for (i=0;i<8;i++) msg[*nmsg].sum+=nav->ion_gps[i];
+    }
+    (*nmsg)++;
+}
+/* decode stream byte by byte ------------------------------------------------*/
+static int decbyte(int format, const uint8_t *buff, int n, msg_t *msg)
+{
+    rtcm_t rtcm={0};
+    raw_t raw={{0}};
+    int i,ret,nmsg=0;
+
+    if (format==STRFMT_RTCM3) {
+        assert(init_rtcm(&rtcm));
+        for (i=0;i<n;i++) {
+            ret=input_rtcm3(&rtcm,buff[i]);
+            if (rtcm.nbyte_invalid) {
+                i-=rtcm.nbyte_invalid-1; /* rewind to last preamble+1 */
+                rtcm.nbyte_invalid=0;
+            }
+            recmsg(msg,&nmsg,ret,&rtcm.obs,&rtcm.nav,rtcm.time);
+        }
+        free_rtcm(&rtcm);
+    }
+    else {
+        assert(init_raw(&raw,format));
+        for (i=0;i<n;i++) {
+            ret=input_raw(&raw,format,buff[i]);
+            recmsg(msg,&nmsg,ret,&raw.obs,&raw.nav,raw.time);
+        }
+        free_raw(&raw);
+    }
+    return nmsg;
+}
+/* decode stream by buffers of size nb ---------------------------------------*/
+static int decbuff(int format, const uint8_t *buff, int n, int nb, msg_t *msg)
+{
+    rtcm_t rtcm={0};
+    raw_t raw={{0}};
+    int i,j,m,k,ret,nmsg=0;
+
+    if (format==STRFMT_RTCM3) assert(init_rtcm(&rtcm));
+    else assert(init_raw(&raw,format));
+
+    for (i=0;i<n;i+=nb) {
+        k=n-i<nb?n-i:nb;
+        for (j=0;j<k;j+=m) {
+            if (format==STRFMT_RTCM3) {
+                m=input_rtcm3b(&rtcm,buff+i+j,k-j,&ret);
+                recmsg(msg,&nmsg,ret,&rtcm.obs,&rtcm.nav,rtcm.time);
+            }
+            else {
+                m=input_rawb(&raw,format,buff+i+j,k-j,&ret);
+                recmsg(msg,&nmsg,ret,&raw.obs,&raw.nav,raw.time);
+            }
+            assert(m>0||ret);
+        }
+    }
+    if (format==STRFMT_RTCM3) free_rtcm(&rtcm); else free_raw(&raw);
+    return nmsg;
+}
+/* compare decoded messages --------------------------------------------------*/
+static void cmpmsg(const msg_t *msg1, int n1, const msg_t *msg2, int n2)
+{
+    int i;
+
+    assert(n1==n2);
+    for (i=0;i<n1;i++) {
+        assert(msg1[i].ret==msg2[i].ret);
+        assert(msg1[i].n==msg2[i].n);
+        assert(msg1[i].time==msg2[i].time);
+        assert(msg1[i].sum==msg2[i].sum);
+    }
+}
+/* read file -----------------------------------------------------------------*/
+static int readfile(const char *file, uint8_t *buff)
+{
+    FILE *fp;
+    int n;
+
+    fp=fopen(file,"rb");
+        assert(fp);
+    n=(int)fread(buff,1,MAXBUFF,fp);
+    fclose(fp);
+    return n;
+}
+/* test byte and buffer input ------------------------------------------------*/
+static void testbuff(int format, const uint8_t *buff, int n, int nmin)
+{
+    static msg_t msg1[MAXMSG],msg2[MAXMSG];
+    const int nb[]={1,2,7,100,1024,4096,MAXBUFF};
+    int i,n1,n2;
+
+    n1=decbyte(format,buff,n,msg1);
+        assert(n1>=nmin);
+
+    for (i=0;i<(int)(sizeof(nb)/sizeof(*nb));i++) {
+        n2=decbuff(format,buff,n,nb[i],msg2);
+        cmpmsg(msg1,n1,msg2,n2);
+    }
+    printf("format=%2d bytes=%7d msgs=%5d OK\n",format,n,n1);
+}
+/* input_rtcm3b() ------------------------------------------------------------*/
+static void utest1(void)
+{
+    const char *file="../data/rcvraw/GMSD7_20121014.rtcm3";
+    static uint8_t buff[MAXBUFF];
+    int i,n;
+
+    n=readfile(file,buff);
+    testbuff(STRFMT_RTCM3,buff,n,300);
+
+    /* corrupted stream */
+    for (i=0;i<n;i+=997) buff[i]^=0x5A;
+    testbuff(STRFMT_RTCM3,buff,n,200);
+}
+/* input_rawb() for ublox ----------------------------------------------------*/
+static void utest2(void)
+{
+    const char *file="../data/rcvraw/ubx_20080526.ubx";
+    static uint8_t buff[MAXBUFF];
+    int i,n;
+
+    n=readfile(file,buff);
+    testbuff(STRFMT_UBX,buff,n,500);
+
+    /* corrupted stream */
+    for (i=0;i<n;i+=997) buff[i]^=0x5A;
+    testbuff(STRFMT_UBX,buff,n,100);
+}
+/* crc-16-ccitt --------------------------------------------------------------*/
+static uint16_t crc16(const uint8_t *buff, int len)
+{
+    uint16_t crc=0;
+    int i,j;
+
+    for (i=0;i<len;i++) {
+        crc^=(uint16_t)buff[i]<<8;
+        for (j=0;j<8;j++) crc=crc&0x8000?(crc<<1)^0x1021:crc<<1;
+    }
+    return crc;
+}
+/* input_rawb() for septentrio sbf -------------------------------------------*/
+static void utest3(void)
+{
+    static uint8_t buff[MAXBUFF];
+    uint8_t *p;
+    uint16_t u;
+    uint32_t tow;
+    float ion;
+    int i,j,n=0;
+
+    /* generate GPSIon blocks with partial sync fields between blocks */
+    for (i=0;i<5000;i++) {
+        p=buff+n;
+        memset(p,0,48);
+        p[0]='$'; p[1]='@';
+        u=5893; memcpy(p+4,&u,2);
+        u=48;   memcpy(p+6,&u,2);
+        tow=(uint32_t)i*1000; memcpy(p+8,&tow,4);
+        u=1700; memcpy(p+12,&u,2);
+        for (j=0;j<8;j++) {
+            ion=(float)(i*8+j); memcpy(p+16+j*4,&ion,4);
+        }
+        u=crc16(p+4,44); memcpy(p+2,&u,2);
+        n+=48;
+        for (j=0;j<i%5;j++) buff[n++]="$A@$"[j];
+    }
+    testbuff(STRFMT_SEPT,buff,n,5000);
+
+    /* corrupted stream */
+    for (i=0;i<n;i+=997) buff[i]^=0x5A;
+    testbuff(STRFMT_SEPT,buff,n,4000);
+}
+/* input_rtcm3f() -----------------------------------------------------------*/
+static void utest4(void)
+{
+    const char *file="../data/rcvraw/GMSD7_20121014.rtcm3";
+    static msg_t msg1[MAXMSG],msg2[MAXMSG];
+    static uint8_t buff[MAXBUFF];
+    rtcm_t rtcm={0};
+    FILE *fp;
+    int i,n,n1,n2=0,ret;
+
+    n=readfile(file,buff);
+    for (i=0;i<n;i+=997) buff[i]^=0x5A;
+    n1=decbyte(STRFMT_RTCM3,buff,n,msg1);
+
+    fp=tmpfile();
+        assert(fp);
+    fwrite(buff,1,n,fp);
+    rewind(fp);
+    assert(init_rtcm(&rtcm));
+    while ((ret=input_rtcm3f(&rtcm,fp))>=-1) {
+        recmsg(msg2,&n2,ret,&rtcm.obs,&rtcm.nav,rtcm.time);
+    }
+    free_rtcm(&rtcm);
+    fclose(fp);
+    cmpmsg(msg1,n1,msg2,n2);
+    printf("input_rtcm3f msgs=%5d OK\n",n2);
+}
+int main(int argc, char **argv)
+{
+    utest1();
+    utest2();
+    utest3();
+    utest4();
+    return 0;
+}
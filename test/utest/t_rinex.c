@@ -2,6 +2,7 @@
 * rtklib unit test driver : rinex function
 *-----------------------------------------------------------------------------*/
 #include <stdio.h>
+#include <stdlib.h>
 #include <assert.h>
 #include "../../src/rtklib.h"
 
@@ -208,6 +209,148 @@ void utest6(void)
     }
     printf("%s utest6 : OK\n",__FILE__);
 }
+/* outrnxobsb(), outrnxnavb() fields compared with printf */
+void utest7(void)
+{
+    rnxopt_t opt={{0}};
+    obsd_t data={{0}};
+    eph_t eph={0};
+    FILE *fp;
+    double val,e;
+    char buff[1024],str[64],*p;
+    int i,j;
+
+    opt.rnxver=304;
+    opt.navsys=SYS_GPS;
+    opt.nobs[0]=2;
+    strcpy(opt.tobs[0][0],"C1C");
+    strcpy(opt.tobs[0][1],"L1C");
+    for (i=0;i<MAXCODE;i++) opt.mask[0][i]='1';
+    data.sat=eph.sat=1;
+    data.code[0]=CODE_L1C;
+    eph.toc=eph.ttr=epoch2time((double []){2020,1,1,0,0,0});
+    srand(0);
+
+    for (i=0;i<100000;i++) {
+        val=(rand()/(double)RAND_MAX-0.5)*pow(10.0,rand()%12-2);
+        if (i%4==0) val=floor(val*1000.0)/1000.0+0.0005; /* near to tie */
+        data.P[0]=val;
+        data.L[0]=-val;
+        eph.f0=val;
+
+        fp=tmpfile();
+            assert(fp);
+        outrnxobsb(fp,&opt,&data,1,0);
+        outrnxnavb(fp,&opt,&eph);
+        rewind(fp);
+        p=fgets(buff,sizeof(buff),fp);
+            assert(p);
+        p=fgets(buff,sizeof(buff),fp);
+            assert(p);
+        for (j=0;j<2;j++) {
+            sprintf(str,"%14.3f",fmod(j?-val:val,1e9));
+            assert(!strncmp(buff+3+j*16,str,14));
+        }
+        p=fgets(buff,sizeof(buff),fp);
+            assert(p);
+        e=(fabs(val)<1E-99)?0.0:floor(log10(fabs(val))+1.0);
+        sprintf(str," %s.%012.0f%s%+03.0f",val<0.0?"-":" ",
+                fabs(val)/pow(10.0,e-12),"D",e);
+        assert(!strncmp(buff+23,str,strlen(str)));
+        fclose(fp);
+    }
+    printf("%s utest7 : OK\n",__FILE__);
+}
+/* read product files --------------------------------------------------------*/
+static void readprod(nav_t *nav, pcvs_t *pcvs)
+{
+    gtime_t t0={0};
+    obs_t obs={0};
+    sta_t sta={""};
+
+    readrnxt("../data/rinex/07590920.05o",1,t0,t0,0.0,"",&obs,nav,&sta);
+    readrnxt("../data/rinex/brdc1820.10n",1,t0,t0,0.0,"",&obs,nav,&sta);
+    readrnxt("../data/rinex/brdc0910.09g",1,t0,t0,0.0,"",&obs,nav,&sta);
+    readrnxc("../data/sp3/igs15904.clk",nav);
+    readsp3("../data/sp3/igs15904.sp3",nav,0);
+    readpcv("../../data/ant/gnssant_ext.atx",pcvs);
+    freeobs(&obs);
+}
+/* compare product data ------------------------------------------------------*/
+static int cmpprod(const nav_t *nav1, const pcvs_t *pcvs1, const nav_t *nav2,
+                   const pcvs_t *pcvs2)
+{
+    return nav1->n==nav2->n&&nav1->ng==nav2->ng&&nav1->ne==nav2->ne&&
+           nav1->nc==nav2->nc&&pcvs1->n==pcvs2->n&&
+           !memcmp(nav1->eph ,nav2->eph ,sizeof(eph_t )*nav1->n )&&
+           !memcmp(nav1->geph,nav2->geph,sizeof(geph_t)*nav1->ng)&&
+           !memcmp(nav1->peph,nav2->peph,sizeof(peph_t)*nav1->ne)&&
+           !memcmp(nav1->pclk,nav2->pclk,sizeof(pclk_t)*nav1->nc)&&
+           !memcmp(pcvs1->pcv,pcvs2->pcv,sizeof(pcv_t)*pcvs1->n)&&
+           !memcmp(nav1->ion_gps,nav2->ion_gps,sizeof(nav1->ion_gps))&&
+           !memcmp(nav1->utc_gps,nav2->utc_gps,sizeof(nav1->utc_gps))&&
+           !memcmp(nav1->glo_fcn,nav2->glo_fcn,sizeof(nav1->glo_fcn));
+}
+/* setprodcache(), loadprodcache(), saveprodcache() */
+void utest8(void)
+{
+    static nav_t nav[4];
+    pcvs_t pcvs[4]={{0}};
+    FILE *fp;
+    char *paths[256],dir[]="pcache";
+    int32_t nrec=-1;
+    int i,n,ret,nhit,nmiss;
+
+    for (i=0;i<256;i++) paths[i]=(char *)malloc(1024);
+    n=expath("pcache/*.pch",paths,256);
+    for (i=0;i<n;i++) remove(paths[i]);
+
+    setprodcache("");
+    readprod(nav,pcvs);
+        assert(nav[0].n>0&&nav[0].ng>0&&nav[0].ne>0&&nav[0].nc>0&&pcvs[0].n>0);
+    ret=getprodcache(&nhit,&nmiss);
+        assert(!ret);
+
+    setprodcache(dir); /* parse and save to cache */
+    readprod(nav+1,pcvs+1);
+    ret=getprodcache(&nhit,&nmiss);
+        assert(ret&&nhit==0&&nmiss==5);
+    ret=cmpprod(nav,pcvs,nav+1,pcvs+1);
+        assert(ret);
+
+    setprodcache(dir); /* load from cache */
+    readprod(nav+2,pcvs+2);
+    ret=getprodcache(&nhit,&nmiss);
+        assert(ret&&nhit==5&&nmiss==0);
+    ret=cmpprod(nav,pcvs,nav+2,pcvs+2);
+        assert(ret);
+
+    /* corrupted record count in cache header rejected */
+    n=expath("pcache/*.pch",paths,256);
+        assert(n==5);
+    fp=fopen(paths[0],"r+b");
+        assert(fp);
+    fseek(fp,48,SEEK_SET); /* n[0] of header */
+    fwrite(&nrec,sizeof(nrec),1,fp);
+    fclose(fp);
+    setprodcache(dir);
+    readprod(nav+3,pcvs+3);
+    ret=getprodcache(&nhit,&nmiss);
+        assert(ret&&nhit==4&&nmiss==1);
+    ret=cmpprod(nav,pcvs,nav+3,pcvs+3);
+        assert(ret);
+
+    setprodcache("");
+    for (i=0;i<4;i++) {
+        freenav(nav+i,0xFF);
+        free(pcvs[i].pcv);
+    }
+    n=expath("pcache/*.pch",paths,256);
+    for (i=0;i<n;i++) remove(paths[i]);
+    for (i=0;i<256;i++) free(paths[i]);
+
+    printf("%s utest8 : OK\n",__FILE__);
+}
 int main(int argc, char **argv)
 {
     utest1();
@@ -216,5 +359,7 @@ int main(int argc, char **argv)
     utest4();
     utest5();
     utest6();
+    utest7();
+    utest8();
     return 0;
 }
@@ -0,0 +1,304 @@
+/*------------------------------------------------------------------------------
+* rtklib unit test driver : rtk server status snapshot
+*-----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "../../src/rtklib.h"
+
+#define NREADER     4           /* number of status reader threads */
+#define CYCLE       10          /* server cycle (ms) */
+#define BUFFSIZE    4096        /* input buffer size (bytes) */
+#define TIDLE       1000        /* idle time to end replay (ms) */
+#define TWAIT       30000       /* timeout of replay (ms) */
+#define FILE_RAW    "../data/rcvraw/ubx_20080526.ubx"
+#define FILE_REP    "rtksvr_replay.ubx" /* time-tagged replay file */
+
+static rtksvr_t svr;            /* rtk server */
+static volatile int stop=0;     /* stop flag of reader threads */
+
+typedef struct {                /* reader thread record */
+    uint32_t nread;             /* number of snapshots read */
+    uint32_t nsol;              /* number of single solutions checked */
+} reader_t;
+
+/* dummy functions of application --------------------------------------------*/
+extern int showmsg(const char *format, ...) {return 0;}
+extern void settspan(gtime_t ts, gtime_t te) {}
+extern void settime(gtime_t time) {}
+
+/* check consistency of status snapshot --------------------------------------*/
+static int chkstat(const svrstat_t *stat, reader_t *rd)
+{
+    int i,j,ns=0;
+
+    assert(!(stat->seq&1));
+    assert(stat->nobs[0]>=0&&stat->nobs[0]<=MAXOBS);
+    for (i=0;i<stat->nobs[0];i++) {
+        assert(stat->sat[0][i]>=1&&stat->sat[0][i]<=MAXSAT);
+        for (j=0;j<NFREQ;j++) assert(stat->snr[0][i][j]>=0.0);
+    }
+    if (stat->sol.stat!=SOLQ_SINGLE) return 1;
+
+    /* number of valid satellites equals to valid flags of satellite status */
+    for (i=0;i<MAXSAT;i++) ns+=stat->ssat[i].vs;
+    assert(ns==stat->sol.ns);
+    rd->nsol++;
+    return 1;
+}
+/* status reader thread ------------------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI readthread(void *arg)
+#else
+static void *readthread(void *arg)
+#endif
+{
+    reader_t *rd=(reader_t *)arg;
+    svrstat_t *stat=(svrstat_t *)malloc(sizeof(svrstat_t));
+    gtime_t time,tsol={0};
+    double az[MAXOBS],el[MAXOBS];
+    int i,ns,sat[MAXOBS],snr[MAXOBS][NFREQ],*psnr[MAXOBS],vsat[MAXOBS];
+    int sstat[MAXSTRRTK];
+    uint32_t count=0;
+    char msg[MAXSTRMSG*MAXSTRRTK];
+
+    assert(stat);
+    for (i=0;i<MAXOBS;i++) psnr[i]=snr[i];
+
+    while (!stop) {
+        if (rtksvrstat(&svr,stat)) {
+            assert(stat->count>=count);
+            count=stat->count;
+            if (stat->sol.stat!=SOLQ_NONE) {
+                assert(timediff(stat->sol.time,tsol)>=0.0);
+                tsol=stat->sol.time;
+            }
+            chkstat(stat,rd);
+            rd->nread++;
+        }
+        ns=rtksvrostat(&svr,0,&time,sat,az,el,psnr,vsat);
+        assert(ns<=MAXOBS);
+        rtksvrsstat(&svr,sstat,msg);
+    }
+    free(stat);
+    return 0;
+}
+/* rtksvrstat(), rtksvrostat(), rtksvrsstat() during replay */
+void utest1(void)
+{
+    prcopt_t prcopt=prcopt_default;
+    solopt_t solopt[2];
+    rtklib_thread_t thread[NREADER];
+    reader_t rd[NREADER]={{0}};
+    svrstat_t *stat=(svrstat_t *)malloc(sizeof(svrstat_t));
+    const char *paths[8]={FILE_RAW,"","","","","","",""};
+    const char *cmds[3]={0},*ropts[3]={"","",""};
+    double npos[3]={0};
+    char errmsg[256];
+    uint32_t tick,tick0,tickl,n,nl=0;
+    int i,ret,strs[8]={STR_FILE},formats[3]={STRFMT_UBX,STRFMT_UBX,STRFMT_RTCM3};
+
+    assert(stat);
+    prcopt.mode=PMODE_SINGLE;
+    prcopt.navsys=SYS_GPS;
+    solopt[0]=solopt[1]=solopt_default;
+
+    ret=rtksvrinit(&svr);
+        assert(ret);
+    ret=rtksvrstat(&svr,stat);
+        assert(!ret);
+
+    for (i=0;i<NREADER;i++) {
+#ifdef WIN32
+        ret=(thread[i]=CreateThread(NULL,0,readthread,rd+i,0,NULL))!=NULL;
+#else
+        ret=!pthread_create(thread+i,NULL,readthread,rd+i);
+#endif
+        assert(ret);
+    }
+    ret=rtksvrstart(&svr,CYCLE,BUFFSIZE,strs,paths,formats,0,cmds,cmds,
+                    ropts,0,0,npos,&prcopt,solopt,NULL,errmsg);
+        assert(ret);
+
+    /* wait for end of replay */
+    for (tick0=tickl=tickget();(int)(tickget()-tick0)<TWAIT;) {
+        sleepms(100);
+        tick=tickget();
+        if (!rtksvrstat(&svr,stat)) continue;
+        if ((n=stat->nmsg[0][0])!=nl) {
+            nl=n;
+            tickl=tick;
+        }
+        else if ((int)(tick-tickl)>=TIDLE) break;
+    }
+    assert((int)(tickget()-tick0)<TWAIT);
+    stop=1;
+    for (i=0;i<NREADER;i++) {
+#ifdef WIN32
+        WaitForSingleObject(thread[i],INFINITE);
+        CloseHandle(thread[i]);
+#else
+        pthread_join(thread[i],NULL);
+#endif
+    }
+    /* last snapshot equals to server status */
+    ret=rtksvrstat(&svr,stat);
+        assert(ret);
+    assert(stat->nobs[0]>0&&stat->sol.stat==SOLQ_SINGLE);
+    assert(timediff(stat->sol.time,svr.rtk.sol.time)==0.0);
+    assert(stat->nsolq[SOLQ_SINGLE]==svr.nsolq[SOLQ_SINGLE]);
+
+    for (i=0;i<NREADER;i++) {
+        printf("reader %d: snapshots=%u single=%u\n",i,rd[i].nread,rd[i].nsol);
+        assert(rd[i].nread>0&&rd[i].nsol>0);
+    }
+    rtksvrstop(&svr,cmds);
+    rtksvrfree(&svr);
+    free(stat);
+
+    printf("%s utest1 : OK\n",__FILE__);
+}
+/* generate time-tagged replay file by observation times ---------------------*/
+static double gentag(const char *file, const char *tagfile, int *nep)
+{
+    FILE *fp,*ofp,*tfp;
+    raw_t raw;
+    gtime_t time0={0};
+    double sec;
+    uint32_t tick=0,fpos=0;
+    char tagh[64]="TIMETAG RTKLIB test";
+    int c,ret;
+
+    fp=fopen(FILE_RAW,"rb");
+        assert(fp);
+    ofp=fopen(file,"wb");
+        assert(ofp);
+    tfp=fopen(tagfile,"wb");
+        assert(tfp);
+    ret=init_raw(&raw,STRFMT_UBX);
+        assert(ret);
+
+    for (*nep=0;(c=fgetc(fp))!=EOF;) {
+        fputc(c,ofp);
+        fpos++;
+        if (input_raw(&raw,STRFMT_UBX,(uint8_t)c)!=1) continue;
+
+        if (!time0.time) { /* header: HEADER(64)+TIME(4+8) */
+            time0=raw.time;
+            tick=(uint32_t)time0.time;
+            sec=time0.sec;
+            fwrite(tagh,1,sizeof(tagh),tfp);
+            fwrite(&tick,1,sizeof(tick),tfp);
+            fwrite(&sec ,1,sizeof(sec ),tfp);
+        }
+        /* record: TICK(4)+FPOS(4) at end of observation data */
+        tick=(uint32_t)(timediff(raw.time,time0)*1000.0+0.5);
+        fwrite(&tick,1,sizeof(tick),tfp);
+        fwrite(&fpos,1,sizeof(fpos),tfp);
+        (*nep)++;
+    }
+    free_raw(&raw);
+    fclose(fp); fclose(ofp); fclose(tfp);
+    assert(time0.time);
+    return tick*0.001;
+}
+/* replay time-tagged file and write solutions -------------------------------*/
+static void replay(const char *outfile, int nep)
+{
+    prcopt_t prcopt=prcopt_default;
+    solopt_t solopt[2];
+    gtime_t time;
+    const char *paths[8]={FILE_REP"::T","","",outfile,"","","",""};
+    const char *cmds[3]={0},*ropts[3]={"","",""};
+    double npos[3]={0};
+    char errmsg[256];
+    uint32_t tick;
+    int i,n=0,ret,strs[8]={STR_FILE,0,0,STR_FILE};
+    int formats[3]={STRFMT_UBX,STRFMT_UBX,STRFMT_RTCM3};
+
+    prcopt.mode=PMODE_SINGLE;
+    prcopt.navsys=SYS_GPS;
+    solopt[0]=solopt[1]=solopt_default;
+    solopt[0].outhead=0;
+
+    ret=rtksvrinit(&svr);
+        assert(ret);
+    svr.replay=1;
+    ret=rtksvrstart(&svr,CYCLE,BUFFSIZE,strs,paths,formats,0,cmds,cmds,
+                    ropts,0,0,npos,&prcopt,solopt,NULL,errmsg);
+        assert(ret);
+
+    /* wait for end of replay: all epochs processed by rtk server */
+    for (tick=tickget();(int)(tickget()-tick)<TWAIT;sleepms(10)) {
+        rtksvrlock(&svr);
+        for (i=n=0;i<=MAXSOLQ;i++) n+=svr.nsolq[i];
+        n+=svr.prcout;
+        rtksvrunlock(&svr);
+        if (n>=nep&&!strreptime(svr.stream,&time)) break;
+    }
+    printf("replay: epochs=%d processed=%d\n",nep,n);
+    assert(n>=nep);
+    assert(svr.nsolq[SOLQ_SINGLE]>0);
+    rtksvrstop(&svr,cmds);
+    rtksvrfree(&svr);
+}
+/* compare files -------------------------------------------------------------*/
+static int cmpfile(const char *file1, const char *file2)
+{
+    FILE *fp1,*fp2;
+    char buff1[1024],buff2[1024];
+    int n=0,stat=1;
+
+    fp1=fopen(file1,"r");
+        assert(fp1);
+    fp2=fopen(file2,"r");
+        assert(fp2);
+    for (;;) {
+        if (!fgets(buff1,sizeof(buff1),fp1)) {
+            stat=!fgets(buff2,sizeof(buff2),fp2);
+            break;
+        }
+        if (!fgets(buff2,sizeof(buff2),fp2)||strcmp(buff1,buff2)) {
+            stat=0;
+            break;
+        }
+        n++;
+    }
+    fclose(fp1); fclose(fp2);
+    return stat?n:-1;
+}
+/* replay by time-tags with no wait */
+void utest2(void)
+{
+    double span;
+    uint32_t tick;
+    int n,nep;
+
+    span=gentag(FILE_REP,FILE_REP".tag",&nep);
+        assert(nep>0);
+
+    tick=tickget();
+    replay("rtksvr_replay1.pos",nep);
+    tick=tickget()-tick;
+    replay("rtksvr_replay2.pos",nep);
+
+    /* solutions reproducible and replay faster than real time */
+    n=cmpfile("rtksvr_replay1.pos","rtksvr_replay2.pos");
+    printf("replay: span=%.1fs time=%.3fs solutions=%d\n",span,tick*0.001,n);
+    assert(n>0);
+    assert(tick*0.001<span);
+
+    remove(FILE_REP);
+    remove(FILE_REP".tag");
+    remove("rtksvr_replay1.pos");
+    remove("rtksvr_replay2.pos");
+
+    printf("%s utest2 : OK\n",__FILE__);
+}
+int main(void)
+{
+    utest1();
+    utest2();
+    return 0;
+}
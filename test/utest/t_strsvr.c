@@ -0,0 +1,147 @@
+/*------------------------------------------------------------------------------
+* rtklib unit test driver : stream server with stalled network output
+*-----------------------------------------------------------------------------*/
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "../../src/rtklib.h"
+
+/* dummy functions of application --------------------------------------------*/
+extern int showmsg(const char *format, ...) {return 0;}
+extern void settspan(gtime_t ts, gtime_t te) {}
+extern void settime(gtime_t time) {}
+
+#ifndef WIN32
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define NMSG        20          /* number of input messages */
+#define MSGLEN      100         /* length of input message (bytes) */
+#define TMSG        50          /* interval of input messages (ms) */
+#define TRECV       3000        /* receive timeout (ms) */
+#define RELAYMSG    "RELAYBACK" /* message relayed back from output */
+
+static strsvr_t svr;            /* stream server */
+
+/* open local listening socket -----------------------------------------------*/
+static int openlisten(char *path)
+{
+    struct sockaddr_in addr={0};
+    socklen_t len=sizeof(addr);
+    int sock,ret;
+
+    addr.sin_family=AF_INET;
+    addr.sin_addr.s_addr=htonl(INADDR_LOOPBACK);
+    sock=socket(AF_INET,SOCK_STREAM,0);
+        assert(sock>=0);
+    ret=bind(sock,(struct sockaddr *)&addr,sizeof(addr));
+        assert(!ret);
+    ret=listen(sock,4);
+        assert(!ret);
+    ret=getsockname(sock,(struct sockaddr *)&addr,&len);
+        assert(!ret);
+    sprintf(path,"127.0.0.1:%d",ntohs(addr.sin_port));
+    return sock;
+}
+/* accept connection with receive timeout ------------------------------------*/
+static int acceptto(int lsock)
+{
+    struct timeval tv={TRECV/1000,0};
+    int sock;
+
+    sock=accept(lsock,NULL,NULL);
+        assert(sock>=0);
+    setsockopt(sock,SOL_SOCKET,SO_RCVTIMEO,&tv,sizeof(tv));
+    close(lsock);
+    return sock;
+}
+/* receive n bytes until timeout ---------------------------------------------*/
+static int recvn(int sock, char *buff, int n)
+{
+    int m,nr=0;
+
+    while (nr<n&&(m=recv(sock,buff+nr,n-nr,0))>0) nr+=m;
+    return nr;
+}
+/* relay with output stream stalled by writer holding stream lock ----------*/
+static void utest1(void)
+{
+    const char *paths[3],*logs[3]={"","",""},*cmds[3]={0},*cmds_p[3]={0};
+    char path[3][64],msg[MSGLEN],buff[NMSG*MSGLEN+MSGLEN];
+    strconv_t *conv[2]={0};
+    int i,n,ret,lsock[3],src,cas,snk,strs[3]={STR_TCPCLI,STR_TCPCLI,STR_TCPCLI};
+    int opts[8]={10000,100,1000,32768,10,0,30,1}; /* relay back output 1 */
+    int nrel=(int)strlen(RELAYMSG);
+    uint32_t tick;
+
+    for (i=0;i<3;i++) {
+        lsock[i]=openlisten(path[i]);
+        paths[i]=path[i];
+    }
+    memset(msg,'x',sizeof(msg));
+
+    strsvrinit(&svr,2);
+    svr.qsize=65536;
+    ret=strsvrstart(&svr,opts,strs,paths,logs,conv,cmds,cmds_p,NULL);
+        assert(ret);
+
+    /* input (source), output 1 (caster) and output 2 (sink) connections */
+    src=acceptto(lsock[0]);
+    n=send(src,msg,MSGLEN,0);
+        assert(n==MSGLEN);
+    cas=acceptto(lsock[1]);
+    snk=acceptto(lsock[2]);
+    n=recvn(snk,buff,MSGLEN);
+        assert(n==MSGLEN);
+
+    /* output 1 stalled: stream locked as by a blocked write */
+    strlock(svr.stream+1);
+    tick=tickget();
+
+    for (i=0;i<NMSG;i++) {
+        n=send(src,msg,MSGLEN,0);
+            assert(n==MSGLEN);
+        sleepms(TMSG);
+    }
+    /* output 2 receives all data while output 1 is stalled */
+    n=recvn(snk,buff,NMSG*MSGLEN);
+    tick=tickget()-tick;
+        assert(n==NMSG*MSGLEN);
+        assert((int)tick<NMSG*TMSG+TRECV/2);
+        assert(!memcmp(buff,msg,MSGLEN));
+
+    /* relay back from output 1 resumes after the stall */
+    n=send(cas,RELAYMSG,nrel,0);
+        assert(n==nrel);
+    sleepms(100);
+    strunlock(svr.stream+1);
+    n=recvn(src,buff,nrel);
+        assert(n==nrel);
+        assert(!strncmp(buff,RELAYMSG,nrel));
+
+    /* queued data written to output 1 after the stall */
+    n=recvn(cas,buff,(NMSG+1)*MSGLEN);
+        assert(n==(NMSG+1)*MSGLEN);
+
+    strsvrstop(&svr,cmds);
+    close(src); close(cas); close(snk);
+
+    printf("%s utest1 : OK\n",__FILE__);
+}
+int main(void)
+{
+    utest1();
+    return 0;
+}
+#else
+int main(void)
+{
+    printf("local tcp server not supported: skipped\n");
+    return 0;
+}
+#endif
@@ -2,6 +2,8 @@
 * rtklib unit test driver : norad two line element function
 *-----------------------------------------------------------------------------*/
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #include "../../src/rtklib.h"
 
@@ -151,11 +153,64 @@ static void utest3(void)
     }
     fprintf(OUT,"%s utest3 : OK\n",__FILE__);
 }
+/* tle_index(), tle_pos_batch() ---------------------------------------------*/
+static void utest4(void)
+{
+    const char *file1="../data/tle/TLE_GNSS_20121101.txt";
+    const char *file2="../data/tle/igs17127.erp";
+    const double ep[6]={2012,10,31,0,0,0};
+    erp_t erp={0};
+    tle_t tle={0};
+    gtime_t time[96];
+    char sat[16];
+    double *rs,rs1[6];
+    int i,j,k,n,ret,nok=0,index[MAXSAT+1],*stat;
+
+    ret=readerp(file2,&erp);
+        assert(ret);
+    ret=tle_read(file1,&tle);
+        assert(ret);
+
+    for (j=0;j<MAXSAT;j++) {
+        satno2id(j+1,sat);
+        index[j]=tle_index(sat,"","",&tle);
+    }
+    index[MAXSAT]=tle_index("TEST_ERR","","",&tle);
+        assert(index[MAXSAT]<0);
+
+    for (i=0;i<96;i++) time[i]=timeadd(epoch2time(ep),900.0*i);
+
+    rs=(double *)malloc(sizeof(double)*6*96*(MAXSAT+1));
+    stat=(int *)malloc(sizeof(int)*96*(MAXSAT+1));
+        assert(rs&&stat);
+
+    n=tle_pos_batch(time,96,index,MAXSAT+1,&tle,&erp,rs,stat);
+        assert(n>0);
+
+    /* same results as tle_pos() */
+    for (i=0;i<96;i++) for (j=0;j<=MAXSAT;j++) {
+        if (j<MAXSAT) satno2id(j+1,sat); else strcpy(sat,"TEST_ERR");
+
+        if (!tle_pos(time[i],sat,"","",&tle,&erp,rs1)) {
+            assert(!stat[i*(MAXSAT+1)+j]);
+            continue;
+        }
+        assert(stat[i*(MAXSAT+1)+j]);
+        for (k=0;k<6;k++) assert(rs[(i*(MAXSAT+1)+j)*6+k]==rs1[k]);
+        nok++;
+    }
+    assert(nok==n);
+    free(rs);
+    free(stat);
+
+    fprintf(OUT,"%s utest4 : OK\n",__FILE__);
+}
 /* main ----------------------------------------------------------------------*/
 int main(int argc, char **argv)
 {
     utest1();
     utest2();
     utest3();
+    utest4();
     return 0;
 }
@@ -0,0 +1,206 @@
+/*------------------------------------------------------------------------------
+* strload.c : load test of tcp server and ntrip caster
+*
+*          Copyright (C) 2026 by T.TAKASU, All rights reserved.
+*
+* description : open many tcp/ntrip client connections to a local tcp server or
+*               ntrip caster (e.g. str2str -out tcpsvr://:port or
+*               ntripc://:port/mntpnt), receive the data and print the number
+*               of connected/closed clients and the received data rate.
+*               slow clients, which never read data, can be added to test
+*               eviction of slow clients by the server.
+*
+* version : $Revision:$ $Date:$
+* history : 2026/10/18 1.0 new
+*-----------------------------------------------------------------------------*/
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define MAXCLIS     65536           /* max number of clients */
+
+static const char *help[]={
+"",
+" usage: strload [-n nclis] [-s nslow] [-m mntpnt] [-t sec] [-i intv] addr:port",
+"",
+" Open many client connections to tcp server or ntrip caster and receive data",
+"",
+" -n nclis     number of clients [1000]",
+" -s nslow     number of slow clients never reading data [0]",
+" -m mntpnt    ntrip mountpoint (send ntrip request) [no]",
+" -t sec       test duration (s) [10]",
+" -i intv      status output interval (s) [1]",
+};
+typedef struct {            /* client type */
+    int sock;               /* socket (-1:closed) */
+    int slow;               /* slow client flag */
+    int conn;               /* connected flag */
+    double bytes;           /* received bytes */
+} cli_t;
+
+/* print help ----------------------------------------------------------------*/
+static void printhelp(void)
+{
+    int i;
+    for (i=0;i<(int)(sizeof(help)/sizeof(*help));i++) fprintf(stderr,"%s\n",help[i]);
+    exit(0);
+}
+/* current time (s) ----------------------------------------------------------*/
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    return ts.tv_sec+ts.tv_nsec*1E-9;
+}
+/* open client connection ----------------------------------------------------*/
+static int opencli(const struct sockaddr_in *addr, const char *mntpnt)
+{
+    char req[512];
+    int sock,n;
+    
+    if ((sock=socket(AF_INET,SOCK_STREAM,0))<0) return -1;
+    
+    if (connect(sock,(const struct sockaddr *)addr,sizeof(*addr))<0) {
+        close(sock);
+        return -1;
+    }
+    if (*mntpnt) {
+        n=sprintf(req,"GET /%.256s HTTP/1.0\r\nUser-Agent: NTRIP strload\r\n"
+                  "\r\n",mntpnt);
+        if (send(sock,req,n,0)!=n) {
+            close(sock);
+            return -1;
+        }
+    }
+    fcntl(sock,F_SETFL,fcntl(sock,F_GETFL,0)|O_NONBLOCK);
+    return sock;
+}
+/* main ----------------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+    struct sockaddr_in addr={0};
+    struct rlimit rl;
+    struct pollfd *pfd;
+    cli_t *cli;
+    char *p,*mntpnt="",saddr[256]="127.0.0.1";
+    double t0,t,tout=0.0,tlast,bytes,bytes0=0.0,bmin,bmax,tdur=10.0,intv=1.0;
+    uint8_t buff[65536];
+    int i,j,n,ncli=1000,nslow=0,nconn,nclose=0,nerr=0,nact,port=0;
+    
+    for (i=1;i<argc;i++) {
+        if      (!strcmp(argv[i],"-n")&&i+1<argc) ncli=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-s")&&i+1<argc) nslow=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-m")&&i+1<argc) mntpnt=argv[++i];
+        else if (!strcmp(argv[i],"-t")&&i+1<argc) tdur=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-i")&&i+1<argc) intv=atof(argv[++i]);
+        else if (*argv[i]=='-') printhelp();
+        else if ((p=strrchr(argv[i],':'))) {
+            if (p>argv[i]) sprintf(saddr,"%.*s",(int)(p-argv[i]),argv[i]);
+            port=atoi(p+1);
+        }
+    }
+    if (port<=0||ncli<=0||ncli>MAXCLIS) printhelp();
+    if (nslow>ncli) nslow=ncli;
+    
+    /* raise limit of open files */
+    if (!getrlimit(RLIMIT_NOFILE,&rl)&&rl.rlim_cur<(rlim_t)ncli+64) {
+        rl.rlim_cur=rl.rlim_max<(rlim_t)ncli+64?rl.rlim_max:(rlim_t)ncli+64;
+        setrlimit(RLIMIT_NOFILE,&rl);
+    }
+    addr.sin_family=AF_INET;
+    addr.sin_port=htons(port);
+    if (inet_pton(AF_INET,saddr,&addr.sin_addr)!=1) {
+        fprintf(stderr,"address error: %s\n",saddr);
+        return -1;
+    }
+    if (!(cli=(cli_t *)calloc(ncli,sizeof(cli_t)))||
+        !(pfd=(struct pollfd *)calloc(ncli,sizeof(struct pollfd)))) {
+        fprintf(stderr,"memory allocation error\n");
+        return -1;
+    }
+    /* open client connections */
+    t0=now();
+    for (i=nconn=0;i<ncli;i++) {
+        cli[i].slow=i<nslow;
+        if ((cli[i].sock=opencli(&addr,mntpnt))<0) {
+            nerr++;
+            continue;
+        }
+        cli[i].conn=1;
+        nconn++;
+    }
+    fprintf(stderr,"%d clients connected (%d slow, %d errors) in %.3f s\n",
+            nconn,nslow,nerr,now()-t0);
+    
+    /* receive data */
+    tlast=t0=now();
+    while ((t=now())-t0<tdur) {
+        for (i=n=0;i<ncli;i++) {
+            if (cli[i].sock<0||cli[i].slow) continue;
+            pfd[n].fd=cli[i].sock;
+            pfd[n].events=POLLIN;
+            pfd[n++].revents=0;
+        }
+        if (poll(pfd,n,100)<0&&errno!=EINTR) break;
+        
+        for (i=j=0;i<ncli;i++) {
+            if (cli[i].sock<0||cli[i].slow) continue;
+            if (!(pfd[j++].revents&(POLLIN|POLLHUP|POLLERR))) continue;
+            
+            if ((n=(int)recv(cli[i].sock,buff,sizeof(buff),0))>0) {
+                cli[i].bytes+=n;
+            }
+            else if (n==0||(errno!=EAGAIN&&errno!=EWOULDBLOCK)) {
+                close(cli[i].sock);
+                cli[i].sock=-1;
+                nclose++;
+            }
+        }
+        /* detect slow clients closed by server */
+        for (i=0;i<nslow;i++) {
+            if (cli[i].sock<0) continue;
+            if (recv(cli[i].sock,buff,0,MSG_PEEK)==0) {
+                close(cli[i].sock);
+                cli[i].sock=-1;
+                nclose++;
+            }
+        }
+        if (t-tlast<intv) continue;
+        
+        for (i=nact=0,bytes=0.0,bmin=1E99,bmax=0.0;i<ncli;i++) {
+            bytes+=cli[i].bytes;
+            if (cli[i].sock<0||cli[i].slow) continue;
+            if (cli[i].bytes<bmin) bmin=cli[i].bytes;
+            if (cli[i].bytes>bmax) bmax=cli[i].bytes;
+            nact++;
+        }
+        fprintf(stderr,"%6.1fs active=%5d closed=%5d rate=%10.0f bps "
+                "bytes/cli min=%.0f max=%.0f\n",t-t0,nact,nclose,
+                (bytes-bytes0)*8.0/(t-tlast),nact?bmin:0.0,bmax);
+        bytes0=bytes;
+        tlast=t;
+        tout=t-t0;
+    }
+    for (i=j=0;i<ncli;i++) {
+        if (cli[i].sock<0) {
+            if (cli[i].slow&&cli[i].conn) j++;
+            continue;
+        }
+        close(cli[i].sock);
+    }
+    fprintf(stderr,"done: %.1f s, %d clients, %d closed by server "
+            "(%d of %d slow clients evicted)\n",tout,nconn,nclose,j,nslow);
+    free(cli); free(pfd);
+    return 0;
+}